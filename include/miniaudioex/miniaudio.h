@@ -740,6 +740,16 @@ typedef ma_uint32 ma_spinlock;
         typedef ma_handle ma_thread;
     #endif
 
+    #if defined(MA_POSIX)
+        #define MA_THREADCALL
+        typedef void* ma_thread_result;
+    #elif defined(MA_WIN32)
+        #define MA_THREADCALL __stdcall
+        typedef unsigned long ma_thread_result;
+    #endif
+
+    typedef ma_thread_result (MA_THREADCALL * ma_thread_entry_proc)(void* pData);
+
     #if defined(MA_POSIX)
         typedef ma_pthread_mutex_t ma_mutex;
     #elif defined(MA_WIN32)
@@ -2476,6 +2486,18 @@ MA_API ma_result ma_spinlock_unlock(volatile ma_spinlock* pSpinlock);
 
 #ifndef MA_NO_THREADING
 
+/*
+Creates a thread that runs entryProc. A stackSize of 0 uses the default stack size. The thread must be
+waited on with ma_thread_wait(), which also releases it.
+*/
+MA_API ma_result ma_thread_create(ma_thread* pThread, ma_thread_priority priority, size_t stackSize, ma_thread_entry_proc entryProc, void* pData, const ma_allocation_callbacks* pAllocationCallbacks);
+
+/*
+Waits for a thread created with ma_thread_create() to return.
+*/
+MA_API void ma_thread_wait(ma_thread* pThread);
+
+
 /*
 Creates a mutex.
 
@@ -2686,6 +2708,7 @@ typedef enum
     MA_JOB_TYPE_RESOURCE_MANAGER_FREE_DATA_STREAM,
     MA_JOB_TYPE_RESOURCE_MANAGER_PAGE_DATA_STREAM,
     MA_JOB_TYPE_RESOURCE_MANAGER_SEEK_DATA_STREAM,
+    MA_JOB_TYPE_RESOURCE_MANAGER_DECODE_DATA_BUFFER_NODE_SEGMENT,
 
     /* Device. */
     MA_JOB_TYPE_DEVICE_AAUDIO_REROUTE,
@@ -2748,7 +2771,20 @@ struct ma_job
                 /*ma_decoder**/ void* pDecoder;
                 ma_async_notification* pDoneNotification;       /* Signalled when the data buffer has been fully decoded. */
                 ma_fence* pDoneFence;                           /* Passed through from LOAD_DATA_BUFFER_NODE and released when the data buffer completes decoding or an error occurs. */
+                ma_uint32 flags;                                /* Passed through from LOAD_DATA_BUFFER_NODE. Selects the job lane. */
             } pageDataBufferNode;
+            struct
+            {
+                /*ma_resource_manager**/ void* pResourceManager;
+                /*ma_resource_manager_data_buffer_node**/ void* pDataBufferNode;
+                /*ma_decoder**/ void* pDecoder;                 /* NULL until the first page of the segment is decoded. */
+                ma_uint64 frameIndex;                           /* Where the next page of the segment is decoded to. */
+                ma_uint64 endFrameIndex;                        /* Where the next segment starts. */
+                ma_uint32 segmentIndex;                         /* The bit of the segment in the node's segmentsDoneMask. */
+                ma_async_notification* pDoneNotification;       /* Signalled by whichever segment of the data buffer finishes last. */
+                ma_fence* pDoneFence;                           /* Released by whichever segment of the data buffer finishes last. */
+                ma_uint32 flags;                                /* Passed through from LOAD_DATA_BUFFER_NODE. Without MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_ASYNC, the thread loading the node finishes it. */
+            } decodeDataBufferNodeSegment;
 
             struct
             {
@@ -6605,6 +6641,7 @@ typedef struct ma_resource_manager_data_buffer_node ma_resource_manager_data_buf
 typedef struct ma_resource_manager_data_buffer      ma_resource_manager_data_buffer;
 typedef struct ma_resource_manager_data_stream      ma_resource_manager_data_stream;
 typedef struct ma_resource_manager_data_source      ma_resource_manager_data_source;
+typedef struct ma_resource_manager_mp3_seek_table   ma_resource_manager_mp3_seek_table;
 
 typedef enum
 {
@@ -6613,7 +6650,8 @@ typedef enum
     MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_ASYNC          = 0x00000004,   /* When set, the resource manager will load the data source asynchronously. */
     MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_WAIT_INIT      = 0x00000008,   /* When set, waits for initialization of the underlying data source before returning from ma_resource_manager_data_source_init(). */
     MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_UNKNOWN_LENGTH = 0x00000010,   /* Gives the resource manager a hint that the length of the data source is unknown and calling `ma_data_source_get_length_in_pcm_frames()` should be avoided. */
-    MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_LOOPING        = 0x00000020    /* When set, configures the data source to loop by default. */
+    MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_LOOPING        = 0x00000020,   /* When set, configures the data source to loop by default. */
+    MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_BACKGROUND     = 0x00000040    /* When set, asynchronous loading jobs go to the background lane and only run when no streaming or regular loading jobs are queued. Intended for prefetching. */
 } ma_resource_manager_data_source_flags;
 
 
@@ -6671,6 +6709,23 @@ typedef enum
     MA_RESOURCE_MANAGER_FLAG_NO_THREADING = 0x00000002
 } ma_resource_manager_flags;
 
+/* Job threads always take the next job from the first lane that isn't empty. */
+typedef enum
+{
+    ma_resource_manager_job_lane_stream     = 0,    /* Loading, paging, seeking and freeing data streams, so playing streams don't wait behind loads. */
+    ma_resource_manager_job_lane_load       = 1,    /* Loading and freeing data buffers. */
+    ma_resource_manager_job_lane_background = 2,    /* Data buffers loaded with MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_BACKGROUND, and the quit job. */
+    ma_resource_manager_job_lane_count
+} ma_resource_manager_job_lane;
+
+typedef struct
+{
+    ma_job* pJobs;          /* Circular buffer. Doubles in size when a job is posted while it is full. */
+    ma_uint32 capacity;
+    ma_uint32 head;         /* Index of the oldest job. */
+    ma_uint32 count;
+} ma_resource_manager_job_lane_queue;
+
 typedef struct
 {
     const char* pFilePath;
@@ -6710,7 +6765,7 @@ typedef struct
         {
             const void* pData;
             ma_uint64 totalFrameCount;
-            ma_uint64 decodedFrameCount;
+            MA_ATOMIC(8, ma_uint64) decodedFrameCount;  /* Frames from the start of the buffer that can be read while the node is still decoding. */
             ma_format format;
             ma_uint32 channels;
             ma_uint32 sampleRate;
@@ -6726,16 +6781,25 @@ typedef struct
 
 struct ma_resource_manager_data_buffer_node
 {
-    ma_uint32 hashedName32;                         /* The hashed name. This is the key. */
+    ma_uint64 hashedName64;                         /* The hashed name. This is the key. */
+    const char* pName;                              /* The full name, or NULL if the node was named with a wide string. Stored in the same allocation as the node and compared on lookup since different names can share a key. */
+    const wchar_t* pNameW;                          /* The full name, or NULL if the node was named with a narrow string. */
     ma_uint32 refCount;
     MA_ATOMIC(4, ma_result) result;                 /* Result from asynchronous loading. When loading set to MA_BUSY. When fully loaded set to MA_SUCCESS. When deleting set to MA_UNAVAILABLE. */
     MA_ATOMIC(4, ma_uint32) executionCounter;       /* For allocating execution orders for jobs. */
     MA_ATOMIC(4, ma_uint32) executionPointer;       /* For managing the order of execution for asynchronous jobs relating to this object. Incremented as jobs complete processing. */
     ma_bool32 isDataOwnedByResourceManager;         /* Set to true when the underlying data buffer was allocated the resource manager. Set to false if it is owned by the application (via ma_resource_manager_register_*()). */
+    ma_uint32 flags;                                /* The flags the node was created with. Every job that has to wait for the node goes to the job lane these select. */
     ma_resource_manager_data_supply data;
-    ma_resource_manager_data_buffer_node* pParent;
-    ma_resource_manager_data_buffer_node* pChildLo;
-    ma_resource_manager_data_buffer_node* pChildHi;
+    ma_uint64 decodedSizeInBytes;                   /* Size of the decoded data owned by the resource manager. Counted against the cache budget. */
+    ma_bool32 isCached;                             /* Set while the node is no longer referenced and only kept alive by the cache. */
+    ma_resource_manager_data_buffer_node* pCachePrev;
+    ma_resource_manager_data_buffer_node* pCacheNext;
+    ma_uint64 firstSegmentSizeInFrames;             /* When decoding is split into segments, the PAGE_DATA_BUFFER_NODE jobs only decode this many frames. 0 when decoding is not split. */
+    ma_uint32 segmentCount;                         /* The number of segments decoding is split into, at most 64. Only valid when firstSegmentSizeInFrames is not 0. */
+    MA_ATOMIC(8, ma_uint64) segmentsDoneMask;       /* One bit for each segment that finished without an error. Segments are published to decodedFrameCount once the ones before them are done. */
+    MA_ATOMIC(4, ma_uint32) segmentsRemaining;      /* The number of segments that are still decoding, including the first. */
+    MA_ATOMIC(4, ma_result) segmentResult;          /* The first error from decoding a segment. */
 };
 
 struct ma_resource_manager_data_buffer
@@ -6769,7 +6833,8 @@ struct ma_resource_manager_data_stream
     ma_uint64 totalLengthInPCMFrames;           /* This is calculated when first loaded by the MA_JOB_TYPE_RESOURCE_MANAGER_LOAD_DATA_STREAM. */
     ma_uint32 relativeCursor;                   /* The playback cursor, relative to the current page. Only ever accessed by the public API. Never accessed by the job thread. */
     MA_ATOMIC(8, ma_uint64) absoluteCursor;     /* The playback cursor, in absolute position starting from the start of the file. */
-    ma_uint32 currentPageIndex;                 /* Toggles between 0 and 1. Index 0 is the first half of pPageData. Index 1 is the second half. Only ever accessed by the public API. Never accessed by the job thread. */
+    ma_uint32 currentPageIndex;                 /* Toggles between 0 and 1. Selects the page in pPageData that is being read. Only ever accessed by the public API. Never accessed by the job thread. */
+    ma_bool32 isStarving;                       /* Set while reads return MA_BUSY because the job thread hasn't caught up. Only ever accessed by the public API. */
     MA_ATOMIC(4, ma_uint32) executionCounter;   /* For allocating execution orders for jobs. */
     MA_ATOMIC(4, ma_uint32) executionPointer;   /* For managing the order of execution for asynchronous jobs relating to this object. Incremented as jobs complete processing. */
 
@@ -6777,8 +6842,15 @@ struct ma_resource_manager_data_stream
     MA_ATOMIC(4, ma_bool32) isLooping;          /* Whether or not the stream is looping. It's important to set the looping flag at the data stream level for smooth loop transitions. */
 
     /* Written by the job thread, read by the public API. */
-    void* pPageData;                            /* Buffer containing the decoded data of each page. Allocated once at initialization time. */
+    void* pPageData[2];                         /* Buffer containing the decoded data of each page. Only reallocated by the job thread while the page is invalid. */
     MA_ATOMIC(4, ma_uint32) pageFrameCount[2];  /* The number of valid PCM frames in each page. Used to determine the last valid frame. */
+    MA_ATOMIC(4, ma_uint32) pageSizeInFrames[2];/* The size the page was filled to. The cursor moves on to the next page when it reaches this. */
+
+    /* Only ever accessed by the job thread. */
+    ma_uint32 pageCapacityInFrames[2];          /* The number of frames each page buffer can hold. */
+    ma_uint32 targetPageSizeInFrames;           /* The page size the next fill will use. Adjusted from the bitrate of the file and the time it takes to fill a page. */
+    ma_uint32 lastStarvationCount;              /* The starvation count at the previous fill. The page grows when it changed. */
+    MA_ATOMIC(4, ma_uint32) starvationCount;    /* The number of times the public API ran out of decoded frames before the end of the stream. */
 
     /* Written and read by both the public API and the job thread. These must be atomic. */
     MA_ATOMIC(4, ma_result) result;             /* Result from asynchronous loading. When loading set to MA_BUSY. When initialized set to MA_SUCCESS. When deleting set to MA_UNAVAILABLE. If an error occurs when loading, set to an error code. */
@@ -6809,34 +6881,106 @@ typedef struct
     ma_uint32 decodedSampleRate;    /* the decoded sample rate to use. Set to 0 (default) to use the file's native sample rate. */
     ma_uint32 jobThreadCount;       /* Set to 0 if you want to self-manage your job threads. Defaults to 1. */
     size_t jobThreadStackSize;
-    ma_uint32 jobQueueCapacity;     /* The maximum number of jobs that can fit in the queue at a time. Defaults to MA_JOB_TYPE_RESOURCE_MANAGER_QUEUE_CAPACITY. Cannot be zero. */
+    ma_uint32 jobQueueCapacity;     /* The number of jobs each lane can hold before it has to grow. Defaults to MA_JOB_TYPE_RESOURCE_MANAGER_QUEUE_CAPACITY. Cannot be zero. */
     ma_uint32 flags;
     ma_vfs* pVFS;                   /* Can be NULL in which case defaults will be used. */
     ma_decoding_backend_vtable** ppCustomDecodingBackendVTables;
     ma_uint32 customDecodingBackendCount;
     void* pCustomDecodingBackendUserData;
     ma_resampler_config resampling;
+    ma_uint64 cacheBudgetInBytes;   /* When not 0, decoded data buffers that are no longer referenced are kept and evicted least recently used first once the decoded data owned by the resource manager exceeds this many bytes. */
+    size_t streamPagePoolSizeInBytes;           /* When not 0, the pages of every data stream are allocated from one pool of this many bytes. Pages that don't fit fall back to the heap. */
+    ma_uint32 streamPageMinSizeInMilliseconds;  /* The smallest page a data stream uses. Defaults to MA_RESOURCE_MANAGER_PAGE_SIZE_IN_MILLISECONDS. */
+    ma_uint32 streamPageMaxSizeInMilliseconds;  /* The largest page a data stream grows to. Defaults to MA_RESOURCE_MANAGER_PAGE_SIZE_IN_MILLISECONDS. Pages are only sized adaptively when this is larger than the minimum. */
+    ma_uint32 decodeSegmentMinSizeInMilliseconds;   /* Decoding a file that seeks cheaply is split into segments of at least this length, each decoded on its own job thread. Set to 0 to always decode from start to finish. Defaults to MA_RESOURCE_MANAGER_DECODE_SEGMENT_MIN_SIZE_IN_MILLISECONDS. */
+    ma_decoding_backend_vtable** ppSegmentedDecodingBackendVTables; /* Custom decoding backends that seek cheaply enough to be decoded in segments. The built-in WAV (except ADPCM) and FLAC backends always are, and MP3 is when a seek table is used. */
+    ma_uint32 segmentedDecodingBackendCount;
+    ma_uint32 mp3SeekPointIntervalInMilliseconds;   /* When not 0, a seek table with a seek point about every this many milliseconds is built the first time an MP3 file is loaded and shared by every later decoder for it. Defaults to 0. */
+    ma_bool32 saveMP3SeekTables;                    /* When set, MP3 seek tables are saved next to the file as "<file>.seektable" through the VFS and loaded from there the next time. Defaults to false. */
 } ma_resource_manager_config;
 
 MA_API ma_resource_manager_config ma_resource_manager_config_init(void);
 
+typedef struct
+{
+    MA_ATOMIC(8, ma_uint64) hashedName64;                           /* 0 when the slot has never been used. */
+    MA_ATOMIC(MA_SIZEOF_PTR, ma_resource_manager_data_buffer_node*) pNode;  /* NULL with a non-zero key when the node has been removed. */
+} ma_resource_manager_data_buffer_node_slot;
+
+typedef struct
+{
+    ma_uint32 capacity;                                             /* Always a power of two. Never changes, a full table is replaced instead. */
+    ma_uint32 count;                                                /* The number of slots holding a node. */
+    ma_uint32 removedCount;                                         /* The number of slots whose node has been removed. These still need to be probed past. */
+    ma_resource_manager_data_buffer_node_slot* pSlots;              /* Allocated with the table. */
+    void* pRetiredNext;                                             /* The tables this one replaced that haven't been freed yet. Freed once no search can still be using them. */
+} ma_resource_manager_data_buffer_node_table;
+
 struct ma_resource_manager
 {
     ma_resource_manager_config config;
-    ma_resource_manager_data_buffer_node* pRootDataBufferNode;      /* The root buffer in the binary tree. */
+    MA_ATOMIC(MA_SIZEOF_PTR, ma_resource_manager_data_buffer_node_table*) pDataBufferNodeTable;    /* Open addressing hash table of data buffer nodes. Modified while holding dataBufferBSTLock, but searched without it. */
+    MA_ATOMIC(4, ma_uint32) dataBufferNodeReaderEpoch;              /* Selects the counter in dataBufferNodeReaderCounts that searches starting now count themselves in. */
+    MA_ATOMIC(4, ma_uint32) dataBufferNodeReaderCounts[2];          /* The number of searches running without the lock, by the epoch they started in. A removed node is freed once both have been seen at 0. */
 #ifndef MA_NO_THREADING
-    ma_mutex dataBufferBSTLock;                                     /* For synchronizing access to the data buffer binary tree. */
+    ma_mutex dataBufferBSTLock;                                     /* For synchronizing changes to the data buffer node table. */
     ma_thread jobThreads[MA_RESOURCE_MANAGER_MAX_JOB_THREAD_COUNT]; /* The threads for executing jobs. */
 #endif
-    ma_job_queue jobQueue;                                          /* Multi-consumer, multi-producer job queue for managing jobs for asynchronous decoding and streaming. */
+    ma_resource_manager_job_lane_queue jobLanes[ma_resource_manager_job_lane_count];   /* Multi-consumer, multi-producer job queues for asynchronous decoding and streaming, one per ma_resource_manager_job_lane. */
+    ma_spinlock jobLock;                                            /* Guards the job lanes. */
+#ifndef MA_NO_THREADING
+    ma_semaphore jobSemaphore;                                      /* Released once for every posted job. Not used with MA_RESOURCE_MANAGER_FLAG_NON_BLOCKING. */
+#endif
     ma_default_vfs defaultVFS;                                      /* Only used if a custom VFS is not specified. */
     ma_log log;                                                     /* Only used if no log was specified in the config. */
+    ma_resource_manager_data_buffer_node* pCacheHead;               /* Least recently used node in the cache. The cache is guarded by dataBufferBSTLock. */
+    ma_resource_manager_data_buffer_node* pCacheTail;               /* Most recently used node in the cache. */
+    ma_uint64 cachedSizeInBytes;
+    ma_uint32 cachedNodeCount;
+    MA_ATOMIC(8, ma_uint64) decodedSizeInBytes;                     /* Total size of the decoded data owned by the resource manager, referenced or cached. */
+    MA_ATOMIC(8, ma_uint64) cacheHits;
+    MA_ATOMIC(8, ma_uint64) cacheMisses;
+    MA_ATOMIC(8, ma_uint64) cacheEvictions;
+    void* pStreamPagePool;                                          /* Shared memory for the pages of data streams. Divided into blocks of MA_RESOURCE_MANAGER_STREAM_PAGE_POOL_BLOCK_SIZE bytes. */
+    ma_uint32* pStreamPagePoolBlocks;                               /* Per block: 0 when free, the length of the allocation for its first block, 0xFFFFFFFF for the others. */
+    ma_uint32 streamPagePoolBlockCount;
+    ma_uint32 streamPagePoolBlocksInUse;
+    ma_spinlock streamPagePoolLock;
+    MA_ATOMIC(8, ma_uint64) streamPageHeapSizeInBytes;              /* Page memory that didn't fit in the pool, or all page memory when there is no pool. */
+    MA_ATOMIC(8, ma_uint64) streamPagePoolFallbacks;
+    MA_ATOMIC(8, ma_uint64) streamStarvations;
+    ma_resource_manager_mp3_seek_table** ppMP3SeekTableBuckets;     /* Hash table of the seek table of every MP3 asset that has been loaded, keyed by the hashed name. Guarded by dataBufferBSTLock. */
+    ma_uint32 mp3SeekTableBucketCount;                              /* Always a power of two, or 0 before the first table is added. */
+    ma_uint32 mp3SeekTableCount;
 };
 
+typedef struct
+{
+    ma_uint64 budgetInBytes;
+    ma_uint64 decodedSizeInBytes;   /* Decoded data owned by the resource manager, including what is cached. */
+    ma_uint64 cachedSizeInBytes;    /* Decoded data that is no longer referenced and only kept by the cache. */
+    ma_uint32 cachedCount;
+    ma_uint64 hits;                 /* Acquisitions that found an existing data buffer node, including one taken back from the cache. */
+    ma_uint64 misses;               /* Acquisitions that had to create and load a new data buffer node. */
+    ma_uint64 evictions;
+} ma_resource_manager_cache_stats;
+
+typedef struct
+{
+    ma_uint64 poolSizeInBytes;
+    ma_uint64 poolUsedInBytes;      /* Page memory of data streams taken from the pool. */
+    ma_uint64 heapSizeInBytes;      /* Page memory of data streams allocated on the heap. */
+    ma_uint64 poolFallbacks;        /* Pages that were allocated on the heap because the pool had no room. */
+    ma_uint64 starvations;          /* The number of times a data stream ran out of decoded frames before the job thread caught up. */
+} ma_resource_manager_stream_stats;
+
 /* Init. */
 MA_API ma_result ma_resource_manager_init(const ma_resource_manager_config* pConfig, ma_resource_manager* pResourceManager);
 MA_API void ma_resource_manager_uninit(ma_resource_manager* pResourceManager);
 MA_API ma_log* ma_resource_manager_get_log(ma_resource_manager* pResourceManager);
+MA_API ma_result ma_resource_manager_set_cache_budget(ma_resource_manager* pResourceManager, ma_uint64 budgetInBytes);
+MA_API ma_result ma_resource_manager_get_cache_stats(ma_resource_manager* pResourceManager, ma_resource_manager_cache_stats* pStats);
+MA_API ma_result ma_resource_manager_get_stream_stats(ma_resource_manager* pResourceManager, ma_resource_manager_stream_stats* pStats);
 
 /* Registration. */
 MA_API ma_result ma_resource_manager_register_file(ma_resource_manager* pResourceManager, const char* pFilePath, ma_uint32 flags);
@@ -6880,6 +7024,7 @@ MA_API ma_result ma_resource_manager_data_stream_result(const ma_resource_manage
 MA_API ma_result ma_resource_manager_data_stream_set_looping(ma_resource_manager_data_stream* pDataStream, ma_bool32 isLooping);
 MA_API ma_bool32 ma_resource_manager_data_stream_is_looping(const ma_resource_manager_data_stream* pDataStream);
 MA_API ma_result ma_resource_manager_data_stream_get_available_frames(ma_resource_manager_data_stream* pDataStream, ma_uint64* pAvailableFrames);
+MA_API ma_uint32 ma_resource_manager_data_stream_get_starvation_count(const ma_resource_manager_data_stream* pDataStream);
 
 /* Data Sources. */
 MA_API ma_result ma_resource_manager_data_source_init_ex(ma_resource_manager* pResourceManager, const ma_resource_manager_data_source_config* pConfig, ma_resource_manager_data_source* pDataSource);
@@ -6900,6 +7045,8 @@ MA_API ma_result ma_resource_manager_data_source_get_available_frames(ma_resourc
 /* Job management. */
 MA_API ma_result ma_resource_manager_post_job(ma_resource_manager* pResourceManager, const ma_job* pJob);
 MA_API ma_result ma_resource_manager_post_job_quit(ma_resource_manager* pResourceManager);  /* Helper for posting a quit job. */
+MA_API ma_resource_manager_job_lane ma_resource_manager_get_job_lane(const ma_job* pJob);
+MA_API ma_uint32 ma_resource_manager_get_job_count(ma_resource_manager* pResourceManager, ma_resource_manager_job_lane lane);
 MA_API ma_result ma_resource_manager_next_job(ma_resource_manager* pResourceManager, ma_job* pJob);
 MA_API ma_result ma_resource_manager_process_job(ma_resource_manager* pResourceManager, ma_job* pJob);  /* DEPRECATED. Use ma_job_process(). Will be removed in version 0.12. */
 MA_API ma_result ma_resource_manager_process_next_job(ma_resource_manager* pResourceManager);   /* Returns MA_CANCELLED if a MA_JOB_TYPE_QUIT job is found. In non-blocking mode, returns MA_NO_DATA_AVAILABLE if no jobs are available. */
@@ -7420,6 +7567,7 @@ typedef enum
     MA_SOUND_FLAG_WAIT_INIT             = 0x00000008,   /* MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_WAIT_INIT */
     MA_SOUND_FLAG_UNKNOWN_LENGTH        = 0x00000010,   /* MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_UNKNOWN_LENGTH */
     MA_SOUND_FLAG_LOOPING               = 0x00000020,   /* MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_LOOPING */
+    MA_SOUND_FLAG_BACKGROUND            = 0x00000040,   /* MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_BACKGROUND */
 
     /* ma_sound specific flags. */
     MA_SOUND_FLAG_NO_DEFAULT_ATTACHMENT = 0x00001000,   /* Do not attach to the endpoint by default. Useful for when setting up nodes in a complex graph system. */
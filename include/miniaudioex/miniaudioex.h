@@ -48,7 +48,7 @@
 
 /* Note that this may not be fully compatible with the original miniaudio library
     Notable changes made in miniaudio:
-    - added method ma_sound_init_from_memory
+    - added method ma_sound_init_from_memory (with MA_SOUND_FLAG_DECODE the content is decoded once and shared through the resource manager)
     - added method ma_sound_init_from_callback
     - added custom data source: ma_procedural_data_source
     - added method ma_procedural_data_source_config_init
@@ -66,6 +66,28 @@
     - added method ma_get_size_of_type
     - added MA_DATA_SOURCE_IS_DECODER and MA_DATA_SOURCE_IS_PROCEDURAL flags (internally used)
     - modified ma_sound_uninit so it can free allocated memory caused by calling ma_sound_init_from_memory and ma_sound_init_from_callback
+    - modified ma_sound_uninit so it leaves data sources passed to ma_sound_init_from_data_source alone
+    - modified sound processing so a seek discards frames left in the processing cache
+    - modified the FREE_DATA_BUFFER job so it no longer touches the data buffer after signalling its owner
+    - added an LRU cache for unreferenced decoded data buffer nodes (ma_resource_manager_config.cacheBudgetInBytes)
+    - added method ma_resource_manager_set_cache_budget
+    - added method ma_resource_manager_get_cache_stats
+    - modified ma_resource_manager_data_buffer_node_acquire so a file that fails to load no longer reads its freed node
+    - added a shared pool for the pages of data streams (ma_resource_manager_config.streamPagePoolSizeInBytes)
+    - modified data streams so their page size adapts between ma_resource_manager_config.streamPageMinSizeInMilliseconds and streamPageMaxSizeInMilliseconds
+    - added method ma_resource_manager_get_stream_stats
+    - added method ma_resource_manager_data_stream_get_starvation_count
+    - modified the resource manager job queue into growable priority lanes (streams, loads, background)
+    - added flags MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_BACKGROUND and MA_SOUND_FLAG_BACKGROUND
+    - added method ma_resource_manager_get_job_lane
+    - added method ma_resource_manager_get_job_count
+    - replaced the data buffer node binary tree with a hash table keyed by a 64-bit hash and verified against the full name, so already loaded files are acquired without the resource manager lock
+    - added parallel decoding of long files in segments split at seek points (ma_resource_manager_config.decodeSegmentMinSizeInMilliseconds and ppSegmentedDecodingBackendVTables)
+    - modified decoder initialization so that without an encoding format the stock WAV, FLAC or MP3 decoder picked from the first bytes is tried before any other decoder
+    - added MP3 seek tables that are built once per file and shared by every resource manager decoder for it, optionally saved next to the file (ma_resource_manager_config.mp3SeekPointIntervalInMilliseconds and saveMP3SeekTables)
+    - modified ma_hash_64 to hash the data in a single pass instead of once per seed
+    - added method ma_thread_create
+    - added method ma_thread_wait
 */
 
 #ifndef MINIAUDIOEX_H
@@ -92,6 +114,18 @@ struct ma_ex_device_info {
     ma_ex_native_data_format *nativeDataFormats;
 };
 
+typedef struct ma_ex_device_enumerator ma_ex_device_enumerator;
+
+/* Cached playback devices. Everything lives in one allocation that is only replaced when the cache is refreshed. */
+struct ma_ex_device_enumerator {
+    ma_ex_device_info *pDevices;    /* Start of the allocation. Handed out to callers as read-only views. */
+    ma_device_id *pDeviceIDs;
+    ma_uint8 *pFormatsQueried;      /* Native data formats are queried per device the first time they are asked for. */
+    ma_uint32 deviceCount;
+    ma_bool32 isValid;
+    MA_ATOMIC(4, ma_uint32) isDirty;    /* Set when the backend reports a change, such as the device being rerouted. */
+};
+
 typedef struct ma_ex_context_config ma_ex_context_config;
 
 struct ma_ex_context_config {
@@ -100,30 +134,226 @@ struct ma_ex_context_config {
     ma_uint8 channels;
     ma_uint32 periodSizeInFrames;
     ma_device_data_proc deviceDataProc;
+    ma_bool32 noDevice;     /* When set to true, no ma_device is created. Audio is pulled with ma_ex_context_render() or ma_ex_context_render_to_file(). */
+    ma_uint32 commandQueueCapacity; /* When set to something other than 0, audio source setters are recorded into a queue that is drained at the start of every audio callback. Rounded up to a power of two, and doubled whenever the queue fills up. */
+    ma_uint32 sourcePoolCapacity;   /* Number of preallocated audio sources. Rounded up to a multiple of 32. When 0 or exhausted, sources are allocated on the heap. */
+    ma_uint32 listenerPoolCapacity; /* Number of preallocated audio listeners. Rounded up to a multiple of 32. When 0 or exhausted, listeners are allocated on the heap. */
+    ma_uint32 soundGroupPoolCapacity; /* Number of preallocated sound groups. Rounded up to a multiple of 32. When 0 or exhausted, sound groups are allocated on the heap. */
+    ma_uint32 maxVoices;    /* The maximum number of audio sources that can play at the same time. When set to 0 there is no limit. */
+    ma_uint32 voiceStealFadeInMilliseconds; /* The length of the fade out applied to a voice that is stolen to make room for another one or becomes virtual. */
+    ma_bool32 virtualVoices;        /* When set to true, ma_ex_context_update() stops processing sources that can't be heard while keeping track of their position. */
+    float virtualVoiceThreshold;    /* Sources with an estimated gain at or below this value become virtual. */
+    ma_bool32 shareMemoryDecodes;   /* Decode memory played with ma_ex_audio_source_play_from_memory once and share the PCM, instead of a decoder per source. */
+    ma_bool32 parallelInit;         /* Initialize the backend and device on a separate thread while the resource manager is initialized. */
+    ma_bool32 deferDeviceStart;     /* Don't start the device until the first audio source plays or ma_ex_context_start_device() is called. */
+    ma_uint32 jobThreadCount;       /* Number of resource manager job threads that decode clips loaded with ma_ex_audio_clip_load_async(). When 0 the resource manager default is used. */
+    ma_uint32 jobQueueCapacity;     /* Number of jobs each resource manager job lane holds before it grows. When 0 the resource manager default is used. */
+    ma_uint64 cacheBudgetInBytes;   /* When not 0, decoded files that no longer play are kept by the resource manager until its decoded data exceeds this many bytes, so playing them again doesn't decode them again. */
+    ma_bool32 memoryMappedFiles;    /* Read files through an ma_ex_mmap_vfs instead of stdio, and play PCM WAV files that match the context format straight from the mapping. Disabled by default. */
+    const char *pDecodeCacheDirectory;  /* When set, files that are decoded up front are also written to this existing directory in the format of the context, and mapped from there on later loads instead of being decoded again. Cache files are found by the path, size and modification time of the file. */
+    ma_uint32 readAheadThreadCount; /* When not 0, files opened by the resource manager go through an ma_ex_readahead_vfs with this many I/O threads. */
+    size_t readAheadBlockSize;      /* Size of the blocks read ahead. When 0, 64 KiB is used. */
+    size_t streamPagePoolSizeInBytes;   /* When not 0, the pages of streamed files are allocated from one pool of this many bytes shared by every stream. */
+    ma_uint32 streamPageMinMilliseconds;    /* The smallest page a stream uses. When 0 the resource manager default is used. */
+    ma_uint32 streamPageMaxMilliseconds;    /* The largest page a stream grows to after running out of data or decoding slowly. When not larger than the minimum, every page has the minimum size. */
+    ma_uint32 decodeSegmentMinMilliseconds; /* Files decoded up front that are at least twice this long are split at seek points and decoded by several job threads at once. When 0 the resource manager default is used. */
+    ma_uint32 mp3SeekPointMilliseconds;     /* MP3 files are scanned once for a seek table with a point every this many milliseconds, shared by every later sound and stream of the file. 0 disables this. */
+    ma_bool32 saveMP3SeekTables;            /* When enabled, MP3 seek tables are saved next to the file as "<file>.seektable" so the scan is skipped the next time. */
+};
+
+typedef struct ma_ex_command_queue ma_ex_command_queue;
+
+/* Multiple producers serialized by producerLock, single consumer (whoever holds isDraining). Grows when it fills up. */
+struct ma_ex_command_queue {
+    void *pCommands;
+    MA_ATOMIC(4, ma_uint32) capacity;
+    ma_spinlock producerLock;
+    MA_ATOMIC(4, ma_uint32) readIndex;
+    MA_ATOMIC(4, ma_uint32) writeIndex;
+    MA_ATOMIC(4, ma_uint32) isDraining;
+    void *pRetiredBatches;  /* Transform batches the consumer has applied. Freed by the next producer to record a batch. */
+};
+
+typedef struct ma_ex_pool ma_ex_pool;
+
+/* Fixed capacity pool of equally sized objects. Allocating and freeing is lock free. */
+struct ma_ex_pool {
+    ma_slot_allocator allocator;
+    void *pItems;
+    size_t itemSize;
+    ma_uint32 capacity;
+    MA_ATOMIC(4, ma_uint32) highWaterMark;  /* The highest number of items that were in use at the same time. */
+    MA_ATOMIC(4, ma_uint32) overflowCount;  /* The number of allocations that had to fall back to the heap. */
+};
+
+typedef struct ma_ex_pool_stats ma_ex_pool_stats;
+
+struct ma_ex_pool_stats {
+    ma_uint32 capacity;
+    ma_uint32 used;
+    ma_uint32 highWaterMark;
+    ma_uint32 overflowCount;
+};
+
+typedef struct ma_ex_sound_group_voice_limit ma_ex_sound_group_voice_limit;
+
+struct ma_ex_sound_group_voice_limit {
+    ma_sound_group *group;
+    ma_uint32 maxVoices;
+};
+
+typedef struct ma_ex_audio_source ma_ex_audio_source;
+
+/* Identifies an audio source. The slot index is stored in the low 32 bits and a generation in the high 32 bits, so handles to destroyed sources can be detected. 0 is never a valid handle. */
+typedef ma_uint64 ma_ex_audio_source_handle;
+
+#define MA_EX_SOURCE_BLOCK_SIZE 256
+#define MA_EX_MAX_SOURCE_BLOCKS 1024
+
+typedef struct ma_ex_source_block ma_ex_source_block;
+
+/* A block of source slots. Settings that change every frame are stored as structure of arrays, so updating many sources touches contiguous memory. */
+struct ma_ex_source_block {
+    ma_uint32 generations[MA_EX_SOURCE_BLOCK_SIZE];
+    ma_uint32 nextFree[MA_EX_SOURCE_BLOCK_SIZE];
+    ma_ex_audio_source *sources[MA_EX_SOURCE_BLOCK_SIZE];
+    float volumes[MA_EX_SOURCE_BLOCK_SIZE];
+    float pitches[MA_EX_SOURCE_BLOCK_SIZE];
+    ma_vec3f positions[MA_EX_SOURCE_BLOCK_SIZE];
+};
+
+typedef struct ma_ex_source_table ma_ex_source_table;
+
+/* Generational handle table for audio sources. Blocks never move once allocated. Slots are allocated, freed and resolved under sourceLock. */
+struct ma_ex_source_table {
+    ma_ex_source_block *pBlocks[MA_EX_MAX_SOURCE_BLOCKS];
+    ma_uint32 blockCount;
+    ma_uint32 slotCount;
+    ma_uint32 freeHead;     /* Slot index + 1 of the first free slot, 0 when there are none. */
+};
+
+typedef struct ma_ex_file_view ma_ex_file_view;
+
+/* Read only view of a whole file. The file is mapped into memory when the platform allows it, otherwise it is read into a heap copy. */
+struct ma_ex_file_view {
+    const void *pData;
+    size_t sizeInBytes;
+    ma_bool32 isMapped;
+};
+
+typedef struct ma_ex_probe_info ma_ex_probe_info;
+
+/* What ma_ex_probe_file and ma_ex_probe_memory read from the headers of a file without decoding any audio. */
+struct ma_ex_probe_info {
+    ma_encoding_format codec;       /* ma_encoding_format_unknown when the file could only be opened by a custom decoder. */
+    ma_format format;               /* The sample format in the file. ma_format_unknown when miniaudio has no matching format, e.g. 64-bit float WAV. */
+    ma_uint32 channels;
+    ma_uint32 sampleRate;
+    ma_uint64 lengthInPCMFrames;    /* 0 when the length can't be told from the headers. */
+    ma_bool32 isLengthExact;        /* False when the length was estimated, e.g. from the bitrate of an MP3 file without a Xing header. */
+};
+
+typedef struct ma_ex_probe_result ma_ex_probe_result;
+
+struct ma_ex_probe_result {
+    const char *pFilePath;
+    ma_result result;
+    ma_ex_probe_info info;
+};
+
+typedef struct ma_ex_mmap_vfs ma_ex_mmap_vfs;
+
+/* ma_vfs that reads straight from memory mapped files. Files opened for writing, wide paths and files that can't be mapped go through the default VFS. */
+struct ma_ex_mmap_vfs {
+    ma_vfs_callbacks cb;
+    ma_default_vfs defaultVFS;
+};
+
+#define MA_EX_READAHEAD_BLOCK_COUNT 4    /* Blocks cached per file, the one being read and the ones prefetched after it. */
+#define MA_EX_READAHEAD_MAX_THREADS 16
+
+typedef struct ma_ex_readahead_file ma_ex_readahead_file;
+typedef struct ma_ex_readahead_vfs ma_ex_readahead_vfs;
+
+/* ma_vfs that serves reads from blocks read ahead of the cursor by a pool of I/O threads, for files that are read front to back. Decoders then rarely wait on the disk themselves. */
+struct ma_ex_readahead_vfs {
+    ma_vfs_callbacks cb;
+    ma_vfs *pInnerVFS;                  /* The VFS files are actually read from. */
+    ma_default_vfs defaultVFS;          /* Used as pInnerVFS when no other VFS is given. */
+    size_t blockSize;
+    ma_mutex lock;                      /* Guards the blocks of every file and the request queue. */
+    ma_semaphore requestSemaphore;      /* Released once for every file that is queued. */
+    ma_ex_readahead_file *pRequestHead; /* Files with blocks waiting to be read, oldest first. */
+    ma_ex_readahead_file *pRequestTail;
+    ma_thread *pThreads;
+    ma_uint32 threadCount;
+    ma_bool32 isShuttingDown;
 };
 
 typedef struct ma_ex_context ma_ex_context;
+typedef struct ma_ex_audio_clip ma_ex_audio_clip;
+
+#define MA_EX_CLIP_CACHE_BUCKET_COUNT 256
+
+typedef struct ma_ex_clip_cache_entry ma_ex_clip_cache_entry;
+
+/* A clip created by the fast path, keyed by its path. The path is stored right after the entry. */
+struct ma_ex_clip_cache_entry {
+    ma_uint64 hash;
+    const char *pFilePath;
+    ma_ex_audio_clip *clip;         /* Not a reference. */
+    ma_ex_clip_cache_entry *pNext;
+};
 
 struct ma_ex_context {
     ma_context context;
+    ma_bool32 isBackendInitialized;     /* Set once context has been initialized. Contexts without a device only initialize it to enumerate devices. */
+    ma_ex_device_enumerator playbackDevices;
     ma_device device;
     ma_engine engine;
     ma_resource_manager resourceManager;
+    ma_ex_mmap_vfs vfs;                 /* Handed to the resource manager when memoryMappedFiles is set. */
+    ma_ex_readahead_vfs readAheadVFS;   /* Handed to the resource manager when readAheadThreadCount is set. Reads from vfs when memoryMappedFiles is set as well. */
+    ma_bool32 memoryMappedFiles;
+    char *pDecodeCacheDirectory;
+    ma_ex_clip_cache_entry *pClipCache[MA_EX_CLIP_CACHE_BUCKET_COUNT];  /* Clips played from a mapping or the decode cache, shared by every source playing the same path. */
+    ma_spinlock clipCacheLock;          /* Guards pClipCache, the pCacheEntry of every clip and pVerifiedDecodeCacheKeys. */
+    ma_uint64 *pVerifiedDecodeCacheKeys;    /* Decode cache files whose source was hashed once already. */
+    ma_uint32 verifiedDecodeCacheKeyCount;
+    ma_uint32 verifiedDecodeCacheKeyCapacity;
     ma_uint32 sampleRate;
     ma_uint8 channels;
     ma_format format;
     ma_int32 listeners[MA_ENGINE_MAX_LISTENERS];
+    ma_bool32 noDevice;
+    ma_ex_command_queue commandQueue;
+    ma_ex_pool sourcePool;
+    ma_ex_pool listenerPool;
+    ma_ex_pool soundGroupPool;
+    ma_ex_pool soundPool;
+    ma_ex_source_table sourceTable;     /* Guarded by sourceLock when slots are allocated or freed. */
+    ma_spinlock sourceLock;             /* Guards the source list and the group voice limits. */
+    ma_ex_audio_source *pSourceHead;    /* Every initialized audio source, used for voice limiting. */
+    ma_uint32 maxVoices;
+    ma_uint32 voiceStealFadeInMilliseconds;
+    ma_bool32 virtualVoices;
+    float virtualVoiceThreshold;
+    ma_bool32 shareMemoryDecodes;
+    MA_ATOMIC(4, ma_uint32) isDeviceStarted;
+    MA_ATOMIC(MA_SIZEOF_PTR, void*) pLoadedClips;  /* Clips whose asynchronous load finished, pushed by the resource manager job threads. */
+    ma_ex_audio_clip *pLoadedClipsPending;         /* Popped from pLoadedClips in completion order. Only used by ma_ex_context_poll_loaded_clips(). */
+    ma_ex_sound_group_voice_limit *pGroupVoiceLimits;
+    ma_uint32 groupVoiceLimitCount;
+    ma_uint32 groupVoiceLimitCapacity;
 };
 
 typedef struct ma_ex_audio_source_settings ma_ex_audio_source_settings;
 
+/* Volume, pitch and position are stored in the source table of the context. */
 struct ma_ex_audio_source_settings {
-    float volume;
-    float pitch;
     float pan;
     ma_pan_mode panMode;
     ma_bool32 loop;
-    ma_vec3f position;
     ma_vec3f direction;
     ma_vec3f velocity;
     ma_bool32 spatialization;
@@ -133,21 +363,123 @@ struct ma_ex_audio_source_settings {
     float maxDistance;
 };
 
-typedef struct ma_ex_audio_clip ma_ex_audio_clip;
+/* Called on a resource manager job thread when an asynchronous load finishes, or on the calling thread when the file was already loaded. */
+typedef void (*ma_ex_audio_clip_loaded_proc)(ma_ex_audio_clip *clip, ma_result result, void *pUserData);
+
+typedef struct ma_ex_audio_clip_notification ma_ex_audio_clip_notification;
 
+struct ma_ex_audio_clip_notification {
+    ma_async_notification_callbacks cb;
+    ma_ex_audio_clip *clip;
+};
+
+/* Audio that is decoded once and shared by any number of sources. Clips are reference counted and freed when the last reference is released. */
 struct ma_ex_audio_clip {
-    ma_sound sound;
-    ma_uint64 soundHash;
-    ma_uint32 flags;
+    ma_ex_context *context;
+    float *pFrames;                             /* Decoded in the format of the context. NULL for streamed and procedural clips. */
+    const void *pMappedFrames;                  /* The data chunk of a PCM WAV file that already matches the context, read in place from fileView instead of being decoded. */
+    ma_format mappedFormat;                     /* ma_format_s16 or ma_format_f32. */
+    ma_ex_file_view fileView;
+    ma_ex_clip_cache_entry *pCacheEntry;        /* The entry of the clip cache of the context pointing at this clip. Removed when the last reference is released. */
+    ma_uint64 frameCount;
+    char *pFilePath;                            /* Set for clips that are streamed from disk and clips loaded asynchronously. Streamed clips are not shared, every source playing one opens its own stream. */
+    ma_procedural_data_source_proc callback;    /* Only set for procedural clips. */
+    void *pUserData;
+    MA_ATOMIC(4, ma_uint32) refCount;
+    ma_resource_manager_data_buffer *pDataBuffer;   /* Only set for clips loaded with ma_ex_audio_clip_load_async(). Keeps the decoded data in the resource manager. */
+    ma_ex_audio_clip_notification readyNotification;
+    ma_ex_audio_clip_notification doneNotification;
+    ma_ex_audio_clip_loaded_proc onLoaded;
+    void *pLoadedUserData;
+    MA_ATOMIC(4, ma_uint32) loadResult;         /* MA_BUSY while loading, otherwise the result of the load. */
+    MA_ATOMIC(4, ma_uint32) isReady;            /* Set once the first page is decoded and the clip can be played. */
+    MA_ATOMIC(4, ma_uint32) isSubmitted;
+    MA_ATOMIC(4, ma_uint32) isLoadFinished;
+    ma_ex_audio_clip *pNextLoaded;
 };
 
-typedef struct ma_ex_audio_source ma_ex_audio_source;
+typedef struct ma_ex_audio_clip_data_source ma_ex_audio_clip_data_source;
+
+/*
+Reads from whichever clip is bound to a source, so switching clips doesn't require a new ma_sound. The owner never
+blocks the audio thread: a new clip is published through pPendingClip and picked up by the next read or seek.
+*/
+struct ma_ex_audio_clip_data_source {
+    ma_data_source_base ds;
+    MA_ATOMIC(MA_SIZEOF_PTR, void*) pPendingClip;   /* Set by the owner when swapping clips. */
+    MA_ATOMIC(MA_SIZEOF_PTR, void*) pClip;          /* Only written by the thread reading from the sound. */
+    MA_ATOMIC(4, ma_uint32) readSequence;           /* Odd while the audio thread is using pClip. */
+    MA_ATOMIC(8, ma_uint64) cursor;
+    ma_uint32 channels;
+    ma_uint32 sampleRate;
+};
 
 struct ma_ex_audio_source {
     ma_ex_context *context;
-    ma_ex_audio_clip clip;
+    ma_ex_audio_source_handle handle;
+    ma_sound *pSound;           /* Only allocated while the source has something to play. */
+    ma_uint64 soundHash;
+    ma_uint32 soundFlags;
+    ma_ex_audio_clip *clip;     /* The clip bound with ma_ex_audio_source_play_clip(), NULL otherwise. */
+    ma_ex_audio_clip_data_source clipDataSource;
+    ma_bool32 isClipSound;      /* Set when the sound reads from clipDataSource. */
     ma_ex_audio_source_settings settings;
     ma_sound_group *group;
+    ma_int32 priority;          /* When the voice limit is reached, sources with a lower priority are stolen first. */
+    ma_bool32 isStolen;         /* Set when the source was faded out to make room for another source. */
+    ma_bool32 isVirtual;        /* Set when the source is playing but not processed because it can't be heard. */
+    ma_uint64 virtualStartTime; /* Engine time in PCM frames at which the source became virtual. */
+    ma_uint64 virtualStartCursor;
+    MA_ATOMIC(4, ma_uint32) pinCount;  /* Handle based calls using the source. ma_ex_audio_source_uninit() waits for them. */
+    ma_ex_audio_source *pPrev;
+    ma_ex_audio_source *pNext;
+};
+
+#define MA_EX_BANK_VERSION 1
+#define MA_EX_BANK_ALIGNMENT 16     /* Payloads start at a multiple of this many bytes from the start of the bank. */
+
+typedef struct ma_ex_bank_header ma_ex_bank_header;
+
+/* Start of a bank file. It is followed by entryCount entries sorted by name hash, and then the payloads. All fields are little endian. */
+struct ma_ex_bank_header {
+    char magic[8];          /* "MAEXBNK" */
+    ma_uint32 version;
+    ma_uint32 entryCount;
+};
+
+typedef struct ma_ex_bank_entry ma_ex_bank_entry;
+
+struct ma_ex_bank_entry {
+    ma_uint64 nameHash;     /* ma_ex_bank_hash_name() of the name the entry was added with. */
+    ma_uint64 offset;       /* From the start of the bank. */
+    ma_uint64 sizeInBytes;
+    ma_uint64 lengthInFrames;
+    ma_uint32 codec;        /* ma_encoding_format, ma_encoding_format_unknown for formats only a custom decoding backend reads. */
+    ma_uint32 format;       /* The ma_format, channels and sample rate the payload decodes to. */
+    ma_uint32 channels;
+    ma_uint32 sampleRate;
+};
+
+typedef struct ma_ex_bank ma_ex_bank;
+
+/* A bank file mapped into memory. An entry is decoded from the mapping the first time it is played and the decoded clip is kept until the bank is uninitialized. */
+struct ma_ex_bank {
+    ma_ex_context *context;
+    ma_ex_file_view view;
+    const ma_ex_bank_entry *pEntries;   /* Points into view. */
+    ma_uint32 entryCount;
+    ma_uint32 *pSlots;                  /* Open addressing table of entry index + 1 by name hash, 0 for empty slots. */
+    ma_uint32 slotMask;
+    ma_ex_audio_clip **ppClips;         /* The decoded clip of every entry, NULL until the entry is played. Shared by every source playing the entry. */
+};
+
+typedef struct ma_ex_bank_builder ma_ex_bank_builder;
+
+struct ma_ex_bank_builder {
+    ma_ex_bank_entry *pEntries;
+    void **ppPayloads;                  /* A copy of the payload of every entry. */
+    ma_uint32 entryCount;
+    ma_uint32 entryCapacity;
 };
 
 typedef struct ma_ex_audio_listener_settings ma_ex_audio_listener_settings;
@@ -181,19 +513,51 @@ MA_API void ma_ex_playback_devices_free(ma_ex_device_info *pDeviceInfo, ma_uint3
 MA_API ma_ex_context_config ma_ex_context_config_init(ma_uint32 sampleRate, ma_uint8 channels, ma_uint32 periodSizeInFrames, const ma_ex_device_info *pDeviceInfo);
 MA_API ma_ex_context *ma_ex_context_init(const ma_ex_context_config *config);
 MA_API void ma_ex_context_uninit(ma_ex_context *context);
+MA_API ma_result ma_ex_context_start_device(ma_ex_context *context);
+MA_API ma_result ma_ex_context_set_cache_budget(ma_ex_context *context, ma_uint64 budgetInBytes);
+MA_API ma_result ma_ex_context_get_cache_stats(ma_ex_context *context, ma_resource_manager_cache_stats *pStats);
+MA_API ma_result ma_ex_context_get_stream_stats(ma_ex_context *context, ma_resource_manager_stream_stats *pStats);
 MA_API void ma_ex_context_set_master_volume(ma_ex_context *context, float volume);
 MA_API float ma_ex_context_get_master_volume(ma_ex_context *context);
 MA_API ma_engine *ma_ex_context_get_engine(ma_ex_context *context);
 MA_API ma_node_graph *ma_ex_context_get_engine_node_graph(ma_ex_context *context);
+MA_API ma_result ma_ex_context_render(ma_ex_context *context, float *pFramesOut, ma_uint64 frameCount, ma_uint64 *pFramesRendered);
+MA_API ma_result ma_ex_context_render_to_file(ma_ex_context *context, const char *filePath, ma_uint64 frameCount);
+MA_API void ma_ex_context_update(ma_ex_context *context);
+MA_API ma_uint32 ma_ex_context_get_virtual_voice_count(ma_ex_context *context);
+MA_API void ma_ex_context_set_max_voices(ma_ex_context *context, ma_uint32 maxVoices);
+MA_API ma_uint32 ma_ex_context_get_max_voices(ma_ex_context *context);
+MA_API ma_uint32 ma_ex_context_get_voice_count(ma_ex_context *context);
+MA_API ma_result ma_ex_context_get_pool_stats(ma_ex_context *context, ma_ex_pool_stats *pSourceStats, ma_ex_pool_stats *pListenerStats, ma_ex_pool_stats *pSoundGroupStats);
 
 MA_API void *ma_ex_device_get_user_data(ma_device *pDevice);
+MA_API ma_result ma_ex_context_get_playback_devices(ma_ex_context *context, const ma_ex_device_info **ppDevices, ma_uint32 *pCount);
+MA_API const ma_ex_device_info *ma_ex_context_get_playback_device_info(ma_ex_context *context, ma_uint32 index);
+MA_API ma_result ma_ex_context_refresh_playback_devices(ma_ex_context *context);
+
+MA_API ma_ex_audio_clip *ma_ex_audio_clip_init_from_file(ma_ex_context *context, const char *filePath, ma_bool32 streamFromDisk);
+MA_API ma_ex_audio_clip *ma_ex_audio_clip_init_from_memory(ma_ex_context *context, const void *data, ma_uint64 dataSize);
+MA_API ma_ex_audio_clip *ma_ex_audio_clip_init_from_callback(ma_ex_context *context, const ma_procedural_data_source_config *pConfig);
+MA_API void ma_ex_audio_clip_uninit(ma_ex_audio_clip *clip);
+MA_API ma_ex_audio_clip *ma_ex_audio_clip_acquire(ma_ex_audio_clip *clip);
+MA_API ma_bool8 ma_ex_audio_clip_is_initialized(ma_ex_audio_clip *clip);
+MA_API ma_uint64 ma_ex_audio_clip_get_length(ma_ex_audio_clip *clip);
+MA_API ma_ex_audio_clip *ma_ex_audio_clip_load_async(ma_ex_context *context, const char *filePath, ma_ex_audio_clip_loaded_proc onLoaded, void *pUserData);
+MA_API ma_ex_audio_clip *ma_ex_audio_clip_prefetch_async(ma_ex_context *context, const char *filePath, ma_ex_audio_clip_loaded_proc onLoaded, void *pUserData);
+MA_API ma_result ma_ex_audio_clip_get_load_result(ma_ex_audio_clip *clip);
+MA_API ma_bool8 ma_ex_audio_clip_is_ready(ma_ex_audio_clip *clip);
+MA_API ma_uint32 ma_ex_context_poll_loaded_clips(ma_ex_context *context, ma_ex_audio_clip **ppClips, ma_uint32 capacity);
 
 MA_API ma_ex_audio_source *ma_ex_audio_source_init(ma_ex_context *context);
 MA_API void ma_ex_audio_source_uninit(ma_ex_audio_source *source);
+MA_API ma_ex_audio_source_handle ma_ex_audio_source_get_handle(ma_ex_audio_source *source);
+MA_API ma_ex_audio_source *ma_ex_audio_source_from_handle(ma_ex_context *context, ma_ex_audio_source_handle handle);
+MA_API void ma_ex_context_set_source_transforms(ma_ex_context *context, const ma_ex_audio_source_handle *handles, ma_uint32 count, const float *positions, const float *velocities, const float *directions);
 MA_API ma_result ma_ex_audio_source_play_from_file(ma_ex_audio_source *source, const char *filePath, ma_bool8 streamFromDisk);
 MA_API ma_result ma_ex_audio_source_play_from_file_w(ma_ex_audio_source *source, const wchar_t *filePath, ma_bool8 streamFromDisk);
 MA_API ma_result ma_ex_audio_source_play_from_memory(ma_ex_audio_source *source, const void *pData, ma_uint64 dataSize);
 MA_API ma_result ma_ex_audio_source_play_from_callback(ma_ex_audio_source *source, ma_procedural_data_source_proc callback, void *pUserData);
+MA_API ma_result ma_ex_audio_source_play_clip(ma_ex_audio_source *source, ma_ex_audio_clip *clip);
 MA_API void ma_ex_audio_source_stop(ma_ex_audio_source *source);
 MA_API void ma_ex_audio_source_apply_settings(ma_ex_audio_source *source);
 MA_API void ma_ex_audio_source_set_volume(ma_ex_audio_source *source, float value);
@@ -215,6 +579,7 @@ MA_API void ma_ex_audio_source_set_direction(ma_ex_audio_source *source, float x
 MA_API void ma_ex_audio_source_get_direction(ma_ex_audio_source *source, float *x, float *y, float *z);
 MA_API void ma_ex_audio_source_set_velocity(ma_ex_audio_source *source, float x, float y, float z);
 MA_API void ma_ex_audio_source_get_velocity(ma_ex_audio_source *source, float *x, float *y, float *z);
+MA_API void ma_ex_audio_source_set_transforms(ma_ex_audio_source **sources, ma_uint32 count, const float *positions, const float *velocities, const float *directions);
 MA_API void ma_ex_audio_source_set_spatialization(ma_ex_audio_source *source, ma_bool32 enabled);
 MA_API ma_bool32 ma_ex_audio_source_get_spatialization(ma_ex_audio_source *source);
 MA_API void ma_ex_audio_source_set_attenuation_model(ma_ex_audio_source *source, ma_attenuation_model model);
@@ -227,9 +592,41 @@ MA_API void ma_ex_audio_source_set_max_distance(ma_ex_audio_source *source, floa
 MA_API float ma_ex_audio_source_get_max_distance(ma_ex_audio_source *source);
 MA_API ma_bool32 ma_ex_audio_source_get_is_playing(ma_ex_audio_source *source);
 MA_API ma_bool32 ma_ex_audio_source_get_is_at_end(ma_ex_audio_source *source);
+MA_API ma_bool32 ma_ex_audio_source_get_is_virtual(ma_ex_audio_source *source);
+MA_API ma_uint32 ma_ex_audio_source_get_starvation_count(ma_ex_audio_source *source);
 MA_API ma_ex_audio_clip *ma_ex_audio_source_get_clip(ma_ex_audio_source *source);
 MA_API ma_result ma_ex_audio_source_set_group(ma_ex_audio_source *source, ma_sound_group *group);
 MA_API ma_sound_group *ma_ex_audio_source_get_group(ma_ex_audio_source *source);
+MA_API void ma_ex_audio_source_set_priority(ma_ex_audio_source *source, ma_int32 priority);
+MA_API ma_int32 ma_ex_audio_source_get_priority(ma_ex_audio_source *source);
+
+MA_API ma_result ma_ex_context_stop_source(ma_ex_context *context, ma_ex_audio_source_handle handle);
+MA_API ma_result ma_ex_context_set_source_volume(ma_ex_context *context, ma_ex_audio_source_handle handle, float value);
+MA_API ma_result ma_ex_context_set_source_pitch(ma_ex_context *context, ma_ex_audio_source_handle handle, float value);
+MA_API ma_result ma_ex_context_set_source_pan(ma_ex_context *context, ma_ex_audio_source_handle handle, float value);
+MA_API ma_result ma_ex_context_set_source_pan_mode(ma_ex_context *context, ma_ex_audio_source_handle handle, ma_pan_mode mode);
+MA_API ma_result ma_ex_context_set_source_pcm_position(ma_ex_context *context, ma_ex_audio_source_handle handle, ma_uint64 position);
+MA_API ma_result ma_ex_context_set_source_loop(ma_ex_context *context, ma_ex_audio_source_handle handle, ma_bool32 loop);
+MA_API ma_result ma_ex_context_set_source_position(ma_ex_context *context, ma_ex_audio_source_handle handle, float x, float y, float z);
+MA_API ma_result ma_ex_context_set_source_direction(ma_ex_context *context, ma_ex_audio_source_handle handle, float x, float y, float z);
+MA_API ma_result ma_ex_context_set_source_velocity(ma_ex_context *context, ma_ex_audio_source_handle handle, float x, float y, float z);
+MA_API ma_result ma_ex_context_set_source_spatialization(ma_ex_context *context, ma_ex_audio_source_handle handle, ma_bool32 enabled);
+MA_API ma_result ma_ex_context_set_source_attenuation_model(ma_ex_context *context, ma_ex_audio_source_handle handle, ma_attenuation_model model);
+MA_API ma_result ma_ex_context_set_source_doppler_factor(ma_ex_context *context, ma_ex_audio_source_handle handle, float factor);
+MA_API ma_result ma_ex_context_set_source_min_distance(ma_ex_context *context, ma_ex_audio_source_handle handle, float distance);
+MA_API ma_result ma_ex_context_set_source_max_distance(ma_ex_context *context, ma_ex_audio_source_handle handle, float distance);
+MA_API ma_result ma_ex_context_set_source_priority(ma_ex_context *context, ma_ex_audio_source_handle handle, ma_int32 priority);
+
+MA_API ma_uint64 ma_ex_bank_hash_name(const char *name);
+MA_API ma_ex_bank *ma_ex_bank_init(ma_ex_context *context, const char *filePath);
+MA_API void ma_ex_bank_uninit(ma_ex_bank *bank);
+MA_API const ma_ex_bank_entry *ma_ex_bank_find(const ma_ex_bank *bank, ma_uint64 nameHash);
+MA_API ma_result ma_ex_audio_source_play_from_bank(ma_ex_audio_source *source, ma_ex_bank *bank, ma_uint64 nameHash);
+MA_API ma_result ma_ex_bank_builder_init(ma_ex_bank_builder *builder);
+MA_API void ma_ex_bank_builder_uninit(ma_ex_bank_builder *builder);
+MA_API ma_result ma_ex_bank_builder_add_memory(ma_ex_bank_builder *builder, const char *name, const void *pData, size_t dataSize);
+MA_API ma_result ma_ex_bank_builder_add_file(ma_ex_bank_builder *builder, const char *name, const char *filePath);
+MA_API ma_result ma_ex_bank_builder_write(ma_ex_bank_builder *builder, const char *filePath);
 
 MA_API ma_ex_audio_listener *ma_ex_audio_listener_init(ma_ex_context *context);
 MA_API void ma_ex_audio_listener_uninit(ma_ex_audio_listener *listener);
@@ -241,6 +638,7 @@ MA_API void ma_ex_audio_listener_set_direction(ma_ex_audio_listener *listener, f
 MA_API void ma_ex_audio_listener_get_direction(ma_ex_audio_listener *listener, float *x, float *y, float *z);
 MA_API void ma_ex_audio_listener_set_velocity(ma_ex_audio_listener *listener, float x, float y, float z);
 MA_API void ma_ex_audio_listener_get_velocity(ma_ex_audio_listener *listener, float *x, float *y, float *z);
+MA_API void ma_ex_audio_listener_set_transforms(ma_ex_audio_listener **listeners, ma_uint32 count, const float *positions, const float *velocities, const float *directions);
 MA_API void ma_ex_audio_listener_set_world_up(ma_ex_audio_listener *listener, float x, float y, float z);
 MA_API void ma_ex_audio_listener_get_world_up(ma_ex_audio_listener *listener, float *x, float *y, float *z);
 MA_API void ma_ex_audio_listener_set_cone(ma_ex_audio_listener *listener, float innerAngleInRadians, float outerAngleInRadians, float outerGain);
@@ -248,13 +646,24 @@ MA_API void ma_ex_audio_listener_get_cone(ma_ex_audio_listener *listener, float
 
 MA_API ma_sound_group *ma_ex_sound_group_init(ma_ex_context *context);
 MA_API void ma_ex_sound_group_uninit(ma_sound_group *group);
+MA_API ma_result ma_ex_sound_group_set_max_voices(ma_sound_group *group, ma_uint32 maxVoices);
+MA_API ma_uint32 ma_ex_sound_group_get_max_voices(ma_sound_group *group);
 
 MA_API char *ma_ex_read_bytes_from_file(const char *filepath, size_t *size);
 MA_API void ma_ex_free_bytes_from_file(char *pointer);
+MA_API ma_result ma_ex_file_view_init(const char *filepath, ma_ex_file_view *view);
+MA_API void ma_ex_file_view_uninit(ma_ex_file_view *view);
+MA_API ma_result ma_ex_mmap_vfs_init(ma_ex_mmap_vfs *vfs);
+MA_API ma_result ma_ex_readahead_vfs_init(ma_ex_readahead_vfs *vfs, ma_vfs *pInnerVFS, ma_uint32 threadCount, size_t blockSize);
+MA_API void ma_ex_readahead_vfs_uninit(ma_ex_readahead_vfs *vfs);
 MA_API void ma_ex_free(void *pointer);
 
 MA_API float *ma_ex_decode_file(const char *pFilePath, ma_uint64 *dataLength, ma_uint32 *channels, ma_uint32 *sampleRate, ma_uint32 desiredChannels, ma_uint32 desiredSampleRate);
 MA_API float *ma_ex_decode_memory(const void *pData, ma_uint64 size, ma_uint64 *dataLength, ma_uint32 *channels, ma_uint32 *sampleRate, ma_uint32 desiredChannels, ma_uint32 desiredSampleRate);
+MA_API ma_result ma_ex_probe_file(const char *pFilePath, ma_ex_probe_info *pInfo);
+MA_API ma_result ma_ex_probe_memory(const void *pData, ma_uint64 size, ma_ex_probe_info *pInfo);
+MA_API ma_ex_probe_result *ma_ex_probe_directory(const char *pDirectoryPath, ma_uint32 threadCount, ma_uint32 *count);
+MA_API void ma_ex_probe_results_free(ma_ex_probe_result *pResults, ma_uint32 count);
 
 #if defined(__cplusplus)
 }
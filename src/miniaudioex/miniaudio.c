@@ -6025,16 +6025,6 @@ MA_API ma_result ma_spinlock_unlock(volatile ma_spinlock* pSpinlock)
 
 
 #ifndef MA_NO_THREADING
-#if defined(MA_POSIX)
-    #define MA_THREADCALL
-    typedef void* ma_thread_result;
-#elif defined(MA_WIN32)
-    #define MA_THREADCALL WINAPI
-    typedef unsigned long ma_thread_result;
-#endif
-
-typedef ma_thread_result (MA_THREADCALL * ma_thread_entry_proc)(void* pData);
-
 #ifdef MA_POSIX
 static ma_result ma_thread_create__posix(ma_thread* pThread, ma_thread_priority priority, size_t stackSize, ma_thread_entry_proc entryProc, void* pData)
 {
@@ -6498,7 +6488,7 @@ static ma_thread_result MA_THREADCALL ma_thread_entry_proxy(void* pData)
     return result;
 }
 
-static ma_result ma_thread_create(ma_thread* pThread, ma_thread_priority priority, size_t stackSize, ma_thread_entry_proc entryProc, void* pData, const ma_allocation_callbacks* pAllocationCallbacks)
+MA_API ma_result ma_thread_create(ma_thread* pThread, ma_thread_priority priority, size_t stackSize, ma_thread_entry_proc entryProc, void* pData, const ma_allocation_callbacks* pAllocationCallbacks)
 {
     ma_result result;
     ma_thread_proxy_data* pProxyData;
@@ -6536,7 +6526,7 @@ static ma_result ma_thread_create(ma_thread* pThread, ma_thread_priority priorit
     return MA_SUCCESS;
 }
 
-static void ma_thread_wait(ma_thread* pThread)
+MA_API void ma_thread_wait(ma_thread* pThread)
 {
     if (pThread == NULL) {
         return;
@@ -7368,6 +7358,7 @@ static ma_result ma_job_process__resource_manager__load_data_stream(ma_job* pJob
 static ma_result ma_job_process__resource_manager__free_data_stream(ma_job* pJob);
 static ma_result ma_job_process__resource_manager__page_data_stream(ma_job* pJob);
 static ma_result ma_job_process__resource_manager__seek_data_stream(ma_job* pJob);
+static ma_result ma_job_process__resource_manager__decode_data_buffer_node_segment(ma_job* pJob);
 
 #if !defined(MA_NO_DEVICE_IO)
 static ma_result ma_job_process__device__aaudio_reroute(ma_job* pJob);
@@ -7389,6 +7380,7 @@ static ma_job_proc g_jobVTable[MA_JOB_TYPE_COUNT] =
     ma_job_process__resource_manager__free_data_stream,         /* MA_JOB_TYPE_RESOURCE_MANAGER_FREE_DATA_STREAM */
     ma_job_process__resource_manager__page_data_stream,         /* MA_JOB_TYPE_RESOURCE_MANAGER_PAGE_DATA_STREAM */
     ma_job_process__resource_manager__seek_data_stream,         /* MA_JOB_TYPE_RESOURCE_MANAGER_SEEK_DATA_STREAM */
+    ma_job_process__resource_manager__decode_data_buffer_node_segment,  /* MA_JOB_TYPE_RESOURCE_MANAGER_DECODE_DATA_BUFFER_NODE_SEGMENT */
 
     /* Device. */
 #if !defined(MA_NO_DEVICE_IO)
@@ -53131,6 +53123,7 @@ typedef struct
     ma_dr_mp3 dr;
     ma_uint32 seekPointCount;
     ma_dr_mp3_seek_point* pSeekPoints;  /* Only used if seek table generation is used. */
+    ma_uint64 lengthInPCMFrames;        /* 0 until known. Without a Xing header the length can only be found by scanning every frame, so it's only done once. */
 #endif
 } ma_mp3;
 
@@ -53663,7 +53656,11 @@ MA_API ma_result ma_mp3_get_length_in_pcm_frames(ma_mp3* pMP3, ma_uint64* pLengt
 
     #if !defined(MA_NO_MP3)
     {
-        *pLength = ma_dr_mp3_get_pcm_frame_count(&pMP3->dr);
+        if (pMP3->lengthInPCMFrames == 0) {
+            pMP3->lengthInPCMFrames = ma_dr_mp3_get_pcm_frame_count(&pMP3->dr);
+        }
+
+        *pLength = pMP3->lengthInPCMFrames;
 
         return MA_SUCCESS;
     }
@@ -54695,6 +54692,18 @@ static ma_data_source_vtable g_ma_decoder_data_source_vtable =
     0
 };
 
+/* Same as g_ma_decoder_data_source_vtable, but marks a decoder that was allocated by ma_sound_init_from_memory() and is owned by the sound. */
+static ma_data_source_vtable g_ma_decoder_owned_data_source_vtable =
+{
+    ma_decoder__data_source_on_read,
+    ma_decoder__data_source_on_seek,
+    ma_decoder__data_source_on_get_data_format,
+    ma_decoder__data_source_on_get_cursor,
+    ma_decoder__data_source_on_get_length,
+    NULL,   /* onSetLooping */
+    0 | MA_DATA_SOURCE_IS_DECODER
+};
+
 static ma_result ma_decoder__preinit(ma_decoder_read_proc onRead, ma_decoder_seek_proc onSeek, ma_decoder_tell_proc onTell, void* pUserData, const ma_decoder_config* pConfig, ma_decoder* pDecoder)
 {
     ma_result result;
@@ -54746,6 +54755,182 @@ static ma_result ma_decoder__postinit(const ma_decoder_config* pConfig, ma_decod
 }
 
 
+/*
+Container sniffing. When the caller doesn't specify an encoding format, the first few bytes nearly always
+identify the container. Custom decoders are still tried first so they keep priority over the built-in ones,
+but after that the matching stock decoder is tried before the others, which saves probing every other stock
+decoder with data it can't read. If the matching decoder fails anyway, the usual trial and error order is used.
+*/
+#define MA_DECODER_SNIFF_SIZE_IN_BYTES  64
+
+/* Returns the size of the ID3v2 tag at the start of the data, or 0 if there isn't one. */
+static size_t ma_decoder_sniff_id3_size(const ma_uint8* pHeader, size_t headerSize)
+{
+    size_t tagSize;
+
+    if (headerSize < 10 || pHeader[0] != 'I' || pHeader[1] != 'D' || pHeader[2] != '3') {
+        return 0;
+    }
+
+    /* The size is a 28-bit synchsafe integer that excludes the 10 byte header and the optional footer. */
+    if ((pHeader[6] | pHeader[7] | pHeader[8] | pHeader[9]) & 0x80) {
+        return 0;
+    }
+
+    tagSize = ((size_t)pHeader[6] << 21) | ((size_t)pHeader[7] << 14) | ((size_t)pHeader[8] << 7) | (size_t)pHeader[9];
+    tagSize += 10;
+
+    if ((pHeader[5] & 0x10) != 0) {
+        tagSize += 10;  /* Footer. */
+    }
+
+    return tagSize;
+}
+
+/* Identifies the container from the bytes at the start of the data, after any ID3v2 tag. */
+static ma_encoding_format ma_decoder_sniff_encoding_format(const ma_uint8* pHeader, size_t headerSize)
+{
+    if (headerSize >= 12) {
+        if ((memcmp(pHeader, "RIFF", 4) == 0 || memcmp(pHeader, "RIFX", 4) == 0 || memcmp(pHeader, "RF64", 4) == 0) && memcmp(pHeader + 8, "WAVE", 4) == 0) {
+            return ma_encoding_format_wav;
+        }
+    }
+
+    /* Wave64 uses GUIDs instead of FourCCs, but the first four bytes of each GUID spell out the old FourCC. */
+    if (headerSize >= 28) {
+        if (memcmp(pHeader, "riff", 4) == 0 && memcmp(pHeader + 24, "wave", 4) == 0) {
+            return ma_encoding_format_wav;
+        }
+    }
+
+    if (headerSize >= 4 && memcmp(pHeader, "fLaC", 4) == 0) {
+        return ma_encoding_format_flac;
+    }
+
+    /* Ogg can hold more than one codec. The first packet of the first page identifies it. */
+    if (headerSize >= 27 && memcmp(pHeader, "OggS", 4) == 0) {
+        size_t packetOffset = 27 + (size_t)pHeader[26];
+        if (headerSize >= packetOffset + 7 && memcmp(pHeader + packetOffset, "\x01vorbis", 7) == 0) {
+            return ma_encoding_format_vorbis;
+        }
+        if (headerSize >= packetOffset + 5 && memcmp(pHeader + packetOffset, "\x7F" "FLAC", 5) == 0) {
+            return ma_encoding_format_flac;
+        }
+
+        return ma_encoding_format_unknown;
+    }
+
+    /* An MPEG audio frame header. The reserved values are rejected, as is layer 0 which is used by ADTS streams. */
+    if (headerSize >= 3 && pHeader[0] == 0xFF && (pHeader[1] & 0xE0) == 0xE0) {
+        ma_uint8 version      = (pHeader[1] >> 3) & 0x03;
+        ma_uint8 layer        = (pHeader[1] >> 1) & 0x03;
+        ma_uint8 bitrateIndex = (pHeader[2] >> 4) & 0x0F;
+        ma_uint8 rateIndex    = (pHeader[2] >> 2) & 0x03;
+
+        if (version != 1 && layer != 0 && bitrateIndex != 15 && rateIndex != 3) {
+            return ma_encoding_format_mp3;
+        }
+    }
+
+    return ma_encoding_format_unknown;
+}
+
+static ma_encoding_format ma_decoder_sniff_encoding_format_from_memory(const void* pData, size_t dataSize)
+{
+    size_t tagSize;
+
+    tagSize = ma_decoder_sniff_id3_size((const ma_uint8*)pData, dataSize);
+    if (tagSize >= dataSize) {
+        return ma_encoding_format_unknown;
+    }
+
+    return ma_decoder_sniff_encoding_format((const ma_uint8*)pData + tagSize, dataSize - tagSize);
+}
+
+/* Reads the first bytes with the decoder's callbacks. The read pointer is moved back to the start afterwards. */
+static ma_encoding_format ma_decoder_sniff_encoding_format_from_callbacks(ma_decoder* pDecoder)
+{
+    ma_uint8 header[MA_DECODER_SNIFF_SIZE_IN_BYTES];
+    size_t headerSize = 0;
+    size_t tagSize;
+    ma_encoding_format encodingFormat;
+
+    MA_ASSERT(pDecoder != NULL);
+
+    /* Without seeking there would be no way to give the bytes back to the decoder. */
+    if (pDecoder->onRead == NULL || pDecoder->onSeek == NULL) {
+        return ma_encoding_format_unknown;
+    }
+
+    if (ma_decoder_read_bytes(pDecoder, header, sizeof(header), &headerSize) != MA_SUCCESS) {
+        headerSize = 0;
+    }
+
+    tagSize = ma_decoder_sniff_id3_size(header, headerSize);
+    if (tagSize > 0) {
+        if (ma_decoder_seek_bytes(pDecoder, (ma_int64)tagSize, ma_seek_origin_start) != MA_SUCCESS || ma_decoder_read_bytes(pDecoder, header, sizeof(header), &headerSize) != MA_SUCCESS) {
+            headerSize = 0;
+        }
+    }
+
+    encodingFormat = ma_decoder_sniff_encoding_format(header, headerSize);
+
+    if (ma_decoder_seek_bytes(pDecoder, 0, ma_seek_origin_start) != MA_SUCCESS) {
+        return ma_encoding_format_unknown;
+    }
+
+    return encodingFormat;
+}
+
+static ma_result ma_decoder_init_sniffed__internal(ma_encoding_format encodingFormat, const ma_decoder_config* pConfig, ma_decoder* pDecoder)
+{
+    (void)pConfig;
+    (void)pDecoder;
+
+    /* Only stock decoders are tried here. Custom decoders have already been given their chance. */
+    switch (encodingFormat)
+    {
+    #ifdef MA_HAS_WAV
+        case ma_encoding_format_wav:  return ma_decoder_init_wav__internal(pConfig, pDecoder);
+    #endif
+    #ifdef MA_HAS_FLAC
+        case ma_encoding_format_flac: return ma_decoder_init_flac__internal(pConfig, pDecoder);
+    #endif
+    #ifdef MA_HAS_MP3
+        case ma_encoding_format_mp3:  return ma_decoder_init_mp3__internal(pConfig, pDecoder);
+    #endif
+    #ifdef MA_HAS_VORBIS
+        case ma_encoding_format_vorbis: return ma_decoder_init_vorbis__internal(pConfig, pDecoder);
+    #endif
+        default: return MA_NO_BACKEND;
+    }
+}
+
+static ma_result ma_decoder_init_sniffed_from_memory__internal(ma_encoding_format encodingFormat, const void* pData, size_t dataSize, const ma_decoder_config* pConfig, ma_decoder* pDecoder)
+{
+    (void)pData;
+    (void)dataSize;
+    (void)pConfig;
+    (void)pDecoder;
+
+    switch (encodingFormat)
+    {
+    #ifdef MA_HAS_WAV
+        case ma_encoding_format_wav:  return ma_decoder_init_wav_from_memory__internal(pData, dataSize, pConfig, pDecoder);
+    #endif
+    #ifdef MA_HAS_FLAC
+        case ma_encoding_format_flac: return ma_decoder_init_flac_from_memory__internal(pData, dataSize, pConfig, pDecoder);
+    #endif
+    #ifdef MA_HAS_MP3
+        case ma_encoding_format_mp3:  return ma_decoder_init_mp3_from_memory__internal(pData, dataSize, pConfig, pDecoder);
+    #endif
+    #ifdef MA_HAS_VORBIS
+        case ma_encoding_format_vorbis: return ma_decoder_init_vorbis_from_memory__internal(pData, dataSize, pConfig, pDecoder);
+    #endif
+        default: return MA_NO_BACKEND;
+    }
+}
+
 static ma_result ma_decoder_init__internal(ma_decoder_read_proc onRead, ma_decoder_seek_proc onSeek, void* pUserData, const ma_decoder_config* pConfig, ma_decoder* pDecoder)
 {
     ma_result result = MA_NO_BACKEND;
@@ -54808,6 +54993,14 @@ static ma_result ma_decoder_init__internal(ma_decoder_read_proc onRead, ma_decod
             return MA_NO_BACKEND;
         }
 
+        /* Of the stock decoders, try the one the first bytes point to before the others. */
+        if (result != MA_SUCCESS) {
+            result = ma_decoder_init_sniffed__internal(ma_decoder_sniff_encoding_format_from_callbacks(pDecoder), pConfig, pDecoder);
+            if (result != MA_SUCCESS) {
+                onSeek(pDecoder, 0, ma_seek_origin_start);
+            }
+        }
+
     #ifdef MA_HAS_WAV
         if (result != MA_SUCCESS) {
             result = ma_decoder_init_wav__internal(pConfig, pDecoder);
@@ -55027,6 +55220,11 @@ MA_API ma_result ma_decoder_init_memory(const void* pData, size_t dataSize, cons
             return MA_NO_BACKEND;
         }
 
+        /* Of the stock decoders, try the one the first bytes point to before the others. */
+        if (result != MA_SUCCESS) {
+            result = ma_decoder_init_sniffed_from_memory__internal(ma_decoder_sniff_encoding_format_from_memory(pData, dataSize), pData, dataSize, &config, pDecoder);
+        }
+
         /* Use trial and error for stock decoders. */
         if (result != MA_SUCCESS) {
         #ifdef MA_HAS_WAV
@@ -55374,6 +55572,14 @@ MA_API ma_result ma_decoder_init_vfs(ma_vfs* pVFS, const char* pFilePath, const
             return MA_NO_BACKEND;
         }
 
+        /* Of the stock decoders, try the one the first bytes of the open file point to before going by the extension. */
+        if (result != MA_SUCCESS) {
+            result = ma_decoder_init_sniffed__internal(ma_decoder_sniff_encoding_format_from_callbacks(pDecoder), &config, pDecoder);
+            if (result != MA_SUCCESS) {
+                ma_decoder__on_seek_vfs(pDecoder, 0, ma_seek_origin_start);
+            }
+        }
+
     #ifdef MA_HAS_WAV
         if (result != MA_SUCCESS && ma_path_extension_equal(pFilePath, "wav")) {
             result = ma_decoder_init_wav__internal(&config, pDecoder);
@@ -55505,6 +55711,14 @@ MA_API ma_result ma_decoder_init_vfs_w(ma_vfs* pVFS, const wchar_t* pFilePath, c
             return MA_NO_BACKEND;
         }
 
+        /* Of the stock decoders, try the one the first bytes of the open file point to before going by the extension. */
+        if (result != MA_SUCCESS) {
+            result = ma_decoder_init_sniffed__internal(ma_decoder_sniff_encoding_format_from_callbacks(pDecoder), &config, pDecoder);
+            if (result != MA_SUCCESS) {
+                ma_decoder__on_seek_vfs(pDecoder, 0, ma_seek_origin_start);
+            }
+        }
+
     #ifdef MA_HAS_WAV
         if (result != MA_SUCCESS && ma_path_extension_equal_w(pFilePath, L"wav")) {
             result = ma_decoder_init_wav__internal(&config, pDecoder);
@@ -57801,10 +58015,23 @@ MA_API ma_result ma_noise_read_pcm_frames(ma_noise* pNoise, void* pFramesOut, ma
 #define MA_RESOURCE_MANAGER_PAGE_SIZE_IN_MILLISECONDS   1000
 #endif
 
+#ifndef MA_RESOURCE_MANAGER_STREAM_PAGE_POOL_BLOCK_SIZE
+#define MA_RESOURCE_MANAGER_STREAM_PAGE_POOL_BLOCK_SIZE 4096
+#endif
+
+/* Files at or above this bitrate start streaming with the largest page. 16-bit stereo PCM at 44.1 kHz. */
+#ifndef MA_RESOURCE_MANAGER_STREAM_PAGE_REFERENCE_BITRATE
+#define MA_RESOURCE_MANAGER_STREAM_PAGE_REFERENCE_BITRATE 1411200
+#endif
+
 #ifndef MA_JOB_TYPE_RESOURCE_MANAGER_QUEUE_CAPACITY
 #define MA_JOB_TYPE_RESOURCE_MANAGER_QUEUE_CAPACITY          1024
 #endif
 
+#ifndef MA_RESOURCE_MANAGER_DECODE_SEGMENT_MIN_SIZE_IN_MILLISECONDS
+#define MA_RESOURCE_MANAGER_DECODE_SEGMENT_MIN_SIZE_IN_MILLISECONDS 30000
+#endif
+
 MA_API ma_resource_manager_pipeline_notifications ma_resource_manager_pipeline_notifications_init(void)
 {
     ma_resource_manager_pipeline_notifications notifications;
@@ -57888,16 +58115,19 @@ static MA_INLINE ma_uint32 ma_hash_fmix32(ma_uint32 h)
     return h;
 }
 
-static ma_uint32 ma_hash_32(const void* key, int len, ma_uint32 seed)
+static ma_uint64 ma_hash_64(const void* key, int len, ma_uint32 seed)
 {
+    /* Two MurmurHash3 lanes with the seeds seed and ~seed, computed in a single pass over the data. */
     const ma_uint8* data = (const ma_uint8*)key;
     const ma_uint32* blocks;
     const ma_uint8* tail;
     const int nblocks = len / 4;
     ma_uint32 h1 = seed;
+    ma_uint32 h2 = ~seed;
     ma_uint32 c1 = 0xcc9e2d51;
     ma_uint32 c2 = 0x1b873593;
     ma_uint32 k1;
+    ma_uint64 hash;
     int i;
 
     blocks = (const ma_uint32 *)(data + nblocks*4);
@@ -57912,8 +58142,11 @@ static ma_uint32 ma_hash_32(const void* key, int len, ma_uint32 seed)
         h1 ^= k1;
         h1 = ma_rotl32(h1, 13);
         h1 = h1*5 + 0xe6546b64;
-    }
 
+        h2 ^= k1;
+        h2 = ma_rotl32(h2, 13);
+        h2 = h2*5 + 0xe6546b64;
+    }
 
     tail = (const ma_uint8*)(data + nblocks*4);
 
@@ -57922,14 +58155,22 @@ static ma_uint32 ma_hash_32(const void* key, int len, ma_uint32 seed)
         case 3: k1 ^= tail[2] << 16;
         case 2: k1 ^= tail[1] << 8;
         case 1: k1 ^= tail[0];
-                k1 *= c1; k1 = ma_rotl32(k1, 15); k1 *= c2; h1 ^= k1;
+                k1 *= c1; k1 = ma_rotl32(k1, 15); k1 *= c2; h1 ^= k1; h2 ^= k1;
     };
 
-
     h1 ^= len;
     h1  = ma_hash_fmix32(h1);
+    h2 ^= len;
+    h2  = ma_hash_fmix32(h2);
+
+    hash = ((ma_uint64)h1 << 32) | h2;
 
-    return h1;
+    /* 0 is used to mark empty slots in the data buffer node table. */
+    if (hash == 0) {
+        hash = 1;
+    }
+
+    return hash;
 }
 
 #if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6)))
@@ -57937,321 +58178,422 @@ static ma_uint32 ma_hash_32(const void* key, int len, ma_uint32 seed)
 #endif
 /* End MurmurHash3 */
 
-static ma_uint32 ma_hash_string_32(const char* str)
+static ma_uint64 ma_hash_string_64(const char* str)
 {
-    return ma_hash_32(str, (int)strlen(str), MA_DEFAULT_HASH_SEED);
+    return ma_hash_64(str, (int)strlen(str), MA_DEFAULT_HASH_SEED);
 }
 
-static ma_uint32 ma_hash_string_w_32(const wchar_t* str)
+static ma_uint64 ma_hash_string_w_64(const wchar_t* str)
 {
-    return ma_hash_32(str, (int)ma_wcslen(str) * sizeof(*str), MA_DEFAULT_HASH_SEED);
+    return ma_hash_64(str, (int)ma_wcslen(str) * sizeof(*str), MA_DEFAULT_HASH_SEED);
 }
 
 
 
 
 /*
-Basic BST Functions
+Data Buffer Node Hash Table
+
+Nodes are indexed by a 64-bit hash of their name with linear probing. Changes to the table are made
+while holding the BST lock, but searches can be done without it so that acquiring a node that is
+already loaded does not need to wait for other threads. This works because of a few rules:
+
+  - The key of a slot is always set before its node, and removing a node only clears the node which
+    means a search never stops early at a slot that has been used before.
+  - A search checks the key and the name of the node itself, so a slot changing under a search is
+    harmless.
+  - A table that has been replaced is kept in a list on the new table. The thread that replaced it
+    takes the list and frees it once it has released the lock and every search that was already
+    running has finished, so at most a few replaced tables are alive at the same time.
+  - A node that has been removed is only freed once every search that was already running without
+    the lock has finished. See ma_resource_manager_data_buffer_node_wait_for_readers().
 */
-static ma_result ma_resource_manager_data_buffer_node_search(ma_resource_manager* pResourceManager, ma_uint32 hashedName32, ma_resource_manager_data_buffer_node** ppDataBufferNode)
+#ifndef MA_RESOURCE_MANAGER_DATA_BUFFER_NODE_TABLE_MIN_CAPACITY
+#define MA_RESOURCE_MANAGER_DATA_BUFFER_NODE_TABLE_MIN_CAPACITY    64
+#endif
+
+static ma_bool32 ma_resource_manager_data_buffer_node_has_name(const ma_resource_manager_data_buffer_node* pDataBufferNode, const char* pName, const wchar_t* pNameW)
+{
+    if (pName != NULL) {
+        return pDataBufferNode->pName != NULL && strcmp(pDataBufferNode->pName, pName) == 0;
+    }
+
+    if (pNameW != NULL) {
+        return pDataBufferNode->pNameW != NULL && ma_wcscmp(pDataBufferNode->pNameW, pNameW) == 0;
+    }
+
+    return pDataBufferNode->pName == NULL && pDataBufferNode->pNameW == NULL;
+}
+
+/* This is safe to call without holding the BST lock, but the node can only be used after a reference has been taken. */
+static ma_result ma_resource_manager_data_buffer_node_search(ma_resource_manager* pResourceManager, ma_uint64 hashedName64, const char* pName, const wchar_t* pNameW, ma_resource_manager_data_buffer_node** ppDataBufferNode)
 {
-    ma_resource_manager_data_buffer_node* pCurrentNode;
+    ma_resource_manager_data_buffer_node_table* pTable;
+    ma_uint32 iSlot;
+    ma_uint32 iProbe;
 
     MA_ASSERT(pResourceManager != NULL);
     MA_ASSERT(ppDataBufferNode != NULL);
+    MA_ASSERT(hashedName64     != 0);
 
-    pCurrentNode = pResourceManager->pRootDataBufferNode;
-    while (pCurrentNode != NULL) {
-        if (hashedName32 == pCurrentNode->hashedName32) {
-            break;  /* Found. */
-        } else if (hashedName32 < pCurrentNode->hashedName32) {
-            pCurrentNode = pCurrentNode->pChildLo;
-        } else {
-            pCurrentNode = pCurrentNode->pChildHi;
-        }
+    *ppDataBufferNode = NULL;
+
+    pTable = (ma_resource_manager_data_buffer_node_table*)ma_atomic_load_ptr(&pResourceManager->pDataBufferNodeTable);
+    if (pTable == NULL) {
+        return MA_DOES_NOT_EXIST;   /* No items. */
     }
 
-    *ppDataBufferNode = pCurrentNode;
+    iSlot = (ma_uint32)hashedName64 & (pTable->capacity - 1);
+    for (iProbe = 0; iProbe < pTable->capacity; iProbe += 1) {
+        ma_uint64 slotHashedName64 = ma_atomic_load_64(&pTable->pSlots[iSlot].hashedName64);
+        if (slotHashedName64 == 0) {
+            break;  /* Never been used. The node is not in the table. */
+        }
 
-    if (pCurrentNode == NULL) {
-        return MA_DOES_NOT_EXIST;
-    } else {
-        return MA_SUCCESS;
+        if (slotHashedName64 == hashedName64) {
+            ma_resource_manager_data_buffer_node* pDataBufferNode = (ma_resource_manager_data_buffer_node*)ma_atomic_load_ptr(&pTable->pSlots[iSlot].pNode);
+            if (pDataBufferNode != NULL && pDataBufferNode->hashedName64 == hashedName64 && ma_resource_manager_data_buffer_node_has_name(pDataBufferNode, pName, pNameW)) {
+                *ppDataBufferNode = pDataBufferNode;
+                return MA_SUCCESS;
+            }
+        }
+
+        iSlot = (iSlot + 1) & (pTable->capacity - 1);
     }
+
+    return MA_DOES_NOT_EXIST;
 }
 
-static ma_result ma_resource_manager_data_buffer_node_insert_point(ma_resource_manager* pResourceManager, ma_uint32 hashedName32, ma_resource_manager_data_buffer_node** ppInsertPoint)
+/*
+Waits for every search that was already running without the BST lock when this was called. Anything removed
+from the table before calling this can be freed afterwards.
+
+Searches count themselves in one of two counters, picked by the epoch at the time they start. Advancing the
+epoch sends new searches to the other counter, so the counter being waited on only drains and the wait is
+bounded by the searches that were already running, however many start in the meantime. Both counters need
+to have been seen at 0 since the epoch may also be advanced by another thread.
+*/
+static void ma_resource_manager_data_buffer_node_wait_for_readers(ma_resource_manager* pResourceManager)
 {
-    ma_result result = MA_SUCCESS;
-    ma_resource_manager_data_buffer_node* pCurrentNode;
+    ma_uint32 drainedMask = 0;
 
-    MA_ASSERT(pResourceManager != NULL);
-    MA_ASSERT(ppInsertPoint    != NULL);
+    while (drainedMask != 3) {
+        ma_uint32 iCounter = ma_atomic_fetch_add_32(&pResourceManager->dataBufferNodeReaderEpoch, 1) & 1;
 
-    *ppInsertPoint = NULL;
+        while (ma_atomic_load_32(&pResourceManager->dataBufferNodeReaderCounts[iCounter]) > 0) {
+            ma_yield();
+        }
 
-    if (pResourceManager->pRootDataBufferNode == NULL) {
-        return MA_SUCCESS;  /* No items. */
+        drainedMask |= (1 << iCounter);
     }
+}
 
-    /* We need to find the node that will become the parent of the new node. If a node is found that already has the same hashed name we need to return MA_ALREADY_EXISTS. */
-    pCurrentNode = pResourceManager->pRootDataBufferNode;
-    while (pCurrentNode != NULL) {
-        if (hashedName32 == pCurrentNode->hashedName32) {
-            result = MA_ALREADY_EXISTS;
-            break;
-        } else {
-            if (hashedName32 < pCurrentNode->hashedName32) {
-                if (pCurrentNode->pChildLo == NULL) {
-                    result = MA_SUCCESS;
-                    break;
-                } else {
-                    pCurrentNode = pCurrentNode->pChildLo;
-                }
-            } else {
-                if (pCurrentNode->pChildHi == NULL) {
-                    result = MA_SUCCESS;
-                    break;
-                } else {
-                    pCurrentNode = pCurrentNode->pChildHi;
-                }
+static void ma_resource_manager_data_buffer_node_table_place(ma_resource_manager_data_buffer_node_table* pTable, ma_resource_manager_data_buffer_node* pDataBufferNode)
+{
+    ma_uint32 iSlot;
+
+    MA_ASSERT(pTable->count + pTable->removedCount < pTable->capacity);
+
+    iSlot = (ma_uint32)pDataBufferNode->hashedName64 & (pTable->capacity - 1);
+    for (;;) {
+        ma_resource_manager_data_buffer_node_slot* pSlot = &pTable->pSlots[iSlot];
+        ma_uint64 slotHashedName64 = ma_atomic_load_64(&pSlot->hashedName64);
+
+        if (slotHashedName64 == 0 || ma_atomic_load_ptr(&pSlot->pNode) == NULL) {
+            if (slotHashedName64 != 0) {
+                pTable->removedCount -= 1;  /* Reusing a removed slot. */
             }
+
+            /* The key must be set before the node for the sake of searches running without the lock. */
+            ma_atomic_exchange_64(&pSlot->hashedName64, pDataBufferNode->hashedName64);
+            ma_atomic_exchange_ptr(&pSlot->pNode, pDataBufferNode);
+            pTable->count += 1;
+            return;
         }
-    }
 
-    *ppInsertPoint = pCurrentNode;
-    return result;
+        iSlot = (iSlot + 1) & (pTable->capacity - 1);
+    }
 }
 
-static ma_result ma_resource_manager_data_buffer_node_insert_at(ma_resource_manager* pResourceManager, ma_resource_manager_data_buffer_node* pDataBufferNode, ma_resource_manager_data_buffer_node* pInsertPoint)
+/* Must be called while holding the BST lock. The node must not already be in the table. */
+static ma_result ma_resource_manager_data_buffer_node_insert(ma_resource_manager* pResourceManager, ma_resource_manager_data_buffer_node* pDataBufferNode)
 {
+    ma_resource_manager_data_buffer_node_table* pTable;
+
     MA_ASSERT(pResourceManager != NULL);
     MA_ASSERT(pDataBufferNode  != NULL);
 
     /* The key must have been set before calling this function. */
-    MA_ASSERT(pDataBufferNode->hashedName32 != 0);
+    MA_ASSERT(pDataBufferNode->hashedName64 != 0);
 
-    if (pInsertPoint == NULL) {
-        /* It's the first node. */
-        pResourceManager->pRootDataBufferNode = pDataBufferNode;
-    } else {
-        /* It's not the first node. It needs to be inserted. */
-        if (pDataBufferNode->hashedName32 < pInsertPoint->hashedName32) {
-            MA_ASSERT(pInsertPoint->pChildLo == NULL);
-            pInsertPoint->pChildLo = pDataBufferNode;
-        } else {
-            MA_ASSERT(pInsertPoint->pChildHi == NULL);
-            pInsertPoint->pChildHi = pDataBufferNode;
+    pTable = (ma_resource_manager_data_buffer_node_table*)ma_atomic_load_ptr(&pResourceManager->pDataBufferNodeTable);
+
+    /*
+    Keep the table at most three quarters full, counting removed slots since they lengthen searches
+    just as much. The replacement is sized so that the live nodes take up at most half of it.
+    */
+    if (pTable == NULL || (pTable->count + pTable->removedCount + 1) * 4 > pTable->capacity * 3) {
+        ma_resource_manager_data_buffer_node_table* pNewTable;
+        ma_uint32 newCapacity = MA_RESOURCE_MANAGER_DATA_BUFFER_NODE_TABLE_MIN_CAPACITY;
+        ma_uint32 newCount = (pTable != NULL) ? pTable->count + 1 : 1;
+        ma_uint32 iSlot;
+
+        while (newCount * 2 > newCapacity) {
+            newCapacity *= 2;
+        }
+
+        pNewTable = (ma_resource_manager_data_buffer_node_table*)ma_calloc(sizeof(*pNewTable) + newCapacity * sizeof(*pNewTable->pSlots), &pResourceManager->config.allocationCallbacks);
+        if (pNewTable == NULL) {
+            return MA_OUT_OF_MEMORY;
+        }
+
+        pNewTable->capacity = newCapacity;
+        pNewTable->pSlots   = (ma_resource_manager_data_buffer_node_slot*)ma_offset_ptr(pNewTable, sizeof(*pNewTable));
+
+        if (pTable != NULL) {
+            for (iSlot = 0; iSlot < pTable->capacity; iSlot += 1) {
+                ma_resource_manager_data_buffer_node* pExistingNode = (ma_resource_manager_data_buffer_node*)ma_atomic_load_ptr(&pTable->pSlots[iSlot].pNode);
+                if (pExistingNode != NULL) {
+                    ma_resource_manager_data_buffer_node_table_place(pNewTable, pExistingNode);
+                }
+            }
         }
+
+        /*
+        Searches running without the lock may still be using the old table, so it's retired instead of freed. It's freed
+        later by ma_resource_manager_data_buffer_node_free_retired_tables(), outside of the lock, so this never waits while
+        holding it.
+        */
+        pNewTable->pRetiredNext = pTable;   /* Along with the tables it replaced itself that haven't been freed yet. */
+        ma_atomic_exchange_ptr(&pResourceManager->pDataBufferNodeTable, pNewTable);
+
+        pTable = pNewTable;
     }
 
-    pDataBufferNode->pParent = pInsertPoint;
+    ma_resource_manager_data_buffer_node_table_place(pTable, pDataBufferNode);
 
     return MA_SUCCESS;
 }
 
-#if 0   /* Unused for now. */
-static ma_result ma_resource_manager_data_buffer_node_insert(ma_resource_manager* pResourceManager, ma_resource_manager_data_buffer_node* pDataBufferNode)
+/* Must be called while holding the BST lock. Detaches the tables that have been replaced so they can be freed after releasing it. */
+static ma_resource_manager_data_buffer_node_table* ma_resource_manager_data_buffer_node_take_retired_tables(ma_resource_manager* pResourceManager)
 {
-    ma_result result;
-    ma_resource_manager_data_buffer_node* pInsertPoint;
-
-    MA_ASSERT(pResourceManager != NULL);
-    MA_ASSERT(pDataBufferNode  != NULL);
+    ma_resource_manager_data_buffer_node_table* pTable;
+    ma_resource_manager_data_buffer_node_table* pRetiredTable;
 
-    result = ma_resource_manager_data_buffer_node_insert_point(pResourceManager, pDataBufferNode->hashedName32, &pInsertPoint);
-    if (result != MA_SUCCESS) {
-        return MA_INVALID_ARGS;
+    pTable = (ma_resource_manager_data_buffer_node_table*)ma_atomic_load_ptr(&pResourceManager->pDataBufferNodeTable);
+    if (pTable == NULL) {
+        return NULL;
     }
 
-    return ma_resource_manager_data_buffer_node_insert_at(pResourceManager, pDataBufferNode, pInsertPoint);
+    pRetiredTable = (ma_resource_manager_data_buffer_node_table*)pTable->pRetiredNext;
+    pTable->pRetiredNext = NULL;
+
+    return pRetiredTable;
 }
-#endif
 
-static MA_INLINE ma_resource_manager_data_buffer_node* ma_resource_manager_data_buffer_node_find_min(ma_resource_manager_data_buffer_node* pDataBufferNode)
+/* Must be called without holding the BST lock. Frees the tables returned by ma_resource_manager_data_buffer_node_take_retired_tables(). */
+static void ma_resource_manager_data_buffer_node_free_retired_tables(ma_resource_manager* pResourceManager, ma_resource_manager_data_buffer_node_table* pRetiredTable)
 {
-    ma_resource_manager_data_buffer_node* pCurrentNode;
+    if (pRetiredTable == NULL) {
+        return;
+    }
 
-    MA_ASSERT(pDataBufferNode != NULL);
+    /* The tables were replaced before they were detached, so only searches that were already running can still be using them. */
+    ma_resource_manager_data_buffer_node_wait_for_readers(pResourceManager);
 
-    pCurrentNode = pDataBufferNode;
-    while (pCurrentNode->pChildLo != NULL) {
-        pCurrentNode = pCurrentNode->pChildLo;
+    while (pRetiredTable != NULL) {
+        ma_resource_manager_data_buffer_node_table* pNextRetiredTable = (ma_resource_manager_data_buffer_node_table*)pRetiredTable->pRetiredNext;
+        ma_free(pRetiredTable, &pResourceManager->config.allocationCallbacks);
+        pRetiredTable = pNextRetiredTable;
     }
-
-    return pCurrentNode;
 }
 
-static MA_INLINE ma_resource_manager_data_buffer_node* ma_resource_manager_data_buffer_node_find_max(ma_resource_manager_data_buffer_node* pDataBufferNode)
+/* Must be called while holding the BST lock. The node must not be freed before ma_resource_manager_data_buffer_node_wait_for_readers() has returned. */
+static ma_result ma_resource_manager_data_buffer_node_remove(ma_resource_manager* pResourceManager, ma_resource_manager_data_buffer_node* pDataBufferNode)
 {
-    ma_resource_manager_data_buffer_node* pCurrentNode;
+    ma_resource_manager_data_buffer_node_table* pTable;
+    ma_uint32 iSlot;
+    ma_uint32 iProbe;
 
-    MA_ASSERT(pDataBufferNode != NULL);
+    MA_ASSERT(pResourceManager != NULL);
+    MA_ASSERT(pDataBufferNode  != NULL);
 
-    pCurrentNode = pDataBufferNode;
-    while (pCurrentNode->pChildHi != NULL) {
-        pCurrentNode = pCurrentNode->pChildHi;
+    pTable = (ma_resource_manager_data_buffer_node_table*)ma_atomic_load_ptr(&pResourceManager->pDataBufferNodeTable);
+    if (pTable == NULL) {
+        return MA_DOES_NOT_EXIST;
     }
 
-    return pCurrentNode;
-}
+    iSlot = (ma_uint32)pDataBufferNode->hashedName64 & (pTable->capacity - 1);
+    for (iProbe = 0; iProbe < pTable->capacity; iProbe += 1) {
+        ma_resource_manager_data_buffer_node_slot* pSlot = &pTable->pSlots[iSlot];
 
-static MA_INLINE ma_resource_manager_data_buffer_node* ma_resource_manager_data_buffer_node_find_inorder_successor(ma_resource_manager_data_buffer_node* pDataBufferNode)
-{
-    MA_ASSERT(pDataBufferNode           != NULL);
-    MA_ASSERT(pDataBufferNode->pChildHi != NULL);
+        if (ma_atomic_load_64(&pSlot->hashedName64) == 0) {
+            break;
+        }
 
-    return ma_resource_manager_data_buffer_node_find_min(pDataBufferNode->pChildHi);
-}
+        if (ma_atomic_load_ptr(&pSlot->pNode) == pDataBufferNode) {
+            /* The key is left in place so searches keep probing past this slot. */
+            ma_atomic_exchange_ptr(&pSlot->pNode, NULL);
+            pTable->count        -= 1;
+            pTable->removedCount += 1;
+            return MA_SUCCESS;
+        }
 
-#if 0   /* Currently unused, but might make use of this later. */
-static MA_INLINE ma_resource_manager_data_buffer_node* ma_resource_manager_data_buffer_node_find_inorder_predecessor(ma_resource_manager_data_buffer_node* pDataBufferNode)
-{
-    MA_ASSERT(pDataBufferNode           != NULL);
-    MA_ASSERT(pDataBufferNode->pChildLo != NULL);
+        iSlot = (iSlot + 1) & (pTable->capacity - 1);
+    }
 
-    return ma_resource_manager_data_buffer_node_find_max(pDataBufferNode->pChildLo);
+    MA_ASSERT(MA_FALSE);    /* Should never get here. The node is not in the table. */
+    return MA_DOES_NOT_EXIST;
 }
-#endif
 
-static ma_result ma_resource_manager_data_buffer_node_remove(ma_resource_manager* pResourceManager, ma_resource_manager_data_buffer_node* pDataBufferNode)
+/*
+Takes a reference to a node that has finished loading without holding the BST lock. Returns NULL if
+the node does not exist, has not finished loading or is not referenced by anything (a cached node),
+in which case the BST lock needs to be taken.
+*/
+static ma_resource_manager_data_buffer_node* ma_resource_manager_data_buffer_node_try_acquire_loaded(ma_resource_manager* pResourceManager, ma_uint64 hashedName64, const char* pName, const wchar_t* pNameW)
 {
-    MA_ASSERT(pResourceManager != NULL);
-    MA_ASSERT(pDataBufferNode  != NULL);
+    ma_resource_manager_data_buffer_node* pDataBufferNode;
+    ma_uint32 iReaderCounter;
 
-    if (pDataBufferNode->pChildLo == NULL) {
-        if (pDataBufferNode->pChildHi == NULL) {
-            /* Simple case - deleting a buffer with no children. */
-            if (pDataBufferNode->pParent == NULL) {
-                MA_ASSERT(pResourceManager->pRootDataBufferNode == pDataBufferNode);    /* There is only a single buffer in the tree which should be equal to the root node. */
-                pResourceManager->pRootDataBufferNode = NULL;
-            } else {
-                if (pDataBufferNode->pParent->pChildLo == pDataBufferNode) {
-                    pDataBufferNode->pParent->pChildLo = NULL;
-                } else {
-                    pDataBufferNode->pParent->pChildHi = NULL;
-                }
-            }
-        } else {
-            /* Node has one child - pChildHi != NULL. */
-            pDataBufferNode->pChildHi->pParent = pDataBufferNode->pParent;
+    iReaderCounter = ma_atomic_load_32(&pResourceManager->dataBufferNodeReaderEpoch) & 1;
 
-            if (pDataBufferNode->pParent == NULL) {
-                MA_ASSERT(pResourceManager->pRootDataBufferNode == pDataBufferNode);
-                pResourceManager->pRootDataBufferNode = pDataBufferNode->pChildHi;
-            } else {
-                if (pDataBufferNode->pParent->pChildLo == pDataBufferNode) {
-                    pDataBufferNode->pParent->pChildLo = pDataBufferNode->pChildHi;
-                } else {
-                    pDataBufferNode->pParent->pChildHi = pDataBufferNode->pChildHi;
+    ma_atomic_fetch_add_32(&pResourceManager->dataBufferNodeReaderCounts[iReaderCounter], 1);
+    {
+        if (ma_resource_manager_data_buffer_node_search(pResourceManager, hashedName64, pName, pNameW, &pDataBufferNode) == MA_SUCCESS && ma_atomic_load_i32(&pDataBufferNode->result) == MA_SUCCESS) {
+            /* The reference count can only be incremented while it's not 0. Once it reaches 0 the node is owned by whoever decremented it. */
+            ma_uint32 refCount = ma_atomic_load_32(&pDataBufferNode->refCount);
+            for (;;) {
+                if (refCount == 0) {
+                    pDataBufferNode = NULL;
+                    break;
                 }
-            }
-        }
-    } else {
-        if (pDataBufferNode->pChildHi == NULL) {
-            /* Node has one child - pChildLo != NULL. */
-            pDataBufferNode->pChildLo->pParent = pDataBufferNode->pParent;
 
-            if (pDataBufferNode->pParent == NULL) {
-                MA_ASSERT(pResourceManager->pRootDataBufferNode == pDataBufferNode);
-                pResourceManager->pRootDataBufferNode = pDataBufferNode->pChildLo;
-            } else {
-                if (pDataBufferNode->pParent->pChildLo == pDataBufferNode) {
-                    pDataBufferNode->pParent->pChildLo = pDataBufferNode->pChildLo;
-                } else {
-                    pDataBufferNode->pParent->pChildHi = pDataBufferNode->pChildLo;
+                if (ma_atomic_compare_exchange_strong_32(&pDataBufferNode->refCount, &refCount, refCount + 1)) {
+                    ma_atomic_fetch_add_64(&pResourceManager->cacheHits, 1);
+                    break;
                 }
             }
         } else {
-            /* Complex case - deleting a node with two children. */
-            ma_resource_manager_data_buffer_node* pReplacementDataBufferNode;
+            pDataBufferNode = NULL;
+        }
+    }
+    ma_atomic_fetch_sub_32(&pResourceManager->dataBufferNodeReaderCounts[iReaderCounter], 1);
 
-            /* For now we are just going to use the in-order successor as the replacement, but we may want to try to keep this balanced by switching between the two. */
-            pReplacementDataBufferNode = ma_resource_manager_data_buffer_node_find_inorder_successor(pDataBufferNode);
-            MA_ASSERT(pReplacementDataBufferNode != NULL);
+    return pDataBufferNode;
+}
 
-            /*
-            Now that we have our replacement node we can make the change. The simple way to do this would be to just exchange the values, and then remove the replacement
-            node, however we track specific nodes via pointers which means we can't just swap out the values. We need to instead just change the pointers around. The
-            replacement node should have at most 1 child. Therefore, we can detach it in terms of our simpler cases above. What we're essentially doing is detaching the
-            replacement node and reinserting it into the same position as the deleted node.
-            */
-            MA_ASSERT(pReplacementDataBufferNode->pParent  != NULL);  /* The replacement node should never be the root which means it should always have a parent. */
-            MA_ASSERT(pReplacementDataBufferNode->pChildLo == NULL);  /* Because we used in-order successor. This would be pChildHi == NULL if we used in-order predecessor. */
+static ma_resource_manager_data_supply_type ma_resource_manager_data_buffer_node_get_data_supply_type(ma_resource_manager_data_buffer_node* pDataBufferNode)
+{
+    return (ma_resource_manager_data_supply_type)ma_atomic_load_i32(&pDataBufferNode->data.type);
+}
 
-            if (pReplacementDataBufferNode->pChildHi == NULL) {
-                if (pReplacementDataBufferNode->pParent->pChildLo == pReplacementDataBufferNode) {
-                    pReplacementDataBufferNode->pParent->pChildLo = NULL;
-                } else {
-                    pReplacementDataBufferNode->pParent->pChildHi = NULL;
-                }
-            } else {
-                pReplacementDataBufferNode->pChildHi->pParent = pReplacementDataBufferNode->pParent;
-                if (pReplacementDataBufferNode->pParent->pChildLo == pReplacementDataBufferNode) {
-                    pReplacementDataBufferNode->pParent->pChildLo = pReplacementDataBufferNode->pChildHi;
-                } else {
-                    pReplacementDataBufferNode->pParent->pChildHi = pReplacementDataBufferNode->pChildHi;
-                }
-            }
+static void ma_resource_manager_data_buffer_node_set_data_supply_type(ma_resource_manager_data_buffer_node* pDataBufferNode, ma_resource_manager_data_supply_type supplyType)
+{
+    ma_atomic_exchange_i32(&pDataBufferNode->data.type, supplyType);
+}
 
+/* The cache functions below must be called while holding the BST lock. */
+static void ma_resource_manager_cache_link(ma_resource_manager* pResourceManager, ma_resource_manager_data_buffer_node* pDataBufferNode)
+{
+    MA_ASSERT(pDataBufferNode->isCached == MA_FALSE);
 
-            /* The replacement node has essentially been detached from the binary tree, so now we need to replace the old data buffer with it. The first thing to update is the parent */
-            if (pDataBufferNode->pParent != NULL) {
-                if (pDataBufferNode->pParent->pChildLo == pDataBufferNode) {
-                    pDataBufferNode->pParent->pChildLo = pReplacementDataBufferNode;
-                } else {
-                    pDataBufferNode->pParent->pChildHi = pReplacementDataBufferNode;
-                }
-            }
+    pDataBufferNode->isCached   = MA_TRUE;
+    pDataBufferNode->pCachePrev = pResourceManager->pCacheTail;
+    pDataBufferNode->pCacheNext = NULL;
 
-            /* Now need to update the replacement node's pointers. */
-            pReplacementDataBufferNode->pParent  = pDataBufferNode->pParent;
-            pReplacementDataBufferNode->pChildLo = pDataBufferNode->pChildLo;
-            pReplacementDataBufferNode->pChildHi = pDataBufferNode->pChildHi;
+    if (pResourceManager->pCacheTail != NULL) {
+        pResourceManager->pCacheTail->pCacheNext = pDataBufferNode;
+    } else {
+        pResourceManager->pCacheHead = pDataBufferNode;
+    }
 
-            /* Now the children of the replacement node need to have their parent pointers updated. */
-            if (pReplacementDataBufferNode->pChildLo != NULL) {
-                pReplacementDataBufferNode->pChildLo->pParent = pReplacementDataBufferNode;
-            }
-            if (pReplacementDataBufferNode->pChildHi != NULL) {
-                pReplacementDataBufferNode->pChildHi->pParent = pReplacementDataBufferNode;
-            }
+    pResourceManager->pCacheTail = pDataBufferNode;
+    pResourceManager->cachedSizeInBytes += pDataBufferNode->decodedSizeInBytes;
+    pResourceManager->cachedNodeCount   += 1;
+}
 
-            /* Now the root node needs to be updated. */
-            if (pResourceManager->pRootDataBufferNode == pDataBufferNode) {
-                pResourceManager->pRootDataBufferNode = pReplacementDataBufferNode;
-            }
-        }
+static void ma_resource_manager_cache_unlink(ma_resource_manager* pResourceManager, ma_resource_manager_data_buffer_node* pDataBufferNode)
+{
+    MA_ASSERT(pDataBufferNode->isCached == MA_TRUE);
+
+    if (pDataBufferNode->pCachePrev != NULL) {
+        pDataBufferNode->pCachePrev->pCacheNext = pDataBufferNode->pCacheNext;
+    } else {
+        pResourceManager->pCacheHead = pDataBufferNode->pCacheNext;
     }
 
-    return MA_SUCCESS;
+    if (pDataBufferNode->pCacheNext != NULL) {
+        pDataBufferNode->pCacheNext->pCachePrev = pDataBufferNode->pCachePrev;
+    } else {
+        pResourceManager->pCacheTail = pDataBufferNode->pCachePrev;
+    }
+
+    pDataBufferNode->isCached   = MA_FALSE;
+    pDataBufferNode->pCachePrev = NULL;
+    pDataBufferNode->pCacheNext = NULL;
+    pResourceManager->cachedSizeInBytes -= pDataBufferNode->decodedSizeInBytes;
+    pResourceManager->cachedNodeCount   -= 1;
 }
 
-#if 0   /* Unused for now. */
-static ma_result ma_resource_manager_data_buffer_node_remove_by_key(ma_resource_manager* pResourceManager, ma_uint32 hashedName32)
+static ma_bool32 ma_resource_manager_cache_can_hold(ma_resource_manager* pResourceManager, ma_resource_manager_data_buffer_node* pDataBufferNode)
 {
-    ma_result result;
-    ma_resource_manager_data_buffer_node* pDataBufferNode;
+    /* Only fully decoded data that the resource manager can free is worth keeping around. */
+    return
+        pResourceManager->config.cacheBudgetInBytes > 0 &&
+        pDataBufferNode->isDataOwnedByResourceManager &&
+        pDataBufferNode->decodedSizeInBytes > 0 &&
+        ma_atomic_load_i32(&pDataBufferNode->result) == MA_SUCCESS;
+}
 
-    result = ma_resource_manager_data_buffer_search(pResourceManager, hashedName32, &pDataBufferNode);
-    if (result != MA_SUCCESS) {
-        return result;  /* Could not find the data buffer. */
+/*
+Removes the least recently used nodes from the cache and the table until the decoded data fits the
+budget. The removed nodes are returned as a list linked through pCacheNext and must be freed with
+ma_resource_manager_cache_free() after the BST lock is released.
+*/
+static ma_resource_manager_data_buffer_node* ma_resource_manager_cache_evict(ma_resource_manager* pResourceManager)
+{
+    ma_resource_manager_data_buffer_node* pEvicted = NULL;
+    ma_uint64 decodedSizeInBytes = ma_atomic_load_64(&pResourceManager->decodedSizeInBytes);
+
+    while (pResourceManager->pCacheHead != NULL && decodedSizeInBytes > pResourceManager->config.cacheBudgetInBytes) {
+        ma_resource_manager_data_buffer_node* pDataBufferNode = pResourceManager->pCacheHead;
+
+        ma_resource_manager_cache_unlink(pResourceManager, pDataBufferNode);
+        ma_resource_manager_data_buffer_node_remove(pResourceManager, pDataBufferNode);
+        decodedSizeInBytes -= pDataBufferNode->decodedSizeInBytes;
+
+        pDataBufferNode->pCacheNext = pEvicted;
+        pEvicted = pDataBufferNode;
+
+        ma_atomic_fetch_add_64(&pResourceManager->cacheEvictions, 1);
     }
 
-    return ma_resource_manager_data_buffer_remove(pResourceManager, pDataBufferNode);
+    return pEvicted;
 }
-#endif
 
-static ma_resource_manager_data_supply_type ma_resource_manager_data_buffer_node_get_data_supply_type(ma_resource_manager_data_buffer_node* pDataBufferNode)
+static void ma_resource_manager_data_buffer_node_free(ma_resource_manager* pResourceManager, ma_resource_manager_data_buffer_node* pDataBufferNode);
+
+static void ma_resource_manager_cache_free(ma_resource_manager* pResourceManager, ma_resource_manager_data_buffer_node* pEvicted)
 {
-    return (ma_resource_manager_data_supply_type)ma_atomic_load_i32(&pDataBufferNode->data.type);
+    while (pEvicted != NULL) {
+        ma_resource_manager_data_buffer_node* pNext = pEvicted->pCacheNext;
+        ma_resource_manager_data_buffer_node_free(pResourceManager, pEvicted);
+        pEvicted = pNext;
+    }
 }
 
-static void ma_resource_manager_data_buffer_node_set_data_supply_type(ma_resource_manager_data_buffer_node* pDataBufferNode, ma_resource_manager_data_supply_type supplyType)
+/* Counts the decoded data of a node against the cache budget. Only for data owned by the resource manager. */
+static void ma_resource_manager_data_buffer_node_track_decoded(ma_resource_manager* pResourceManager, ma_resource_manager_data_buffer_node* pDataBufferNode)
 {
-    ma_atomic_exchange_i32(&pDataBufferNode->data.type, supplyType);
+    MA_ASSERT(pDataBufferNode->decodedSizeInBytes == 0);
+
+    pDataBufferNode->decodedSizeInBytes = pDataBufferNode->data.backend.decoded.totalFrameCount * ma_get_bytes_per_frame(pDataBufferNode->data.backend.decoded.format, pDataBufferNode->data.backend.decoded.channels);
+    ma_atomic_fetch_add_64(&pResourceManager->decodedSizeInBytes, pDataBufferNode->decodedSizeInBytes);
 }
 
+/* Must be called while holding the BST lock when the node could be in the cache. */
 static ma_result ma_resource_manager_data_buffer_node_increment_ref(ma_resource_manager* pResourceManager, ma_resource_manager_data_buffer_node* pDataBufferNode, ma_uint32* pNewRefCount)
 {
     ma_uint32 refCount;
@@ -58259,10 +58601,12 @@ static ma_result ma_resource_manager_data_buffer_node_increment_ref(ma_resource_
     MA_ASSERT(pResourceManager != NULL);
     MA_ASSERT(pDataBufferNode  != NULL);
 
-    (void)pResourceManager;
-
     refCount = ma_atomic_fetch_add_32(&pDataBufferNode->refCount, 1) + 1;
 
+    if (pDataBufferNode->isCached) {
+        ma_resource_manager_cache_unlink(pResourceManager, pDataBufferNode);
+    }
+
     if (pNewRefCount != NULL) {
         *pNewRefCount = refCount;
     }
@@ -58293,6 +58637,10 @@ static void ma_resource_manager_data_buffer_node_free(ma_resource_manager* pReso
     MA_ASSERT(pResourceManager != NULL);
     MA_ASSERT(pDataBufferNode  != NULL);
 
+    if (pDataBufferNode->decodedSizeInBytes > 0) {
+        ma_atomic_fetch_sub_64(&pResourceManager->decodedSizeInBytes, pDataBufferNode->decodedSizeInBytes);
+    }
+
     if (pDataBufferNode->isDataOwnedByResourceManager) {
         if (ma_resource_manager_data_buffer_node_get_data_supply_type(pDataBufferNode) == ma_resource_manager_data_supply_type_encoded) {
             ma_free((void*)pDataBufferNode->data.backend.encoded.pData, &pResourceManager->config.allocationCallbacks);
@@ -58310,7 +58658,8 @@ static void ma_resource_manager_data_buffer_node_free(ma_resource_manager* pReso
         }
     }
 
-    /* The data buffer itself needs to be freed. */
+    /* The data buffer itself needs to be freed, but not while a search without the lock could still be looking at it. */
+    ma_resource_manager_data_buffer_node_wait_for_readers(pResourceManager);
     ma_free(pDataBufferNode, &pResourceManager->config.allocationCallbacks);
 }
 
@@ -58426,6 +58775,487 @@ static void ma_resource_manager_data_buffer_bst_unlock(ma_resource_manager* pRes
     }
 }
 
+/*
+Evicts cached nodes after a node has finished loading, since newly decoded data can push the total over
+the budget while nothing is being released. The lock is only taken when the budget is exceeded.
+*/
+static void ma_resource_manager_cache_trim(ma_resource_manager* pResourceManager)
+{
+    ma_resource_manager_data_buffer_node* pEvicted;
+
+    if (pResourceManager->config.cacheBudgetInBytes == 0 || ma_atomic_load_64(&pResourceManager->decodedSizeInBytes) <= pResourceManager->config.cacheBudgetInBytes) {
+        return;
+    }
+
+    ma_resource_manager_data_buffer_bst_lock(pResourceManager);
+    {
+        pEvicted = ma_resource_manager_cache_evict(pResourceManager);
+    }
+    ma_resource_manager_data_buffer_bst_unlock(pResourceManager);
+
+    ma_resource_manager_cache_free(pResourceManager, pEvicted);
+}
+
+
+#ifdef MA_HAS_MP3
+/*
+MP3 Seek Tables
+
+Without a Xing header the only way to find the length of an MP3 file or to seek in it accurately is to scan every frame. When
+mp3SeekPointIntervalInMilliseconds is set, the resource manager does this once per asset and binds the resulting seek table to
+every MP3 decoder it creates for that asset afterwards, whether it's for a data buffer, a segment of one or a data stream. The
+tables are kept in a hash table keyed by the hashed name of the asset, guarded by dataBufferBSTLock, until the resource manager
+is uninitialized. They outlive the data buffer nodes so a data stream, or an asset that is loaded again, finds its table. When
+saveMP3SeekTables is set they are also saved next to the file through the VFS so the scan is skipped the next time the file is
+loaded.
+*/
+#define MA_RESOURCE_MANAGER_MP3_SEEK_TABLE_FILE_EXTENSION   ".seektable"
+#define MA_RESOURCE_MANAGER_MP3_SEEK_TABLE_FILE_MAGIC       "maseek01"
+
+#ifndef MA_RESOURCE_MANAGER_MP3_SEEK_TABLE_MIN_BUCKET_COUNT
+#define MA_RESOURCE_MANAGER_MP3_SEEK_TABLE_MIN_BUCKET_COUNT 16
+#endif
+
+struct ma_resource_manager_mp3_seek_table
+{
+    ma_resource_manager_mp3_seek_table* pNext;  /* The next table in the same bucket. */
+    ma_uint64 hashedName64;
+    const char* pName;                  /* Stored in the same allocation as the table, like the name of a data buffer node. NULL if the asset was named with a wide string. */
+    const wchar_t* pNameW;
+    ma_uint64 lengthInPCMFrames;
+    ma_uint32 seekPointCount;
+    ma_dr_mp3_seek_point* pSeekPoints;  /* Stored after the structure. Never changed once the table is in the list since decoders point at it. */
+};
+
+typedef struct
+{
+    char magic[8];
+    ma_uint64 assetSizeInBytes;         /* The size of the MP3 file the table was built for. The table is ignored if the file has changed size since. */
+    ma_uint64 lengthInPCMFrames;
+    ma_uint32 seekPointCount;
+    ma_uint32 seekPointSizeInBytes;     /* sizeof(ma_dr_mp3_seek_point) of the build that saved the table. */
+} ma_resource_manager_mp3_seek_table_file_header;
+
+static ma_resource_manager_mp3_seek_table* ma_resource_manager_mp3_seek_table_alloc(ma_resource_manager* pResourceManager, const char* pName, const wchar_t* pNameW, ma_uint32 seekPointCount)
+{
+    ma_resource_manager_mp3_seek_table* pSeekTable;
+    size_t seekPointsSizeInBytes;
+    size_t nameSizeInBytes;
+
+    MA_ASSERT(pName != NULL || pNameW != NULL);
+
+    seekPointsSizeInBytes = sizeof(ma_dr_mp3_seek_point) * seekPointCount;
+
+    if (pName != NULL) {
+        nameSizeInBytes = strlen(pName) + 1;
+    } else {
+        nameSizeInBytes = (ma_wcslen(pNameW) + 1) * sizeof(wchar_t);
+    }
+
+    pSeekTable = (ma_resource_manager_mp3_seek_table*)ma_malloc(sizeof(*pSeekTable) + seekPointsSizeInBytes + nameSizeInBytes, &pResourceManager->config.allocationCallbacks);
+    if (pSeekTable == NULL) {
+        return NULL;
+    }
+
+    MA_ZERO_OBJECT(pSeekTable);
+    pSeekTable->seekPointCount = seekPointCount;
+    pSeekTable->pSeekPoints    = (ma_dr_mp3_seek_point*)(pSeekTable + 1);
+
+    if (pName != NULL) {
+        pSeekTable->hashedName64 = ma_hash_string_64(pName);
+        pSeekTable->pName        = (const char*)((ma_uint8*)pSeekTable->pSeekPoints + seekPointsSizeInBytes);
+        MA_COPY_MEMORY((char*)pSeekTable->pName, pName, nameSizeInBytes);
+    } else {
+        pSeekTable->hashedName64 = ma_hash_string_w_64(pNameW);
+        pSeekTable->pNameW       = (const wchar_t*)((ma_uint8*)pSeekTable->pSeekPoints + seekPointsSizeInBytes);
+        MA_COPY_MEMORY((wchar_t*)pSeekTable->pNameW, pNameW, nameSizeInBytes);
+    }
+
+    return pSeekTable;
+}
+
+/* The caller must hold dataBufferBSTLock. */
+static ma_resource_manager_mp3_seek_table* ma_resource_manager_mp3_seek_table_find(ma_resource_manager* pResourceManager, ma_uint64 hashedName64, const char* pName, const wchar_t* pNameW)
+{
+    ma_resource_manager_mp3_seek_table* pSeekTable;
+
+    if (pResourceManager->ppMP3SeekTableBuckets == NULL) {
+        return NULL;
+    }
+
+    for (pSeekTable = pResourceManager->ppMP3SeekTableBuckets[(ma_uint32)hashedName64 & (pResourceManager->mp3SeekTableBucketCount - 1)]; pSeekTable != NULL; pSeekTable = pSeekTable->pNext) {
+        if (pSeekTable->hashedName64 != hashedName64) {
+            continue;
+        }
+
+        if (pName != NULL) {
+            if (pSeekTable->pName != NULL && strcmp(pSeekTable->pName, pName) == 0) {
+                return pSeekTable;
+            }
+        } else {
+            if (pSeekTable->pNameW != NULL && ma_wcscmp(pSeekTable->pNameW, pNameW) == 0) {
+                return pSeekTable;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/*
+The caller must hold dataBufferBSTLock. Doubles the number of buckets once there are as many tables as buckets so chains stay
+short. If the new buckets can't be allocated the old ones are kept, which only makes lookups a little slower.
+*/
+static void ma_resource_manager_mp3_seek_table_grow(ma_resource_manager* pResourceManager)
+{
+    ma_resource_manager_mp3_seek_table** ppNewBuckets;
+    ma_uint32 newBucketCount;
+    ma_uint32 iBucket;
+
+    if (pResourceManager->mp3SeekTableCount < pResourceManager->mp3SeekTableBucketCount) {
+        return;
+    }
+
+    newBucketCount = (pResourceManager->mp3SeekTableBucketCount > 0) ? pResourceManager->mp3SeekTableBucketCount * 2 : MA_RESOURCE_MANAGER_MP3_SEEK_TABLE_MIN_BUCKET_COUNT;
+
+    ppNewBuckets = (ma_resource_manager_mp3_seek_table**)ma_calloc(newBucketCount * sizeof(*ppNewBuckets), &pResourceManager->config.allocationCallbacks);
+    if (ppNewBuckets == NULL) {
+        return;
+    }
+
+    for (iBucket = 0; iBucket < pResourceManager->mp3SeekTableBucketCount; iBucket += 1) {
+        while (pResourceManager->ppMP3SeekTableBuckets[iBucket] != NULL) {
+            ma_resource_manager_mp3_seek_table* pSeekTable = pResourceManager->ppMP3SeekTableBuckets[iBucket];
+            ma_uint32 iNewBucket = (ma_uint32)pSeekTable->hashedName64 & (newBucketCount - 1);
+
+            pResourceManager->ppMP3SeekTableBuckets[iBucket] = pSeekTable->pNext;
+            pSeekTable->pNext = ppNewBuckets[iNewBucket];
+            ppNewBuckets[iNewBucket] = pSeekTable;
+        }
+    }
+
+    ma_free(pResourceManager->ppMP3SeekTableBuckets, &pResourceManager->config.allocationCallbacks);
+    pResourceManager->ppMP3SeekTableBuckets   = ppNewBuckets;
+    pResourceManager->mp3SeekTableBucketCount = newBucketCount;
+}
+
+/*
+Adds a table to the hash table and returns it. If another thread added a table for the same asset in the meantime that one is
+returned instead and the new one is freed. Returns NULL and frees the table if there is no memory for the buckets.
+*/
+static ma_resource_manager_mp3_seek_table* ma_resource_manager_mp3_seek_table_add(ma_resource_manager* pResourceManager, ma_resource_manager_mp3_seek_table* pSeekTable)
+{
+    ma_resource_manager_mp3_seek_table* pExistingSeekTable;
+    ma_bool32 isAdded = MA_FALSE;
+
+    ma_resource_manager_data_buffer_bst_lock(pResourceManager);
+    {
+        pExistingSeekTable = ma_resource_manager_mp3_seek_table_find(pResourceManager, pSeekTable->hashedName64, pSeekTable->pName, pSeekTable->pNameW);
+        if (pExistingSeekTable == NULL) {
+            ma_resource_manager_mp3_seek_table_grow(pResourceManager);
+
+            if (pResourceManager->ppMP3SeekTableBuckets != NULL) {
+                ma_uint32 iBucket = (ma_uint32)pSeekTable->hashedName64 & (pResourceManager->mp3SeekTableBucketCount - 1);
+
+                pSeekTable->pNext = pResourceManager->ppMP3SeekTableBuckets[iBucket];
+                pResourceManager->ppMP3SeekTableBuckets[iBucket] = pSeekTable;
+                pResourceManager->mp3SeekTableCount += 1;
+                isAdded = MA_TRUE;
+            }
+        }
+    }
+    ma_resource_manager_data_buffer_bst_unlock(pResourceManager);
+
+    if (isAdded == MA_FALSE) {
+        ma_free(pSeekTable, &pResourceManager->config.allocationCallbacks);
+        return pExistingSeekTable;
+    }
+
+    return pSeekTable;
+}
+
+static void ma_resource_manager_mp3_seek_table_free_all(ma_resource_manager* pResourceManager)
+{
+    ma_uint32 iBucket;
+
+    for (iBucket = 0; iBucket < pResourceManager->mp3SeekTableBucketCount; iBucket += 1) {
+        while (pResourceManager->ppMP3SeekTableBuckets[iBucket] != NULL) {
+            ma_resource_manager_mp3_seek_table* pNext = pResourceManager->ppMP3SeekTableBuckets[iBucket]->pNext;
+            ma_free(pResourceManager->ppMP3SeekTableBuckets[iBucket], &pResourceManager->config.allocationCallbacks);
+            pResourceManager->ppMP3SeekTableBuckets[iBucket] = pNext;
+        }
+    }
+
+    ma_free(pResourceManager->ppMP3SeekTableBuckets, &pResourceManager->config.allocationCallbacks);
+    pResourceManager->ppMP3SeekTableBuckets   = NULL;
+    pResourceManager->mp3SeekTableBucketCount = 0;
+    pResourceManager->mp3SeekTableCount       = 0;
+}
+
+static ma_result ma_resource_manager_mp3_seek_table_file_open(ma_resource_manager* pResourceManager, const char* pName, const wchar_t* pNameW, ma_uint32 openMode, ma_vfs_file* pFile)
+{
+    ma_result result;
+    const char* pExtension = MA_RESOURCE_MANAGER_MP3_SEEK_TABLE_FILE_EXTENSION;
+    size_t extensionLength = strlen(pExtension);
+
+    if (pName != NULL) {
+        size_t nameLength = strlen(pName);
+        char* pFilePath;
+
+        pFilePath = (char*)ma_malloc(nameLength + extensionLength + 1, &pResourceManager->config.allocationCallbacks);
+        if (pFilePath == NULL) {
+            return MA_OUT_OF_MEMORY;
+        }
+
+        MA_COPY_MEMORY(pFilePath, pName, nameLength);
+        MA_COPY_MEMORY(pFilePath + nameLength, pExtension, extensionLength + 1);
+
+        result = ma_vfs_or_default_open(pResourceManager->config.pVFS, pFilePath, openMode, pFile);
+        ma_free(pFilePath, &pResourceManager->config.allocationCallbacks);
+    } else {
+        size_t nameLength = ma_wcslen(pNameW);
+        wchar_t* pFilePathW;
+        size_t iChar;
+
+        pFilePathW = (wchar_t*)ma_malloc((nameLength + extensionLength + 1) * sizeof(wchar_t), &pResourceManager->config.allocationCallbacks);
+        if (pFilePathW == NULL) {
+            return MA_OUT_OF_MEMORY;
+        }
+
+        MA_COPY_MEMORY(pFilePathW, pNameW, nameLength * sizeof(wchar_t));
+        for (iChar = 0; iChar <= extensionLength; iChar += 1) {
+            pFilePathW[nameLength + iChar] = (wchar_t)pExtension[iChar];
+        }
+
+        result = ma_vfs_or_default_open_w(pResourceManager->config.pVFS, pFilePathW, openMode, pFile);
+        ma_free(pFilePathW, &pResourceManager->config.allocationCallbacks);
+    }
+
+    return result;
+}
+
+static ma_resource_manager_mp3_seek_table* ma_resource_manager_mp3_seek_table_load_file(ma_resource_manager* pResourceManager, const char* pName, const wchar_t* pNameW, ma_uint64 assetSizeInBytes)
+{
+    ma_result result;
+    ma_vfs_file file;
+    ma_file_info info;
+    ma_resource_manager_mp3_seek_table_file_header header;
+    ma_resource_manager_mp3_seek_table* pSeekTable = NULL;
+    size_t seekPointsSizeInBytes;
+    size_t bytesRead;
+
+    result = ma_resource_manager_mp3_seek_table_file_open(pResourceManager, pName, pNameW, MA_OPEN_MODE_READ, &file);
+    if (result != MA_SUCCESS) {
+        return NULL;    /* Not saved yet. */
+    }
+
+    result = ma_vfs_or_default_info(pResourceManager->config.pVFS, file, &info);
+    if (result != MA_SUCCESS) {
+        goto done;
+    }
+
+    result = ma_vfs_or_default_read(pResourceManager->config.pVFS, file, &header, sizeof(header), &bytesRead);
+    if (result != MA_SUCCESS || bytesRead != sizeof(header)) {
+        goto done;
+    }
+
+    if (memcmp(header.magic, MA_RESOURCE_MANAGER_MP3_SEEK_TABLE_FILE_MAGIC, sizeof(header.magic)) != 0 || header.seekPointSizeInBytes != sizeof(ma_dr_mp3_seek_point) || header.assetSizeInBytes != assetSizeInBytes) {
+        goto done;      /* Not a table, saved by a different build, or saved for an older version of the file. */
+    }
+
+    seekPointsSizeInBytes = sizeof(ma_dr_mp3_seek_point) * header.seekPointCount;
+    if (header.seekPointCount == 0 || info.sizeInBytes != sizeof(header) + (ma_uint64)seekPointsSizeInBytes) {
+        goto done;
+    }
+
+    pSeekTable = ma_resource_manager_mp3_seek_table_alloc(pResourceManager, pName, pNameW, header.seekPointCount);
+    if (pSeekTable == NULL) {
+        goto done;
+    }
+
+    result = ma_vfs_or_default_read(pResourceManager->config.pVFS, file, pSeekTable->pSeekPoints, seekPointsSizeInBytes, &bytesRead);
+    if (result != MA_SUCCESS || bytesRead != seekPointsSizeInBytes) {
+        ma_free(pSeekTable, &pResourceManager->config.allocationCallbacks);
+        pSeekTable = NULL;
+        goto done;
+    }
+
+    pSeekTable->lengthInPCMFrames = header.lengthInPCMFrames;
+
+done:
+    ma_vfs_or_default_close(pResourceManager->config.pVFS, file);
+    return pSeekTable;
+}
+
+static void ma_resource_manager_mp3_seek_table_save_file(ma_resource_manager* pResourceManager, const ma_resource_manager_mp3_seek_table* pSeekTable, ma_uint64 assetSizeInBytes)
+{
+    ma_result result;
+    ma_vfs_file file;
+    ma_resource_manager_mp3_seek_table_file_header header;
+
+    MA_ZERO_OBJECT(&header);
+    MA_COPY_MEMORY(header.magic, MA_RESOURCE_MANAGER_MP3_SEEK_TABLE_FILE_MAGIC, sizeof(header.magic));
+    header.assetSizeInBytes     = assetSizeInBytes;
+    header.lengthInPCMFrames    = pSeekTable->lengthInPCMFrames;
+    header.seekPointCount       = pSeekTable->seekPointCount;
+    header.seekPointSizeInBytes = sizeof(ma_dr_mp3_seek_point);
+
+    result = ma_resource_manager_mp3_seek_table_file_open(pResourceManager, pSeekTable->pName, pSeekTable->pNameW, MA_OPEN_MODE_WRITE, &file);
+    if (result == MA_SUCCESS) {
+        result = ma_vfs_or_default_write(pResourceManager->config.pVFS, file, &header, sizeof(header), NULL);
+        if (result == MA_SUCCESS) {
+            result = ma_vfs_or_default_write(pResourceManager->config.pVFS, file, pSeekTable->pSeekPoints, sizeof(ma_dr_mp3_seek_point) * pSeekTable->seekPointCount, NULL);
+        }
+
+        ma_vfs_or_default_close(pResourceManager->config.pVFS, file);
+    }
+
+    /* Not being able to save is not an error. The table will just be built again next time. */
+    if (result != MA_SUCCESS && pSeekTable->pName != NULL) {
+        ma_log_postf(ma_resource_manager_get_log(pResourceManager), MA_LOG_LEVEL_DEBUG, "Failed to save the seek table of \"%s\". %s.\n", pSeekTable->pName, ma_result_description(result));
+    }
+}
+
+/* The size of the file behind a decoder, whether it's reading the file through the VFS or from an encoded data buffer. 0 if it can't be retrieved. */
+static ma_uint64 ma_resource_manager_get_decoder_asset_size(ma_decoder* pDecoder)
+{
+    ma_file_info info;
+
+    if (pDecoder->onRead == ma_decoder__on_read_memory) {
+        return pDecoder->data.memory.dataSize;
+    }
+
+    if (pDecoder->onRead != ma_decoder__on_read_vfs) {
+        return 0;
+    }
+
+    if (ma_vfs_or_default_info(pDecoder->data.vfs.pVFS, pDecoder->data.vfs.file, &info) != MA_SUCCESS) {
+        return 0;
+    }
+
+    return info.sizeInBytes;
+}
+
+static ma_resource_manager_mp3_seek_table* ma_resource_manager_mp3_seek_table_build(ma_resource_manager* pResourceManager, const char* pName, const wchar_t* pNameW, ma_mp3* pMP3)
+{
+    ma_resource_manager_mp3_seek_table* pSeekTable;
+    ma_uint64 lengthInPCMFrames;
+    ma_uint64 intervalInPCMFrames;
+    ma_uint64 seekPointCount;
+    ma_uint32 calculatedSeekPointCount;
+
+    if (ma_mp3_get_length_in_pcm_frames(pMP3, &lengthInPCMFrames) != MA_SUCCESS || lengthInPCMFrames == 0) {
+        return NULL;
+    }
+
+    intervalInPCMFrames = ((ma_uint64)pMP3->dr.sampleRate * pResourceManager->config.mp3SeekPointIntervalInMilliseconds) / 1000;
+    if (intervalInPCMFrames == 0) {
+        intervalInPCMFrames = 1;
+    }
+
+    seekPointCount = lengthInPCMFrames / intervalInPCMFrames;
+    if (seekPointCount == 0) {
+        seekPointCount = 1;
+    }
+    if (seekPointCount > 0xFFFFFFFF / sizeof(ma_dr_mp3_seek_point)) {
+        seekPointCount = 0xFFFFFFFF / sizeof(ma_dr_mp3_seek_point);
+    }
+
+    pSeekTable = ma_resource_manager_mp3_seek_table_alloc(pResourceManager, pName, pNameW, (ma_uint32)seekPointCount);
+    if (pSeekTable == NULL) {
+        return NULL;
+    }
+
+    /* This leaves the decoder where it was. The count can come back lower than requested for short files. */
+    calculatedSeekPointCount = (ma_uint32)seekPointCount;
+    if (ma_dr_mp3_calculate_seek_points(&pMP3->dr, &calculatedSeekPointCount, pSeekTable->pSeekPoints) != MA_TRUE || calculatedSeekPointCount == 0) {
+        ma_free(pSeekTable, &pResourceManager->config.allocationCallbacks);
+        return NULL;
+    }
+
+    pSeekTable->seekPointCount    = calculatedSeekPointCount;
+    pSeekTable->lengthInPCMFrames = lengthInPCMFrames;
+
+    return pSeekTable;
+}
+#endif
+
+/*
+Binds the seek table of an asset to a decoder that was just initialized for it, building the table first if this is the first
+decoder for the asset. Does nothing for decoders that aren't MP3. isFile is false when the asset was registered by the application
+rather than loaded from a file, in which case the table is never saved.
+*/
+static void ma_resource_manager_bind_mp3_seek_table(ma_resource_manager* pResourceManager, const char* pName, const wchar_t* pNameW, ma_bool32 isFile, ma_decoder* pDecoder)
+{
+#ifdef MA_HAS_MP3
+    ma_mp3* pMP3;
+    ma_resource_manager_mp3_seek_table* pSeekTable;
+    ma_uint64 hashedName64;
+    ma_uint64 assetSizeInBytes = 0;
+
+    MA_ASSERT(pResourceManager != NULL);
+    MA_ASSERT(pDecoder         != NULL);
+
+    if (pResourceManager->config.mp3SeekPointIntervalInMilliseconds == 0 || pDecoder->pBackendVTable != &g_ma_decoding_backend_vtable_mp3) {
+        return;
+    }
+
+    if (pName == NULL && pNameW == NULL) {
+        return;
+    }
+
+    pMP3 = (ma_mp3*)pDecoder->pBackend;
+    if (pMP3->seekPointCount > 0) {
+        return; /* The decoder config asked for a table of its own. */
+    }
+
+    hashedName64 = (pName != NULL) ? ma_hash_string_64(pName) : ma_hash_string_w_64(pNameW);
+
+    ma_resource_manager_data_buffer_bst_lock(pResourceManager);
+    {
+        pSeekTable = ma_resource_manager_mp3_seek_table_find(pResourceManager, hashedName64, pName, pNameW);
+    }
+    ma_resource_manager_data_buffer_bst_unlock(pResourceManager);
+
+    if (pSeekTable == NULL) {
+        if (pResourceManager->config.saveMP3SeekTables && isFile) {
+            assetSizeInBytes = ma_resource_manager_get_decoder_asset_size(pDecoder);
+        }
+
+        if (assetSizeInBytes > 0) {
+            pSeekTable = ma_resource_manager_mp3_seek_table_load_file(pResourceManager, pName, pNameW, assetSizeInBytes);
+        }
+
+        if (pSeekTable == NULL) {
+            pSeekTable = ma_resource_manager_mp3_seek_table_build(pResourceManager, pName, pNameW, pMP3);
+            if (pSeekTable == NULL) {
+                return; /* The decoder still works, it just seeks by scanning. */
+            }
+
+            if (assetSizeInBytes > 0) {
+                ma_resource_manager_mp3_seek_table_save_file(pResourceManager, pSeekTable, assetSizeInBytes);
+            }
+        }
+
+        pSeekTable = ma_resource_manager_mp3_seek_table_add(pResourceManager, pSeekTable);
+        if (pSeekTable == NULL) {
+            return;
+        }
+    }
+
+    /* The table belongs to the resource manager so pSeekPoints is left NULL to stop ma_mp3_uninit() from freeing it. */
+    ma_dr_mp3_bind_seek_table(&pMP3->dr, pSeekTable->seekPointCount, pSeekTable->pSeekPoints);
+    pMP3->seekPointCount    = pSeekTable->seekPointCount;
+    pMP3->lengthInPCMFrames = pSeekTable->lengthInPCMFrames;
+#else
+    (void)pResourceManager;
+    (void)pName;
+    (void)pNameW;
+    (void)isFile;
+    (void)pDecoder;
+#endif
+}
+
 #ifndef MA_NO_THREADING
 static ma_thread_result MA_THREADCALL ma_resource_manager_job_thread(void* pUserData)
 {
@@ -58453,6 +59283,132 @@ static ma_thread_result MA_THREADCALL ma_resource_manager_job_thread(void* pUser
 }
 #endif
 
+static ma_result ma_resource_manager_job_lanes_init(ma_resource_manager* pResourceManager);
+static void ma_resource_manager_job_lanes_uninit(ma_resource_manager* pResourceManager);
+
+static ma_result ma_resource_manager_stream_page_pool_init(ma_resource_manager* pResourceManager)
+{
+    size_t blockCount = pResourceManager->config.streamPagePoolSizeInBytes / MA_RESOURCE_MANAGER_STREAM_PAGE_POOL_BLOCK_SIZE;
+
+    if (blockCount == 0) {
+        return MA_SUCCESS;  /* No pool. Pages are allocated on the heap. */
+    }
+
+    if (blockCount > 0xFFFFFFFE) {
+        return MA_INVALID_ARGS;
+    }
+
+    pResourceManager->pStreamPagePool = ma_malloc(blockCount * MA_RESOURCE_MANAGER_STREAM_PAGE_POOL_BLOCK_SIZE, &pResourceManager->config.allocationCallbacks);
+    if (pResourceManager->pStreamPagePool == NULL) {
+        return MA_OUT_OF_MEMORY;
+    }
+
+    pResourceManager->pStreamPagePoolBlocks = (ma_uint32*)ma_calloc(blockCount * sizeof(ma_uint32), &pResourceManager->config.allocationCallbacks);
+    if (pResourceManager->pStreamPagePoolBlocks == NULL) {
+        ma_free(pResourceManager->pStreamPagePool, &pResourceManager->config.allocationCallbacks);
+        pResourceManager->pStreamPagePool = NULL;
+        return MA_OUT_OF_MEMORY;
+    }
+
+    pResourceManager->streamPagePoolBlockCount = (ma_uint32)blockCount;
+
+    return MA_SUCCESS;
+}
+
+static void ma_resource_manager_stream_page_pool_uninit(ma_resource_manager* pResourceManager)
+{
+    ma_free(pResourceManager->pStreamPagePoolBlocks, &pResourceManager->config.allocationCallbacks);
+    ma_free(pResourceManager->pStreamPagePool, &pResourceManager->config.allocationCallbacks);
+    pResourceManager->pStreamPagePoolBlocks    = NULL;
+    pResourceManager->pStreamPagePool          = NULL;
+    pResourceManager->streamPagePoolBlockCount = 0;
+}
+
+/*
+Allocates the buffer of a stream page. The first run of free blocks in the pool that is large enough
+is used. When there is none the page is allocated on the heap instead.
+*/
+static void* ma_resource_manager_stream_page_alloc(ma_resource_manager* pResourceManager, size_t sizeInBytes)
+{
+    void* pPage = NULL;
+
+    if (pResourceManager->pStreamPagePool != NULL) {
+        size_t blocksNeeded = (sizeInBytes + MA_RESOURCE_MANAGER_STREAM_PAGE_POOL_BLOCK_SIZE - 1) / MA_RESOURCE_MANAGER_STREAM_PAGE_POOL_BLOCK_SIZE;
+
+        ma_spinlock_lock(&pResourceManager->streamPagePoolLock);
+        {
+            ma_uint32* pBlocks = pResourceManager->pStreamPagePoolBlocks;
+            ma_uint32 blockCount = pResourceManager->streamPagePoolBlockCount;
+            ma_uint32 runStart = 0;
+            ma_uint32 iBlock = 0;
+
+            if (blocksNeeded <= blockCount - pResourceManager->streamPagePoolBlocksInUse) {
+                while (iBlock < blockCount) {
+                    if (pBlocks[iBlock] != 0) {
+                        iBlock  += pBlocks[iBlock];  /* Skip over the whole allocation. */
+                        runStart = iBlock;
+                        continue;
+                    }
+
+                    iBlock += 1;
+
+                    if (iBlock - runStart == blocksNeeded) {
+                        ma_uint32 iRunBlock;
+
+                        pBlocks[runStart] = (ma_uint32)blocksNeeded;
+                        for (iRunBlock = runStart + 1; iRunBlock < iBlock; iRunBlock += 1) {
+                            pBlocks[iRunBlock] = 0xFFFFFFFF;
+                        }
+
+                        pResourceManager->streamPagePoolBlocksInUse += (ma_uint32)blocksNeeded;
+                        pPage = ma_offset_ptr(pResourceManager->pStreamPagePool, (size_t)runStart * MA_RESOURCE_MANAGER_STREAM_PAGE_POOL_BLOCK_SIZE);
+                        break;
+                    }
+                }
+            }
+        }
+        ma_spinlock_unlock(&pResourceManager->streamPagePoolLock);
+
+        if (pPage != NULL) {
+            return pPage;
+        }
+
+        ma_atomic_fetch_add_64(&pResourceManager->streamPagePoolFallbacks, 1);
+    }
+
+    pPage = ma_malloc(sizeInBytes, &pResourceManager->config.allocationCallbacks);
+    if (pPage != NULL) {
+        ma_atomic_fetch_add_64(&pResourceManager->streamPageHeapSizeInBytes, sizeInBytes);
+    }
+
+    return pPage;
+}
+
+static void ma_resource_manager_stream_page_free(ma_resource_manager* pResourceManager, void* pPage, size_t sizeInBytes)
+{
+    size_t poolSizeInBytes = (size_t)pResourceManager->streamPagePoolBlockCount * MA_RESOURCE_MANAGER_STREAM_PAGE_POOL_BLOCK_SIZE;
+
+    if (pPage == NULL) {
+        return;
+    }
+
+    if (pResourceManager->pStreamPagePool != NULL && (ma_uint8*)pPage >= (ma_uint8*)pResourceManager->pStreamPagePool && (ma_uint8*)pPage < (ma_uint8*)pResourceManager->pStreamPagePool + poolSizeInBytes) {
+        ma_uint32 firstBlock = (ma_uint32)(((ma_uint8*)pPage - (ma_uint8*)pResourceManager->pStreamPagePool) / MA_RESOURCE_MANAGER_STREAM_PAGE_POOL_BLOCK_SIZE);
+
+        ma_spinlock_lock(&pResourceManager->streamPagePoolLock);
+        {
+            ma_uint32 blockCount = pResourceManager->pStreamPagePoolBlocks[firstBlock];
+
+            MA_ZERO_MEMORY(pResourceManager->pStreamPagePoolBlocks + firstBlock, blockCount * sizeof(ma_uint32));
+            pResourceManager->streamPagePoolBlocksInUse -= blockCount;
+        }
+        ma_spinlock_unlock(&pResourceManager->streamPagePoolLock);
+    } else {
+        ma_free(pPage, &pResourceManager->config.allocationCallbacks);
+        ma_atomic_fetch_sub_64(&pResourceManager->streamPageHeapSizeInBytes, sizeInBytes);
+    }
+}
+
 MA_API ma_resource_manager_config ma_resource_manager_config_init(void)
 {
     ma_resource_manager_config config;
@@ -58463,6 +59419,11 @@ MA_API ma_resource_manager_config ma_resource_manager_config_init(void)
     config.decodedSampleRate = 0;
     config.jobThreadCount    = 1;   /* A single miniaudio-managed job thread by default. */
     config.jobQueueCapacity  = MA_JOB_TYPE_RESOURCE_MANAGER_QUEUE_CAPACITY;
+    config.streamPageMinSizeInMilliseconds = MA_RESOURCE_MANAGER_PAGE_SIZE_IN_MILLISECONDS;
+    config.streamPageMaxSizeInMilliseconds = MA_RESOURCE_MANAGER_PAGE_SIZE_IN_MILLISECONDS;
+    config.decodeSegmentMinSizeInMilliseconds = MA_RESOURCE_MANAGER_DECODE_SEGMENT_MIN_SIZE_IN_MILLISECONDS;
+    config.mp3SeekPointIntervalInMilliseconds = 0;
+    config.saveMP3SeekTables = MA_FALSE;
     config.resampling        = ma_resampler_config_init(ma_format_unknown, 0, 0, 0, ma_resample_algorithm_linear); /* Format/channels/rate doesn't matter here. */
 
     /* Flags. */
@@ -58482,7 +59443,6 @@ MA_API ma_resource_manager_config ma_resource_manager_config_init(void)
 MA_API ma_result ma_resource_manager_init(const ma_resource_manager_config* pConfig, ma_resource_manager* pResourceManager)
 {
     ma_result result;
-    ma_job_queue_config jobQueueConfig;
 
     if (pResourceManager == NULL) {
         return MA_INVALID_ARGS;
@@ -58541,18 +59501,14 @@ MA_API ma_result ma_resource_manager_init(const ma_resource_manager_config* pCon
         }
     }
 
-    /* Job queue. */
-    jobQueueConfig.capacity = pResourceManager->config.jobQueueCapacity;
-    jobQueueConfig.flags    = 0;
+    /* Job lanes. */
     if ((pResourceManager->config.flags & MA_RESOURCE_MANAGER_FLAG_NON_BLOCKING) != 0) {
         if (pResourceManager->config.jobThreadCount > 0) {
             return MA_INVALID_ARGS; /* Non-blocking mode is only valid for self-managed job threads. */
         }
-
-        jobQueueConfig.flags |= MA_JOB_QUEUE_FLAG_NON_BLOCKING;
     }
 
-    result = ma_job_queue_init(&jobQueueConfig, &pResourceManager->config.allocationCallbacks, &pResourceManager->jobQueue);
+    result = ma_resource_manager_job_lanes_init(pResourceManager);
     if (result != MA_SUCCESS) {
         return result;
     }
@@ -58565,7 +59521,7 @@ MA_API ma_result ma_resource_manager_init(const ma_resource_manager_config* pCon
 
         ppCustomDecodingBackendVTables = (ma_decoding_backend_vtable**)ma_malloc(sizeInBytes, &pResourceManager->config.allocationCallbacks);
         if (pResourceManager->config.ppCustomDecodingBackendVTables == NULL) {
-            ma_job_queue_uninit(&pResourceManager->jobQueue, &pResourceManager->config.allocationCallbacks);
+            ma_resource_manager_job_lanes_uninit(pResourceManager);
             return MA_OUT_OF_MEMORY;
         }
 
@@ -58576,6 +59532,42 @@ MA_API ma_result ma_resource_manager_init(const ma_resource_manager_config* pCon
         pResourceManager->config.pCustomDecodingBackendUserData = pConfig->pCustomDecodingBackendUserData;
     }
 
+    /* Custom decoding backends that can be decoded in segments. */
+    pResourceManager->config.ppSegmentedDecodingBackendVTables = NULL;
+    pResourceManager->config.segmentedDecodingBackendCount     = 0;
+
+    if (pConfig->ppSegmentedDecodingBackendVTables != NULL && pConfig->segmentedDecodingBackendCount > 0) {
+        size_t sizeInBytes = sizeof(*pResourceManager->config.ppSegmentedDecodingBackendVTables) * pConfig->segmentedDecodingBackendCount;
+        ma_decoding_backend_vtable** ppSegmentedDecodingBackendVTables;
+
+        ppSegmentedDecodingBackendVTables = (ma_decoding_backend_vtable**)ma_malloc(sizeInBytes, &pResourceManager->config.allocationCallbacks);
+        if (ppSegmentedDecodingBackendVTables == NULL) {
+            ma_free((ma_decoding_backend_vtable**)pResourceManager->config.ppCustomDecodingBackendVTables, &pResourceManager->config.allocationCallbacks);
+            ma_resource_manager_job_lanes_uninit(pResourceManager);
+            return MA_OUT_OF_MEMORY;
+        }
+
+        MA_COPY_MEMORY(ppSegmentedDecodingBackendVTables, pConfig->ppSegmentedDecodingBackendVTables, sizeInBytes);
+
+        pResourceManager->config.ppSegmentedDecodingBackendVTables = ppSegmentedDecodingBackendVTables;
+        pResourceManager->config.segmentedDecodingBackendCount     = pConfig->segmentedDecodingBackendCount;
+    }
+
+    /* Stream pages. */
+    if (pResourceManager->config.streamPageMinSizeInMilliseconds == 0) {
+        pResourceManager->config.streamPageMinSizeInMilliseconds = MA_RESOURCE_MANAGER_PAGE_SIZE_IN_MILLISECONDS;
+    }
+    if (pResourceManager->config.streamPageMaxSizeInMilliseconds < pResourceManager->config.streamPageMinSizeInMilliseconds) {
+        pResourceManager->config.streamPageMaxSizeInMilliseconds = pResourceManager->config.streamPageMinSizeInMilliseconds;
+    }
+
+    result = ma_resource_manager_stream_page_pool_init(pResourceManager);
+    if (result != MA_SUCCESS) {
+        ma_free((ma_decoding_backend_vtable**)pResourceManager->config.ppSegmentedDecodingBackendVTables, &pResourceManager->config.allocationCallbacks);
+        ma_free((ma_decoding_backend_vtable**)pResourceManager->config.ppCustomDecodingBackendVTables, &pResourceManager->config.allocationCallbacks);
+        ma_resource_manager_job_lanes_uninit(pResourceManager);
+        return result;
+    }
 
 
     /* Here is where we initialize our threading stuff. We don't do this if we don't support threading. */
@@ -58587,7 +59579,8 @@ MA_API ma_result ma_resource_manager_init(const ma_resource_manager_config* pCon
             /* Data buffer lock. */
             result = ma_mutex_init(&pResourceManager->dataBufferBSTLock);
             if (result != MA_SUCCESS) {
-                ma_job_queue_uninit(&pResourceManager->jobQueue, &pResourceManager->config.allocationCallbacks);
+                ma_resource_manager_stream_page_pool_uninit(pResourceManager);
+                ma_resource_manager_job_lanes_uninit(pResourceManager);
                 return result;
             }
 
@@ -58596,7 +59589,8 @@ MA_API ma_result ma_resource_manager_init(const ma_resource_manager_config* pCon
                 result = ma_thread_create(&pResourceManager->jobThreads[iJobThread], ma_thread_priority_normal, pResourceManager->config.jobThreadStackSize, ma_resource_manager_job_thread, pResourceManager, &pResourceManager->config.allocationCallbacks);
                 if (result != MA_SUCCESS) {
                     ma_mutex_uninit(&pResourceManager->dataBufferBSTLock);
-                    ma_job_queue_uninit(&pResourceManager->jobQueue, &pResourceManager->config.allocationCallbacks);
+                    ma_resource_manager_stream_page_pool_uninit(pResourceManager);
+                    ma_resource_manager_job_lanes_uninit(pResourceManager);
                     return result;
                 }
             }
@@ -58615,15 +59609,30 @@ MA_API ma_result ma_resource_manager_init(const ma_resource_manager_config* pCon
 
 static void ma_resource_manager_delete_all_data_buffer_nodes(ma_resource_manager* pResourceManager)
 {
+    ma_resource_manager_data_buffer_node_table* pTable;
+    ma_uint32 iSlot;
+
     MA_ASSERT(pResourceManager);
 
+    pTable = (ma_resource_manager_data_buffer_node_table*)ma_atomic_exchange_ptr(&pResourceManager->pDataBufferNodeTable, NULL);
+    if (pTable == NULL) {
+        return;
+    }
+
     /* If everything was done properly, there shouldn't be any active data buffers. */
-    while (pResourceManager->pRootDataBufferNode != NULL) {
-        ma_resource_manager_data_buffer_node* pDataBufferNode = pResourceManager->pRootDataBufferNode;
-        ma_resource_manager_data_buffer_node_remove(pResourceManager, pDataBufferNode);
+    for (iSlot = 0; iSlot < pTable->capacity; iSlot += 1) {
+        ma_resource_manager_data_buffer_node* pDataBufferNode = (ma_resource_manager_data_buffer_node*)ma_atomic_load_ptr(&pTable->pSlots[iSlot].pNode);
+        if (pDataBufferNode != NULL) {
+            /* The table has already been detached, so we can free the node's data straight away. */
+            ma_resource_manager_data_buffer_node_free(pResourceManager, pDataBufferNode);
+        }
+    }
 
-        /* The data buffer has been removed from the BST, so now we need to free its data. */
-        ma_resource_manager_data_buffer_node_free(pResourceManager, pDataBufferNode);
+    /* Replaced tables only point at nodes that are either in the current table or already freed. */
+    while (pTable != NULL) {
+        ma_resource_manager_data_buffer_node_table* pRetiredTable = (ma_resource_manager_data_buffer_node_table*)pTable->pRetiredNext;
+        ma_free(pTable, &pResourceManager->config.allocationCallbacks);
+        pTable = pRetiredTable;
     }
 }
 
@@ -58659,8 +59668,18 @@ MA_API void ma_resource_manager_uninit(ma_resource_manager* pResourceManager)
     /* At this point the thread should have returned and no other thread should be accessing our data. We can now delete all data buffers. */
     ma_resource_manager_delete_all_data_buffer_nodes(pResourceManager);
 
-    /* The job queue is no longer needed. */
-    ma_job_queue_uninit(&pResourceManager->jobQueue, &pResourceManager->config.allocationCallbacks);
+    /* The job lanes are no longer needed. */
+    ma_resource_manager_job_lanes_uninit(pResourceManager);
+
+    /* Every data stream has been uninitialized so none of their pages are left in the pool. */
+    ma_resource_manager_stream_page_pool_uninit(pResourceManager);
+
+    /* No decoder is left to reference the seek tables. */
+    #ifdef MA_HAS_MP3
+    {
+        ma_resource_manager_mp3_seek_table_free_all(pResourceManager);
+    }
+    #endif
 
     /* We're no longer doing anything with data buffers so the lock can now be uninitialized. */
     if (ma_resource_manager_is_threading_enabled(pResourceManager)) {
@@ -58676,6 +59695,7 @@ MA_API void ma_resource_manager_uninit(ma_resource_manager* pResourceManager)
     }
 
     ma_free((ma_decoding_backend_vtable**)pResourceManager->config.ppCustomDecodingBackendVTables, &pResourceManager->config.allocationCallbacks);  /* <-- Naughty const-cast, but this is safe. */
+    ma_free((ma_decoding_backend_vtable**)pResourceManager->config.ppSegmentedDecodingBackendVTables, &pResourceManager->config.allocationCallbacks);
 
     if (pResourceManager->config.pLog == &pResourceManager->log) {
         ma_log_uninit(&pResourceManager->log);
@@ -58691,6 +59711,80 @@ MA_API ma_log* ma_resource_manager_get_log(ma_resource_manager* pResourceManager
     return pResourceManager->config.pLog;
 }
 
+MA_API ma_result ma_resource_manager_set_cache_budget(ma_resource_manager* pResourceManager, ma_uint64 budgetInBytes)
+{
+    ma_resource_manager_data_buffer_node* pEvicted;
+
+    if (pResourceManager == NULL) {
+        return MA_INVALID_ARGS;
+    }
+
+    ma_resource_manager_data_buffer_bst_lock(pResourceManager);
+    {
+        pResourceManager->config.cacheBudgetInBytes = budgetInBytes;
+        pEvicted = ma_resource_manager_cache_evict(pResourceManager);
+    }
+    ma_resource_manager_data_buffer_bst_unlock(pResourceManager);
+
+    ma_resource_manager_cache_free(pResourceManager, pEvicted);
+
+    return MA_SUCCESS;
+}
+
+MA_API ma_result ma_resource_manager_get_cache_stats(ma_resource_manager* pResourceManager, ma_resource_manager_cache_stats* pStats)
+{
+    if (pStats == NULL) {
+        return MA_INVALID_ARGS;
+    }
+
+    MA_ZERO_OBJECT(pStats);
+
+    if (pResourceManager == NULL) {
+        return MA_INVALID_ARGS;
+    }
+
+    ma_resource_manager_data_buffer_bst_lock(pResourceManager);
+    {
+        pStats->budgetInBytes     = pResourceManager->config.cacheBudgetInBytes;
+        pStats->cachedSizeInBytes = pResourceManager->cachedSizeInBytes;
+        pStats->cachedCount       = pResourceManager->cachedNodeCount;
+    }
+    ma_resource_manager_data_buffer_bst_unlock(pResourceManager);
+
+    pStats->decodedSizeInBytes = ma_atomic_load_64(&pResourceManager->decodedSizeInBytes);
+    pStats->hits               = ma_atomic_load_64(&pResourceManager->cacheHits);
+    pStats->misses             = ma_atomic_load_64(&pResourceManager->cacheMisses);
+    pStats->evictions          = ma_atomic_load_64(&pResourceManager->cacheEvictions);
+
+    return MA_SUCCESS;
+}
+
+MA_API ma_result ma_resource_manager_get_stream_stats(ma_resource_manager* pResourceManager, ma_resource_manager_stream_stats* pStats)
+{
+    if (pStats == NULL) {
+        return MA_INVALID_ARGS;
+    }
+
+    MA_ZERO_OBJECT(pStats);
+
+    if (pResourceManager == NULL) {
+        return MA_INVALID_ARGS;
+    }
+
+    ma_spinlock_lock(&pResourceManager->streamPagePoolLock);
+    {
+        pStats->poolSizeInBytes = (ma_uint64)pResourceManager->streamPagePoolBlockCount  * MA_RESOURCE_MANAGER_STREAM_PAGE_POOL_BLOCK_SIZE;
+        pStats->poolUsedInBytes = (ma_uint64)pResourceManager->streamPagePoolBlocksInUse * MA_RESOURCE_MANAGER_STREAM_PAGE_POOL_BLOCK_SIZE;
+    }
+    ma_spinlock_unlock(&pResourceManager->streamPagePoolLock);
+
+    pStats->heapSizeInBytes = ma_atomic_load_64(&pResourceManager->streamPageHeapSizeInBytes);
+    pStats->poolFallbacks   = ma_atomic_load_64(&pResourceManager->streamPagePoolFallbacks);
+    pStats->starvations     = ma_atomic_load_64(&pResourceManager->streamStarvations);
+
+    return MA_SUCCESS;
+}
+
 
 
 MA_API ma_resource_manager_data_source_config ma_resource_manager_data_source_config_init(void)
@@ -58749,6 +59843,8 @@ static ma_result ma_resource_manager__init_decoder(ma_resource_manager* pResourc
         }
     }
 
+    ma_resource_manager_bind_mp3_seek_table(pResourceManager, pFilePath, pFilePathW, MA_TRUE, pDecoder);
+
     return MA_SUCCESS;
 }
 
@@ -58804,6 +59900,9 @@ static ma_result ma_resource_manager_data_buffer_init_connector(ma_resource_mana
             ma_decoder_config config;
             config = ma_resource_manager__init_decoder_config(pDataBuffer->pResourceManager);
             result = ma_decoder_init_memory(pDataBuffer->pNode->data.backend.encoded.pData, pDataBuffer->pNode->data.backend.encoded.sizeInBytes, &config, &pDataBuffer->connector.decoder);
+            if (result == MA_SUCCESS) {
+                ma_resource_manager_bind_mp3_seek_table(pDataBuffer->pResourceManager, pDataBuffer->pNode->pName, pDataBuffer->pNode->pNameW, pDataBuffer->pNode->isDataOwnedByResourceManager, &pDataBuffer->connector.decoder);
+            }
         } break;
 
         case ma_resource_manager_data_supply_type_decoded:          /* Connector is an audio buffer. */
@@ -59011,6 +60110,7 @@ static ma_result ma_resource_manager_data_buffer_node_init_supply_decoded(ma_res
         pDataBufferNode->data.backend.decoded.channels          = pDecoder->outputChannels;
         pDataBufferNode->data.backend.decoded.sampleRate        = pDecoder->outputSampleRate;
         pDataBufferNode->data.backend.decoded.decodedFrameCount = 0;
+        ma_resource_manager_data_buffer_node_track_decoded(pResourceManager, pDataBufferNode);
         ma_resource_manager_data_buffer_node_set_data_supply_type(pDataBufferNode, ma_resource_manager_data_supply_type_decoded);  /* <-- Must be set last. */
     } else {
         /*
@@ -59060,9 +60160,13 @@ static ma_result ma_resource_manager_data_buffer_node_decode_next_page(ma_resour
     {
         case ma_resource_manager_data_supply_type_decoded:
         {
-            /* The destination buffer is an offset to the existing buffer. Don't read more than we originally retrieved when we first initialized the decoder. */
+            /*
+            The destination buffer is an offset to the existing buffer. Don't read more than we originally retrieved when we first initialized the decoder. When
+            decoding is split into segments this decoder only decodes the first one.
+            */
             void* pDst;
-            ma_uint64 framesRemaining = pDataBufferNode->data.backend.decoded.totalFrameCount - pDataBufferNode->data.backend.decoded.decodedFrameCount;
+            ma_uint64 frameLimit = (pDataBufferNode->firstSegmentSizeInFrames > 0) ? pDataBufferNode->firstSegmentSizeInFrames : pDataBufferNode->data.backend.decoded.totalFrameCount;
+            ma_uint64 framesRemaining = frameLimit - pDataBufferNode->data.backend.decoded.decodedFrameCount;
             if (framesToTryReading > framesRemaining) {
                 framesToTryReading = framesRemaining;
             }
@@ -59076,7 +60180,8 @@ static ma_result ma_resource_manager_data_buffer_node_decode_next_page(ma_resour
 
                 result = ma_decoder_read_pcm_frames(pDecoder, pDst, framesToTryReading, &framesRead);
                 if (framesRead > 0) {
-                    pDataBufferNode->data.backend.decoded.decodedFrameCount += framesRead;
+                    /* Published atomically because data buffers read up to it while the node is still decoding. */
+                    ma_atomic_fetch_add_64(&pDataBufferNode->data.backend.decoded.decodedFrameCount, framesRead);
                 }
             } else {
                 framesRead = 0;
@@ -59129,26 +60234,244 @@ static ma_result ma_resource_manager_data_buffer_node_decode_next_page(ma_resour
     return result;
 }
 
-static ma_result ma_resource_manager_data_buffer_node_acquire_critical_section(ma_resource_manager* pResourceManager, const char* pFilePath, const wchar_t* pFilePathW, ma_uint32 hashedName32, ma_uint32 flags, const ma_resource_manager_data_supply* pExistingData, ma_fence* pInitFence, ma_fence* pDoneFence, ma_resource_manager_inline_notification* pInitNotification, ma_resource_manager_data_buffer_node** ppDataBufferNode)
+/*
+Seeking needs to be cheap and exact for a segment to start decoding in the middle of a file. ADPCM WAV
+files, MP3 files without a seek table and custom backends that aren't listed in the config are all
+decoded from start to finish instead.
+*/
+static ma_bool32 ma_resource_manager_decoder_seeks_cheaply(ma_resource_manager* pResourceManager, const ma_decoder* pDecoder)
+{
+    ma_uint32 iBackend;
+
+    /* Resampling is stateful, so a segment would not continue exactly where the previous one ended. */
+    if (pDecoder->converter.hasResampler) {
+        return MA_FALSE;
+    }
+
+#ifdef MA_HAS_WAV
+    if (pDecoder->pBackendVTable == &g_ma_decoding_backend_vtable_wav) {
+        ma_uint16 formatTag = ((const ma_wav*)pDecoder->pBackend)->dr.translatedFormatTag;
+        return formatTag == MA_DR_WAVE_FORMAT_PCM || formatTag == MA_DR_WAVE_FORMAT_IEEE_FLOAT || formatTag == MA_DR_WAVE_FORMAT_ALAW || formatTag == MA_DR_WAVE_FORMAT_MULAW;
+    }
+#endif
+#ifdef MA_HAS_FLAC
+    if (pDecoder->pBackendVTable == &g_ma_decoding_backend_vtable_flac) {
+        return MA_TRUE;
+    }
+#endif
+#ifdef MA_HAS_MP3
+    if (pDecoder->pBackendVTable == &g_ma_decoding_backend_vtable_mp3) {
+        return ((const ma_mp3*)pDecoder->pBackend)->seekPointCount > 0;
+    }
+#endif
+
+    for (iBackend = 0; iBackend < pResourceManager->config.segmentedDecodingBackendCount; iBackend += 1) {
+        if (pDecoder->pBackendVTable == pResourceManager->config.ppSegmentedDecodingBackendVTables[iBackend]) {
+            return MA_TRUE;
+        }
+    }
+
+    return MA_FALSE;
+}
+
+/* Returns the number of segments a decoded node is split into. 1 means it is decoded from start to finish. */
+static ma_uint32 ma_resource_manager_data_buffer_node_get_segment_count(ma_resource_manager* pResourceManager, ma_resource_manager_data_buffer_node* pDataBufferNode, const ma_decoder* pDecoder, ma_bool32 isLoadingThreadDecoding)
+{
+    ma_uint64 minSegmentSizeInFrames;
+    ma_uint64 segmentCount;
+    ma_uint32 maxSegmentCount;
+
+    if (pResourceManager->config.decodeSegmentMinSizeInMilliseconds == 0 || ma_resource_manager_is_threading_enabled(pResourceManager) == MA_FALSE || pResourceManager->config.jobThreadCount == 0) {
+        return 1;
+    }
+
+    /* Only a buffer of a known length can be split, and every segment opens the file again by its name. */
+    if (ma_resource_manager_data_buffer_node_get_data_supply_type(pDataBufferNode) != ma_resource_manager_data_supply_type_decoded || (pDataBufferNode->pName == NULL && pDataBufferNode->pNameW == NULL)) {
+        return 1;
+    }
+
+    if (ma_resource_manager_decoder_seeks_cheaply(pResourceManager, pDecoder) == MA_FALSE) {
+        return 1;
+    }
+
+    /* A thread decoding synchronously takes the first segment itself, so one more segment keeps every thread busy. */
+    maxSegmentCount = pResourceManager->config.jobThreadCount + (isLoadingThreadDecoding ? 1 : 0);
+
+    /* Finished segments are tracked with one bit each in segmentsDoneMask. */
+    if (maxSegmentCount > 64) {
+        maxSegmentCount = 64;
+    }
+
+    minSegmentSizeInFrames = (ma_uint64)pResourceManager->config.decodeSegmentMinSizeInMilliseconds * pDataBufferNode->data.backend.decoded.sampleRate / 1000;
+    if (minSegmentSizeInFrames == 0) {
+        minSegmentSizeInFrames = 1;
+    }
+
+    segmentCount = pDataBufferNode->data.backend.decoded.totalFrameCount / minSegmentSizeInFrames;
+    if (segmentCount > maxSegmentCount) {
+        segmentCount = maxSegmentCount;
+    }
+    if (segmentCount < 1) {
+        segmentCount = 1;
+    }
+
+    return (ma_uint32)segmentCount;
+}
+
+/* Sets up the segment fields. Must be done before any segment can start decoding. */
+static void ma_resource_manager_data_buffer_node_init_segments(ma_resource_manager_data_buffer_node* pDataBufferNode, ma_uint32 segmentCount)
+{
+    MA_ASSERT(segmentCount > 1 && segmentCount <= 64);
+
+    pDataBufferNode->firstSegmentSizeInFrames = pDataBufferNode->data.backend.decoded.totalFrameCount / segmentCount;
+    pDataBufferNode->segmentCount             = segmentCount;
+    ma_atomic_exchange_64(&pDataBufferNode->segmentsDoneMask, 0);
+    ma_atomic_exchange_32(&pDataBufferNode->segmentsRemaining, segmentCount);
+    ma_atomic_exchange_i32(&pDataBufferNode->segmentResult, MA_SUCCESS);
+}
+
+/*
+Publishes the end of the segments that have finished without a gap before them as the decoded frame count.
+Segments finish in any order so this is done with a compare and swap that never moves the count backwards.
+*/
+static void ma_resource_manager_data_buffer_node_publish_segments(ma_resource_manager_data_buffer_node* pDataBufferNode, ma_uint64 doneMask)
+{
+    ma_uint32 finishedSegmentCount = 0;
+    ma_uint64 decodedFrameCount;
+    ma_uint64 oldDecodedFrameCount;
+
+    while (finishedSegmentCount < pDataBufferNode->segmentCount && (doneMask & ((ma_uint64)1 << finishedSegmentCount)) != 0) {
+        finishedSegmentCount += 1;
+    }
+
+    if (finishedSegmentCount == 0) {
+        return; /* The first segment publishes its own progress while it decodes. */
+    }
+
+    if (finishedSegmentCount == pDataBufferNode->segmentCount) {
+        decodedFrameCount = pDataBufferNode->data.backend.decoded.totalFrameCount;
+    } else {
+        decodedFrameCount = pDataBufferNode->firstSegmentSizeInFrames * finishedSegmentCount;
+    }
+
+    oldDecodedFrameCount = ma_atomic_load_64(&pDataBufferNode->data.backend.decoded.decodedFrameCount);
+    while (oldDecodedFrameCount < decodedFrameCount) {
+        if (ma_atomic_compare_exchange_weak_64(&pDataBufferNode->data.backend.decoded.decodedFrameCount, &oldDecodedFrameCount, decodedFrameCount)) {
+            break;
+        }
+    }
+}
+
+/* Returns true for the last segment to finish, which is the one that has to finish the node. */
+static ma_bool32 ma_resource_manager_data_buffer_node_segment_done(ma_resource_manager_data_buffer_node* pDataBufferNode, ma_uint32 iSegment, ma_result result)
+{
+    MA_ASSERT(iSegment < pDataBufferNode->segmentCount);
+
+    if (result != MA_SUCCESS && result != MA_AT_END) {
+        ma_atomic_compare_and_swap_i32(&pDataBufferNode->segmentResult, MA_SUCCESS, result);
+    } else {
+        ma_uint64 segmentBit = (ma_uint64)1 << iSegment;
+        ma_resource_manager_data_buffer_node_publish_segments(pDataBufferNode, ma_atomic_fetch_or_64(&pDataBufferNode->segmentsDoneMask, segmentBit) | segmentBit);
+    }
+
+    return ma_atomic_fetch_sub_32(&pDataBufferNode->segmentsRemaining, 1) == 1;
+}
+
+/* Returns the result of decoding every segment. Must only be called by the last segment to finish. */
+static ma_result ma_resource_manager_data_buffer_node_segments_result(ma_resource_manager_data_buffer_node* pDataBufferNode)
+{
+    /* On success every segment has been published so the decoded frame count is already the total. */
+    return (ma_result)ma_atomic_load_i32(&pDataBufferNode->segmentResult);
+}
+
+/* Finishes a node that was loaded asynchronously the same way the last PAGE_DATA_BUFFER_NODE job does when decoding is not split. */
+static void ma_resource_manager_data_buffer_node_finish_segments(ma_resource_manager* pResourceManager, ma_resource_manager_data_buffer_node* pDataBufferNode, ma_async_notification* pDoneNotification, ma_fence* pDoneFence)
+{
+    ma_result result = ma_resource_manager_data_buffer_node_segments_result(pDataBufferNode);
+
+    ma_atomic_compare_and_swap_i32(&pDataBufferNode->result, MA_BUSY, result);
+
+    if (result == MA_SUCCESS) {
+        ma_resource_manager_cache_trim(pResourceManager);
+    }
+
+    if (pDoneNotification != NULL) {
+        ma_async_notification_signal(pDoneNotification);
+    }
+
+    if (pDoneFence != NULL) {
+        ma_fence_release(pDoneFence);
+    }
+
+    /* Nothing can free the node before this point because the FREE_DATA_BUFFER_NODE job waits for it. */
+    ma_atomic_fetch_add_32(&pDataBufferNode->executionPointer, 1);
+}
+
+/*
+Splits decoding of the node into segments. The caller keeps decoding the first segment with page jobs
+or, when loading synchronously, on its own thread. Every other segment is decoded by a
+DECODE_DATA_BUFFER_NODE_SEGMENT job straight into the buffer at its own offset. The node is finished by
+whichever segment is done last.
+*/
+static void ma_resource_manager_data_buffer_node_post_segments(ma_resource_manager* pResourceManager, ma_resource_manager_data_buffer_node* pDataBufferNode, ma_uint32 segmentCount, ma_uint32 flags, ma_async_notification* pDoneNotification, ma_fence* pDoneFence)
+{
+    ma_uint64 segmentSizeInFrames;
+    ma_uint32 iSegment;
+
+    MA_ASSERT(segmentCount > 1);
+
+    segmentSizeInFrames = pDataBufferNode->data.backend.decoded.totalFrameCount / segmentCount;
+
+    for (iSegment = 1; iSegment < segmentCount; iSegment += 1) {
+        ma_result result;
+        ma_job job;
+
+        job = ma_job_init(MA_JOB_TYPE_RESOURCE_MANAGER_DECODE_DATA_BUFFER_NODE_SEGMENT);
+        job.data.resourceManager.decodeDataBufferNodeSegment.pResourceManager  = pResourceManager;
+        job.data.resourceManager.decodeDataBufferNodeSegment.pDataBufferNode   = pDataBufferNode;
+        job.data.resourceManager.decodeDataBufferNodeSegment.pDecoder          = NULL;
+        job.data.resourceManager.decodeDataBufferNodeSegment.frameIndex        = segmentSizeInFrames * iSegment;
+        job.data.resourceManager.decodeDataBufferNodeSegment.endFrameIndex     = (iSegment + 1 < segmentCount) ? segmentSizeInFrames * (iSegment + 1) : pDataBufferNode->data.backend.decoded.totalFrameCount;
+        job.data.resourceManager.decodeDataBufferNodeSegment.segmentIndex      = iSegment;
+        job.data.resourceManager.decodeDataBufferNodeSegment.pDoneNotification = pDoneNotification;
+        job.data.resourceManager.decodeDataBufferNodeSegment.pDoneFence        = pDoneFence;
+        job.data.resourceManager.decodeDataBufferNodeSegment.flags             = flags;
+
+        result = ma_resource_manager_post_job(pResourceManager, &job);
+        if (result != MA_SUCCESS) {
+            /*
+            The segment will never be decoded. This can't be the last segment because the first one
+            is only decoded after this returns, either by the caller or by paging jobs that are held
+            back by the execution pointer until the LOAD_DATA_BUFFER_NODE job has finished.
+            */
+            ma_log_postf(ma_resource_manager_get_log(pResourceManager), MA_LOG_LEVEL_ERROR, "Failed to post MA_JOB_TYPE_RESOURCE_MANAGER_DECODE_DATA_BUFFER_NODE_SEGMENT job. %s\n", ma_result_description(result));
+            ma_resource_manager_data_buffer_node_segment_done(pDataBufferNode, iSegment, result);
+        }
+    }
+}
+
+static ma_result ma_resource_manager_data_buffer_node_acquire_critical_section(ma_resource_manager* pResourceManager, const char* pFilePath, const wchar_t* pFilePathW, ma_uint64 hashedName64, ma_uint32 flags, const ma_resource_manager_data_supply* pExistingData, ma_fence* pInitFence, ma_fence* pDoneFence, ma_resource_manager_inline_notification* pInitNotification, ma_resource_manager_data_buffer_node** ppDataBufferNode)
 {
     ma_result result = MA_SUCCESS;
     ma_resource_manager_data_buffer_node* pDataBufferNode = NULL;
-    ma_resource_manager_data_buffer_node* pInsertPoint;
 
     if (ppDataBufferNode != NULL) {
         *ppDataBufferNode = NULL;
     }
 
-    result = ma_resource_manager_data_buffer_node_insert_point(pResourceManager, hashedName32, &pInsertPoint);
-    if (result == MA_ALREADY_EXISTS) {
+    result = ma_resource_manager_data_buffer_node_search(pResourceManager, hashedName64, pFilePath, pFilePathW, &pDataBufferNode);
+    if (result == MA_SUCCESS) {
         /* The node already exists. We just need to increment the reference count. */
-        pDataBufferNode = pInsertPoint;
-
         result = ma_resource_manager_data_buffer_node_increment_ref(pResourceManager, pDataBufferNode, NULL);
         if (result != MA_SUCCESS) {
             return result;  /* Should never happen. Failed to increment the reference count. */
         }
 
+        /* Registering data under a name that is already in use is not a lookup. */
+        if (pExistingData == NULL) {
+            ma_atomic_fetch_add_64(&pResourceManager->cacheHits, 1);
+        }
+
         result = MA_ALREADY_EXISTS;
         goto done;
     } else {
@@ -59157,16 +60480,36 @@ static ma_result ma_resource_manager_data_buffer_node_acquire_critical_section(m
         needs to be done inside the critical section to ensure an uninitialization of the node
         does not occur before initialization on another thread.
         */
-        pDataBufferNode = (ma_resource_manager_data_buffer_node*)ma_malloc(sizeof(*pDataBufferNode), &pResourceManager->config.allocationCallbacks);
+        size_t nameSizeInBytes = 0;
+
+        /* The name is stored after the node so it can be verified on lookup without another allocation. */
+        if (pFilePath != NULL) {
+            nameSizeInBytes = strlen(pFilePath) + 1;
+        } else if (pFilePathW != NULL) {
+            nameSizeInBytes = (ma_wcslen(pFilePathW) + 1) * sizeof(*pFilePathW);
+        }
+
+        pDataBufferNode = (ma_resource_manager_data_buffer_node*)ma_malloc(sizeof(*pDataBufferNode) + nameSizeInBytes, &pResourceManager->config.allocationCallbacks);
         if (pDataBufferNode == NULL) {
             return MA_OUT_OF_MEMORY;
         }
 
         MA_ZERO_OBJECT(pDataBufferNode);
-        pDataBufferNode->hashedName32 = hashedName32;
+        pDataBufferNode->hashedName64 = hashedName64;
         pDataBufferNode->refCount     = 1;        /* Always set to 1 by default (this is our first reference). */
+        pDataBufferNode->flags        = flags;
+
+        if (pFilePath != NULL) {
+            MA_COPY_MEMORY(ma_offset_ptr(pDataBufferNode, sizeof(*pDataBufferNode)), pFilePath, nameSizeInBytes);
+            pDataBufferNode->pName  = (const char*)ma_offset_ptr(pDataBufferNode, sizeof(*pDataBufferNode));
+        } else if (pFilePathW != NULL) {
+            MA_COPY_MEMORY(ma_offset_ptr(pDataBufferNode, sizeof(*pDataBufferNode)), pFilePathW, nameSizeInBytes);
+            pDataBufferNode->pNameW = (const wchar_t*)ma_offset_ptr(pDataBufferNode, sizeof(*pDataBufferNode));
+        }
 
         if (pExistingData == NULL) {
+            ma_atomic_fetch_add_64(&pResourceManager->cacheMisses, 1);
+
             pDataBufferNode->data.type    = ma_resource_manager_data_supply_type_unknown;    /* <-- We won't know this until we start decoding. */
             pDataBufferNode->result       = MA_BUSY;  /* Must be set to MA_BUSY before we leave the critical section, so might as well do it now. */
             pDataBufferNode->isDataOwnedByResourceManager = MA_TRUE;
@@ -59176,10 +60519,10 @@ static ma_result ma_resource_manager_data_buffer_node_acquire_critical_section(m
             pDataBufferNode->isDataOwnedByResourceManager = MA_FALSE;
         }
 
-        result = ma_resource_manager_data_buffer_node_insert_at(pResourceManager, pDataBufferNode, pInsertPoint);
+        result = ma_resource_manager_data_buffer_node_insert(pResourceManager, pDataBufferNode);
         if (result != MA_SUCCESS) {
             ma_free(pDataBufferNode, &pResourceManager->config.allocationCallbacks);
-            return result;  /* Should never happen. Failed to insert the data buffer into the BST. */
+            return result;  /* Failed to grow the table. */
         }
 
         /*
@@ -59202,6 +60545,7 @@ static ma_result ma_resource_manager_data_buffer_node_acquire_critical_section(m
 
             if (pFilePathCopy == NULL && pFilePathWCopy == NULL) {
                 ma_resource_manager_data_buffer_node_remove(pResourceManager, pDataBufferNode);
+                ma_resource_manager_data_buffer_node_wait_for_readers(pResourceManager);
                 ma_free(pDataBufferNode, &pResourceManager->config.allocationCallbacks);
                 return MA_OUT_OF_MEMORY;
             }
@@ -59256,6 +60600,7 @@ static ma_result ma_resource_manager_data_buffer_node_acquire_critical_section(m
                 }
 
                 ma_resource_manager_data_buffer_node_remove(pResourceManager, pDataBufferNode);
+                ma_resource_manager_data_buffer_node_wait_for_readers(pResourceManager);
                 ma_free(pDataBufferNode, &pResourceManager->config.allocationCallbacks);
 
                 return result;
@@ -59271,7 +60616,7 @@ done:
     return result;
 }
 
-static ma_result ma_resource_manager_data_buffer_node_acquire(ma_resource_manager* pResourceManager, const char* pFilePath, const wchar_t* pFilePathW, ma_uint32 hashedName32, ma_uint32 flags, const ma_resource_manager_data_supply* pExistingData, ma_fence* pInitFence, ma_fence* pDoneFence, ma_resource_manager_data_buffer_node** ppDataBufferNode)
+static ma_result ma_resource_manager_data_buffer_node_acquire(ma_resource_manager* pResourceManager, const char* pFilePath, const wchar_t* pFilePathW, ma_uint64 hashedName64, ma_uint32 flags, const ma_resource_manager_data_supply* pExistingData, ma_fence* pInitFence, ma_fence* pDoneFence, ma_resource_manager_data_buffer_node** ppDataBufferNode)
 {
     ma_result result = MA_SUCCESS;
     ma_bool32 nodeAlreadyExists = MA_FALSE;
@@ -59282,7 +60627,7 @@ static ma_result ma_resource_manager_data_buffer_node_acquire(ma_resource_manage
         *ppDataBufferNode = NULL;   /* Safety. */
     }
 
-    if (pResourceManager == NULL || (pFilePath == NULL && pFilePathW == NULL && hashedName32 == 0)) {
+    if (pResourceManager == NULL || (pFilePath == NULL && pFilePathW == NULL && hashedName64 == 0)) {
         return MA_INVALID_ARGS;
     }
 
@@ -59296,26 +60641,40 @@ static ma_result ma_resource_manager_data_buffer_node_acquire(ma_resource_manage
         flags &= ~MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_ASYNC;
     }
 
-    if (hashedName32 == 0) {
+    if (hashedName64 == 0) {
         if (pFilePath != NULL) {
-            hashedName32 = ma_hash_string_32(pFilePath);
+            hashedName64 = ma_hash_string_64(pFilePath);
         } else {
-            hashedName32 = ma_hash_string_w_32(pFilePathW);
+            hashedName64 = ma_hash_string_w_64(pFilePathW);
         }
     }
 
     /*
-    Here is where we either increment the node's reference count or allocate a new one and add it
-    to the BST. When allocating a new node, we need to make sure the LOAD_DATA_BUFFER_NODE job is
-    posted inside the critical section just in case the caller immediately uninitializes the node
-    as this will ensure the FREE_DATA_BUFFER_NODE job is given an execution order such that the
-    node is not uninitialized before initialization.
+    The common case is a node that has already been loaded. That only needs a reference which can
+    be taken without the lock so it doesn't have to wait on other threads loading or freeing nodes.
     */
-    ma_resource_manager_data_buffer_bst_lock(pResourceManager);
-    {
-        result = ma_resource_manager_data_buffer_node_acquire_critical_section(pResourceManager, pFilePath, pFilePathW, hashedName32, flags, pExistingData, pInitFence, pDoneFence, &initNotification, &pDataBufferNode);
+    pDataBufferNode = ma_resource_manager_data_buffer_node_try_acquire_loaded(pResourceManager, hashedName64, pFilePath, pFilePathW);
+    if (pDataBufferNode != NULL) {
+        result = MA_ALREADY_EXISTS;
+    } else {
+        /*
+        Here is where we either increment the node's reference count or allocate a new one and add
+        it to the table. When allocating a new node, we need to make sure the LOAD_DATA_BUFFER_NODE
+        job is posted inside the critical section just in case the caller immediately uninitializes
+        the node as this will ensure the FREE_DATA_BUFFER_NODE job is given an execution order such
+        that the node is not uninitialized before initialization.
+        */
+        ma_resource_manager_data_buffer_node_table* pRetiredTable;
+
+        ma_resource_manager_data_buffer_bst_lock(pResourceManager);
+        {
+            result = ma_resource_manager_data_buffer_node_acquire_critical_section(pResourceManager, pFilePath, pFilePathW, hashedName64, flags, pExistingData, pInitFence, pDoneFence, &initNotification, &pDataBufferNode);
+            pRetiredTable = ma_resource_manager_data_buffer_node_take_retired_tables(pResourceManager);
+        }
+        ma_resource_manager_data_buffer_bst_unlock(pResourceManager);
+
+        ma_resource_manager_data_buffer_node_free_retired_tables(pResourceManager, pRetiredTable);
     }
-    ma_resource_manager_data_buffer_bst_unlock(pResourceManager);
 
     if (result == MA_ALREADY_EXISTS) {
         nodeAlreadyExists = MA_TRUE;
@@ -59356,11 +60715,29 @@ static ma_result ma_resource_manager_data_buffer_node_acquire(ma_resource_manage
                 } else {
                     /* Decoding. We do this the same way as we do when loading asynchronously. */
                     ma_decoder* pDecoder;
+                    ma_uint32 segmentCount;
+                    ma_resource_manager_inline_notification segmentsNotification;
+
                     result = ma_resource_manager_data_buffer_node_init_supply_decoded(pResourceManager, pDataBufferNode, pFilePath, pFilePathW, flags, &pDecoder);
                     if (result != MA_SUCCESS) {
                         goto done;
                     }
 
+                    /* Long files can have the rest of the file decoded by the job threads while this thread decodes the first segment. */
+                    segmentCount = ma_resource_manager_data_buffer_node_get_segment_count(pResourceManager, pDataBufferNode, pDecoder, MA_TRUE);
+                    if (segmentCount > 1) {
+                        result = ma_resource_manager_inline_notification_init(pResourceManager, &segmentsNotification);
+                        if (result != MA_SUCCESS) {
+                            segmentCount = 1;   /* Just decode the whole file on this thread. */
+                        }
+                    }
+
+                    if (segmentCount > 1) {
+                        ma_resource_manager_data_buffer_node_init_segments(pDataBufferNode, segmentCount);
+
+                        ma_resource_manager_data_buffer_node_post_segments(pResourceManager, pDataBufferNode, segmentCount, flags, (ma_async_notification*)&segmentsNotification, NULL);
+                    }
+
                     /* We have the decoder, now decode page by page just like we do when loading asynchronously. */
                     for (;;) {
                         /* Decode next page. */
@@ -59381,10 +60758,24 @@ static ma_result ma_resource_manager_data_buffer_node_acquire(ma_resource_manage
                     */
                     ma_decoder_uninit(pDecoder);
                     ma_free(pDecoder, &pResourceManager->config.allocationCallbacks);
+
+                    /* The node can't be finished until every other segment has been decoded. */
+                    if (segmentCount > 1) {
+                        if (ma_resource_manager_data_buffer_node_segment_done(pDataBufferNode, 0, result) == MA_FALSE) {
+                            ma_resource_manager_inline_notification_wait(&segmentsNotification);
+                        }
+
+                        ma_resource_manager_inline_notification_uninit(&segmentsNotification);
+                        result = ma_resource_manager_data_buffer_node_segments_result(pDataBufferNode);
+                    }
                 }
 
                 /* Getting here means we were successful. Make sure the status of the node is updated accordingly. */
                 ma_atomic_exchange_i32(&pDataBufferNode->result, result);
+
+                if (result == MA_SUCCESS) {
+                    ma_resource_manager_cache_trim(pResourceManager);
+                }
             } else {
                 /* Loading asynchronously. We may need to wait for initialization. */
                 if ((flags & MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_WAIT_INIT) != 0) {
@@ -59398,17 +60789,9 @@ static ma_result ma_resource_manager_data_buffer_node_acquire(ma_resource_manage
     }
 
 done:
-    /* If we failed to initialize the data buffer we need to free it. */
-    if (result != MA_SUCCESS) {
-        if (nodeAlreadyExists == MA_FALSE) {
-            ma_resource_manager_data_buffer_node_remove(pResourceManager, pDataBufferNode);
-            ma_free(pDataBufferNode, &pResourceManager->config.allocationCallbacks);
-        }
-    }
-
     /*
     The init notification needs to be uninitialized. This will be used if the node does not already
-    exist, and we've specified ASYNC | WAIT_INIT.
+    exist, and we've specified ASYNC | WAIT_INIT. This needs to happen before the node is freed below.
     */
     if (nodeAlreadyExists == MA_FALSE && pDataBufferNode->isDataOwnedByResourceManager && (flags & MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_ASYNC) != 0) {
         if ((flags & MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_WAIT_INIT) != 0) {
@@ -59416,6 +60799,21 @@ done:
         }
     }
 
+    /* If we failed to initialize the data buffer we need to free it. */
+    if (result != MA_SUCCESS) {
+        if (nodeAlreadyExists == MA_FALSE) {
+            ma_resource_manager_data_buffer_bst_lock(pResourceManager);
+            {
+                ma_resource_manager_data_buffer_node_remove(pResourceManager, pDataBufferNode);
+            }
+            ma_resource_manager_data_buffer_bst_unlock(pResourceManager);
+
+            ma_resource_manager_data_buffer_node_wait_for_readers(pResourceManager);
+            ma_free(pDataBufferNode, &pResourceManager->config.allocationCallbacks);
+            pDataBufferNode = NULL;
+        }
+    }
+
     if (ppDataBufferNode != NULL) {
         *ppDataBufferNode = pDataBufferNode;
     }
@@ -59427,7 +60825,8 @@ static ma_result ma_resource_manager_data_buffer_node_unacquire(ma_resource_mana
 {
     ma_result result = MA_SUCCESS;
     ma_uint32 refCount = 0xFFFFFFFF; /* The new reference count of the node after decrementing. Initialize to non-0 to be safe we don't fall into the freeing path. */
-    ma_uint32 hashedName32 = 0;
+    ma_uint64 hashedName64 = 0;
+    ma_resource_manager_data_buffer_node* pEvicted = NULL;
 
     if (pResourceManager == NULL) {
         return MA_INVALID_ARGS;
@@ -59439,9 +60838,9 @@ static ma_result ma_resource_manager_data_buffer_node_unacquire(ma_resource_mana
         }
 
         if (pName != NULL) {
-            hashedName32 = ma_hash_string_32(pName);
+            hashedName64 = ma_hash_string_64(pName);
         } else {
-            hashedName32 = ma_hash_string_w_32(pNameW);
+            hashedName64 = ma_hash_string_w_64(pNameW);
         }
     }
 
@@ -59454,27 +60853,33 @@ static ma_result ma_resource_manager_data_buffer_node_unacquire(ma_resource_mana
     {
         /* Might need to find the node. Must be done inside the critical section. */
         if (pDataBufferNode == NULL) {
-            result = ma_resource_manager_data_buffer_node_search(pResourceManager, hashedName32, &pDataBufferNode);
-            if (result != MA_SUCCESS) {
-                goto stage2;    /* Couldn't find the node. */
+            result = ma_resource_manager_data_buffer_node_search(pResourceManager, hashedName64, pName, pNameW, &pDataBufferNode);
+
+            /* A cached node is not referenced by anything, so it can't be unregistered either. */
+            if (result == MA_SUCCESS && pDataBufferNode->isCached) {
+                result = MA_DOES_NOT_EXIST;
             }
         }
 
-        result = ma_resource_manager_data_buffer_node_decrement_ref(pResourceManager, pDataBufferNode, &refCount);
-        if (result != MA_SUCCESS) {
-            goto stage2;    /* Should never happen. */
+        if (result == MA_SUCCESS) {
+            result = ma_resource_manager_data_buffer_node_decrement_ref(pResourceManager, pDataBufferNode, &refCount);
         }
 
-        if (refCount == 0) {
-            result = ma_resource_manager_data_buffer_node_remove(pResourceManager, pDataBufferNode);
-            if (result != MA_SUCCESS) {
-                goto stage2;  /* An error occurred when trying to remove the data buffer. This should never happen. */
+        if (result == MA_SUCCESS && refCount == 0) {
+            if (ma_resource_manager_cache_can_hold(pResourceManager, pDataBufferNode)) {
+                /* The node stays in the table so the next acquisition picks it up without loading. */
+                ma_resource_manager_cache_link(pResourceManager, pDataBufferNode);
+                pEvicted = ma_resource_manager_cache_evict(pResourceManager);
+                refCount = 0xFFFFFFFF;
+            } else {
+                result = ma_resource_manager_data_buffer_node_remove(pResourceManager, pDataBufferNode);
             }
         }
     }
     ma_resource_manager_data_buffer_bst_unlock(pResourceManager);
 
-stage2:
+    ma_resource_manager_cache_free(pResourceManager, pEvicted);
+
     if (result != MA_SUCCESS) {
         return result;
     }
@@ -59580,7 +60985,7 @@ static ma_data_source_vtable g_ma_resource_manager_data_buffer_vtable =
     0
 };
 
-static ma_result ma_resource_manager_data_buffer_init_ex_internal(ma_resource_manager* pResourceManager, const ma_resource_manager_data_source_config* pConfig, ma_uint32 hashedName32, ma_resource_manager_data_buffer* pDataBuffer)
+static ma_result ma_resource_manager_data_buffer_init_ex_internal(ma_resource_manager* pResourceManager, const ma_resource_manager_data_source_config* pConfig, ma_uint64 hashedName64, ma_resource_manager_data_buffer* pDataBuffer)
 {
     ma_result result = MA_SUCCESS;
     ma_resource_manager_data_buffer_node* pDataBufferNode;
@@ -59636,7 +61041,7 @@ static ma_result ma_resource_manager_data_buffer_init_ex_internal(ma_resource_ma
     ma_resource_manager_pipeline_notifications_acquire_all_fences(&notifications);
     {
         /* We first need to acquire a node. If ASYNC is not set, this will not return until the entire sound has been loaded. */
-        result = ma_resource_manager_data_buffer_node_acquire(pResourceManager, pConfig->pFilePath, pConfig->pFilePathW, hashedName32, flags, NULL, notifications.init.pFence, notifications.done.pFence, &pDataBufferNode);
+        result = ma_resource_manager_data_buffer_node_acquire(pResourceManager, pConfig->pFilePath, pConfig->pFilePathW, hashedName64, flags, NULL, notifications.init.pFence, notifications.done.pFence, &pDataBufferNode);
         if (result != MA_SUCCESS) {
             ma_resource_manager_pipeline_notifications_signal_all_notifications(&notifications);
             goto done;
@@ -59790,10 +61195,13 @@ MA_API ma_result ma_resource_manager_data_buffer_init_copy(ma_resource_manager*
 
     MA_ASSERT(pExistingDataBuffer->pNode != NULL);  /* <-- If you've triggered this, you've passed in an invalid existing data buffer. */
 
+    /* The name is needed to tell the node apart from others with the same key. The existing buffer keeps the node, and therefore the name, alive. */
     config = ma_resource_manager_data_source_config_init();
-    config.flags = pExistingDataBuffer->flags;
+    config.pFilePath  = pExistingDataBuffer->pNode->pName;
+    config.pFilePathW = pExistingDataBuffer->pNode->pNameW;
+    config.flags      = pExistingDataBuffer->flags;
 
-    return ma_resource_manager_data_buffer_init_ex_internal(pResourceManager, &config, pExistingDataBuffer->pNode->hashedName32, pDataBuffer);
+    return ma_resource_manager_data_buffer_init_ex_internal(pResourceManager, &config, pExistingDataBuffer->pNode->hashedName64, pDataBuffer);
 }
 
 static ma_result ma_resource_manager_data_buffer_uninit_internal(ma_resource_manager_data_buffer* pDataBuffer)
@@ -60145,6 +61553,25 @@ MA_API ma_result ma_resource_manager_data_buffer_get_available_frames(ma_resourc
 
         case ma_resource_manager_data_supply_type_decoded:
         {
+            /*
+            While the node is still decoding only the frames that have been published can be read. When decoding is
+            split into segments, a segment is published once every segment before it has finished.
+            */
+            if (ma_resource_manager_data_buffer_node_result(pDataBuffer->pNode) == MA_BUSY) {
+                ma_uint64 cursor;
+                ma_uint64 decodedFrameCount;
+                ma_audio_buffer_get_cursor_in_pcm_frames(&pDataBuffer->connector.buffer, &cursor);
+
+                decodedFrameCount = ma_atomic_load_64(&pDataBuffer->pNode->data.backend.decoded.decodedFrameCount);
+                if (decodedFrameCount > cursor) {
+                    *pAvailableFrames = decodedFrameCount - cursor;
+                } else {
+                    *pAvailableFrames = 0;
+                }
+
+                return MA_SUCCESS;
+            }
+
             return ma_audio_buffer_get_available_frames(&pDataBuffer->connector.buffer, pAvailableFrames);
         };
 
@@ -60516,12 +61943,130 @@ MA_API ma_result ma_resource_manager_data_stream_uninit(ma_resource_manager_data
 }
 
 
-static ma_uint32 ma_resource_manager_data_stream_get_page_size_in_frames(ma_resource_manager_data_stream* pDataStream)
+static ma_uint32 ma_resource_manager_data_stream_milliseconds_to_frames(ma_resource_manager_data_stream* pDataStream, ma_uint32 milliseconds)
 {
+    ma_uint64 frameCount;
+
     MA_ASSERT(pDataStream != NULL);
     MA_ASSERT(pDataStream->isDecoderInitialized == MA_TRUE);
 
-    return MA_RESOURCE_MANAGER_PAGE_SIZE_IN_MILLISECONDS * (pDataStream->decoder.outputSampleRate/1000);
+    frameCount = ((ma_uint64)milliseconds * pDataStream->decoder.outputSampleRate) / 1000;
+    if (frameCount == 0) {
+        frameCount = 1;
+    }
+    if (frameCount > 0x7FFFFFFF) {
+        frameCount = 0x7FFFFFFF;
+    }
+
+    return (ma_uint32)frameCount;
+}
+
+/*
+Picks the page size a stream starts with. Files with a higher bitrate need more I/O per second of
+audio, so they start closer to the largest page to leave more room for a slow disk.
+*/
+static ma_uint32 ma_resource_manager_data_stream_get_initial_page_size_in_frames(ma_resource_manager_data_stream* pDataStream)
+{
+    ma_resource_manager* pResourceManager = pDataStream->pResourceManager;
+    ma_uint32 minPageSizeInFrames = ma_resource_manager_data_stream_milliseconds_to_frames(pDataStream, pResourceManager->config.streamPageMinSizeInMilliseconds);
+    ma_uint32 maxPageSizeInFrames = ma_resource_manager_data_stream_milliseconds_to_frames(pDataStream, pResourceManager->config.streamPageMaxSizeInMilliseconds);
+    ma_file_info fileInfo;
+    ma_uint64 bitrate;
+
+    if (minPageSizeInFrames >= maxPageSizeInFrames) {
+        return minPageSizeInFrames;
+    }
+
+    if (pDataStream->totalLengthInPCMFrames == 0 || ma_vfs_or_default_info(pDataStream->decoder.data.vfs.pVFS, pDataStream->decoder.data.vfs.file, &fileInfo) != MA_SUCCESS) {
+        return maxPageSizeInFrames;
+    }
+
+    bitrate = (fileInfo.sizeInBytes * 8 * pDataStream->decoder.outputSampleRate) / pDataStream->totalLengthInPCMFrames;
+    if (bitrate > MA_RESOURCE_MANAGER_STREAM_PAGE_REFERENCE_BITRATE) {
+        bitrate = MA_RESOURCE_MANAGER_STREAM_PAGE_REFERENCE_BITRATE;
+    }
+
+    return minPageSizeInFrames + (ma_uint32)(((ma_uint64)(maxPageSizeInFrames - minPageSizeInFrames) * bitrate) / MA_RESOURCE_MANAGER_STREAM_PAGE_REFERENCE_BITRATE);
+}
+
+/*
+Adjusts the page size after a page has been filled. The page grows when the public API ran out of
+frames since the last fill, or when filling took more than a quarter of the time the page plays
+for. It shrinks slowly when filling is cheap so idle streams give their memory back to the pool.
+*/
+static void ma_resource_manager_data_stream_update_page_size(ma_resource_manager_data_stream* pDataStream, ma_uint64 framesFilled, double fillTimeInSeconds)
+{
+    ma_resource_manager* pResourceManager = pDataStream->pResourceManager;
+    ma_uint32 minPageSizeInFrames = ma_resource_manager_data_stream_milliseconds_to_frames(pDataStream, pResourceManager->config.streamPageMinSizeInMilliseconds);
+    ma_uint32 maxPageSizeInFrames = ma_resource_manager_data_stream_milliseconds_to_frames(pDataStream, pResourceManager->config.streamPageMaxSizeInMilliseconds);
+    ma_uint32 starvationCount = ma_atomic_load_32(&pDataStream->starvationCount);
+    ma_uint64 targetPageSizeInFrames = pDataStream->targetPageSizeInFrames;
+    double pageTimeInSeconds = (double)framesFilled / pDataStream->decoder.outputSampleRate;
+
+    if (minPageSizeInFrames >= maxPageSizeInFrames) {
+        return;
+    }
+
+    if (starvationCount != pDataStream->lastStarvationCount) {
+        pDataStream->lastStarvationCount = starvationCount;
+        targetPageSizeInFrames *= 2;
+    } else if (framesFilled == 0) {
+        return; /* Nothing to judge the fill time by. */
+    } else if (fillTimeInSeconds > pageTimeInSeconds / 4) {
+        targetPageSizeInFrames += targetPageSizeInFrames / 2;
+    } else if (fillTimeInSeconds < pageTimeInSeconds / 32) {
+        targetPageSizeInFrames -= targetPageSizeInFrames / 8;
+    }
+
+    if (targetPageSizeInFrames < minPageSizeInFrames) {
+        targetPageSizeInFrames = minPageSizeInFrames;
+    }
+    if (targetPageSizeInFrames > maxPageSizeInFrames) {
+        targetPageSizeInFrames = maxPageSizeInFrames;
+    }
+
+    pDataStream->targetPageSizeInFrames = (ma_uint32)targetPageSizeInFrames;
+}
+
+/*
+Makes sure the buffer of an invalid page can hold the target page size. A buffer that is at least
+twice as large as needed is replaced by a smaller one. If a new buffer can't be allocated the old
+one is kept. Only the job thread calls this, and only for a page the public API isn't reading.
+*/
+static ma_result ma_resource_manager_data_stream_reserve_page(ma_resource_manager_data_stream* pDataStream, ma_uint32 pageIndex)
+{
+    ma_uint32 bytesPerFrame = ma_get_bytes_per_frame(pDataStream->decoder.outputFormat, pDataStream->decoder.outputChannels);
+    ma_uint32 capacityInFrames = pDataStream->pageCapacityInFrames[pageIndex];
+    ma_uint32 targetInFrames = pDataStream->targetPageSizeInFrames;
+    void* pNewPageData;
+
+    if (pDataStream->pPageData[pageIndex] != NULL && capacityInFrames >= targetInFrames && capacityInFrames / 2 < targetInFrames) {
+        return MA_SUCCESS;
+    }
+
+    pNewPageData = ma_resource_manager_stream_page_alloc(pDataStream->pResourceManager, (size_t)targetInFrames * bytesPerFrame);
+    if (pNewPageData == NULL) {
+        return (pDataStream->pPageData[pageIndex] != NULL) ? MA_SUCCESS : MA_OUT_OF_MEMORY;
+    }
+
+    ma_resource_manager_stream_page_free(pDataStream->pResourceManager, pDataStream->pPageData[pageIndex], (size_t)capacityInFrames * bytesPerFrame);
+
+    pDataStream->pPageData[pageIndex]            = pNewPageData;
+    pDataStream->pageCapacityInFrames[pageIndex] = targetInFrames;
+
+    return MA_SUCCESS;
+}
+
+static void ma_resource_manager_data_stream_free_pages(ma_resource_manager_data_stream* pDataStream)
+{
+    ma_uint32 bytesPerFrame = ma_get_bytes_per_frame(pDataStream->decoder.outputFormat, pDataStream->decoder.outputChannels);
+    ma_uint32 iPage;
+
+    for (iPage = 0; iPage < 2; iPage += 1) {
+        ma_resource_manager_stream_page_free(pDataStream->pResourceManager, pDataStream->pPageData[iPage], (size_t)pDataStream->pageCapacityInFrames[iPage] * bytesPerFrame);
+        pDataStream->pPageData[iPage]            = NULL;
+        pDataStream->pageCapacityInFrames[iPage] = 0;
+    }
 }
 
 static void* ma_resource_manager_data_stream_get_page_data_pointer(ma_resource_manager_data_stream* pDataStream, ma_uint32 pageIndex, ma_uint32 relativeCursor)
@@ -60530,17 +62075,34 @@ static void* ma_resource_manager_data_stream_get_page_data_pointer(ma_resource_m
     MA_ASSERT(pDataStream->isDecoderInitialized == MA_TRUE);
     MA_ASSERT(pageIndex == 0 || pageIndex == 1);
 
-    return ma_offset_ptr(pDataStream->pPageData, ((ma_resource_manager_data_stream_get_page_size_in_frames(pDataStream) * pageIndex) + relativeCursor) * ma_get_bytes_per_frame(pDataStream->decoder.outputFormat, pDataStream->decoder.outputChannels));
+    return ma_offset_ptr(pDataStream->pPageData[pageIndex], relativeCursor * ma_get_bytes_per_frame(pDataStream->decoder.outputFormat, pDataStream->decoder.outputChannels));
 }
 
-static void ma_resource_manager_data_stream_fill_page(ma_resource_manager_data_stream* pDataStream, ma_uint32 pageIndex)
+static ma_result ma_resource_manager_data_stream_fill_page(ma_resource_manager_data_stream* pDataStream, ma_uint32 pageIndex)
 {
     ma_result result = MA_SUCCESS;
     ma_uint64 pageSizeInFrames;
     ma_uint64 totalFramesReadForThisPage = 0;
-    void* pPageData = ma_resource_manager_data_stream_get_page_data_pointer(pDataStream, pageIndex, 0);
+    void* pPageData;
+    ma_timer timer;
 
-    pageSizeInFrames = ma_resource_manager_data_stream_get_page_size_in_frames(pDataStream);
+    /*
+    The page isn't valid while it's being filled, so its buffer can be resized to the current target. If the page has no
+    buffer at all it is marked as valid but empty so nothing waits on it, and the stream is put into an error state.
+    */
+    result = ma_resource_manager_data_stream_reserve_page(pDataStream, pageIndex);
+    if (result != MA_SUCCESS) {
+        ma_atomic_compare_and_swap_i32(&pDataStream->result, MA_SUCCESS, result);
+        ma_atomic_exchange_32(&pDataStream->pageFrameCount[pageIndex], 0);
+        ma_atomic_exchange_32(&pDataStream->pageSizeInFrames[pageIndex], 0);
+        ma_atomic_exchange_32(&pDataStream->isPageValid[pageIndex], MA_TRUE);
+        return result;
+    }
+
+    pPageData        = ma_resource_manager_data_stream_get_page_data_pointer(pDataStream, pageIndex, 0);
+    pageSizeInFrames = ma_min(pDataStream->targetPageSizeInFrames, pDataStream->pageCapacityInFrames[pageIndex]);
+
+    ma_timer_init(&timer);
 
     /* The decoder needs to inherit the stream's looping and range state. */
     {
@@ -60565,18 +62127,29 @@ static void ma_resource_manager_data_stream_fill_page(ma_resource_manager_data_s
     }
 
     ma_atomic_exchange_32(&pDataStream->pageFrameCount[pageIndex], (ma_uint32)totalFramesReadForThisPage);
+    ma_atomic_exchange_32(&pDataStream->pageSizeInFrames[pageIndex], (ma_uint32)pageSizeInFrames);
     ma_atomic_exchange_32(&pDataStream->isPageValid[pageIndex], MA_TRUE);
+
+    ma_resource_manager_data_stream_update_page_size(pDataStream, totalFramesReadForThisPage, ma_timer_get_time_in_seconds(&timer));
+
+    return MA_SUCCESS;
 }
 
-static void ma_resource_manager_data_stream_fill_pages(ma_resource_manager_data_stream* pDataStream)
+static ma_result ma_resource_manager_data_stream_fill_pages(ma_resource_manager_data_stream* pDataStream)
 {
+    ma_result result = MA_SUCCESS;
     ma_uint32 iPage;
 
     MA_ASSERT(pDataStream != NULL);
 
     for (iPage = 0; iPage < 2; iPage += 1) {
-        ma_resource_manager_data_stream_fill_page(pDataStream, iPage);
+        ma_result pageResult = ma_resource_manager_data_stream_fill_page(pDataStream, iPage);
+        if (pageResult != MA_SUCCESS) {
+            result = pageResult;
+        }
     }
+
+    return result;
 }
 
 
@@ -60628,12 +62201,21 @@ static ma_result ma_resource_manager_data_stream_map(ma_resource_manager_data_st
         if (ma_resource_manager_data_stream_is_decoder_at_end(pDataStream)) {
             return MA_AT_END;
         } else {
+            /* Count each underrun once, not every read that runs into it. */
+            if (pDataStream->isStarving == MA_FALSE) {
+                pDataStream->isStarving = MA_TRUE;
+                ma_atomic_fetch_add_32(&pDataStream->starvationCount, 1);
+                ma_atomic_fetch_add_64(&pDataStream->pResourceManager->streamStarvations, 1);
+            }
+
             return MA_BUSY; /* There are no frames available, but we're not marked as EOF so we might have caught up to the job thread. Need to return MA_BUSY and wait for more data. */
         }
     }
 
     MA_ASSERT(framesAvailable > 0);
 
+    pDataStream->isStarving = MA_FALSE;
+
     if (frameCount > framesAvailable) {
         frameCount = framesAvailable;
     }
@@ -60666,7 +62248,7 @@ static ma_result ma_resource_manager_data_stream_unmap(ma_resource_manager_data_
         return MA_INVALID_ARGS;
     }
 
-    pageSizeInFrames = ma_resource_manager_data_stream_get_page_size_in_frames(pDataStream);
+    pageSizeInFrames = ma_atomic_load_32(&pDataStream->pageSizeInFrames[pDataStream->currentPageIndex]);
 
     /* The absolute cursor needs to be updated for ma_resource_manager_data_stream_get_cursor_in_pcm_frames(). */
     ma_resource_manager_data_stream_set_absolute_cursor(pDataStream, ma_atomic_load_64(&pDataStream->absoluteCursor) + frameCount);
@@ -60808,6 +62390,7 @@ MA_API ma_result ma_resource_manager_data_stream_seek_to_pcm_frame(ma_resource_m
     */
     pDataStream->relativeCursor   = 0;
     pDataStream->currentPageIndex = 0;
+    pDataStream->isStarving       = MA_FALSE;
     ma_atomic_exchange_32(&pDataStream->isPageValid[0], MA_FALSE);
     ma_atomic_exchange_32(&pDataStream->isPageValid[1], MA_FALSE);
 
@@ -60951,6 +62534,15 @@ MA_API ma_bool32 ma_resource_manager_data_stream_is_looping(const ma_resource_ma
     return ma_atomic_load_32((ma_bool32*)&pDataStream->isLooping);   /* Naughty const-cast. Value won't change from here in practice (maybe from another thread). */
 }
 
+MA_API ma_uint32 ma_resource_manager_data_stream_get_starvation_count(const ma_resource_manager_data_stream* pDataStream)
+{
+    if (pDataStream == NULL) {
+        return 0;
+    }
+
+    return ma_atomic_load_32((ma_uint32*)&pDataStream->starvationCount);    /* Naughty const-cast. */
+}
+
 MA_API ma_result ma_resource_manager_data_stream_get_available_frames(ma_resource_manager_data_stream* pDataStream, ma_uint64* pAvailableFrames)
 {
     ma_uint32 pageIndex0;
@@ -61244,13 +62836,213 @@ MA_API ma_result ma_resource_manager_data_source_get_available_frames(ma_resourc
 }
 
 
+MA_API ma_resource_manager_job_lane ma_resource_manager_get_job_lane(const ma_job* pJob)
+{
+    ma_uint32 flags = 0;
+
+    if (pJob == NULL) {
+        return ma_resource_manager_job_lane_load;
+    }
+
+    switch (pJob->toc.breakup.code)
+    {
+        case MA_JOB_TYPE_RESOURCE_MANAGER_LOAD_DATA_STREAM:
+        case MA_JOB_TYPE_RESOURCE_MANAGER_FREE_DATA_STREAM:
+        case MA_JOB_TYPE_RESOURCE_MANAGER_PAGE_DATA_STREAM:
+        case MA_JOB_TYPE_RESOURCE_MANAGER_SEEK_DATA_STREAM:
+        {
+            return ma_resource_manager_job_lane_stream;
+        }
+
+        case MA_JOB_TYPE_RESOURCE_MANAGER_LOAD_DATA_BUFFER_NODE:
+        {
+            flags = pJob->data.resourceManager.loadDataBufferNode.flags;
+        } break;
+
+        case MA_JOB_TYPE_RESOURCE_MANAGER_PAGE_DATA_BUFFER_NODE:
+        {
+            flags = pJob->data.resourceManager.pageDataBufferNode.flags;
+        } break;
+
+        case MA_JOB_TYPE_RESOURCE_MANAGER_DECODE_DATA_BUFFER_NODE_SEGMENT:
+        {
+            flags = pJob->data.resourceManager.decodeDataBufferNodeSegment.flags;
+        } break;
+
+        /*
+        Jobs that wait for the jobs of a node go to the lane of the node. They are reposted to their own
+        lane while they wait, so a lane with a higher priority would never let the node's jobs run.
+        */
+        case MA_JOB_TYPE_RESOURCE_MANAGER_FREE_DATA_BUFFER_NODE:
+        {
+            flags = ((ma_resource_manager_data_buffer_node*)pJob->data.resourceManager.freeDataBufferNode.pDataBufferNode)->flags;
+        } break;
+
+        case MA_JOB_TYPE_RESOURCE_MANAGER_LOAD_DATA_BUFFER:
+        case MA_JOB_TYPE_RESOURCE_MANAGER_FREE_DATA_BUFFER:
+        {
+            ma_resource_manager_data_buffer* pDataBuffer = (ma_resource_manager_data_buffer*)((pJob->toc.breakup.code == MA_JOB_TYPE_RESOURCE_MANAGER_LOAD_DATA_BUFFER) ? pJob->data.resourceManager.loadDataBuffer.pDataBuffer : pJob->data.resourceManager.freeDataBuffer.pDataBuffer);
+            flags = (pDataBuffer->pNode != NULL) ? pDataBuffer->pNode->flags : pDataBuffer->flags;
+        } break;
+
+        /* The quit job goes last so that every job posted before it still runs. */
+        case MA_JOB_TYPE_QUIT:
+        {
+            return ma_resource_manager_job_lane_background;
+        }
+
+        default: break;
+    }
+
+    if ((flags & MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_BACKGROUND) != 0) {
+        return ma_resource_manager_job_lane_background;
+    }
+
+    return ma_resource_manager_job_lane_load;
+}
+
+static ma_result ma_resource_manager_job_lanes_init(ma_resource_manager* pResourceManager)
+{
+    ma_uint32 iLane;
+
+    if (pResourceManager->config.jobQueueCapacity == 0) {
+        return MA_INVALID_ARGS;
+    }
+
+    for (iLane = 0; iLane < ma_resource_manager_job_lane_count; iLane += 1) {
+        pResourceManager->jobLanes[iLane].pJobs = (ma_job*)ma_malloc(sizeof(ma_job) * pResourceManager->config.jobQueueCapacity, &pResourceManager->config.allocationCallbacks);
+        if (pResourceManager->jobLanes[iLane].pJobs == NULL) {
+            ma_resource_manager_job_lanes_uninit(pResourceManager);
+            return MA_OUT_OF_MEMORY;
+        }
+
+        pResourceManager->jobLanes[iLane].capacity = pResourceManager->config.jobQueueCapacity;
+    }
+
+    /* The semaphore is only needed when ma_resource_manager_next_job() is allowed to block. */
+    if ((pResourceManager->config.flags & MA_RESOURCE_MANAGER_FLAG_NON_BLOCKING) == 0) {
+        #ifndef MA_NO_THREADING
+        {
+            ma_result result = ma_semaphore_init(0, &pResourceManager->jobSemaphore);
+            if (result != MA_SUCCESS) {
+                ma_resource_manager_job_lanes_uninit(pResourceManager);
+                return result;
+            }
+        }
+        #else
+        {
+            ma_resource_manager_job_lanes_uninit(pResourceManager);
+            return MA_INVALID_OPERATION;
+        }
+        #endif
+    }
+
+    return MA_SUCCESS;
+}
+
+static void ma_resource_manager_job_lanes_uninit(ma_resource_manager* pResourceManager)
+{
+    ma_uint32 iLane;
+
+    for (iLane = 0; iLane < ma_resource_manager_job_lane_count; iLane += 1) {
+        ma_free(pResourceManager->jobLanes[iLane].pJobs, &pResourceManager->config.allocationCallbacks);
+        MA_ZERO_OBJECT(&pResourceManager->jobLanes[iLane]);
+    }
+
+    if ((pResourceManager->config.flags & MA_RESOURCE_MANAGER_FLAG_NON_BLOCKING) == 0) {
+        #ifndef MA_NO_THREADING
+        {
+            ma_semaphore_uninit(&pResourceManager->jobSemaphore);
+        }
+        #endif
+    }
+}
+
+static ma_result ma_resource_manager_post_job_to_lane(ma_resource_manager* pResourceManager, const ma_job* pJob, ma_resource_manager_job_lane lane)
+{
+    ma_resource_manager_job_lane_queue* pLane = &pResourceManager->jobLanes[lane];
+
+    /* A full lane grows instead of rejecting the job. The new buffer is allocated without holding the lock, so another thread may have grown the lane in the meantime. */
+    for (;;) {
+        ma_uint32 capacity;
+        ma_job* pNewJobs;
+        ma_job* pOldJobs = NULL;
+
+        ma_spinlock_lock(&pResourceManager->jobLock);
+        {
+            if (pLane->count < pLane->capacity) {
+                pLane->pJobs[(pLane->head + pLane->count) % pLane->capacity] = *pJob;
+                pLane->count += 1;
+                ma_spinlock_unlock(&pResourceManager->jobLock);
+                break;
+            }
+
+            capacity = pLane->capacity;
+        }
+        ma_spinlock_unlock(&pResourceManager->jobLock);
+
+        if (capacity > 0x7FFFFFFF / sizeof(ma_job)) {
+            return MA_OUT_OF_MEMORY;
+        }
+
+        pNewJobs = (ma_job*)ma_malloc(sizeof(ma_job) * capacity * 2, &pResourceManager->config.allocationCallbacks);
+        if (pNewJobs == NULL) {
+            return MA_OUT_OF_MEMORY;
+        }
+
+        ma_spinlock_lock(&pResourceManager->jobLock);
+        {
+            if (pLane->capacity == capacity) {
+                ma_uint32 iJob;
+
+                /* Unwrap the queued jobs to the start of the new buffer. */
+                for (iJob = 0; iJob < pLane->count; iJob += 1) {
+                    pNewJobs[iJob] = pLane->pJobs[(pLane->head + iJob) % pLane->capacity];
+                }
+
+                pOldJobs        = pLane->pJobs;
+                pLane->pJobs    = pNewJobs;
+                pLane->capacity = capacity * 2;
+                pLane->head     = 0;
+            } else {
+                pOldJobs = pNewJobs;    /* Somebody else grew the lane first. */
+            }
+        }
+        ma_spinlock_unlock(&pResourceManager->jobLock);
+
+        ma_free(pOldJobs, &pResourceManager->config.allocationCallbacks);
+    }
+
+    /* Signal the semaphore as the last step if we're using synchronous mode. */
+    if ((pResourceManager->config.flags & MA_RESOURCE_MANAGER_FLAG_NON_BLOCKING) == 0) {
+        #ifndef MA_NO_THREADING
+        {
+            ma_semaphore_release(&pResourceManager->jobSemaphore);
+        }
+        #endif
+    }
+
+    return MA_SUCCESS;
+}
+
+/*
+Posts a job again that could not run yet because it has to wait for another job. It goes back to the
+end of its own lane, so it keeps its priority over the jobs of lower lanes. The jobs it waits for are
+always in the same lane, see ma_resource_manager_get_job_lane(), so they get to run before it comes
+up again.
+*/
+static ma_result ma_resource_manager_repost_job(ma_resource_manager* pResourceManager, const ma_job* pJob)
+{
+    return ma_resource_manager_post_job_to_lane(pResourceManager, pJob, ma_resource_manager_get_job_lane(pJob));
+}
+
 MA_API ma_result ma_resource_manager_post_job(ma_resource_manager* pResourceManager, const ma_job* pJob)
 {
-    if (pResourceManager == NULL) {
+    if (pResourceManager == NULL || pJob == NULL) {
         return MA_INVALID_ARGS;
     }
 
-    return ma_job_queue_post(&pResourceManager->jobQueue, pJob);
+    return ma_resource_manager_post_job_to_lane(pResourceManager, pJob, ma_resource_manager_get_job_lane(pJob));
 }
 
 MA_API ma_result ma_resource_manager_post_job_quit(ma_resource_manager* pResourceManager)
@@ -61261,11 +63053,73 @@ MA_API ma_result ma_resource_manager_post_job_quit(ma_resource_manager* pResourc
 
 MA_API ma_result ma_resource_manager_next_job(ma_resource_manager* pResourceManager, ma_job* pJob)
 {
-    if (pResourceManager == NULL) {
+    ma_result result = MA_NO_DATA_AVAILABLE;
+    ma_uint32 iLane;
+
+    if (pResourceManager == NULL || pJob == NULL) {
         return MA_INVALID_ARGS;
     }
 
-    return ma_job_queue_next(&pResourceManager->jobQueue, pJob);
+    /* If we're running in synchronous mode we'll need to wait on a semaphore. */
+    if ((pResourceManager->config.flags & MA_RESOURCE_MANAGER_FLAG_NON_BLOCKING) == 0) {
+        #ifndef MA_NO_THREADING
+        {
+            ma_semaphore_wait(&pResourceManager->jobSemaphore);
+        }
+        #endif
+    }
+
+    ma_spinlock_lock(&pResourceManager->jobLock);
+    {
+        for (iLane = 0; iLane < ma_resource_manager_job_lane_count; iLane += 1) {
+            ma_resource_manager_job_lane_queue* pLane = &pResourceManager->jobLanes[iLane];
+
+            if (pLane->count == 0) {
+                continue;
+            }
+
+            *pJob = pLane->pJobs[pLane->head];
+
+            /* A quit job is left in its lane so every other job thread gets to see it too. */
+            if (pJob->toc.breakup.code == MA_JOB_TYPE_QUIT) {
+                result = MA_CANCELLED;
+            } else {
+                pLane->head   = (pLane->head + 1) % pLane->capacity;
+                pLane->count -= 1;
+                result = MA_SUCCESS;
+            }
+
+            break;
+        }
+    }
+    ma_spinlock_unlock(&pResourceManager->jobLock);
+
+    if (result == MA_CANCELLED && (pResourceManager->config.flags & MA_RESOURCE_MANAGER_FLAG_NON_BLOCKING) == 0) {
+        #ifndef MA_NO_THREADING
+        {
+            ma_semaphore_release(&pResourceManager->jobSemaphore);  /* Wakes up the next job thread to see the quit job. */
+        }
+        #endif
+    }
+
+    return result;
+}
+
+MA_API ma_uint32 ma_resource_manager_get_job_count(ma_resource_manager* pResourceManager, ma_resource_manager_job_lane lane)
+{
+    ma_uint32 count;
+
+    if (pResourceManager == NULL || lane >= ma_resource_manager_job_lane_count) {
+        return 0;
+    }
+
+    ma_spinlock_lock(&pResourceManager->jobLock);
+    {
+        count = pResourceManager->jobLanes[lane].count;
+    }
+    ma_spinlock_unlock(&pResourceManager->jobLock);
+
+    return count;
 }
 
 
@@ -61286,7 +63140,7 @@ static ma_result ma_job_process__resource_manager__load_data_buffer_node(ma_job*
 
     /* The data buffer is not getting deleted, but we may be getting executed out of order. If so, we need to push the job back onto the queue and return. */
     if (pJob->order != ma_atomic_load_32(&pDataBufferNode->executionPointer)) {
-        return ma_resource_manager_post_job(pResourceManager, pJob);    /* Attempting to execute out of order. Probably interleaved with a MA_JOB_TYPE_RESOURCE_MANAGER_FREE_DATA_BUFFER job. */
+        return ma_resource_manager_repost_job(pResourceManager, pJob);    /* Attempting to execute out of order. Probably interleaved with a MA_JOB_TYPE_RESOURCE_MANAGER_FREE_DATA_BUFFER job. */
     }
 
     /* First thing we need to do is check whether or not the data buffer is getting deleted. If so we just abort. */
@@ -61321,6 +63175,7 @@ static ma_result ma_job_process__resource_manager__load_data_buffer_node(ma_job*
         */
         ma_decoder* pDecoder;   /* <-- Free'd on the last page decode. */
         ma_job pageDataBufferNodeJob;
+        ma_uint32 segmentCount;
 
         /* Allocate the decoder by initializing a decoded data supply. */
         result = ma_resource_manager_data_buffer_node_init_supply_decoded(pResourceManager, pDataBufferNode, pJob->data.resourceManager.loadDataBufferNode.pFilePath, pJob->data.resourceManager.loadDataBufferNode.pFilePathW, pJob->data.resourceManager.loadDataBufferNode.flags, &pDecoder);
@@ -61353,7 +63208,16 @@ static ma_result ma_job_process__resource_manager__load_data_buffer_node(ma_job*
         work is done.
 
         Note that if an error occurred at an earlier point, this section will have been skipped.
+
+        Long files are split into segments so that other job threads can decode the rest of the
+        file in parallel. The paging jobs only decode the first segment in this case. The segment
+        fields need to be set before the paging job is posted because it may run straight away.
         */
+        segmentCount = ma_resource_manager_data_buffer_node_get_segment_count(pResourceManager, pDataBufferNode, pDecoder, MA_FALSE);
+        if (segmentCount > 1) {
+            ma_resource_manager_data_buffer_node_init_segments(pDataBufferNode, segmentCount);
+        }
+
         pageDataBufferNodeJob = ma_job_init(MA_JOB_TYPE_RESOURCE_MANAGER_PAGE_DATA_BUFFER_NODE);
         pageDataBufferNodeJob.order = ma_resource_manager_data_buffer_node_next_execution_order(pDataBufferNode);
         pageDataBufferNodeJob.data.resourceManager.pageDataBufferNode.pResourceManager  = pResourceManager;
@@ -61361,6 +63225,7 @@ static ma_result ma_job_process__resource_manager__load_data_buffer_node(ma_job*
         pageDataBufferNodeJob.data.resourceManager.pageDataBufferNode.pDecoder          = pDecoder;
         pageDataBufferNodeJob.data.resourceManager.pageDataBufferNode.pDoneNotification = pJob->data.resourceManager.loadDataBufferNode.pDoneNotification;
         pageDataBufferNodeJob.data.resourceManager.pageDataBufferNode.pDoneFence        = pJob->data.resourceManager.loadDataBufferNode.pDoneFence;
+        pageDataBufferNodeJob.data.resourceManager.pageDataBufferNode.flags             = pJob->data.resourceManager.loadDataBufferNode.flags;
 
         /* The job has been set up so it can now be posted. */
         result = ma_resource_manager_post_job(pResourceManager, &pageDataBufferNodeJob);
@@ -61376,6 +63241,10 @@ static ma_result ma_job_process__resource_manager__load_data_buffer_node(ma_job*
             ma_decoder_uninit(pDecoder);
             ma_free(pDecoder, &pResourceManager->config.allocationCallbacks);
         } else {
+            if (segmentCount > 1) {
+                ma_resource_manager_data_buffer_node_post_segments(pResourceManager, pDataBufferNode, segmentCount, pJob->data.resourceManager.loadDataBufferNode.flags, pJob->data.resourceManager.loadDataBufferNode.pDoneNotification, pJob->data.resourceManager.loadDataBufferNode.pDoneFence);
+            }
+
             result = MA_BUSY;
         }
     } else {
@@ -61441,7 +63310,7 @@ static ma_result ma_job_process__resource_manager__free_data_buffer_node(ma_job*
     MA_ASSERT(pDataBufferNode != NULL);
 
     if (pJob->order != ma_atomic_load_32(&pDataBufferNode->executionPointer)) {
-        return ma_resource_manager_post_job(pResourceManager, pJob);    /* Out of order. */
+        return ma_resource_manager_repost_job(pResourceManager, pJob);    /* Out of order. */
     }
 
     /* The event needs to be signalled last. */
@@ -61475,7 +63344,7 @@ static ma_result ma_job_process__resource_manager__page_data_buffer_node(ma_job*
     MA_ASSERT(pDataBufferNode != NULL);
 
     if (pJob->order != ma_atomic_load_32(&pDataBufferNode->executionPointer)) {
-        return ma_resource_manager_post_job(pResourceManager, pJob);    /* Out of order. */
+        return ma_resource_manager_repost_job(pResourceManager, pJob);    /* Out of order. */
     }
 
     /* Don't do any more decoding if the data buffer has started the uninitialization process. */
@@ -61516,9 +63385,26 @@ done:
         result  = MA_SUCCESS;
     }
 
+    /*
+    When decoding is split into segments this was only the first one. Whichever segment finishes last
+    finishes the node, which includes incrementing the execution pointer. Until then the node must not
+    be freed, so the execution pointer is left where it is.
+    */
+    if (result != MA_BUSY && pDataBufferNode->firstSegmentSizeInFrames > 0) {
+        if (ma_resource_manager_data_buffer_node_segment_done(pDataBufferNode, 0, result) == MA_FALSE) {
+            return MA_SUCCESS;
+        }
+
+        result = ma_resource_manager_data_buffer_node_segments_result(pDataBufferNode);
+    }
+
     /* Make sure we set the result of node in case some error occurred. */
     ma_atomic_compare_and_swap_i32(&pDataBufferNode->result, MA_BUSY, result);
 
+    if (result == MA_SUCCESS) {
+        ma_resource_manager_cache_trim(pResourceManager);
+    }
+
     /* Signal the notification after setting the result in case the notification callback wants to inspect the result code. */
     if (result != MA_BUSY) {
         if (pJob->data.resourceManager.pageDataBufferNode.pDoneNotification != NULL) {
@@ -61535,6 +63421,107 @@ done:
 }
 
 
+static ma_result ma_job_process__resource_manager__decode_data_buffer_node_segment(ma_job* pJob)
+{
+    ma_result result = MA_SUCCESS;
+    ma_resource_manager* pResourceManager;
+    ma_resource_manager_data_buffer_node* pDataBufferNode;
+    ma_decoder* pDecoder;
+    ma_uint64 frameIndex;
+    ma_uint64 endFrameIndex;
+    ma_uint64 framesToTryReading;
+    ma_uint64 framesRead = 0;
+
+    MA_ASSERT(pJob != NULL);
+
+    pResourceManager = (ma_resource_manager*)pJob->data.resourceManager.decodeDataBufferNodeSegment.pResourceManager;
+    MA_ASSERT(pResourceManager != NULL);
+
+    pDataBufferNode = (ma_resource_manager_data_buffer_node*)pJob->data.resourceManager.decodeDataBufferNodeSegment.pDataBufferNode;
+    MA_ASSERT(pDataBufferNode != NULL);
+
+    pDecoder      = (ma_decoder*)pJob->data.resourceManager.decodeDataBufferNodeSegment.pDecoder;
+    frameIndex    = pJob->data.resourceManager.decodeDataBufferNodeSegment.frameIndex;
+    endFrameIndex = pJob->data.resourceManager.decodeDataBufferNodeSegment.endFrameIndex;
+
+    /*
+    Segments are not ordered with the execution pointer. They can run at the same time as each other and
+    the paging jobs because each one writes to its own range of the buffer. The node can't be freed
+    while a segment is outstanding because the last segment to finish is the one that increments the
+    execution pointer.
+    */
+
+    /* Don't do any more decoding if the data buffer has started the uninitialization process. */
+    result = ma_resource_manager_data_buffer_node_result(pDataBufferNode);
+    if (result != MA_BUSY) {
+        goto done;
+    }
+
+    /* The decoder is only initialized when the segment starts decoding so that queued segments don't keep files open. */
+    if (pDecoder == NULL) {
+        pDecoder = (ma_decoder*)ma_malloc(sizeof(*pDecoder), &pResourceManager->config.allocationCallbacks);
+        if (pDecoder == NULL) {
+            result = MA_OUT_OF_MEMORY;
+            goto done;
+        }
+
+        result = ma_resource_manager__init_decoder(pResourceManager, pDataBufferNode->pName, pDataBufferNode->pNameW, pDecoder);
+        if (result != MA_SUCCESS) {
+            ma_free(pDecoder, &pResourceManager->config.allocationCallbacks);
+            pDecoder = NULL;
+            goto done;
+        }
+
+        result = ma_decoder_seek_to_pcm_frame(pDecoder, frameIndex);
+        if (result != MA_SUCCESS) {
+            goto done;
+        }
+    }
+
+    /* Decode a page at a time like the paging jobs so one long segment doesn't starve other jobs. */
+    framesToTryReading = MA_RESOURCE_MANAGER_PAGE_SIZE_IN_MILLISECONDS * (pDecoder->outputSampleRate/1000);
+    if (framesToTryReading > endFrameIndex - frameIndex) {
+        framesToTryReading = endFrameIndex - frameIndex;
+    }
+
+    result = ma_decoder_read_pcm_frames(pDecoder, ma_offset_ptr(pDataBufferNode->data.backend.decoded.pData, frameIndex * ma_get_bytes_per_frame(pDataBufferNode->data.backend.decoded.format, pDataBufferNode->data.backend.decoded.channels)), framesToTryReading, &framesRead);
+    frameIndex += framesRead;
+
+    if (result == MA_SUCCESS && framesRead > 0 && frameIndex < endFrameIndex) {
+        ma_job newJob;
+        newJob = *pJob;
+        newJob.data.resourceManager.decodeDataBufferNodeSegment.pDecoder   = pDecoder;
+        newJob.data.resourceManager.decodeDataBufferNodeSegment.frameIndex = frameIndex;
+
+        result = ma_resource_manager_post_job(pResourceManager, &newJob);
+        if (result == MA_SUCCESS) {
+            return MA_SUCCESS;
+        }
+    }
+
+    /* The file ending before the segment does is fine. The rest of the segment is left silent just like when decoding isn't split. */
+    if (result == MA_AT_END) {
+        result  = MA_SUCCESS;
+    }
+
+done:
+    if (pDecoder != NULL) {
+        ma_decoder_uninit(pDecoder);
+        ma_free(pDecoder, &pResourceManager->config.allocationCallbacks);
+    }
+
+    if (ma_resource_manager_data_buffer_node_segment_done(pDataBufferNode, pJob->data.resourceManager.decodeDataBufferNodeSegment.segmentIndex, result)) {
+        if ((pJob->data.resourceManager.decodeDataBufferNodeSegment.flags & MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_ASYNC) != 0) {
+            ma_resource_manager_data_buffer_node_finish_segments(pResourceManager, pDataBufferNode, pJob->data.resourceManager.decodeDataBufferNodeSegment.pDoneNotification, pJob->data.resourceManager.decodeDataBufferNodeSegment.pDoneFence);
+        } else {
+            /* Loading synchronously. The loading thread is waiting for this and will finish the node itself. */
+            ma_async_notification_signal(pJob->data.resourceManager.decodeDataBufferNodeSegment.pDoneNotification);
+        }
+    }
+
+    return result;
+}
+
 static ma_result ma_job_process__resource_manager__load_data_buffer(ma_job* pJob)
 {
     ma_result result = MA_SUCCESS;
@@ -61555,7 +63542,7 @@ static ma_result ma_job_process__resource_manager__load_data_buffer(ma_job* pJob
     pResourceManager = pDataBuffer->pResourceManager;
 
     if (pJob->order != ma_atomic_load_32(&pDataBuffer->executionPointer)) {
-        return ma_resource_manager_post_job(pResourceManager, pJob);    /* Attempting to execute out of order. Probably interleaved with a MA_JOB_TYPE_RESOURCE_MANAGER_FREE_DATA_BUFFER job. */
+        return ma_resource_manager_repost_job(pResourceManager, pJob);    /* Attempting to execute out of order. Probably interleaved with a MA_JOB_TYPE_RESOURCE_MANAGER_FREE_DATA_BUFFER job. */
     }
 
     /*
@@ -61608,7 +63595,7 @@ static ma_result ma_job_process__resource_manager__load_data_buffer(ma_job* pJob
     */
     result = ma_resource_manager_data_buffer_node_result(pDataBuffer->pNode);
     if (result == MA_BUSY || (result == MA_SUCCESS && isConnectorInitialized == MA_FALSE && dataSupplyType == ma_resource_manager_data_supply_type_unknown)) {
-        return ma_resource_manager_post_job(pResourceManager, pJob);
+        return ma_resource_manager_repost_job(pResourceManager, pJob);
     }
 
 done:
@@ -61653,11 +63640,14 @@ static ma_result ma_job_process__resource_manager__free_data_buffer(ma_job* pJob
     pResourceManager = pDataBuffer->pResourceManager;
 
     if (pJob->order != ma_atomic_load_32(&pDataBuffer->executionPointer)) {
-        return ma_resource_manager_post_job(pResourceManager, pJob);    /* Out of order. */
+        return ma_resource_manager_repost_job(pResourceManager, pJob);    /* Out of order. */
     }
 
     ma_resource_manager_data_buffer_uninit_internal(pDataBuffer);
 
+    /* The owner frees the data buffer as soon as it is signalled, so it must not be touched after that. */
+    ma_atomic_fetch_add_32(&pDataBuffer->executionPointer, 1);
+
     /* The event needs to be signalled last. */
     if (pJob->data.resourceManager.freeDataBuffer.pDoneNotification != NULL) {
         ma_async_notification_signal(pJob->data.resourceManager.freeDataBuffer.pDoneNotification);
@@ -61667,7 +63657,6 @@ static ma_result ma_job_process__resource_manager__free_data_buffer(ma_job* pJob
         ma_fence_release(pJob->data.resourceManager.freeDataBuffer.pDoneFence);
     }
 
-    ma_atomic_fetch_add_32(&pDataBuffer->executionPointer, 1);
     return MA_SUCCESS;
 }
 
@@ -61675,7 +63664,6 @@ static ma_result ma_job_process__resource_manager__load_data_stream(ma_job* pJob
 {
     ma_result result = MA_SUCCESS;
     ma_decoder_config decoderConfig;
-    ma_uint32 pageBufferSizeInBytes;
     ma_resource_manager* pResourceManager;
     ma_resource_manager_data_stream* pDataStream;
 
@@ -61687,7 +63675,7 @@ static ma_result ma_job_process__resource_manager__load_data_stream(ma_job* pJob
     pResourceManager = pDataStream->pResourceManager;
 
     if (pJob->order != ma_atomic_load_32(&pDataStream->executionPointer)) {
-        return ma_resource_manager_post_job(pResourceManager, pJob);    /* Out of order. */
+        return ma_resource_manager_repost_job(pResourceManager, pJob);    /* Out of order. */
     }
 
     if (ma_resource_manager_data_stream_result(pDataStream) != MA_BUSY) {
@@ -61707,6 +63695,11 @@ static ma_result ma_job_process__resource_manager__load_data_stream(ma_job* pJob
         goto done;
     }
 
+    /* With a seek table bound the length below is known without scanning the file. Building the table is a scan itself so it's not done when the length isn't wanted. */
+    if ((pDataStream->flags & MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_UNKNOWN_LENGTH) == 0) {
+        ma_resource_manager_bind_mp3_seek_table(pResourceManager, pJob->data.resourceManager.loadDataStream.pFilePath, pJob->data.resourceManager.loadDataStream.pFilePathW, MA_TRUE, &pDataStream->decoder);
+    }
+
     /* Retrieve the total length of the file before marking the decoder as loaded. */
     if ((pDataStream->flags & MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_UNKNOWN_LENGTH) == 0) {
         result = ma_decoder_get_length_in_pcm_frames(&pDataStream->decoder, &pDataStream->totalLengthInPCMFrames);
@@ -61723,12 +63716,13 @@ static ma_result ma_job_process__resource_manager__load_data_stream(ma_job* pJob
     */
     pDataStream->isDecoderInitialized = MA_TRUE;
 
-    /* We have the decoder so we can now initialize our page buffer. */
-    pageBufferSizeInBytes = ma_resource_manager_data_stream_get_page_size_in_frames(pDataStream) * 2 * ma_get_bytes_per_frame(pDataStream->decoder.outputFormat, pDataStream->decoder.outputChannels);
+    /* We have the decoder so we can now initialize our page buffers. */
+    pDataStream->targetPageSizeInFrames = ma_resource_manager_data_stream_get_initial_page_size_in_frames(pDataStream);
 
-    pDataStream->pPageData = ma_malloc(pageBufferSizeInBytes, &pResourceManager->config.allocationCallbacks);
-    if (pDataStream->pPageData == NULL) {
+    if (ma_resource_manager_data_stream_reserve_page(pDataStream, 0) != MA_SUCCESS || ma_resource_manager_data_stream_reserve_page(pDataStream, 1) != MA_SUCCESS) {
+        ma_resource_manager_data_stream_free_pages(pDataStream);
         ma_decoder_uninit(&pDataStream->decoder);
+        pDataStream->isDecoderInitialized = MA_FALSE;   /* Or the free job would uninitialize the decoder a second time. */
         result = MA_OUT_OF_MEMORY;
         goto done;
     }
@@ -61737,10 +63731,7 @@ static ma_result ma_job_process__resource_manager__load_data_stream(ma_job* pJob
     ma_decoder_seek_to_pcm_frame(&pDataStream->decoder, pJob->data.resourceManager.loadDataStream.initialSeekPoint);
 
     /* We have our decoder and our page buffer, so now we need to fill our pages. */
-    ma_resource_manager_data_stream_fill_pages(pDataStream);
-
-    /* And now we're done. We want to make sure the result is MA_SUCCESS. */
-    result = MA_SUCCESS;
+    result = ma_resource_manager_data_stream_fill_pages(pDataStream);
 
 done:
     ma_free(pJob->data.resourceManager.loadDataStream.pFilePath,  &pResourceManager->config.allocationCallbacks);
@@ -61774,21 +63765,18 @@ static ma_result ma_job_process__resource_manager__free_data_stream(ma_job* pJob
     pResourceManager = pDataStream->pResourceManager;
 
     if (pJob->order != ma_atomic_load_32(&pDataStream->executionPointer)) {
-        return ma_resource_manager_post_job(pResourceManager, pJob);    /* Out of order. */
+        return ma_resource_manager_repost_job(pResourceManager, pJob);    /* Out of order. */
     }
 
     /* If our status is not MA_UNAVAILABLE we have a bug somewhere. */
     MA_ASSERT(ma_resource_manager_data_stream_result(pDataStream) == MA_UNAVAILABLE);
 
     if (pDataStream->isDecoderInitialized) {
+        /* The page sizes depend on the output format of the decoder so the pages go first. */
+        ma_resource_manager_data_stream_free_pages(pDataStream);
         ma_decoder_uninit(&pDataStream->decoder);
     }
 
-    if (pDataStream->pPageData != NULL) {
-        ma_free(pDataStream->pPageData, &pResourceManager->config.allocationCallbacks);
-        pDataStream->pPageData = NULL;  /* Just in case... */
-    }
-
     ma_data_source_uninit(&pDataStream->ds);
 
     /* The event needs to be signalled last. */
@@ -61817,7 +63805,7 @@ static ma_result ma_job_process__resource_manager__page_data_stream(ma_job* pJob
     pResourceManager = pDataStream->pResourceManager;
 
     if (pJob->order != ma_atomic_load_32(&pDataStream->executionPointer)) {
-        return ma_resource_manager_post_job(pResourceManager, pJob);    /* Out of order. */
+        return ma_resource_manager_repost_job(pResourceManager, pJob);    /* Out of order. */
     }
 
     /* For streams, the status should be MA_SUCCESS. */
@@ -61826,7 +63814,7 @@ static ma_result ma_job_process__resource_manager__page_data_stream(ma_job* pJob
         goto done;
     }
 
-    ma_resource_manager_data_stream_fill_page(pDataStream, pJob->data.resourceManager.pageDataStream.pageIndex);
+    result = ma_resource_manager_data_stream_fill_page(pDataStream, pJob->data.resourceManager.pageDataStream.pageIndex);
 
 done:
     ma_atomic_fetch_add_32(&pDataStream->executionPointer, 1);
@@ -61847,7 +63835,7 @@ static ma_result ma_job_process__resource_manager__seek_data_stream(ma_job* pJob
     pResourceManager = pDataStream->pResourceManager;
 
     if (pJob->order != ma_atomic_load_32(&pDataStream->executionPointer)) {
-        return ma_resource_manager_post_job(pResourceManager, pJob);    /* Out of order. */
+        return ma_resource_manager_repost_job(pResourceManager, pJob);    /* Out of order. */
     }
 
     /* For streams the status should be MA_SUCCESS for this to do anything. */
@@ -61863,7 +63851,7 @@ static ma_result ma_job_process__resource_manager__seek_data_stream(ma_job* pJob
     ma_decoder_seek_to_pcm_frame(&pDataStream->decoder, pJob->data.resourceManager.seekDataStream.frameIndex);
 
     /* After seeking we'll need to reload the pages. */
-    ma_resource_manager_data_stream_fill_pages(pDataStream);
+    result = ma_resource_manager_data_stream_fill_pages(pDataStream);
 
     /* We need to let the public API know that we're done seeking. */
     ma_atomic_fetch_sub_32(&pDataStream->seekCounter, 1);
@@ -61910,6 +63898,7 @@ static ma_result ma_job_process__resource_manager__load_data_stream(ma_job* pJob
 static ma_result ma_job_process__resource_manager__free_data_stream(ma_job* pJob)      { return ma_job_process__noop(pJob); }
 static ma_result ma_job_process__resource_manager__page_data_stream(ma_job* pJob)      { return ma_job_process__noop(pJob); }
 static ma_result ma_job_process__resource_manager__seek_data_stream(ma_job* pJob)      { return ma_job_process__noop(pJob); }
+static ma_result ma_job_process__resource_manager__decode_data_buffer_node_segment(ma_job* pJob) { return ma_job_process__noop(pJob); }
 #endif  /* MA_NO_RESOURCE_MANAGER */
 
 
@@ -65396,6 +67385,9 @@ static void ma_engine_node_process_pcm_frames__sound(ma_node* pNode, const float
     if (seekTarget != MA_SEEK_TARGET_NONE) {
         ma_data_source_seek_to_pcm_frame(pSound->pDataSource, seekTarget);
 
+        /* Frames sitting in the processing cache belong to the old position. */
+        pSound->processingCacheFramesRemaining = 0;
+
         /* Any time-dependant effects need to have their times updated. */
         ma_node_set_time(pSound, seekTarget);
 
@@ -67085,14 +69077,120 @@ MA_API ma_result ma_sound_init_from_file_w(ma_engine* pEngine, const wchar_t* pF
     return ma_sound_init_ex(pEngine, &config, pSound);
 }
 
+/* Builds a resource manager name from a 64-bit hash of the content and its size, e.g. "memory://<hash><size>". */
+static void ma_sound_get_memory_name(const void* pData, ma_uint64 dataSize, char* pName)
+{
+    static const char* pHexDigits = "0123456789abcdef";
+    ma_uint64 hash = ma_hash_64(pData, (int)dataSize, MA_DEFAULT_HASH_SEED);
+    int i;
+
+    MA_COPY_MEMORY(pName, "memory://", 9);
+    for (i = 0; i < 16; i += 1) {
+        pName[ 9 + i] = pHexDigits[(hash     >> (60 - i*4)) & 0xF];
+        pName[25 + i] = pHexDigits[(dataSize >> (60 - i*4)) & 0xF];
+    }
+    pName[41] = '\0';
+}
+
+/*
+Decodes encoded memory once into a resource manager data buffer node that is named after a hash of
+the content. Every sound that is initialized from the same bytes shares the decoded PCM, and the
+resource manager frees it when the last of those sounds is uninitialized.
+
+The first sound decodes on the calling thread rather than on a job thread. That keeps decoding off
+the audio thread, and the node never refers to the caller's bytes, so they can be freed as soon as
+this returns just like with ma_resource_manager_register_decoded_data(). A job would need its own
+copy of the encoded data and the sound would need to wait for the node to be created regardless.
+*/
+static ma_result ma_sound_init_from_memory_shared(ma_engine* pEngine, const void* pData, ma_uint64 dataSize, ma_uint32 flags, ma_sound_group* pGroup, ma_fence* pDoneFence, ma_sound* pSound)
+{
+    ma_resource_manager* pResourceManager = pEngine->pResourceManager;
+    ma_resource_manager_data_buffer_node* pDataBufferNode = NULL;
+    char pName[64];
+    ma_uint64 hashedName64;
+    ma_result result;
+
+    ma_sound_get_memory_name(pData, dataSize, pName);
+    hashedName64 = ma_hash_string_64(pName);
+
+    /* Hold a reference while the sound is initialized so another thread can't free the node in between. */
+    ma_resource_manager_data_buffer_bst_lock(pResourceManager);
+    {
+        if (ma_resource_manager_data_buffer_node_search(pResourceManager, hashedName64, pName, NULL, &pDataBufferNode) == MA_SUCCESS) {
+            ma_resource_manager_data_buffer_node_increment_ref(pResourceManager, pDataBufferNode, NULL);
+        } else {
+            pDataBufferNode = NULL;
+        }
+    }
+    ma_resource_manager_data_buffer_bst_unlock(pResourceManager);
+
+    if (pDataBufferNode == NULL) {
+        ma_decoder_config decoderConfig = ma_resource_manager__init_decoder_config(pResourceManager);
+        ma_uint64 frameCount;
+        void* pFrames;
+
+        result = ma_decode_memory(pData, (size_t)dataSize, &decoderConfig, &frameCount, &pFrames);
+        if (result != MA_SUCCESS) {
+            return result;
+        }
+
+        result = ma_resource_manager_register_decoded_data(pResourceManager, pName, pFrames, frameCount, decoderConfig.format, decoderConfig.channels, decoderConfig.sampleRate);
+        if (result != MA_SUCCESS) {
+            ma_free(pFrames, &pResourceManager->config.allocationCallbacks);
+            return result;
+        }
+
+        /* If another thread registered the same content first, our copy is not needed. Otherwise the node takes ownership of it. */
+        ma_resource_manager_data_buffer_bst_lock(pResourceManager);
+        {
+            if (ma_resource_manager_data_buffer_node_search(pResourceManager, hashedName64, pName, NULL, &pDataBufferNode) != MA_SUCCESS) {
+                pDataBufferNode = NULL;
+            } else if (pDataBufferNode->data.backend.decoded.pData == pFrames) {
+                pDataBufferNode->isDataOwnedByResourceManager = MA_TRUE;
+                ma_resource_manager_data_buffer_node_track_decoded(pResourceManager, pDataBufferNode);
+                pFrames = NULL;
+            }
+        }
+        ma_resource_manager_data_buffer_bst_unlock(pResourceManager);
+
+        if (pFrames != NULL) {
+            ma_free(pFrames, &pResourceManager->config.allocationCallbacks);
+        }
+
+        /*
+        The name was unregistered by somebody else between the two lock sections, so the reference
+        from registering it is gone as well. The caller falls back to a decoder owned by the sound.
+        */
+        if (pDataBufferNode == NULL) {
+            return MA_DOES_NOT_EXIST;
+        }
+    }
+
+    result = ma_sound_init_from_file(pEngine, pName, (flags | MA_SOUND_FLAG_DECODE) & ~MA_SOUND_FLAG_STREAM, pGroup, pDoneFence, pSound);
+
+    /* The sound holds its own reference to the node now. */
+    ma_resource_manager_unregister_data(pResourceManager, pName);
+
+    return result;
+}
+
 MA_API ma_result ma_sound_init_from_memory(ma_engine* pEngine, const void* pData, ma_uint64 dataSize, ma_uint32 flags, ma_sound_group* pGroup, ma_fence* pDoneFence, ma_sound* pSound)
 {
     ma_sound_config config;
+    ma_result result;
 
     if (pSound == NULL || pData == NULL || dataSize == 0) {
         return MA_INVALID_ARGS;
     }
 
+    /* With MA_SOUND_FLAG_DECODE the content is decoded once and shared instead of every sound running its own decoder on the audio thread. */
+    if ((flags & MA_SOUND_FLAG_DECODE) != 0 && pEngine != NULL && pEngine->pResourceManager != NULL && dataSize <= 0x7FFFFFFF) {
+        result = ma_sound_init_from_memory_shared(pEngine, pData, dataSize, flags, pGroup, pDoneFence, pSound);
+        if (result != MA_DOES_NOT_EXIST) {
+            return result;
+        }
+    }
+
     config = ma_sound_config_init_2(pEngine);
     config.pDataSource        = (ma_data_source*)malloc(sizeof(ma_decoder));
     config.flags              = flags;
@@ -67109,16 +69207,20 @@ MA_API ma_result ma_sound_init_from_memory(ma_engine* pEngine, const void* pData
     decoderConfig.customBackendCount = pEngine->pResourceManager->config.customDecodingBackendCount;
     decoderConfig.pCustomBackendUserData = pEngine->pResourceManager->config.pCustomDecodingBackendUserData;
 
-    ma_result result = ma_decoder_init_memory(pData, dataSize, &decoderConfig, config.pDataSource);
+    result = ma_decoder_init_memory(pData, dataSize, &decoderConfig, config.pDataSource);
 
     if(result != MA_SUCCESS) {
         free(config.pDataSource);
         return result;
     }
 
+    /* Mark the decoder as owned by the sound so ma_sound_uninit() knows it has to free it. */
+    ((ma_data_source_base*)config.pDataSource)->vtable = &g_ma_decoder_owned_data_source_vtable;
+
     result = ma_sound_init_ex(pEngine, &config, pSound);
 
     if(result != MA_SUCCESS) {
+        ma_decoder_uninit((ma_decoder*)config.pDataSource);
         free(config.pDataSource);
         return result;
     }
@@ -67282,10 +69384,11 @@ MA_API void ma_sound_uninit(ma_sound* pSound)
             if ((pDataSourceBase->vtable->flags & MA_DATA_SOURCE_IS_PROCEDURAL) != 0) {
                 ma_procedural_data_source_uninit((ma_procedural_data_source*)pSound->pDataSource);
                 free(pSound->pDataSource);
-            } else {
+            } else if ((pDataSourceBase->vtable->flags & MA_DATA_SOURCE_IS_DECODER) != 0) {
                 ma_decoder_uninit((ma_decoder*)pSound->pDataSource);
                 free(pSound->pDataSource);
             }
+            /* Any other data source was passed in with ma_sound_init_from_data_source() and is owned by the caller. */
             pSound->pDataSource = NULL;
         }
     }
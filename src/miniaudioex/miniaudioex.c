@@ -53,10 +53,25 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 #include <assert.h>
+#include <stddef.h>         /* For offsetof() */
 #if !defined(_MSC_VER) && !defined(__DMC__)
     #include <wchar.h>      /* For wcslen(), wcsrtombs() */
 #endif
+#if defined(_WIN32)
+    #include <windows.h>    /* For SwitchToThread() */
+#else
+    #include <sched.h>      /* For sched_yield() */
+    #include <sys/mman.h>   /* For mmap() */
+    #include <sys/stat.h>   /* For fstat() */
+    #include <fcntl.h>      /* For open() */
+    #include <unistd.h>     /* For close(), getpid() */
+    #include <dirent.h>     /* For opendir() */
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>     /* For the _Interlocked* intrinsics */
+#endif
 
 #ifndef MA_ASSERT
 #define MA_ASSERT(condition) assert(condition)
@@ -86,6 +101,10 @@ static MA_INLINE void ma_zero_memory_default(void* p, size_t sz)
 #define MA_MALLOC(sz)                   malloc((sz))
 #endif
 
+#ifndef MA_REALLOC
+#define MA_REALLOC(p, sz)               realloc((p), (sz))
+#endif
+
 #ifndef MA_FREE
 #define MA_FREE(p)                      free((p))
 #endif
@@ -143,1021 +162,5192 @@ static ma_uint32 ma_next_power_of_two(ma_uint32 value) {
     return value;
 }
 
-static void ma_ex_on_data_proc(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount) {
-    ma_engine_read_pcm_frames((ma_engine *)pDevice->pUserData, pOutput, frameCount, NULL);
-    (void)pInput;
+/* The atomics of miniaudio are only visible inside miniaudio.c, so the few we need are implemented here. */
+#if defined(_MSC_VER) && !defined(__clang__)
+static MA_INLINE ma_uint32 ma_ex_atomic_load_32(volatile ma_uint32 *p) {
+    return (ma_uint32)_InterlockedCompareExchange((volatile long*)p, 0, 0);
 }
 
-MA_API ma_ex_device_info *ma_ex_playback_devices_get(ma_uint32 *count) {
-    *count = 0;
+static MA_INLINE void ma_ex_atomic_store_32(volatile ma_uint32 *p, ma_uint32 value) {
+    _InterlockedExchange((volatile long*)p, (long)value);
+}
 
-    ma_context context;
-    ma_result result = ma_context_init(NULL, 0, NULL, &context);
-    
-    if (result != MA_SUCCESS) {
-        return NULL;
-    }
+static MA_INLINE ma_uint32 ma_ex_atomic_fetch_add_32(volatile ma_uint32 *p, ma_uint32 value) {
+    return (ma_uint32)_InterlockedExchangeAdd((volatile long*)p, (long)value);
+}
 
-    ma_device_info *pPlaybackInfos;
-    ma_uint32 playbackCount;
-    ma_device_info* pCaptureInfos;
-    ma_uint32 captureCount;
-    result = ma_context_get_devices(&context, &pPlaybackInfos, &playbackCount, &pCaptureInfos, &captureCount);
+static MA_INLINE ma_bool32 ma_ex_atomic_compare_exchange_32(volatile ma_uint32 *p, ma_uint32 expected, ma_uint32 desired) {
+    return (ma_uint32)_InterlockedCompareExchange((volatile long*)p, (long)desired, (long)expected) == expected;
+}
 
-    if(result != MA_SUCCESS)
-        return NULL;
+static MA_INLINE ma_uint64 ma_ex_atomic_load_64(volatile ma_uint64 *p) {
+    return (ma_uint64)_InterlockedCompareExchange64((volatile __int64*)p, 0, 0);
+}
 
-    ma_ex_device_info *pDeviceInfo = NULL;
+static MA_INLINE void ma_ex_atomic_store_64(volatile ma_uint64 *p, ma_uint64 value) {
+    _InterlockedExchange64((volatile __int64*)p, (__int64)value);
+}
 
-    if(playbackCount == 0)
-        return NULL;
+static MA_INLINE void *ma_ex_atomic_load_ptr(void *volatile *p) {
+    return _InterlockedCompareExchangePointer(p, NULL, NULL);
+}
 
-    size_t allocationSize = sizeof(ma_ex_device_info) * playbackCount;
-    pDeviceInfo = MA_MALLOC(allocationSize);
-    
-    if(pDeviceInfo == NULL)
-        return NULL;
+static MA_INLINE void *ma_ex_atomic_exchange_ptr(void *volatile *p, void *value) {
+    return _InterlockedExchangePointer(p, value);
+}
 
-    MA_ZERO_MEMORY(pDeviceInfo, allocationSize);
+static MA_INLINE ma_bool32 ma_ex_atomic_compare_exchange_ptr(void *volatile *p, void *expected, void *desired) {
+    return _InterlockedCompareExchangePointer(p, desired, expected) == expected;
+}
+#else
+static MA_INLINE ma_uint32 ma_ex_atomic_load_32(volatile ma_uint32 *p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
 
-    ma_bool32 allocationError = MA_FALSE;
+static MA_INLINE void ma_ex_atomic_store_32(volatile ma_uint32 *p, ma_uint32 value) {
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
 
-    for (ma_uint32 iDevice = 0; iDevice < playbackCount; iDevice++) {
-        pDeviceInfo[iDevice].index = iDevice;
-        pDeviceInfo[iDevice].isDefault = pPlaybackInfos[iDevice].isDefault;
+static MA_INLINE ma_uint32 ma_ex_atomic_fetch_add_32(volatile ma_uint32 *p, ma_uint32 value) {
+    return __atomic_fetch_add(p, value, __ATOMIC_SEQ_CST);
+}
 
-        ma_device_info deviceInfo = {0};
-        
-        if(ma_context_get_device_info(&context, ma_device_type_playback, &pPlaybackInfos[iDevice].id, &deviceInfo) != MA_SUCCESS) {
-            allocationError = MA_TRUE;
-            break;
-        }
+static MA_INLINE ma_bool32 ma_ex_atomic_compare_exchange_32(volatile ma_uint32 *p, ma_uint32 expected, ma_uint32 desired) {
+    return __atomic_compare_exchange_n(p, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
 
-        const ma_uint32 formatCount = deviceInfo.nativeDataFormatCount;
+static MA_INLINE ma_uint64 ma_ex_atomic_load_64(volatile ma_uint64 *p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
 
-        if(formatCount > 0) {
-            pDeviceInfo[iDevice].nativeDataFormatCount = formatCount;
-            pDeviceInfo[iDevice].nativeDataFormats = MA_MALLOC(formatCount * sizeof(ma_ex_native_data_format));
-            if(pDeviceInfo[iDevice].nativeDataFormats == NULL) {
-                allocationError = MA_TRUE;
-                break;
-            }
-            for (ma_uint32 n = 0; n < formatCount; n++) {
-                pDeviceInfo[iDevice].nativeDataFormats[n].channels = deviceInfo.nativeDataFormats[n].channels;
-                pDeviceInfo[iDevice].nativeDataFormats[n].flags = deviceInfo.nativeDataFormats[n].flags;
-                pDeviceInfo[iDevice].nativeDataFormats[n].format = deviceInfo.nativeDataFormats[n].format;
-                pDeviceInfo[iDevice].nativeDataFormats[n].sampleRate = deviceInfo.nativeDataFormats[n].sampleRate;
-            }
-        } else {
-            pDeviceInfo[iDevice].nativeDataFormatCount = 0;
-            pDeviceInfo[iDevice].nativeDataFormats = NULL;
-        }
+static MA_INLINE void ma_ex_atomic_store_64(volatile ma_uint64 *p, ma_uint64 value) {
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
 
-        size_t len = strlen(pPlaybackInfos[iDevice].name) + 1;
-        pDeviceInfo[iDevice].pName = MA_MALLOC(len);
-        if(pDeviceInfo[iDevice].pName == NULL) {
-            allocationError = MA_TRUE;
-            break;
-        }
-        memset(pDeviceInfo[iDevice].pName, 0, len);
-        memcpy(pDeviceInfo[iDevice].pName, pPlaybackInfos[iDevice].name, len);
-    }
+static MA_INLINE void *ma_ex_atomic_load_ptr(void *volatile *p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
 
-    if(allocationError == MA_TRUE) {
-        for(ma_uint32 i = 0; i < playbackCount; i++) {
-            if(pDeviceInfo[i].pName != NULL) {
-                MA_FREE(pDeviceInfo[i].pName);
-            }
-            if(pDeviceInfo[i].nativeDataFormats != NULL) {
-                MA_FREE(pDeviceInfo[i].nativeDataFormats);
-            }
-        }        
-        MA_FREE(pDeviceInfo);
-        return NULL;
-    }
+static MA_INLINE void *ma_ex_atomic_exchange_ptr(void *volatile *p, void *value) {
+    return __atomic_exchange_n(p, value, __ATOMIC_SEQ_CST);
+}
 
-    ma_context_uninit(&context);
-    *count = playbackCount;
-    return pDeviceInfo;
+static MA_INLINE ma_bool32 ma_ex_atomic_compare_exchange_ptr(void *volatile *p, void *expected, void *desired) {
+    return __atomic_compare_exchange_n(p, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
 }
+#endif
 
-MA_API void ma_ex_playback_devices_free(ma_ex_device_info *pDeviceInfo, ma_uint32 count) {
-    if(pDeviceInfo != NULL) {
-        for(ma_uint32 i = 0; i < count; i++) {
-            if(pDeviceInfo[i].pName != NULL)
-                MA_FREE(pDeviceInfo[i].pName);
-            if(pDeviceInfo[i].nativeDataFormats != NULL)
-                MA_FREE(pDeviceInfo[i].nativeDataFormats);
-        }
-        MA_FREE(pDeviceInfo);
-    }
+static MA_INLINE void ma_ex_yield(void) {
+#if defined(_WIN32)
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
 }
 
-MA_API ma_ex_context_config ma_ex_context_config_init(ma_uint32 sampleRate, ma_uint8 channels, ma_uint32 periodSizeInFrames, const ma_ex_device_info *pDeviceInfo) {
-    MA_ASSERT(sampleRate > 0);
-    MA_ASSERT(channels > 0);
+static MA_INLINE ma_uint32 ma_ex_get_process_id(void) {
+#if defined(_WIN32)
+    return (ma_uint32)GetCurrentProcessId();
+#else
+    return (ma_uint32)getpid();
+#endif
+}
 
-    ma_ex_context_config config;
-    config.sampleRate = sampleRate;
-    config.channels = channels;
-    config.periodSizeInFrames = periodSizeInFrames == 0 ? 0 : ma_next_power_of_two(periodSizeInFrames);
-    config.deviceDataProc = NULL;
+static MA_INLINE ma_ex_context *ma_ex_context_from_engine(ma_engine *pEngine) {
+    return (ma_ex_context*)((ma_uint8*)pEngine - offsetof(ma_ex_context, engine));
+}
 
-    if(pDeviceInfo == NULL) {
-        config.deviceInfo.index = -1;
-    } else {
-        config.deviceInfo = *pDeviceInfo;
-    }
+typedef enum {
+    ma_ex_command_type_set_volume,
+    ma_ex_command_type_set_pitch,
+    ma_ex_command_type_set_pan,
+    ma_ex_command_type_set_pan_mode,
+    ma_ex_command_type_set_pcm_position,
+    ma_ex_command_type_set_loop,
+    ma_ex_command_type_set_position,
+    ma_ex_command_type_set_direction,
+    ma_ex_command_type_set_velocity,
+    ma_ex_command_type_set_spatialization,
+    ma_ex_command_type_set_attenuation_model,
+    ma_ex_command_type_set_doppler_factor,
+    ma_ex_command_type_set_min_distance,
+    ma_ex_command_type_set_max_distance,
+    ma_ex_command_type_set_transforms
+} ma_ex_command_type;
+
+typedef struct {
+    ma_ex_command_type type;
+    ma_ex_audio_source *source;
+    union {
+        float f32[3];
+        ma_uint32 u32;
+        ma_uint64 u64;
+        void *p;
+    } value;
+} ma_ex_command;
+
+typedef struct ma_ex_transform_batch ma_ex_transform_batch;
+
+/* The transforms of many sources, copied into a single allocation by ma_ex_audio_source_set_transforms. Arrays that weren't given are NULL. */
+struct ma_ex_transform_batch {
+    ma_ex_transform_batch *pNext;   //Links batches that have been applied until a producer frees them
+    ma_uint32 count;
+    ma_bool32 isPinned;             //Set when the sources were resolved from handles, they are unpinned once the batch is applied
+    ma_ex_audio_source **ppSources;
+    float *pPositions;
+    float *pVelocities;
+    float *pDirections;
+};
+
+static ma_ex_transform_batch *ma_ex_transform_batch_alloc(ma_uint32 count, ma_bool32 hasPositions, ma_bool32 hasVelocities, ma_bool32 hasDirections) {
+    size_t arraySize = sizeof(float) * 3 * count;
+    size_t size = sizeof(ma_ex_transform_batch) + sizeof(ma_ex_audio_source*) * count;
+
+    size += hasPositions ? arraySize : 0;
+    size += hasVelocities ? arraySize : 0;
+    size += hasDirections ? arraySize : 0;
+
+    ma_ex_transform_batch *batch = MA_MALLOC(size);
+
+    if(batch == NULL)
+        return NULL;
 
-    return config;
+    ma_uint8 *pData = (ma_uint8*)(batch + 1);
+
+    batch->pNext = NULL;
+    batch->count = count;
+    batch->isPinned = MA_FALSE;
+    batch->ppSources = (ma_ex_audio_source**)pData;
+    pData += sizeof(ma_ex_audio_source*) * count;
+    batch->pPositions = hasPositions ? (float*)pData : NULL;
+    pData += hasPositions ? arraySize : 0;
+    batch->pVelocities = hasVelocities ? (float*)pData : NULL;
+    pData += hasVelocities ? arraySize : 0;
+    batch->pDirections = hasDirections ? (float*)pData : NULL;
+    return batch;
 }
 
-MA_API ma_ex_context *ma_ex_context_init(const ma_ex_context_config *config) {
-    MA_ASSERT(config != NULL);
-    MA_ASSERT(config->sampleRate > 0);
-    MA_ASSERT(config->channels > 0);
+static MA_INLINE void ma_ex_audio_source_unpin(ma_ex_audio_source *source) {
+    ma_ex_atomic_fetch_add_32(&source->pinCount, (ma_uint32)-1);
+}
 
-    ma_ex_context *context = MA_MALLOC(sizeof(ma_ex_context));
-    MA_ZERO_OBJECT(context);
-    MA_ZERO_OBJECT(&context->context);
-    MA_ZERO_OBJECT(&context->engine);
-    MA_ZERO_OBJECT(&context->device);
-    MA_ZERO_OBJECT(&context->resourceManager);
+/* Applies a batch to the sounds in a single pass. Sources may be NULL, and sounds that have been released are skipped. */
+static void ma_ex_transform_batch_apply(const ma_ex_transform_batch *batch) {
+    for(ma_uint32 i = 0; i < batch->count; i++) {
+        ma_ex_audio_source *source = batch->ppSources[i];
 
-    context->sampleRate = config->sampleRate;
-    context->channels = config->channels;
-    context->format = ma_format_f32;
+        if(source == NULL || source->pSound == NULL)
+            continue;
 
-    if (ma_context_init(NULL, 0, NULL, &context->context) != MA_SUCCESS) {
-        fprintf(stderr, "Failed to initialize ma_context\n");
-        MA_FREE(context);
-        return NULL;
+        if(batch->pPositions != NULL)
+            ma_sound_set_position(source->pSound, batch->pPositions[i * 3], batch->pPositions[i * 3 + 1], batch->pPositions[i * 3 + 2]);
+        if(batch->pVelocities != NULL)
+            ma_sound_set_velocity(source->pSound, batch->pVelocities[i * 3], batch->pVelocities[i * 3 + 1], batch->pVelocities[i * 3 + 2]);
+        if(batch->pDirections != NULL)
+            ma_sound_set_direction(source->pSound, batch->pDirections[i * 3], batch->pDirections[i * 3 + 1], batch->pDirections[i * 3 + 2]);
     }
 
-    ma_device_config deviceConfig = ma_device_config_init(ma_device_type_playback);
-    deviceConfig.playback.format = context->format;
-    deviceConfig.playback.channels = context->channels;
-    deviceConfig.sampleRate = context->sampleRate;
-    deviceConfig.dataCallback = config->deviceDataProc == NULL ? &ma_ex_on_data_proc : config->deviceDataProc;
-    deviceConfig.periodSizeInFrames = config->periodSizeInFrames;
-
-    ma_device_info* pPlaybackInfos;
-    ma_uint32 playbackCount;
-    ma_device_info* pCaptureInfos;
-    ma_uint32 captureCount;
-
-    if (ma_context_get_devices(&context->context, &pPlaybackInfos, &playbackCount, &pCaptureInfos, &captureCount) != MA_SUCCESS) {
-        fprintf(stderr, "Failed to get playback devices\n");
-        ma_context_uninit(&context->context);
-        MA_FREE(context);
-        return NULL;
+    if(batch->isPinned) {
+        for(ma_uint32 i = 0; i < batch->count; i++) {
+            if(batch->ppSources[i] != NULL)
+                ma_ex_audio_source_unpin(batch->ppSources[i]);
+        }
     }
+}
 
-    if(config->deviceInfo.index >= (ma_int32)playbackCount) {
-        fprintf(stderr, "Device index is greater than or equal to the number of playback devices\n");
-        ma_context_uninit(&context->context);
-        MA_FREE(context);
-        return NULL;
-    }
-    
-    ma_device_id *pSelectedDevice = NULL;
+static ma_result ma_ex_command_queue_init(ma_ex_command_queue *queue, ma_uint32 capacity) {
+    MA_ZERO_OBJECT(queue);
 
-    //Use selected device    
-    if(config->deviceInfo.index >= 0)
-        pSelectedDevice = &pPlaybackInfos[config->deviceInfo.index].id;
+    if(capacity == 0)
+        return MA_SUCCESS;
 
-    deviceConfig.playback.pDeviceID = pSelectedDevice;
+    capacity = ma_next_power_of_two(capacity);
 
-    if(ma_device_init(&context->context, &deviceConfig, &context->device) != MA_SUCCESS) {
-        fprintf(stderr, "Failed to initialize ma_device\n");
-        ma_context_uninit(&context->context);
-        MA_FREE(context);
-        return NULL;
-    }
+    queue->pCommands = MA_MALLOC(sizeof(ma_ex_command) * capacity);
 
-    ma_decoding_backend_vtable *pCustomBackendVTables[] = {
-        ma_libvorbis_get_decoding_backend()
-    };
+    if(queue->pCommands == NULL)
+        return MA_OUT_OF_MEMORY;
 
-    ma_resource_manager_config resourceManagerConfig = ma_resource_manager_config_init();
-    resourceManagerConfig.ppCustomDecodingBackendVTables = pCustomBackendVTables;
-    resourceManagerConfig.customDecodingBackendCount = sizeof(pCustomBackendVTables)/sizeof(pCustomBackendVTables[0]);
+    queue->capacity = capacity;
+    return MA_SUCCESS;
+}
 
-    if (ma_resource_manager_init(&resourceManagerConfig, &context->resourceManager) != MA_SUCCESS) {
-        fprintf(stderr, "Failed to initialize ma_resource_manager\n");
-        ma_context_uninit(&context->context);
-        MA_FREE(context);
-        return NULL;
+/* Frees the batches the consumer has applied. Any thread can call this, the whole list is taken at once. */
+static void ma_ex_command_queue_free_retired_batches(ma_ex_command_queue *queue) {
+    ma_ex_transform_batch *batch = (ma_ex_transform_batch*)ma_ex_atomic_exchange_ptr(&queue->pRetiredBatches, NULL);
+
+    while(batch != NULL) {
+        ma_ex_transform_batch *pNext = batch->pNext;
+        MA_FREE(batch);
+        batch = pNext;
     }
+}
 
-    ma_engine_config engineConfig = ma_engine_config_init();
-    engineConfig.listenerCount = MA_ENGINE_MAX_LISTENERS;
-    engineConfig.pDevice = &context->device;
-    engineConfig.pResourceManager = &context->resourceManager;
+static void ma_ex_command_queue_uninit(ma_ex_command_queue *queue) {
+    ma_ex_command_queue_free_retired_batches(queue);
 
-    if(ma_engine_init(&engineConfig, &context->engine) != MA_SUCCESS) {
-        fprintf(stderr, "Failed to initialize ma_engine\n");
-        ma_device_uninit(&context->device);
-        ma_context_uninit(&context->context);
-        MA_FREE(context);
-        return NULL;
+    if(queue->pCommands != NULL) {
+        MA_FREE(queue->pCommands);
+        queue->pCommands = NULL;
     }
+    queue->capacity = 0;
+}
 
-    context->device.pUserData = &context->engine;
+static void ma_ex_command_execute(ma_ex_command_queue *queue, const ma_ex_command *command) {
+    //A batch is applied, then handed back to the producers so the audio thread never frees memory
+    if(command->type == ma_ex_command_type_set_transforms) {
+        ma_ex_transform_batch *batch = (ma_ex_transform_batch*)command->value.p;
+        ma_ex_transform_batch_apply(batch);
 
-    if (ma_device_start(&context->device) != MA_SUCCESS) {
-        fprintf(stderr, "Failed to start ma_device\n");
-        ma_engine_uninit(&context->engine);
-        ma_device_uninit(&context->device);
-        ma_context_uninit(&context->context);
-        MA_FREE(context);
-        return NULL;
+        do {
+            batch->pNext = (ma_ex_transform_batch*)ma_ex_atomic_load_ptr(&queue->pRetiredBatches);
+        } while(!ma_ex_atomic_compare_exchange_ptr(&queue->pRetiredBatches, batch->pNext, batch));
+        return;
     }
 
-    for(size_t i = 0; i < MA_ENGINE_MAX_LISTENERS; i++) {
-        context->listeners[i] = -1;
-    }
+    ma_sound *sound = command->source->pSound;
 
-    return context;
-}
+    //The sound may have been released after the command was recorded
+    if(sound == NULL)
+        return;
 
-MA_API void ma_ex_context_uninit(ma_ex_context *context) {
-    if(context != NULL) {
-        ma_engine_uninit(&context->engine);
-        ma_resource_manager_uninit(&context->resourceManager);
-        ma_device_uninit(&context->device);
-        ma_context_uninit(&context->context);
-        MA_FREE(context);
+    switch(command->type) {
+        case ma_ex_command_type_set_volume:
+            ma_sound_set_volume(sound, command->value.f32[0]);
+            break;
+        case ma_ex_command_type_set_pitch:
+            ma_sound_set_pitch(sound, command->value.f32[0]);
+            break;
+        case ma_ex_command_type_set_pan:
+            ma_sound_set_pan(sound, command->value.f32[0]);
+            break;
+        case ma_ex_command_type_set_pan_mode:
+            ma_sound_set_pan_mode(sound, (ma_pan_mode)command->value.u32);
+            break;
+        case ma_ex_command_type_set_pcm_position:
+            ma_sound_seek_to_pcm_frame(sound, command->value.u64);
+            break;
+        case ma_ex_command_type_set_loop:
+            ma_sound_set_looping(sound, command->value.u32);
+            break;
+        case ma_ex_command_type_set_position:
+            ma_sound_set_position(sound, command->value.f32[0], command->value.f32[1], command->value.f32[2]);
+            break;
+        case ma_ex_command_type_set_direction:
+            ma_sound_set_direction(sound, command->value.f32[0], command->value.f32[1], command->value.f32[2]);
+            break;
+        case ma_ex_command_type_set_velocity:
+            ma_sound_set_velocity(sound, command->value.f32[0], command->value.f32[1], command->value.f32[2]);
+            break;
+        case ma_ex_command_type_set_spatialization:
+            ma_sound_set_spatialization_enabled(sound, command->value.u32);
+            break;
+        case ma_ex_command_type_set_attenuation_model:
+            ma_sound_set_attenuation_model(sound, (ma_attenuation_model)command->value.u32);
+            break;
+        case ma_ex_command_type_set_doppler_factor:
+            ma_sound_set_doppler_factor(sound, command->value.f32[0]);
+            break;
+        case ma_ex_command_type_set_min_distance:
+            ma_sound_set_min_distance(sound, command->value.f32[0]);
+            break;
+        case ma_ex_command_type_set_max_distance:
+            ma_sound_set_max_distance(sound, command->value.f32[0]);
+            break;
+        default:
+            break;
     }
 }
 
-MA_API void ma_ex_context_set_master_volume(ma_ex_context *context, float volume) {
-    if(context != NULL)
-        ma_engine_set_volume(&context->engine, volume);
-}
+/* Consumer side. Only to be called by the thread that won isDraining in ma_ex_command_queue_try_drain. */
+static void ma_ex_command_queue_drain(ma_ex_command_queue *queue) {
+    const ma_ex_command *pCommands = (const ma_ex_command*)queue->pCommands;
+    const ma_uint32 mask = queue->capacity - 1;
+    ma_uint32 readIndex = ma_ex_atomic_load_32(&queue->readIndex);
+    ma_uint32 writeIndex = ma_ex_atomic_load_32(&queue->writeIndex);
 
-MA_API float ma_ex_context_get_master_volume(ma_ex_context *context) {
-    if(context != NULL)
-        return ma_engine_get_volume(&context->engine);
-    return 0.0f;
-}
+    while(readIndex != writeIndex) {
+        ma_ex_command_execute(queue, &pCommands[readIndex & mask]);
+        readIndex++;
+    }
 
-MA_API ma_engine *ma_ex_context_get_engine(ma_ex_context *context) {
-    if(context != NULL)
-        return &context->engine;
-    return NULL;
+    ma_ex_atomic_store_32(&queue->readIndex, readIndex);
 }
 
-MA_API ma_node_graph *ma_ex_context_get_engine_node_graph(ma_ex_context *context) {
-    if(context == NULL)
-        return NULL;
-    return ma_engine_get_node_graph(&context->engine);
-}
+/*
+Drains the queue unless another thread is already doing so. The audio thread and a thread flushing while the device
+is stopped can both try to consume, so this makes sure there is only ever one consumer at a time. Returns MA_FALSE
+when somebody else held the queue.
+*/
+static ma_bool32 ma_ex_command_queue_try_drain(ma_ex_command_queue *queue) {
+    if(ma_ex_atomic_load_32(&queue->capacity) == 0)
+        return MA_TRUE;
 
-MA_API void *ma_ex_device_get_user_data(ma_device *pDevice) {
-    if(pDevice != NULL)
-        return pDevice->pUserData;
-    return NULL;
+    if(!ma_ex_atomic_compare_exchange_32(&queue->isDraining, 0, 1))
+        return MA_FALSE;
+
+    ma_ex_command_queue_drain(queue);
+    ma_ex_atomic_store_32(&queue->isDraining, 0);
+    return MA_TRUE;
 }
 
-MA_API ma_ex_audio_clip *ma_ex_audio_clip_init_from_file(ma_ex_context *context, const char *filePath, ma_bool32 streamFromDisk) {
-    if(context == NULL)
-        return NULL;
+/*
+Waits until every command that has been recorded so far is consumed. When there is no running device there is nobody
+else to drain the queue, so it is drained on the calling thread instead. The device state is checked on every pass
+because a deferred device can start (or stop) while waiting.
+*/
+static void ma_ex_command_queue_flush(ma_ex_context *context) {
+    ma_ex_command_queue *queue = &context->commandQueue;
 
-    if(filePath == NULL)
-        return NULL;
-    
-    ma_ex_audio_clip *clip = MA_MALLOC(sizeof(ma_ex_audio_clip));
-    
-    if(clip == NULL)
-        return NULL;
+    if(ma_ex_atomic_load_32(&queue->capacity) == 0)
+        return;
 
-    MA_ZERO_OBJECT(clip);
-    
-    ma_uint32 flags = MA_SOUND_FLAG_DECODE;
-    
-    if(streamFromDisk)
-        flags |= MA_SOUND_FLAG_STREAM;
+    while(ma_ex_atomic_load_32(&queue->readIndex) != ma_ex_atomic_load_32(&queue->writeIndex)) {
+        if(context->noDevice || !ma_device_is_started(&context->device)) {
+            if(ma_ex_command_queue_try_drain(queue))
+                continue;
+        }
 
-    clip->flags = flags;
+        ma_ex_yield();
+    }
+}
 
-    clip->soundHash = ma_ex_create_hashcode(filePath, strlen(filePath));
+/*
+Doubles the capacity of a full queue. Only to be called with producerLock held. The consumer is kept out by taking
+isDraining while the pending commands are moved, which is only ever held for as long as a drain takes. The indices
+don't change, every pending command is moved to the slot its index maps to in the larger buffer.
+*/
+static ma_result ma_ex_command_queue_grow(ma_ex_command_queue *queue) {
+    ma_uint32 capacity = queue->capacity * 2;
+    ma_ex_command *pCommands = MA_MALLOC(sizeof(ma_ex_command) * capacity);
 
-    ma_result result = ma_sound_init_from_file(&context->engine, filePath, flags, NULL, NULL, &clip->sound);
+    if(pCommands == NULL)
+        return MA_OUT_OF_MEMORY;
 
-    if(result != MA_SUCCESS) {
-        ma_sound_uninit(&clip->sound);
-        MA_FREE(clip);
-        return NULL;
-    }
+    while(!ma_ex_atomic_compare_exchange_32(&queue->isDraining, 0, 1))
+        ma_ex_yield();
 
-    return clip;
+    ma_ex_command *pOldCommands = (ma_ex_command*)queue->pCommands;
+    ma_uint32 writeIndex = ma_ex_atomic_load_32(&queue->writeIndex);
+
+    for(ma_uint32 index = ma_ex_atomic_load_32(&queue->readIndex); index != writeIndex; index++)
+        pCommands[index & (capacity - 1)] = pOldCommands[index & (queue->capacity - 1)];
+
+    queue->pCommands = pCommands;
+    ma_ex_atomic_store_32(&queue->capacity, capacity);
+    ma_ex_atomic_store_32(&queue->isDraining, 0);
+
+    MA_FREE(pOldCommands);
+    return MA_SUCCESS;
 }
 
+/*
+Producer side. Any thread can record commands, producers are serialized with producerLock. A full queue grows rather
+than waiting for the consumer. Returns MA_FALSE when command queueing is disabled, in which case the caller applies
+the change directly.
+*/
+static ma_bool32 ma_ex_command_queue_push(ma_ex_context *context, const ma_ex_command *command) {
+    ma_ex_command_queue *queue = &context->commandQueue;
 
-MA_API ma_ex_audio_clip *ma_ex_audio_clip_init_from_memory(ma_ex_context *context, const void *data, ma_uint64 dataSize) {
-    if(context == NULL || data == NULL || dataSize == 0)
-        return NULL;
+    if(ma_ex_atomic_load_32(&queue->capacity) == 0)
+        return MA_FALSE;
 
-    ma_ex_audio_clip *clip = MA_MALLOC(sizeof(ma_ex_audio_clip));
-    
-    if(clip == NULL)
-        return NULL;
+    ma_spinlock_lock(&queue->producerLock);
 
-    MA_ZERO_OBJECT(clip);
+    ma_uint32 writeIndex = ma_ex_atomic_load_32(&queue->writeIndex);
 
-    ma_uint32 flags = MA_SOUND_FLAG_DECODE;
+    //Only when out of memory does the producer have to wait for room
+    while((writeIndex - ma_ex_atomic_load_32(&queue->readIndex)) == queue->capacity) {
+        if(ma_ex_command_queue_grow(queue) == MA_SUCCESS)
+            break;
+        ma_ex_command_queue_flush(context);
+    }
 
-    clip->flags = flags;
+    ma_ex_command *pCommands = (ma_ex_command*)queue->pCommands;
+    pCommands[writeIndex & (queue->capacity - 1)] = *command;
+    ma_ex_atomic_store_32(&queue->writeIndex, writeIndex + 1);
 
-    clip->soundHash = ma_ex_pointer_to_hashcode(data);
+    ma_spinlock_unlock(&queue->producerLock);
+    return MA_TRUE;
+}
 
-    ma_result result = ma_sound_init_from_memory(&context->engine, data, dataSize, flags, NULL, NULL, &clip->sound);
+static ma_bool32 ma_ex_audio_source_defer_f32(ma_ex_audio_source *source, ma_ex_command_type type, float value) {
+    ma_ex_command command;
+    command.type = type;
+    command.source = source;
+    command.value.f32[0] = value;
+    return ma_ex_command_queue_push(source->context, &command);
+}
 
-    if(result != MA_SUCCESS) {
-        ma_sound_uninit(&clip->sound);
-        MA_FREE(clip);
-        return NULL;
-    }
+static ma_bool32 ma_ex_audio_source_defer_vec3f(ma_ex_audio_source *source, ma_ex_command_type type, float x, float y, float z) {
+    ma_ex_command command;
+    command.type = type;
+    command.source = source;
+    command.value.f32[0] = x;
+    command.value.f32[1] = y;
+    command.value.f32[2] = z;
+    return ma_ex_command_queue_push(source->context, &command);
+}
 
-    return clip;
+static ma_bool32 ma_ex_audio_source_defer_u32(ma_ex_audio_source *source, ma_ex_command_type type, ma_uint32 value) {
+    ma_ex_command command;
+    command.type = type;
+    command.source = source;
+    command.value.u32 = value;
+    return ma_ex_command_queue_push(source->context, &command);
 }
 
-MA_API ma_ex_audio_clip *ma_ex_audio_clip_init_from_callback(ma_ex_context *context, const ma_procedural_data_source_config *pConfig) {
-    if(context == NULL || pConfig == NULL)
-        return NULL;
+static ma_bool32 ma_ex_audio_source_defer_u64(ma_ex_audio_source *source, ma_ex_command_type type, ma_uint64 value) {
+    ma_ex_command command;
+    command.type = type;
+    command.source = source;
+    command.value.u64 = value;
+    return ma_ex_command_queue_push(source->context, &command);
+}
 
-    ma_ex_audio_clip *clip = MA_MALLOC(sizeof(ma_ex_audio_clip));
-    
-    if(clip == NULL)
-        return NULL;
+static ma_result ma_ex_pool_init(ma_ex_pool *pool, size_t itemSize, ma_uint32 capacity) {
+    MA_ZERO_OBJECT(pool);
+    pool->itemSize = itemSize;
 
-    MA_ZERO_OBJECT(clip);
+    if(capacity == 0)
+        return MA_SUCCESS;
 
-    ma_uint32 flags = 0;
+    //The slot allocator works in groups of 32 slots, and can't hand out the tail of a partially used group
+    capacity = (capacity + 31) & ~(ma_uint32)31;
 
-    clip->flags = flags;
+    ma_slot_allocator_config allocatorConfig = ma_slot_allocator_config_init(capacity);
 
-    clip->soundHash = ma_ex_pointer_to_hashcode(&clip->sound);
+    ma_result result = ma_slot_allocator_init(&allocatorConfig, NULL, &pool->allocator);
 
-    ma_result result = ma_sound_init_from_callback(&context->engine, pConfig, flags, NULL, NULL, &clip->sound);
+    if(result != MA_SUCCESS)
+        return result;
 
-    if(result != MA_SUCCESS) {
-        ma_sound_uninit(&clip->sound);
-        MA_FREE(clip);
-        return NULL;
+    pool->pItems = MA_MALLOC(itemSize * capacity);
+
+    if(pool->pItems == NULL) {
+        ma_slot_allocator_uninit(&pool->allocator, NULL);
+        return MA_OUT_OF_MEMORY;
     }
 
-    return clip;
+    pool->capacity = capacity;
+    return MA_SUCCESS;
 }
 
-MA_API void ma_ex_audio_clip_uninit(ma_ex_audio_clip *clip) {
-    if(clip) {
-        ma_sound_uninit(&clip->sound);
-        MA_FREE(clip);
+static void ma_ex_pool_uninit(ma_ex_pool *pool) {
+    if(pool->pItems != NULL) {
+        ma_slot_allocator_uninit(&pool->allocator, NULL);
+        MA_FREE(pool->pItems);
+        pool->pItems = NULL;
     }
+    pool->capacity = 0;
 }
 
-MA_API ma_bool8 ma_ex_audio_clip_is_initialized(ma_ex_audio_clip *clip) {
-    if(!clip)
-        return MA_FALSE;
-    return ma_sound_get_data_source(&clip->sound) != NULL;
-}
+static void *ma_ex_pool_alloc(ma_ex_pool *pool) {
+    ma_uint64 slot;
 
-MA_API ma_ex_audio_source *ma_ex_audio_source_init(ma_ex_context *context) {
-    MA_ASSERT(context != NULL);
-    
-    ma_ex_audio_source *source = MA_MALLOC(sizeof(ma_ex_audio_source));
-    source->context = context;
-    MA_ZERO_OBJECT(&source->clip);
-    MA_ZERO_OBJECT(&source->settings);
-    source->group = NULL;
+    if(pool->capacity > 0 && ma_slot_allocator_alloc(&pool->allocator, &slot) == MA_SUCCESS) {
+        ma_uint32 used = ma_ex_atomic_load_32(&pool->allocator.count);
+        ma_uint32 highWaterMark = ma_ex_atomic_load_32(&pool->highWaterMark);
 
-    source->settings.attenuationModel = ma_attenuation_model_linear;
-    ma_ex_vec3f_set(&source->settings.direction, 0.0f, 0.0f, -1.0f);
-    ma_ex_vec3f_set(&source->settings.position, 0.0f, 0.0f, 0.0f);
-    ma_ex_vec3f_set(&source->settings.velocity, 0.0f, 0.0f, 0.0f);
-    source->settings.dopplerFactor = 1.0f;
-    source->settings.loop = MA_FALSE;
-    source->settings.maxDistance = MA_FLT_MAX;
-    source->settings.minDistance = 1.0f;
-    source->settings.pitch = 1.0f;
-    source->settings.pan = 0.0f;
-    source->settings.panMode = ma_pan_mode_balance;
-    source->settings.spatialization = MA_FALSE;
-    source->settings.volume = 1.0f;
+        while(used > highWaterMark) {
+            if(ma_ex_atomic_compare_exchange_32(&pool->highWaterMark, highWaterMark, used))
+                break;
+            highWaterMark = ma_ex_atomic_load_32(&pool->highWaterMark);
+        }
 
-    return source;
+        return (ma_uint8*)pool->pItems + ((ma_uint32)(slot & 0xFFFFFFFF) * pool->itemSize);
+    }
+
+    ma_ex_atomic_fetch_add_32(&pool->overflowCount, 1);
+    return MA_MALLOC(pool->itemSize);
 }
 
-MA_API void ma_ex_audio_source_uninit(ma_ex_audio_source *source) {
-    if(source != NULL) {
-        ma_sound_uninit(&source->clip.sound);
-        MA_FREE(source);
+static void ma_ex_pool_free(ma_ex_pool *pool, void *pItem) {
+    if(pItem == NULL)
+        return;
+
+    ma_uint8 *pBegin = (ma_uint8*)pool->pItems;
+    ma_uint8 *pEnd = pBegin + (pool->itemSize * pool->capacity);
+
+    if(pool->capacity > 0 && (ma_uint8*)pItem >= pBegin && (ma_uint8*)pItem < pEnd) {
+        ma_uint64 slot = (ma_uint64)(((ma_uint8*)pItem - pBegin) / pool->itemSize);
+        ma_slot_allocator_free(&pool->allocator, slot);
+    } else {
+        MA_FREE(pItem);
     }
 }
 
-MA_API ma_result ma_ex_audio_source_play_from_file(ma_ex_audio_source *source, const char *filePath, ma_bool8 streamFromDisk) {
-    if(source == NULL)
-        return MA_ERROR;
+static void ma_ex_pool_get_stats(ma_ex_pool *pool, ma_ex_pool_stats *pStats) {
+    if(pStats == NULL)
+        return;
+    pStats->capacity = pool->capacity;
+    pStats->used = pool->capacity > 0 ? ma_ex_atomic_load_32(&pool->allocator.count) : 0;
+    pStats->highWaterMark = ma_ex_atomic_load_32(&pool->highWaterMark);
+    pStats->overflowCount = ma_ex_atomic_load_32(&pool->overflowCount);
+}
 
-    if(filePath == NULL)
-        return MA_INVALID_FILE;
-    
-    ma_uint64 soundHash = ma_ex_create_hashcode(filePath, strlen(filePath));
+/* Takes a free slot, or a new one at the end. Must be called with the source lock held. */
+static ma_result ma_ex_source_table_alloc(ma_ex_source_table *table, ma_ex_audio_source *source, ma_ex_audio_source_handle *pHandle) {
+    ma_uint32 index;
+
+    if(table->freeHead != 0) {
+        index = table->freeHead - 1;
+        table->freeHead = table->pBlocks[index / MA_EX_SOURCE_BLOCK_SIZE]->nextFree[index % MA_EX_SOURCE_BLOCK_SIZE];
+    } else {
+        index = table->slotCount;
 
-    if(ma_ex_hashcode_is_same(source->clip.soundHash, soundHash) == MA_FALSE) {
-        ma_sound_uninit(&source->clip.sound);
+        if(index / MA_EX_SOURCE_BLOCK_SIZE >= table->blockCount) {
+            if(table->blockCount == MA_EX_MAX_SOURCE_BLOCKS)
+                return MA_OUT_OF_MEMORY;
 
-        source->clip.flags = MA_SOUND_FLAG_DECODE;
-        
-        if(streamFromDisk == MA_TRUE)
-            source->clip.flags |= MA_SOUND_FLAG_STREAM;
+            ma_ex_source_block *pBlock = MA_MALLOC(sizeof(ma_ex_source_block));
 
-        ma_result result = ma_sound_init_from_file(&source->context->engine, filePath, source->clip.flags, source->group, NULL, &source->clip.sound);
+            if(pBlock == NULL)
+                return MA_OUT_OF_MEMORY;
 
-        if(result != MA_SUCCESS) {
-            ma_sound_uninit(&source->clip.sound);
-            return MA_ERROR;
+            MA_ZERO_OBJECT(pBlock);
+            table->pBlocks[table->blockCount] = pBlock;
+            table->blockCount++;
         }
+
+        table->slotCount++;
     }
 
-    source->clip.soundHash = soundHash;
-    ma_ex_audio_source_apply_settings(source);
-    return ma_sound_start(&source->clip.sound);
-}
+    ma_ex_source_block *pBlock = table->pBlocks[index / MA_EX_SOURCE_BLOCK_SIZE];
+    ma_uint32 i = index % MA_EX_SOURCE_BLOCK_SIZE;
 
-MA_API ma_result ma_ex_audio_source_play_from_file_w(ma_ex_audio_source *source, const wchar_t *filePath, ma_bool8 streamFromDisk) {
-    if(source == NULL)
-        return MA_ERROR;
+    //Generation 0 is reserved so that 0 is never a valid handle
+    if(pBlock->generations[i] == 0)
+        pBlock->generations[i] = 1;
 
-    if(filePath == NULL)
-        return MA_INVALID_FILE;
-    
-    ma_uint64 soundHash = ma_ex_create_hashcode(filePath, wcslen(filePath));
+    pBlock->sources[i] = source;
+    *pHandle = ((ma_uint64)pBlock->generations[i] << 32) | index;
+    return MA_SUCCESS;
+}
 
-    if(ma_ex_hashcode_is_same(source->clip.soundHash, soundHash) == MA_FALSE) {
-        ma_sound_uninit(&source->clip.sound);
+/* Bumps the generation so outstanding handles to the slot become invalid. Must be called with the source lock held. */
+static void ma_ex_source_table_free(ma_ex_source_table *table, ma_ex_audio_source_handle handle) {
+    ma_uint32 index = (ma_uint32)(handle & 0xFFFFFFFF);
+    ma_ex_source_block *pBlock = table->pBlocks[index / MA_EX_SOURCE_BLOCK_SIZE];
+    ma_uint32 i = index % MA_EX_SOURCE_BLOCK_SIZE;
+    ma_uint32 generation = pBlock->generations[i] + 1;
+
+    pBlock->sources[i] = NULL;
+    pBlock->generations[i] = generation == 0 ? 1 : generation;
+    pBlock->nextFree[i] = table->freeHead;
+    table->freeHead = index + 1;
+}
 
-        source->clip.flags = MA_SOUND_FLAG_DECODE;
-        
-        if(streamFromDisk == MA_TRUE)
-            source->clip.flags |= MA_SOUND_FLAG_STREAM;
+/* Must be called with the source lock held, the slot may be freed and reused as soon as it is released. */
+static ma_ex_audio_source *ma_ex_source_table_get(ma_ex_source_table *table, ma_ex_audio_source_handle handle) {
+    ma_uint32 index = (ma_uint32)(handle & 0xFFFFFFFF);
+    ma_uint32 generation = (ma_uint32)(handle >> 32);
 
-        ma_result result = ma_sound_init_from_file_w(&source->context->engine, filePath, source->clip.flags, source->group, NULL, &source->clip.sound);
+    if(generation == 0 || index / MA_EX_SOURCE_BLOCK_SIZE >= MA_EX_MAX_SOURCE_BLOCKS)
+        return NULL;
 
-        if(result != MA_SUCCESS) {
-            ma_sound_uninit(&source->clip.sound);
-            return MA_ERROR;
-        }
-    }
+    ma_ex_source_block *pBlock = table->pBlocks[index / MA_EX_SOURCE_BLOCK_SIZE];
 
-    source->clip.soundHash = soundHash;
-    ma_ex_audio_source_apply_settings(source);
-    return ma_sound_start(&source->clip.sound);
+    if(pBlock == NULL || pBlock->generations[index % MA_EX_SOURCE_BLOCK_SIZE] != generation)
+        return NULL;
+
+    return pBlock->sources[index % MA_EX_SOURCE_BLOCK_SIZE];
 }
 
-MA_API ma_result ma_ex_audio_source_play_from_memory(ma_ex_audio_source *source, const void *pData, ma_uint64 dataSize) {
-    if(source == NULL)
-        return MA_ERROR;
+static void ma_ex_source_table_uninit(ma_ex_source_table *table) {
+    for(ma_uint32 i = 0; i < table->blockCount; i++)
+        MA_FREE(table->pBlocks[i]);
+    MA_ZERO_OBJECT(table);
+}
 
-    if(pData == NULL)
-        return MA_INVALID_DATA;
+static MA_INLINE ma_ex_source_block *ma_ex_audio_source_get_block(ma_ex_audio_source *source, ma_uint32 *pIndex) {
+    ma_uint32 index = (ma_uint32)(source->handle & 0xFFFFFFFF);
+    *pIndex = index % MA_EX_SOURCE_BLOCK_SIZE;
+    return source->context->sourceTable.pBlocks[index / MA_EX_SOURCE_BLOCK_SIZE];
+}
 
-    if(dataSize == 0)
-        return MA_INVALID_ARGS;
-    
-    ma_uint64 soundHash = ma_ex_pointer_to_hashcode(pData);
+static MA_INLINE float *ma_ex_audio_source_volume(ma_ex_audio_source *source) {
+    ma_uint32 i;
+    return &ma_ex_audio_source_get_block(source, &i)->volumes[i];
+}
 
-    if(ma_ex_hashcode_is_same(source->clip.soundHash, soundHash) == MA_FALSE) {
-        ma_sound_uninit(&source->clip.sound);
+static MA_INLINE float *ma_ex_audio_source_pitch(ma_ex_audio_source *source) {
+    ma_uint32 i;
+    return &ma_ex_audio_source_get_block(source, &i)->pitches[i];
+}
 
-        source->clip.flags = MA_SOUND_FLAG_DECODE;
+static MA_INLINE ma_vec3f *ma_ex_audio_source_position(ma_ex_audio_source *source) {
+    ma_uint32 i;
+    return &ma_ex_audio_source_get_block(source, &i)->positions[i];
+}
 
-        ma_result result = ma_sound_init_from_memory(&source->context->engine, pData, dataSize, source->clip.flags, source->group, NULL, &source->clip.sound);
+static void ma_ex_on_data_proc(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount) {
+    ma_engine *pEngine = (ma_engine *)pDevice->pUserData;
+    ma_ex_command_queue_try_drain(&ma_ex_context_from_engine(pEngine)->commandQueue);
+    ma_engine_read_pcm_frames(pEngine, pOutput, frameCount, NULL);
+    (void)pInput;
+}
 
-        if(result != MA_SUCCESS) {
-            ma_sound_uninit(&source->clip.sound);
-            return MA_ERROR;
-        }
-    }
+#define MA_EX_MAX_NATIVE_DATA_FORMATS (sizeof(((ma_device_info*)0)->nativeDataFormats) / sizeof(((ma_device_info*)0)->nativeDataFormats[0]))
 
-    source->clip.soundHash = soundHash;
-    ma_ex_audio_source_apply_settings(source);
-    return ma_sound_start(&source->clip.sound);
+static void ma_ex_device_enumerator_uninit(ma_ex_device_enumerator *enumerator) {
+    if(enumerator->pDevices != NULL)
+        MA_FREE(enumerator->pDevices);
+    enumerator->pDevices = NULL;
+    enumerator->pDeviceIDs = NULL;
+    enumerator->pFormatsQueried = NULL;
+    enumerator->deviceCount = 0;
+    enumerator->isValid = MA_FALSE;
 }
 
-MA_API ma_result ma_ex_audio_source_play_from_callback(ma_ex_audio_source *source, ma_procedural_data_source_proc callback, void *pUserData) {
-    if(source == NULL)
-        return MA_ERROR;
+static void ma_ex_device_info_copy_formats(ma_ex_device_info *pDst, const ma_device_info *pSrc) {
+    pDst->nativeDataFormatCount = pSrc->nativeDataFormatCount;
 
-    if(callback == NULL)
-        return MA_INVALID_ARGS;
-    
-    ma_uint64 soundHash = ma_ex_pointer_to_hashcode(callback);
+    for(ma_uint32 i = 0; i < pSrc->nativeDataFormatCount; i++) {
+        pDst->nativeDataFormats[i].format = pSrc->nativeDataFormats[i].format;
+        pDst->nativeDataFormats[i].channels = pSrc->nativeDataFormats[i].channels;
+        pDst->nativeDataFormats[i].sampleRate = pSrc->nativeDataFormats[i].sampleRate;
+        pDst->nativeDataFormats[i].flags = pSrc->nativeDataFormats[i].flags;
+    }
+}
 
-    if(ma_ex_hashcode_is_same(source->clip.soundHash, soundHash) == MA_FALSE) {
-        ma_sound_uninit(&source->clip.sound);
+/* Enumerates the playback devices into a single allocation. Native data formats are only copied when the backend reports them while enumerating. */
+static ma_result ma_ex_device_enumerator_refresh(ma_ex_device_enumerator *enumerator, ma_context *pContext) {
+    ma_device_info *pPlaybackInfos;
+    ma_uint32 playbackCount;
+    ma_device_info *pCaptureInfos;
+    ma_uint32 captureCount;
 
-        source->clip.flags = 0;
+    ma_result result = ma_context_get_devices(pContext, &pPlaybackInfos, &playbackCount, &pCaptureInfos, &captureCount);
 
-        ma_procedural_data_source_config config = ma_procedural_data_source_config_init(ma_format_f32, source->context->channels, source->context->sampleRate, callback, pUserData != NULL ? pUserData : source);
+    if(result != MA_SUCCESS)
+        return result;
 
-        ma_result result = ma_sound_init_from_callback(&source->context->engine, &config, source->clip.flags, source->group, NULL, &source->clip.sound);
+    ma_ex_device_enumerator_uninit(enumerator);
+    ma_ex_atomic_store_32(&enumerator->isDirty, MA_FALSE);
 
-        if(result != MA_SUCCESS) {
-            ma_sound_uninit(&source->clip.sound);
-            return MA_ERROR;
-        }
+    if(playbackCount == 0) {
+        enumerator->isValid = MA_TRUE;
+        return MA_SUCCESS;
     }
 
-    source->clip.soundHash = soundHash;
-    ma_ex_audio_source_apply_settings(source);
-    return ma_sound_start(&source->clip.sound);
-}
+    //Largest alignment first, names last
+    size_t devicesSize = sizeof(ma_ex_device_info) * playbackCount;
+    size_t idsSize = sizeof(ma_device_id) * playbackCount;
+    size_t formatsSize = sizeof(ma_ex_native_data_format) * MA_EX_MAX_NATIVE_DATA_FORMATS * playbackCount;
+    size_t queriedSize = playbackCount;
+    size_t namesSize = 0;
 
-MA_API void ma_ex_audio_source_stop(ma_ex_audio_source *source) {
-    if(source != NULL) {
-        ma_sound_stop(&source->clip.sound);
-    }
-}
+    for(ma_uint32 i = 0; i < playbackCount; i++)
+        namesSize += strlen(pPlaybackInfos[i].name) + 1;
 
-MA_API void ma_ex_audio_source_apply_settings(ma_ex_audio_source *source) {
-    if(source != NULL) {
-        ma_sound_set_attenuation_model(&source->clip.sound, source->settings.attenuationModel);
-        ma_sound_set_direction(&source->clip.sound, source->settings.direction.x, source->settings.direction.y, source->settings.direction.z);
-        ma_sound_set_doppler_factor(&source->clip.sound, source->settings.dopplerFactor);
-        ma_sound_set_looping(&source->clip.sound, source->settings.loop);
-        ma_sound_set_min_distance(&source->clip.sound, source->settings.minDistance);
-        ma_sound_set_max_distance(&source->clip.sound, source->settings.maxDistance);
-        ma_sound_set_pitch(&source->clip.sound, source->settings.pitch);
-        ma_sound_set_pan(&source->clip.sound, source->settings.pan);
-        ma_sound_set_pan_mode(&source->clip.sound, source->settings.panMode);
-        ma_sound_set_position(&source->clip.sound, source->settings.position.x, source->settings.position.y, source->settings.position.z);
-        ma_sound_set_spatialization_enabled(&source->clip.sound, source->settings.spatialization);
-        ma_sound_set_velocity(&source->clip.sound, source->settings.velocity.x, source->settings.velocity.y, source->settings.velocity.z);
-        ma_sound_set_volume(&source->clip.sound, source->settings.volume);
-    }
-}
+    ma_uint8 *pStorage = MA_MALLOC(devicesSize + idsSize + formatsSize + queriedSize + namesSize);
 
-MA_API void ma_ex_audio_source_set_volume(ma_ex_audio_source *source, float value) {
-    if(source != NULL) {
-        source->settings.volume = value;
-        ma_sound_set_volume(&source->clip.sound, value);
-    }
-}
+    if(pStorage == NULL)
+        return MA_OUT_OF_MEMORY;
 
-MA_API float ma_ex_audio_source_get_volume(ma_ex_audio_source *source) {
-    if(source != NULL)
-        return source->settings.volume;
-    return 1.0f;
-}
+    enumerator->pDevices = (ma_ex_device_info*)pStorage;
+    enumerator->pDeviceIDs = (ma_device_id*)(pStorage + devicesSize);
+    ma_ex_native_data_format *pFormats = (ma_ex_native_data_format*)(pStorage + devicesSize + idsSize);
+    enumerator->pFormatsQueried = pStorage + devicesSize + idsSize + formatsSize;
+    char *pNames = (char*)(enumerator->pFormatsQueried + queriedSize);
 
-MA_API void ma_ex_audio_source_set_pitch(ma_ex_audio_source *source, float value) {
-    if(source != NULL) {
-        source->settings.pitch = value;
-        ma_sound_set_pitch(&source->clip.sound, value);
-    }
-}
+    for(ma_uint32 i = 0; i < playbackCount; i++) {
+        ma_ex_device_info *pDeviceInfo = &enumerator->pDevices[i];
+        size_t length = strlen(pPlaybackInfos[i].name) + 1;
 
-MA_API float ma_ex_audio_source_get_pitch(ma_ex_audio_source *source) {
-    if(source != NULL)
-        return source->settings.pitch;
-    return 1.0f;
-}
+        memcpy(pNames, pPlaybackInfos[i].name, length);
+        pDeviceInfo->pName = pNames;
+        pNames += length;
 
-MA_API void ma_ex_audio_source_set_pan(ma_ex_audio_source *source, float value) {
-    if(source != NULL) {
-        source->settings.pan = value;
-        ma_sound_set_pan(&source->clip.sound, value);
+        pDeviceInfo->index = (ma_int32)i;
+        pDeviceInfo->isDefault = pPlaybackInfos[i].isDefault;
+        pDeviceInfo->nativeDataFormats = pFormats + (i * MA_EX_MAX_NATIVE_DATA_FORMATS);
+        ma_ex_device_info_copy_formats(pDeviceInfo, &pPlaybackInfos[i]);
+
+        enumerator->pDeviceIDs[i] = pPlaybackInfos[i].id;
+        enumerator->pFormatsQueried[i] = pPlaybackInfos[i].nativeDataFormatCount > 0;
     }
-}
 
-MA_API float ma_ex_audio_source_get_pan(ma_ex_audio_source *source) {
-    if(source != NULL)
-        return source->settings.pan;
-    return 0.0f;
+    enumerator->deviceCount = playbackCount;
+    enumerator->isValid = MA_TRUE;
+    return MA_SUCCESS;
 }
 
-MA_API void ma_ex_audio_source_set_pan_mode(ma_ex_audio_source *source, ma_pan_mode mode) {
-    if(source != NULL) {
-        source->settings.panMode = mode;
-        ma_sound_set_pan_mode(&source->clip.sound, mode);
-    }
-}
+static ma_result ma_ex_device_enumerator_query_formats(ma_ex_device_enumerator *enumerator, ma_context *pContext, ma_uint32 index) {
+    if(enumerator->pFormatsQueried[index])
+        return MA_SUCCESS;
 
-MA_API ma_pan_mode ma_ex_audio_source_get_pan_mode(ma_ex_audio_source *source) {
-    if(source != NULL)
-        return source->settings.panMode;
-    return ma_pan_mode_balance;
+    ma_device_info deviceInfo;
+    MA_ZERO_OBJECT(&deviceInfo);
+
+    ma_result result = ma_context_get_device_info(pContext, ma_device_type_playback, &enumerator->pDeviceIDs[index], &deviceInfo);
+
+    if(result != MA_SUCCESS)
+        return result;
+
+    ma_ex_device_info_copy_formats(&enumerator->pDevices[index], &deviceInfo);
+    enumerator->pFormatsQueried[index] = MA_TRUE;
+    return MA_SUCCESS;
 }
 
-MA_API void ma_ex_audio_source_set_pcm_position(ma_ex_audio_source *source, ma_uint64 position) {
-    if(source != NULL) {
-        ma_sound_seek_to_pcm_frame(&source->clip.sound, position);
+MA_API ma_ex_device_info *ma_ex_playback_devices_get(ma_uint32 *count) {
+    *count = 0;
+
+    ma_context context;
+    ma_result result = ma_context_init(NULL, 0, NULL, &context);
+    
+    if (result != MA_SUCCESS) {
+        return NULL;
     }
-}
 
-MA_API ma_uint64 ma_ex_audio_source_get_pcm_position(ma_ex_audio_source *source) {
-    if(source != NULL) {
-        return ma_sound_get_time_in_pcm_frames(&source->clip.sound);
+    ma_ex_device_enumerator enumerator;
+    MA_ZERO_OBJECT(&enumerator);
+
+    if(ma_ex_device_enumerator_refresh(&enumerator, &context) != MA_SUCCESS || enumerator.deviceCount == 0) {
+        ma_ex_device_enumerator_uninit(&enumerator);
+        ma_context_uninit(&context);
+        return NULL;
     }
-    return 0;
-}
 
-MA_API ma_uint64 ma_ex_audio_source_get_pcm_length(ma_ex_audio_source *source) {
-    if(source != NULL) {
-        ma_data_source *dataSource = ma_sound_get_data_source(&source->clip.sound);
-        if(dataSource != NULL) {
-            ma_uint64 length = 0;
-            ma_data_source_get_length_in_pcm_frames(dataSource, &length);
-            return length;
+    for(ma_uint32 i = 0; i < enumerator.deviceCount; i++) {
+        if(ma_ex_device_enumerator_query_formats(&enumerator, &context, i) != MA_SUCCESS) {
+            ma_ex_device_enumerator_uninit(&enumerator);
+            ma_context_uninit(&context);
+            return NULL;
         }
     }
-    return 0;
-}
 
-MA_API void ma_ex_audio_source_set_loop(ma_ex_audio_source *source, ma_bool32 loop) {
-    if(source != NULL) {
-        source->settings.loop = loop;
-        ma_sound_set_looping(&source->clip.sound, loop);
-    }
-}
+    ma_context_uninit(&context);
+    *count = enumerator.deviceCount;
 
-MA_API ma_bool32 ma_ex_audio_source_get_loop(ma_ex_audio_source *source) {
-    if(source != NULL)
-        return source->settings.loop;
-    return MA_FALSE;
+    //The views are the start of the allocation, so the caller frees everything with ma_ex_playback_devices_free
+    return enumerator.pDevices;
 }
 
-MA_API void ma_ex_audio_source_set_position(ma_ex_audio_source *source, float x, float y, float z) {
-    if(source != NULL) {
-        ma_ex_vec3f_set(&source->settings.position, x, y, z);
-        ma_sound_set_position(&source->clip.sound, x, y, z);
-    }
+MA_API void ma_ex_playback_devices_free(ma_ex_device_info *pDeviceInfo, ma_uint32 count) {
+    (void)count;
+    if(pDeviceInfo != NULL)
+        MA_FREE(pDeviceInfo);
 }
 
-MA_API void ma_ex_audio_source_get_position(ma_ex_audio_source *source, float *x, float *y, float *z) {
-    if(source != NULL) {
-        ma_ex_vec3f_get(&source->settings.position, x, y, z);
+MA_API ma_ex_context_config ma_ex_context_config_init(ma_uint32 sampleRate, ma_uint8 channels, ma_uint32 periodSizeInFrames, const ma_ex_device_info *pDeviceInfo) {
+    MA_ASSERT(sampleRate > 0);
+    MA_ASSERT(channels > 0);
+
+    ma_ex_context_config config;
+    MA_ZERO_OBJECT(&config);
+    config.sampleRate = sampleRate;
+    config.channels = channels;
+    config.periodSizeInFrames = periodSizeInFrames == 0 ? 0 : ma_next_power_of_two(periodSizeInFrames);
+    config.deviceDataProc = NULL;
+    config.noDevice = MA_FALSE;
+    config.maxVoices = 0;
+    config.voiceStealFadeInMilliseconds = 10;
+    config.virtualVoices = MA_FALSE;
+    config.virtualVoiceThreshold = 0.0f;
+    config.shareMemoryDecodes = MA_FALSE;
+    config.parallelInit = MA_FALSE;
+    config.deferDeviceStart = MA_FALSE;
+    config.jobThreadCount = 0;
+    config.jobQueueCapacity = 0;
+    config.cacheBudgetInBytes = 0;
+    config.pDecodeCacheDirectory = NULL;
+    config.readAheadThreadCount = 0;
+    config.readAheadBlockSize = 0;
+    config.streamPagePoolSizeInBytes = 0;
+    config.streamPageMinMilliseconds = 0;
+    config.streamPageMaxMilliseconds = 0;
+    config.decodeSegmentMinMilliseconds = 0;
+    config.mp3SeekPointMilliseconds = 1000;
+    config.saveMP3SeekTables = MA_FALSE;
+    config.memoryMappedFiles = MA_FALSE;
+
+    if(pDeviceInfo == NULL) {
+        config.deviceInfo.index = -1;
     } else {
-        *x = 0.0f;
-        *y = 0.0f;
-        *z = 0.0f;
+        config.deviceInfo = *pDeviceInfo;
     }
+
+    return config;
 }
 
-MA_API void ma_ex_audio_source_set_direction(ma_ex_audio_source *source, float x, float y, float z) {
-    if(source != NULL) {
-        ma_ex_vec3f_set(&source->settings.direction, x, y, z);
-        ma_sound_set_direction(&source->clip.sound, x, y, z);
-    }
+static MA_INLINE ma_bool32 ma_ex_audio_source_is_voice(ma_ex_audio_source *source) {
+    //A zeroed sound reports itself as started, so make sure it has been initialized first
+    if(source->isStolen || source->isVirtual || ma_sound_get_engine(source->pSound) == NULL)
+        return MA_FALSE;
+    return ma_sound_is_playing(source->pSound);
 }
 
-MA_API void ma_ex_audio_source_get_direction(ma_ex_audio_source *source, float *x, float *y, float *z) {
-    if(source != NULL) {
-        ma_ex_vec3f_get(&source->settings.direction, x, y, z);
-    } else {
-        *x = 0.0f;
-        *y = 0.0f;
-        *z = 0.0f;
+static float ma_ex_audio_source_get_distance_gain(ma_ex_audio_source *source) {
+    if(!source->settings.spatialization)
+        return 1.0f;
+
+    ma_engine *pEngine = &source->context->engine;
+    const ma_vec3f *position = ma_ex_audio_source_position(source);
+    ma_uint32 listenerIndex = ma_engine_find_closest_listener(pEngine, position->x, position->y, position->z);
+    ma_vec3f listenerPosition = ma_engine_listener_get_position(pEngine, listenerIndex);
+
+    float dx = position->x - listenerPosition.x;
+    float dy = position->y - listenerPosition.y;
+    float dz = position->z - listenerPosition.z;
+    float distance = sqrtf(dx*dx + dy*dy + dz*dz);
+    float minDistance = source->settings.minDistance;
+    float maxDistance = source->settings.maxDistance;
+    float rolloff = ma_sound_get_rolloff(source->pSound);
+
+    if(distance < minDistance)
+        distance = minDistance;
+    if(distance > maxDistance)
+        distance = maxDistance;
+
+    switch(source->settings.attenuationModel) {
+        case ma_attenuation_model_inverse:
+            if(minDistance <= 0.0f)
+                return 1.0f;
+            return minDistance / (minDistance + rolloff * (distance - minDistance));
+        case ma_attenuation_model_linear:
+            if(maxDistance <= minDistance)
+                return 1.0f;
+            return 1.0f - rolloff * (distance - minDistance) / (maxDistance - minDistance);
+        case ma_attenuation_model_exponential:
+            if(minDistance <= 0.0f)
+                return 1.0f;
+            return powf(distance / minDistance, -rolloff);
+        default:
+            return 1.0f;
     }
 }
 
-MA_API void ma_ex_audio_source_set_velocity(ma_ex_audio_source *source, float x, float y, float z) {
-    if(source != NULL) {
-        ma_ex_vec3f_set(&source->settings.velocity, x, y, z);
-        ma_sound_set_velocity(&source->clip.sound, x, y, z);
-    }
+/* An estimate of how loud the source currently is, taking its volume, its group's volume and its distance to the closest listener into account. */
+static float ma_ex_audio_source_get_audibility(ma_ex_audio_source *source) {
+    float gain = *ma_ex_audio_source_volume(source) * ma_ex_audio_source_get_distance_gain(source);
+
+    if(source->group != NULL)
+        gain *= ma_sound_group_get_volume(source->group);
+
+    return gain < 0.0f ? 0.0f : gain;
 }
 
-MA_API void ma_ex_audio_source_get_velocity(ma_ex_audio_source *source, float *x, float *y, float *z) {
-    if(source != NULL) {
-        ma_ex_vec3f_get(&source->settings.velocity, x, y, z);
-    } else {
-        *x = 0.0f;
-        *y = 0.0f;
-        *z = 0.0f;
+static ma_ex_sound_group_voice_limit *ma_ex_find_group_voice_limit(ma_ex_context *context, ma_sound_group *group) {
+    for(ma_uint32 i = 0; i < context->groupVoiceLimitCount; i++) {
+        if(context->pGroupVoiceLimits[i].group == group)
+            return &context->pGroupVoiceLimits[i];
     }
+    return NULL;
 }
 
-MA_API void ma_ex_audio_source_set_spatialization(ma_ex_audio_source *source, ma_bool32 enabled) {
-    if(source != NULL) {
-        source->settings.spatialization = enabled;
-        ma_sound_set_spatialization_enabled(&source->clip.sound, enabled);
+/* Picks the voice with the lowest priority, and of those the quietest one. When group is not NULL only voices in that group are considered. */
+static ma_ex_audio_source *ma_ex_find_voice_to_steal(ma_ex_context *context, ma_sound_group *group, ma_ex_audio_source *exclude) {
+    ma_ex_audio_source *pVictim = NULL;
+    float victimAudibility = 0.0f;
+
+    for(ma_ex_audio_source *pSource = context->pSourceHead; pSource != NULL; pSource = pSource->pNext) {
+        if(pSource == exclude || !ma_ex_audio_source_is_voice(pSource))
+            continue;
+
+        if(group != NULL && pSource->group != group)
+            continue;
+
+        float audibility = ma_ex_audio_source_get_audibility(pSource);
+
+        if(pVictim == NULL || pSource->priority < pVictim->priority || (pSource->priority == pVictim->priority && audibility < victimAudibility)) {
+            pVictim = pSource;
+            victimAudibility = audibility;
+        }
     }
-}
 
-MA_API ma_bool32 ma_ex_audio_source_get_spatialization(ma_ex_audio_source *source) {
-    if(source != NULL)
-        return source->settings.spatialization;
-    return MA_FALSE;
+    return pVictim;
+}
+
+/* Makes room for the source to start playing by stealing voices when the context or group voice limit is reached. The source lock must be held. */
+static ma_result ma_ex_audio_source_acquire_voice_locked(ma_ex_audio_source *source) {
+    ma_ex_context *context = source->context;
+    ma_result result = MA_SUCCESS;
+
+    if(ma_ex_audio_source_is_voice(source))
+        return MA_SUCCESS;
+
+    ma_ex_sound_group_voice_limit *pGroupLimit = source->group != NULL ? ma_ex_find_group_voice_limit(context, source->group) : NULL;
+    ma_uint32 maxGroupVoices = pGroupLimit != NULL ? pGroupLimit->maxVoices : 0;
+
+    if(context->maxVoices > 0 || maxGroupVoices > 0) {
+        for(;;) {
+            ma_uint32 voiceCount = 0;
+            ma_uint32 groupVoiceCount = 0;
+
+            for(ma_ex_audio_source *pSource = context->pSourceHead; pSource != NULL; pSource = pSource->pNext) {
+                if(pSource == source || !ma_ex_audio_source_is_voice(pSource))
+                    continue;
+                voiceCount++;
+                if(pSource->group == source->group)
+                    groupVoiceCount++;
+            }
+
+            ma_ex_audio_source *pVictim = NULL;
+
+            if(maxGroupVoices > 0 && groupVoiceCount >= maxGroupVoices)
+                pVictim = ma_ex_find_voice_to_steal(context, source->group, source);
+            else if(context->maxVoices > 0 && voiceCount >= context->maxVoices)
+                pVictim = ma_ex_find_voice_to_steal(context, NULL, source);
+            else
+                break;
+
+            if(pVictim == NULL || pVictim->priority > source->priority) {
+                result = MA_NO_SPACE;
+                break;
+            }
+
+            pVictim->isStolen = MA_TRUE;
+            ma_sound_stop_with_fade_in_milliseconds(pVictim->pSound, context->voiceStealFadeInMilliseconds);
+        }
+    }
+
+    return result;
+}
+
+/* The position a virtual source would be at had it kept playing, advanced from engine time. */
+static ma_uint64 ma_ex_audio_source_get_virtual_cursor(ma_ex_audio_source *source, ma_bool32 *pAtEnd) {
+    ma_uint64 length = 0;
+    ma_uint32 sampleRate = 0;
+    ma_uint64 elapsed = ma_engine_get_time_in_pcm_frames(&source->context->engine) - source->virtualStartTime;
+
+    ma_sound_get_length_in_pcm_frames(source->pSound, &length);
+    ma_sound_get_data_format(source->pSound, NULL, NULL, &sampleRate, NULL, 0);
+
+    if(sampleRate == 0)
+        sampleRate = source->context->sampleRate;
+
+    double framesAdvanced = (double)elapsed * *ma_ex_audio_source_pitch(source) * ((double)sampleRate / (double)source->context->sampleRate);
+    ma_uint64 cursor = source->virtualStartCursor + (ma_uint64)(framesAdvanced < 0.0 ? 0.0 : framesAdvanced);
+
+    *pAtEnd = MA_FALSE;
+
+    if(length > 0 && cursor >= length) {
+        if(source->settings.loop) {
+            cursor %= length;
+        } else {
+            cursor = length;
+            *pAtEnd = MA_TRUE;
+        }
+    }
+
+    return cursor;
+}
+
+static void ma_ex_audio_source_virtualize(ma_ex_audio_source *source) {
+    ma_uint64 cursor = 0;
+    ma_uint64 length = 0;
+
+    //Without a known length there's no way to tell where the cursor should be when the source becomes audible again
+    if(ma_sound_get_length_in_pcm_frames(source->pSound, &length) != MA_SUCCESS || length == 0)
+        return;
+
+    if(ma_sound_get_cursor_in_pcm_frames(source->pSound, &cursor) != MA_SUCCESS)
+        return;
+
+    source->virtualStartCursor = cursor;
+    source->virtualStartTime = ma_engine_get_time_in_pcm_frames(&source->context->engine);
+    source->isVirtual = MA_TRUE;
+
+    //Fading out avoids a click when a source that is still faintly audible is cut off
+    ma_sound_stop_with_fade_in_milliseconds(source->pSound, source->context->voiceStealFadeInMilliseconds);
+}
+
+/* Seeks a virtual source to where it would have been and makes it a real voice again. Returns MA_FALSE if it reached its end while virtual. */
+static ma_bool32 ma_ex_audio_source_devirtualize(ma_ex_audio_source *source) {
+    ma_bool32 atEnd;
+    ma_uint64 cursor = ma_ex_audio_source_get_virtual_cursor(source, &atEnd);
+
+    source->isVirtual = MA_FALSE;
+
+    //A source that finished while it was virtual stays stopped
+    if(atEnd)
+        return MA_FALSE;
+
+    ma_sound_reset_stop_time_and_fade(source->pSound);
+    ma_sound_seek_to_pcm_frame(source->pSound, cursor);
+    return MA_TRUE;
+}
+
+
+static ma_result ma_ex_audio_source_start(ma_ex_audio_source *source) {
+    //ma_ex_context_update virtualizes and devirtualizes sources under the same lock
+    ma_spinlock_lock(&source->context->sourceLock);
+
+    if(source->isVirtual) {
+        if(source->context->virtualVoices && ma_ex_audio_source_get_audibility(source) <= source->context->virtualVoiceThreshold) {
+            ma_spinlock_unlock(&source->context->sourceLock);
+            return MA_SUCCESS;
+        }
+
+        //Playing a source that finished while it was virtual starts it over, like it would for a real voice
+        if(!ma_ex_audio_source_devirtualize(source)) {
+            ma_sound_reset_stop_time_and_fade(source->pSound);
+            ma_sound_seek_to_pcm_frame(source->pSound, 0);
+        }
+    }
+
+    ma_result result = ma_ex_audio_source_acquire_voice_locked(source);
+
+    if(result == MA_SUCCESS && source->isStolen) {
+        ma_sound_reset_stop_time_and_fade(source->pSound);
+        source->isStolen = MA_FALSE;
+    }
+
+    ma_spinlock_unlock(&source->context->sourceLock);
+
+    if(result != MA_SUCCESS)
+        return result;
+
+    ma_ex_audio_source_apply_settings(source);
+
+    if(!source->context->noDevice) {
+        result = ma_ex_context_start_device(source->context);
+
+        if(result != MA_SUCCESS)
+            return result;
+    }
+
+    return ma_sound_start(source->pSound);
+}
+
+static ma_result ma_ex_context_init_backend(ma_ex_context *context) {
+    if(context->isBackendInitialized)
+        return MA_SUCCESS;
+
+    ma_result result = ma_context_init(NULL, 0, NULL, &context->context);
+
+    if(result != MA_SUCCESS)
+        return result;
+
+    context->isBackendInitialized = MA_TRUE;
+    return MA_SUCCESS;
+}
+
+static void ma_ex_context_uninit_backend(ma_ex_context *context) {
+    if(!context->isBackendInitialized)
+        return;
+    ma_context_uninit(&context->context);
+    context->isBackendInitialized = MA_FALSE;
+}
+
+static ma_ex_context *ma_ex_context_from_device(ma_device *pDevice) {
+    return (ma_ex_context*)((ma_uint8*)pDevice - offsetof(ma_ex_context, device));
+}
+
+static void ma_ex_on_device_notification(const ma_device_notification *pNotification) {
+    //A different device might be the default now, or one might have been added or removed
+    if(pNotification->type == ma_device_notification_type_rerouted || pNotification->type == ma_device_notification_type_interruption_ended)
+        ma_ex_atomic_store_32(&ma_ex_context_from_device(pNotification->pDevice)->playbackDevices.isDirty, MA_TRUE);
+}
+
+static ma_result ma_ex_context_init_device(ma_ex_context *context, const ma_ex_context_config *config) {
+    if (ma_ex_context_init_backend(context) != MA_SUCCESS) {
+        fprintf(stderr, "Failed to initialize ma_context\n");
+        return MA_ERROR;
+    }
+
+    ma_device_config deviceConfig = ma_device_config_init(ma_device_type_playback);
+    deviceConfig.playback.format = context->format;
+    deviceConfig.playback.channels = context->channels;
+    deviceConfig.sampleRate = context->sampleRate;
+    deviceConfig.dataCallback = config->deviceDataProc == NULL ? &ma_ex_on_data_proc : config->deviceDataProc;
+    deviceConfig.notificationCallback = ma_ex_on_device_notification;
+    deviceConfig.periodSizeInFrames = config->periodSizeInFrames;
+
+    ma_device_id *pSelectedDevice = NULL;
+
+    //Only enumerate when a specific device was asked for, the result is kept for ma_ex_context_get_playback_devices
+    if(config->deviceInfo.index >= 0) {
+        if (ma_ex_device_enumerator_refresh(&context->playbackDevices, &context->context) != MA_SUCCESS) {
+            fprintf(stderr, "Failed to get playback devices\n");
+            ma_ex_context_uninit_backend(context);
+            return MA_ERROR;
+        }
+
+        if(config->deviceInfo.index >= (ma_int32)context->playbackDevices.deviceCount) {
+            fprintf(stderr, "Device index is greater than or equal to the number of playback devices\n");
+            ma_ex_context_uninit_backend(context);
+            return MA_INVALID_ARGS;
+        }
+
+        pSelectedDevice = &context->playbackDevices.pDeviceIDs[config->deviceInfo.index];
+    }
+
+    deviceConfig.playback.pDeviceID = pSelectedDevice;
+
+    if(ma_device_init(&context->context, &deviceConfig, &context->device) != MA_SUCCESS) {
+        fprintf(stderr, "Failed to initialize ma_device\n");
+        ma_ex_context_uninit_backend(context);
+        return MA_ERROR;
+    }
+
+    return MA_SUCCESS;
+}
+
+static void ma_ex_context_uninit_device(ma_ex_context *context) {
+    if(!context->noDevice)
+        ma_device_uninit(&context->device);
+    ma_ex_context_uninit_backend(context);
+}
+
+typedef struct {
+    ma_ex_context *context;
+    const ma_ex_context_config *config;
+    ma_result result;
+} ma_ex_device_init_job;
+
+static ma_thread_result MA_THREADCALL ma_ex_device_init_thread(void *pData) {
+    ma_ex_device_init_job *job = (ma_ex_device_init_job*)pData;
+    job->result = ma_ex_context_init_device(job->context, job->config);
+    return (ma_thread_result)0;
+}
+
+/* Initializes the device on a separate thread. When no thread can be created the device is initialized on the calling thread. */
+static void ma_ex_context_init_device_async(ma_ex_device_init_job *job, ma_bool32 *pIsThreaded, ma_thread *pThread) {
+    *pIsThreaded = ma_thread_create(pThread, ma_thread_priority_default, 0, ma_ex_device_init_thread, job, NULL) == MA_SUCCESS;
+
+    if(!*pIsThreaded)
+        job->result = ma_ex_context_init_device(job->context, job->config);
+}
+
+static ma_result ma_ex_context_wait_device(ma_ex_device_init_job *job, ma_bool32 isThreaded, ma_thread *pThread) {
+    if(isThreaded)
+        ma_thread_wait(pThread);
+
+    return job->result;
+}
+
+static ma_result ma_ex_context_init_resource_manager(ma_ex_context *context, const ma_ex_context_config *config) {
+    ma_decoding_backend_vtable *pCustomBackendVTables[] = {
+        ma_libvorbis_get_decoding_backend()
+    };
+
+    ma_resource_manager_config resourceManagerConfig = ma_resource_manager_config_init();
+    resourceManagerConfig.ppCustomDecodingBackendVTables = pCustomBackendVTables;
+    resourceManagerConfig.customDecodingBackendCount = sizeof(pCustomBackendVTables)/sizeof(pCustomBackendVTables[0]);
+
+    //libvorbis seeks to an exact frame, so long Vorbis files can be decoded in segments too
+    resourceManagerConfig.ppSegmentedDecodingBackendVTables = pCustomBackendVTables;
+    resourceManagerConfig.segmentedDecodingBackendCount = sizeof(pCustomBackendVTables)/sizeof(pCustomBackendVTables[0]);
+
+    if(config->jobThreadCount > 0)
+        resourceManagerConfig.jobThreadCount = config->jobThreadCount;
+    if(config->jobQueueCapacity > 0)
+        resourceManagerConfig.jobQueueCapacity = config->jobQueueCapacity;
+
+    resourceManagerConfig.cacheBudgetInBytes = config->cacheBudgetInBytes;
+    resourceManagerConfig.streamPagePoolSizeInBytes = config->streamPagePoolSizeInBytes;
+
+    if(config->streamPageMinMilliseconds > 0)
+        resourceManagerConfig.streamPageMinSizeInMilliseconds = config->streamPageMinMilliseconds;
+    if(config->streamPageMaxMilliseconds > 0)
+        resourceManagerConfig.streamPageMaxSizeInMilliseconds = config->streamPageMaxMilliseconds;
+    if(config->decodeSegmentMinMilliseconds > 0)
+        resourceManagerConfig.decodeSegmentMinSizeInMilliseconds = config->decodeSegmentMinMilliseconds;
+
+    resourceManagerConfig.mp3SeekPointIntervalInMilliseconds = config->mp3SeekPointMilliseconds;
+    resourceManagerConfig.saveMP3SeekTables = config->saveMP3SeekTables;
+
+    //The resource manager opens every file it decodes or streams through its VFS, including the ones handled by libvorbis
+    if(config->memoryMappedFiles && ma_ex_mmap_vfs_init(&context->vfs) == MA_SUCCESS)
+        resourceManagerConfig.pVFS = &context->vfs;
+
+    //Stream pages are decoded on the job threads, read ahead keeps those from waiting on the disk
+    if(config->readAheadThreadCount > 0 && ma_ex_readahead_vfs_init(&context->readAheadVFS, (ma_vfs*)resourceManagerConfig.pVFS, config->readAheadThreadCount, config->readAheadBlockSize) == MA_SUCCESS)
+        resourceManagerConfig.pVFS = &context->readAheadVFS;
+
+    if (ma_resource_manager_init(&resourceManagerConfig, &context->resourceManager) != MA_SUCCESS) {
+        fprintf(stderr, "Failed to initialize ma_resource_manager\n");
+        return MA_ERROR;
+    }
+
+    return MA_SUCCESS;
+}
+
+/* Takes a reference to a clip found in the clip cache, unless its last reference is already being released. */
+static ma_bool32 ma_ex_audio_clip_try_acquire(ma_ex_audio_clip *clip) {
+    ma_uint32 refCount = ma_ex_atomic_load_32(&clip->refCount);
+
+    while(refCount > 0) {
+        if(ma_ex_atomic_compare_exchange_32(&clip->refCount, refCount, refCount + 1))
+            return MA_TRUE;
+        refCount = ma_ex_atomic_load_32(&clip->refCount);
+    }
+
+    return MA_FALSE;
+}
+
+static ma_ex_clip_cache_entry *ma_ex_clip_cache_find(ma_ex_context *context, ma_uint64 hash, const char *filePath) {
+    ma_ex_clip_cache_entry *entry = context->pClipCache[hash % MA_EX_CLIP_CACHE_BUCKET_COUNT];
+
+    while(entry != NULL) {
+        if(entry->hash == hash && strcmp(entry->pFilePath, filePath) == 0)
+            return entry;
+        entry = entry->pNext;
+    }
+
+    return NULL;
+}
+
+/* Looks up a path in the clip cache. Returns NULL when no clip of the path is playing. */
+static ma_ex_audio_clip *ma_ex_clip_cache_acquire(ma_ex_context *context, ma_uint64 hash, const char *filePath) {
+    ma_ex_audio_clip *clip = NULL;
+
+    ma_spinlock_lock(&context->clipCacheLock);
+
+    ma_ex_clip_cache_entry *entry = ma_ex_clip_cache_find(context, hash, filePath);
+
+    if(entry != NULL && ma_ex_audio_clip_try_acquire(entry->clip))
+        clip = entry->clip;
+
+    ma_spinlock_unlock(&context->clipCacheLock);
+    return clip;
+}
+
+/*
+Shares a clip created by the fast path. When another thread cached a clip for the same path first, that clip is returned
+instead of the given one. Files the fast path couldn't handle are not recorded, they would otherwise stay in the cache
+for the lifetime of the context.
+*/
+static ma_ex_audio_clip *ma_ex_clip_cache_insert(ma_ex_context *context, ma_uint64 hash, const char *filePath, ma_ex_audio_clip *clip) {
+    if(clip == NULL)
+        return NULL;
+
+    size_t length = strlen(filePath);
+    ma_ex_clip_cache_entry *newEntry = MA_MALLOC(sizeof(ma_ex_clip_cache_entry) + length + 1);
+
+    //Without an entry the clip still plays, it just isn't shared
+    if(newEntry == NULL)
+        return clip;
+
+    ma_ex_audio_clip *existingClip = NULL;
+
+    ma_spinlock_lock(&context->clipCacheLock);
+
+    ma_ex_clip_cache_entry *entry = ma_ex_clip_cache_find(context, hash, filePath);
+
+    if(entry == NULL) {
+        entry = newEntry;
+        newEntry = NULL;
+        memcpy(entry + 1, filePath, length + 1);
+        entry->hash = hash;
+        entry->pFilePath = (const char*)(entry + 1);
+        entry->clip = NULL;
+        entry->pNext = context->pClipCache[hash % MA_EX_CLIP_CACHE_BUCKET_COUNT];
+        context->pClipCache[hash % MA_EX_CLIP_CACHE_BUCKET_COUNT] = entry;
+    } else if(ma_ex_audio_clip_try_acquire(entry->clip)) {
+        existingClip = entry->clip;
+    }
+
+    if(existingClip == NULL) {
+        //A clip whose last reference is being released gives up the entry
+        if(entry->clip != NULL)
+            entry->clip->pCacheEntry = NULL;
+        entry->clip = clip;
+        clip->pCacheEntry = entry;
+    }
+
+    ma_spinlock_unlock(&context->clipCacheLock);
+
+    if(newEntry != NULL)
+        MA_FREE(newEntry);
+
+    if(existingClip != NULL) {
+        ma_ex_audio_clip_uninit(clip);
+        return existingClip;
+    }
+
+    return clip;
+}
+
+/* Called when the last reference to a clip is released, so the next play of its path maps the file again. */
+static void ma_ex_clip_cache_remove(ma_ex_audio_clip *clip) {
+    ma_ex_context *context = clip->context;
+    ma_ex_clip_cache_entry *entry;
+
+    ma_spinlock_lock(&context->clipCacheLock);
+
+    entry = clip->pCacheEntry;
+
+    if(entry != NULL) {
+        ma_ex_clip_cache_entry **ppLink = &context->pClipCache[entry->hash % MA_EX_CLIP_CACHE_BUCKET_COUNT];
+        while(*ppLink != entry)
+            ppLink = &(*ppLink)->pNext;
+        *ppLink = entry->pNext;
+        clip->pCacheEntry = NULL;
+    }
+
+    ma_spinlock_unlock(&context->clipCacheLock);
+
+    if(entry != NULL)
+        MA_FREE(entry);
+}
+
+static void ma_ex_clip_cache_uninit(ma_ex_context *context) {
+    for(size_t i = 0; i < MA_EX_CLIP_CACHE_BUCKET_COUNT; i++) {
+        ma_ex_clip_cache_entry *entry = context->pClipCache[i];
+
+        while(entry != NULL) {
+            ma_ex_clip_cache_entry *next = entry->pNext;
+            if(entry->clip != NULL)
+                entry->clip->pCacheEntry = NULL;
+            MA_FREE(entry);
+            entry = next;
+        }
+
+        context->pClipCache[i] = NULL;
+    }
+}
+
+/* Releases the allocations owned directly by the context. Safe to call on a partially initialized context. */
+static void ma_ex_context_free(ma_ex_context *context) {
+    ma_ex_clip_cache_uninit(context);
+    if(context->pVerifiedDecodeCacheKeys != NULL)
+        ma_free(context->pVerifiedDecodeCacheKeys, NULL);
+    ma_ex_device_enumerator_uninit(&context->playbackDevices);
+    ma_ex_readahead_vfs_uninit(&context->readAheadVFS);
+    if(context->pDecodeCacheDirectory != NULL)
+        MA_FREE(context->pDecodeCacheDirectory);
+    if(context->pGroupVoiceLimits != NULL)
+        ma_free(context->pGroupVoiceLimits, NULL);
+    ma_ex_source_table_uninit(&context->sourceTable);
+    ma_ex_pool_uninit(&context->soundPool);
+    ma_ex_pool_uninit(&context->soundGroupPool);
+    ma_ex_pool_uninit(&context->listenerPool);
+    ma_ex_pool_uninit(&context->sourcePool);
+    ma_ex_command_queue_uninit(&context->commandQueue);
+    MA_FREE(context);
+}
+
+MA_API ma_ex_context *ma_ex_context_init(const ma_ex_context_config *config) {
+    MA_ASSERT(config != NULL);
+    MA_ASSERT(config->sampleRate > 0);
+    MA_ASSERT(config->channels > 0);
+
+    ma_ex_context *context = MA_MALLOC(sizeof(ma_ex_context));
+    MA_ZERO_OBJECT(context);
+    MA_ZERO_OBJECT(&context->context);
+    MA_ZERO_OBJECT(&context->engine);
+    MA_ZERO_OBJECT(&context->device);
+    MA_ZERO_OBJECT(&context->resourceManager);
+
+    context->sampleRate = config->sampleRate;
+    context->channels = config->channels;
+    context->format = ma_format_f32;
+    context->noDevice = config->noDevice;
+    context->maxVoices = config->maxVoices;
+    context->voiceStealFadeInMilliseconds = config->voiceStealFadeInMilliseconds;
+    context->virtualVoices = config->virtualVoices;
+    context->virtualVoiceThreshold = config->virtualVoiceThreshold;
+    context->shareMemoryDecodes = config->shareMemoryDecodes;
+    context->memoryMappedFiles = config->memoryMappedFiles;
+
+    if(config->pDecodeCacheDirectory != NULL) {
+        size_t length = strlen(config->pDecodeCacheDirectory);
+
+        //A trailing separator would end up doubled in the cache file paths
+        while(length > 1 && (config->pDecodeCacheDirectory[length - 1] == '/' || config->pDecodeCacheDirectory[length - 1] == '\\'))
+            length--;
+
+        context->pDecodeCacheDirectory = MA_MALLOC(length + 1);
+        if(context->pDecodeCacheDirectory != NULL) {
+            memcpy(context->pDecodeCacheDirectory, config->pDecodeCacheDirectory, length);
+            context->pDecodeCacheDirectory[length] = '\0';
+        }
+    }
+
+    if(ma_ex_command_queue_init(&context->commandQueue, config->commandQueueCapacity) != MA_SUCCESS) {
+        fprintf(stderr, "Failed to allocate the command queue\n");
+        ma_ex_context_free(context);
+        return NULL;
+    }
+
+    if(ma_ex_pool_init(&context->sourcePool, sizeof(ma_ex_audio_source), config->sourcePoolCapacity) != MA_SUCCESS ||
+       ma_ex_pool_init(&context->listenerPool, sizeof(ma_ex_audio_listener), config->listenerPoolCapacity) != MA_SUCCESS ||
+       ma_ex_pool_init(&context->soundGroupPool, sizeof(ma_sound_group), config->soundGroupPoolCapacity) != MA_SUCCESS ||
+       ma_ex_pool_init(&context->soundPool, sizeof(ma_sound), config->sourcePoolCapacity) != MA_SUCCESS) {
+        fprintf(stderr, "Failed to allocate the object pools\n");
+        ma_ex_context_free(context);
+        return NULL;
+    }
+
+    ma_ex_device_init_job deviceJob = { context, config, MA_SUCCESS };
+    ma_bool32 isDeviceThreaded = MA_FALSE;
+    ma_thread deviceThread;
+
+    //With parallelInit the device is negotiated while the resource manager and its job threads come up
+    ma_bool32 isParallel = config->parallelInit && !context->noDevice;
+
+    if(isParallel) {
+        ma_ex_context_init_device_async(&deviceJob, &isDeviceThreaded, &deviceThread);
+    } else if(!context->noDevice) {
+        if(ma_ex_context_init_device(context, config) != MA_SUCCESS) {
+            ma_ex_context_free(context);
+            return NULL;
+        }
+    }
+
+    if(ma_ex_context_init_resource_manager(context, config) != MA_SUCCESS) {
+        //A device that failed to initialize has already cleaned up after itself
+        if(!isParallel || ma_ex_context_wait_device(&deviceJob, isDeviceThreaded, &deviceThread) == MA_SUCCESS)
+            ma_ex_context_uninit_device(context);
+        ma_ex_context_free(context);
+        return NULL;
+    }
+
+    //The engine derives its period size and sample rate from the device it owns, so it's only initialized once the device is ready
+    if(isParallel && ma_ex_context_wait_device(&deviceJob, isDeviceThreaded, &deviceThread) != MA_SUCCESS) {
+        ma_resource_manager_uninit(&context->resourceManager);
+        ma_ex_context_free(context);
+        return NULL;
+    }
+
+    ma_engine_config engineConfig = ma_engine_config_init();
+    engineConfig.listenerCount = MA_ENGINE_MAX_LISTENERS;
+    engineConfig.pResourceManager = &context->resourceManager;
+
+    if(context->noDevice) {
+        //Without a device the engine needs to be told the format it should mix in
+        engineConfig.noDevice = MA_TRUE;
+        engineConfig.channels = context->channels;
+        engineConfig.sampleRate = context->sampleRate;
+        engineConfig.periodSizeInFrames = config->periodSizeInFrames;
+    } else {
+        //The device is started below, once its user data points at the engine
+        engineConfig.pDevice = &context->device;
+        engineConfig.noAutoStart = MA_TRUE;
+    }
+
+    if(ma_engine_init(&engineConfig, &context->engine) != MA_SUCCESS) {
+        fprintf(stderr, "Failed to initialize ma_engine\n");
+        ma_resource_manager_uninit(&context->resourceManager);
+        ma_ex_context_uninit_device(context);
+        ma_ex_context_free(context);
+        return NULL;
+    }
+
+    if(!context->noDevice) {
+        context->device.pUserData = &context->engine;
+
+        if(!config->deferDeviceStart && ma_ex_context_start_device(context) != MA_SUCCESS) {
+            fprintf(stderr, "Failed to start ma_device\n");
+            ma_engine_uninit(&context->engine);
+            ma_resource_manager_uninit(&context->resourceManager);
+            ma_ex_context_uninit_device(context);
+            ma_ex_context_free(context);
+            return NULL;
+        }
+    }
+
+    for(size_t i = 0; i < MA_ENGINE_MAX_LISTENERS; i++) {
+        context->listeners[i] = -1;
+    }
+
+    return context;
+}
+
+MA_API void ma_ex_context_uninit(ma_ex_context *context) {
+    if(context != NULL) {
+        //Clips that were never polled still hold a reference, and releasing them needs the resource manager
+        ma_ex_audio_clip *clip = NULL;
+        while(ma_ex_context_poll_loaded_clips(context, &clip, 1) > 0)
+            ma_ex_audio_clip_uninit(clip);
+
+        ma_engine_uninit(&context->engine);
+        ma_resource_manager_uninit(&context->resourceManager);
+        ma_ex_context_uninit_device(context);
+        ma_ex_context_free(context);
+    }
+}
+
+/* Starts the device of a context initialized with deferDeviceStart. Called by the first audio source that starts playing. */
+MA_API ma_result ma_ex_context_start_device(ma_ex_context *context) {
+    if(context == NULL)
+        return MA_INVALID_ARGS;
+
+    if(context->noDevice)
+        return MA_INVALID_OPERATION;
+
+    if(ma_ex_atomic_load_32(&context->isDeviceStarted))
+        return MA_SUCCESS;
+
+    //Only one caller gets to start the device
+    if(!ma_ex_atomic_compare_exchange_32(&context->isDeviceStarted, MA_FALSE, MA_TRUE))
+        return MA_SUCCESS;
+
+    ma_result result = ma_device_start(&context->device);
+
+    if(result != MA_SUCCESS)
+        ma_ex_atomic_store_32(&context->isDeviceStarted, MA_FALSE);
+
+    return result;
+}
+
+/* Setting the budget to 0 disables the cache and frees everything in it. */
+MA_API ma_result ma_ex_context_set_cache_budget(ma_ex_context *context, ma_uint64 budgetInBytes) {
+    if(context == NULL)
+        return MA_INVALID_ARGS;
+    return ma_resource_manager_set_cache_budget(&context->resourceManager, budgetInBytes);
+}
+
+MA_API ma_result ma_ex_context_get_cache_stats(ma_ex_context *context, ma_resource_manager_cache_stats *pStats) {
+    if(context == NULL)
+        return MA_INVALID_ARGS;
+    return ma_resource_manager_get_cache_stats(&context->resourceManager, pStats);
+}
+
+MA_API ma_result ma_ex_context_get_stream_stats(ma_ex_context *context, ma_resource_manager_stream_stats *pStats) {
+    if(context == NULL)
+        return MA_INVALID_ARGS;
+    return ma_resource_manager_get_stream_stats(&context->resourceManager, pStats);
+}
+
+MA_API void ma_ex_context_set_master_volume(ma_ex_context *context, float volume) {
+    if(context != NULL)
+        ma_engine_set_volume(&context->engine, volume);
+}
+
+MA_API float ma_ex_context_get_master_volume(ma_ex_context *context) {
+    if(context != NULL)
+        return ma_engine_get_volume(&context->engine);
+    return 0.0f;
+}
+
+MA_API ma_engine *ma_ex_context_get_engine(ma_ex_context *context) {
+    if(context != NULL)
+        return &context->engine;
+    return NULL;
+}
+
+MA_API ma_node_graph *ma_ex_context_get_engine_node_graph(ma_ex_context *context) {
+    if(context == NULL)
+        return NULL;
+    return ma_engine_get_node_graph(&context->engine);
+}
+
+MA_API ma_result ma_ex_context_render(ma_ex_context *context, float *pFramesOut, ma_uint64 frameCount, ma_uint64 *pFramesRendered) {
+    if(pFramesRendered != NULL)
+        *pFramesRendered = 0;
+
+    if(context == NULL)
+        return MA_INVALID_ARGS;
+
+    //Pulling frames manually while a device is also pulling them would advance the engine twice
+    if(!context->noDevice)
+        return MA_INVALID_OPERATION;
+
+    ma_ex_command_queue_try_drain(&context->commandQueue);
+    return ma_engine_read_pcm_frames(&context->engine, pFramesOut, frameCount, pFramesRendered);
+}
+
+MA_API ma_result ma_ex_context_render_to_file(ma_ex_context *context, const char *filePath, ma_uint64 frameCount) {
+    if(context == NULL || filePath == NULL)
+        return MA_INVALID_ARGS;
+
+    if(!context->noDevice)
+        return MA_INVALID_OPERATION;
+
+    ma_encoder encoder;
+    ma_encoder_config encoderConfig = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32, context->channels, context->sampleRate);
+
+    ma_result result = ma_encoder_init_file(filePath, &encoderConfig, &encoder);
+
+    if(result != MA_SUCCESS)
+        return result;
+
+    float buffer[4096];
+    const ma_uint64 framesPerChunk = (sizeof(buffer) / sizeof(buffer[0])) / context->channels;
+    ma_uint64 framesRemaining = frameCount;
+
+    while(framesRemaining > 0) {
+        ma_uint64 framesToRender = framesRemaining < framesPerChunk ? framesRemaining : framesPerChunk;
+        ma_uint64 framesRendered = 0;
+
+        ma_ex_command_queue_try_drain(&context->commandQueue);
+        result = ma_engine_read_pcm_frames(&context->engine, buffer, framesToRender, &framesRendered);
+
+        if(result != MA_SUCCESS || framesRendered == 0)
+            break;
+
+        result = ma_encoder_write_pcm_frames(&encoder, buffer, framesRendered, NULL);
+
+        if(result != MA_SUCCESS)
+            break;
+
+        framesRemaining -= framesRendered;
+    }
+
+    ma_encoder_uninit(&encoder);
+    return result;
+}
+
+MA_API void ma_ex_context_update(ma_ex_context *context) {
+    if(context == NULL || !context->virtualVoices)
+        return;
+
+    ma_spinlock_lock(&context->sourceLock);
+
+    for(ma_ex_audio_source *pSource = context->pSourceHead; pSource != NULL; pSource = pSource->pNext) {
+        //Sounds are detached under the lock when they are released, so a source without one is skipped
+        if(pSource->pSound == NULL)
+            continue;
+
+        if(pSource->isVirtual) {
+            if(ma_ex_audio_source_get_audibility(pSource) <= context->virtualVoiceThreshold)
+                continue;
+
+            if(!ma_ex_audio_source_devirtualize(pSource))
+                continue;
+
+            //If there's no voice available it stays virtual for now
+            if(ma_ex_audio_source_acquire_voice_locked(pSource) != MA_SUCCESS) {
+                ma_ex_audio_source_virtualize(pSource);
+                continue;
+            }
+
+            ma_sound_start(pSource->pSound);
+        } else if(ma_ex_audio_source_is_voice(pSource)) {
+            if(ma_ex_audio_source_get_audibility(pSource) <= context->virtualVoiceThreshold)
+                ma_ex_audio_source_virtualize(pSource);
+        }
+    }
+
+    ma_spinlock_unlock(&context->sourceLock);
+}
+
+MA_API ma_uint32 ma_ex_context_get_virtual_voice_count(ma_ex_context *context) {
+    if(context == NULL)
+        return 0;
+
+    ma_uint32 voiceCount = 0;
+
+    ma_spinlock_lock(&context->sourceLock);
+    for(ma_ex_audio_source *pSource = context->pSourceHead; pSource != NULL; pSource = pSource->pNext) {
+        if(pSource->isVirtual)
+            voiceCount++;
+    }
+    ma_spinlock_unlock(&context->sourceLock);
+
+    return voiceCount;
+}
+
+MA_API void ma_ex_context_set_max_voices(ma_ex_context *context, ma_uint32 maxVoices) {
+    if(context != NULL)
+        context->maxVoices = maxVoices;
+}
+
+MA_API ma_uint32 ma_ex_context_get_max_voices(ma_ex_context *context) {
+    if(context != NULL)
+        return context->maxVoices;
+    return 0;
+}
+
+MA_API ma_uint32 ma_ex_context_get_voice_count(ma_ex_context *context) {
+    if(context == NULL)
+        return 0;
+
+    ma_uint32 voiceCount = 0;
+
+    ma_spinlock_lock(&context->sourceLock);
+    for(ma_ex_audio_source *pSource = context->pSourceHead; pSource != NULL; pSource = pSource->pNext) {
+        if(ma_ex_audio_source_is_voice(pSource))
+            voiceCount++;
+    }
+    ma_spinlock_unlock(&context->sourceLock);
+
+    return voiceCount;
+}
+
+MA_API ma_result ma_ex_context_get_pool_stats(ma_ex_context *context, ma_ex_pool_stats *pSourceStats, ma_ex_pool_stats *pListenerStats, ma_ex_pool_stats *pSoundGroupStats) {
+    if(context == NULL)
+        return MA_INVALID_ARGS;
+    ma_ex_pool_get_stats(&context->sourcePool, pSourceStats);
+    ma_ex_pool_get_stats(&context->listenerPool, pListenerStats);
+    ma_ex_pool_get_stats(&context->soundGroupPool, pSoundGroupStats);
+    return MA_SUCCESS;
+}
+
+MA_API void *ma_ex_device_get_user_data(ma_device *pDevice) {
+    if(pDevice != NULL)
+        return pDevice->pUserData;
+    return NULL;
+}
+
+/* The views stay valid until the devices are refreshed, which happens here when the backend reported a change. */
+MA_API ma_result ma_ex_context_get_playback_devices(ma_ex_context *context, const ma_ex_device_info **ppDevices, ma_uint32 *pCount) {
+    if(ppDevices != NULL)
+        *ppDevices = NULL;
+    if(pCount != NULL)
+        *pCount = 0;
+
+    if(context == NULL || ppDevices == NULL || pCount == NULL)
+        return MA_INVALID_ARGS;
+
+    if(!context->playbackDevices.isValid || ma_ex_atomic_load_32(&context->playbackDevices.isDirty)) {
+        ma_result result = ma_ex_context_refresh_playback_devices(context);
+
+        if(result != MA_SUCCESS)
+            return result;
+    }
+
+    *ppDevices = context->playbackDevices.pDevices;
+    *pCount = context->playbackDevices.deviceCount;
+    return MA_SUCCESS;
+}
+
+/* Same view as returned by ma_ex_context_get_playback_devices, with the native data formats filled in. */
+MA_API const ma_ex_device_info *ma_ex_context_get_playback_device_info(ma_ex_context *context, ma_uint32 index) {
+    const ma_ex_device_info *pDevices;
+    ma_uint32 count;
+
+    if(ma_ex_context_get_playback_devices(context, &pDevices, &count) != MA_SUCCESS || index >= count)
+        return NULL;
+
+    if(ma_ex_device_enumerator_query_formats(&context->playbackDevices, &context->context, index) != MA_SUCCESS)
+        return NULL;
+
+    return &pDevices[index];
+}
+
+MA_API ma_result ma_ex_context_refresh_playback_devices(ma_ex_context *context) {
+    if(context == NULL)
+        return MA_INVALID_ARGS;
+
+    ma_result result = ma_ex_context_init_backend(context);
+
+    if(result != MA_SUCCESS)
+        return result;
+
+    return ma_ex_device_enumerator_refresh(&context->playbackDevices, &context->context);
+}
+
+static ma_ex_audio_clip *ma_ex_audio_clip_alloc(ma_ex_context *context) {
+    ma_ex_audio_clip *clip = MA_MALLOC(sizeof(ma_ex_audio_clip));
+
+    if(clip == NULL)
+        return NULL;
+
+    MA_ZERO_OBJECT(clip);
+    clip->context = context;
+    ma_ex_atomic_store_32(&clip->refCount, 1);
+    return clip;
+}
+
+static ma_decoder_config ma_ex_audio_clip_get_decoder_config(ma_ex_context *context) {
+    ma_decoder_config config = ma_decoder_config_init(ma_format_f32, context->channels, context->sampleRate);
+    config.ppCustomBackendVTables = context->resourceManager.config.ppCustomDecodingBackendVTables;
+    config.customBackendCount = context->resourceManager.config.customDecodingBackendCount;
+    config.pCustomBackendUserData = context->resourceManager.config.pCustomDecodingBackendUserData;
+    return config;
+}
+
+static MA_INLINE ma_uint16 ma_ex_read_le16(const ma_uint8 *p) {
+    return (ma_uint16)(p[0] | (p[1] << 8));
+}
+
+static MA_INLINE ma_uint32 ma_ex_read_le32(const ma_uint8 *p) {
+    return (ma_uint32)p[0] | ((ma_uint32)p[1] << 8) | ((ma_uint32)p[2] << 16) | ((ma_uint32)p[3] << 24);
+}
+
+static MA_INLINE ma_bool32 ma_ex_is_little_endian(void) {
+    ma_uint16 value = 1;
+    return *(const ma_uint8*)&value == 1;
+}
+
+/* Finds the data chunk of a little endian s16 or f32 PCM WAV file. Anything else, including compressed and 24 bit files, is left to the decoders. */
+static ma_bool32 ma_ex_find_wav_pcm_data(const void *pData, size_t dataSize, ma_format *pFormat, ma_uint32 *pChannels, ma_uint32 *pSampleRate, size_t *pOffset, size_t *pSize) {
+    const ma_uint8 *p = (const ma_uint8*)pData;
+
+    if(dataSize < 12 || memcmp(p, "RIFF", 4) != 0 || memcmp(p + 8, "WAVE", 4) != 0)
+        return MA_FALSE;
+
+    ma_format format = ma_format_unknown;
+    size_t offset = 12;
+
+    while(offset + 8 <= dataSize) {
+        const ma_uint8 *pChunk = p + offset;
+        size_t chunkSize = ma_ex_read_le32(pChunk + 4);
+        offset += 8;
+
+        if(memcmp(pChunk, "fmt ", 4) == 0) {
+            if(chunkSize < 16 || offset + chunkSize > dataSize)
+                return MA_FALSE;
+
+            ma_uint16 formatTag = ma_ex_read_le16(pChunk + 8);
+            ma_uint16 channels = ma_ex_read_le16(pChunk + 10);
+            ma_uint16 blockAlign = ma_ex_read_le16(pChunk + 20);
+            ma_uint16 bitsPerSample = ma_ex_read_le16(pChunk + 22);
+
+            //WAVE_FORMAT_EXTENSIBLE stores the actual format tag at the start of the sub format GUID
+            if(formatTag == 0xFFFE) {
+                if(chunkSize < 40)
+                    return MA_FALSE;
+                formatTag = ma_ex_read_le16(pChunk + 32);
+            }
+
+            if(formatTag == 1 && bitsPerSample == 16)
+                format = ma_format_s16;
+            else if(formatTag == 3 && bitsPerSample == 32)
+                format = ma_format_f32;
+            else
+                return MA_FALSE;
+
+            if(channels == 0 || blockAlign != ma_get_bytes_per_frame(format, channels))
+                return MA_FALSE;
+
+            *pFormat = format;
+            *pChannels = channels;
+            *pSampleRate = ma_ex_read_le32(pChunk + 12);
+        } else if(memcmp(pChunk, "data", 4) == 0) {
+            if(format == ma_format_unknown)
+                return MA_FALSE;
+
+            //Files that were cut short still play up to where they end
+            if(chunkSize > dataSize - offset)
+                chunkSize = dataSize - offset;
+
+            *pOffset = offset;
+            *pSize = chunkSize;
+            return MA_TRUE;
+        }
+
+        if(chunkSize >= dataSize - offset)
+            return MA_FALSE;
+
+        //Chunks are padded to an even size
+        offset += chunkSize + (chunkSize & 1);
+    }
+
+    return MA_FALSE;
+}
+
+/* Creates a clip that plays a PCM WAV file straight from a mapping of the file. Returns NULL when the file isn't mapped or doesn't already match the format of the context. */
+static ma_ex_audio_clip *ma_ex_audio_clip_init_from_mapped_wav(ma_ex_context *context, const char *filePath) {
+    if(!context->memoryMappedFiles || !ma_ex_is_little_endian())
+        return NULL;
+
+    ma_ex_file_view view;
+
+    if(ma_ex_file_view_init(filePath, &view) != MA_SUCCESS)
+        return NULL;
+
+    ma_format format;
+    ma_uint32 channels;
+    ma_uint32 sampleRate;
+    size_t offset;
+    size_t size;
+
+    //Conversion to f32 is cheap enough to do while reading, resampling and channel mapping are not
+    if(!view.isMapped ||
+       !ma_ex_find_wav_pcm_data(view.pData, view.sizeInBytes, &format, &channels, &sampleRate, &offset, &size) ||
+       channels != context->channels || sampleRate != context->sampleRate ||
+       (offset % ma_get_bytes_per_sample(format)) != 0 || size < ma_get_bytes_per_frame(format, channels)) {
+        ma_ex_file_view_uninit(&view);
+        return NULL;
+    }
+
+    ma_ex_audio_clip *clip = ma_ex_audio_clip_alloc(context);
+
+    if(clip == NULL) {
+        ma_ex_file_view_uninit(&view);
+        return NULL;
+    }
+
+    clip->fileView = view;
+    clip->pMappedFrames = (const ma_uint8*)view.pData + offset;
+    clip->mappedFormat = format;
+    clip->frameCount = size / ma_get_bytes_per_frame(format, channels);
+    return clip;
+}
+
+#define MA_EX_DECODE_CACHE_VERSION 2
+
+typedef struct ma_ex_decode_cache_header ma_ex_decode_cache_header;
+
+/* Written in front of the PCM frames of a decode cache file. Cache files are only read on the machine that wrote them, so the header is stored in native byte order. */
+struct ma_ex_decode_cache_header {
+    char magic[8];          /* "MAEXPCM" */
+    ma_uint32 version;
+    ma_uint32 format;
+    ma_uint32 channels;
+    ma_uint32 sampleRate;
+    ma_uint64 frameCount;
+    ma_uint64 sourceSize;           /* Size of the file that was decoded. */
+    ma_uint64 sourceModifiedTime;   /* Last modification time of the file that was decoded, as returned by ma_ex_get_file_info(). */
+    ma_uint64 sourceHash;           /* Hash of the contents of the file that was decoded. Only checked the first time the context uses the cache file. */
+};
+
+/* Size and last modification time of a file, read without opening it. The time is only ever compared for equality, so its unit depends on the platform. */
+static ma_result ma_ex_get_file_info(const char *filepath, ma_uint64 *pSize, ma_uint64 *pModifiedTime) {
+#if defined(_WIN32)
+    WIN32_FILE_ATTRIBUTE_DATA info;
+    if(!GetFileAttributesExA(filepath, GetFileExInfoStandard, &info))
+        return MA_DOES_NOT_EXIST;
+
+    *pSize = ((ma_uint64)info.nFileSizeHigh << 32) | info.nFileSizeLow;
+    *pModifiedTime = ((ma_uint64)info.ftLastWriteTime.dwHighDateTime << 32) | info.ftLastWriteTime.dwLowDateTime;
+#else
+    struct stat info;
+    if(stat(filepath, &info) != 0)
+        return MA_DOES_NOT_EXIST;
+
+    *pSize = (ma_uint64)info.st_size;
+#if defined(__APPLE__)
+    *pModifiedTime = (ma_uint64)info.st_mtimespec.tv_sec * 1000000000 + (ma_uint64)info.st_mtimespec.tv_nsec;
+#else
+    *pModifiedTime = (ma_uint64)info.st_mtim.tv_sec * 1000000000 + (ma_uint64)info.st_mtim.tv_nsec;
+#endif
+#endif
+
+    return MA_SUCCESS;
+}
+
+/* Hashes 8 bytes at a time. ma_ex_create_hashcode() is fine for paths but too slow for whole files. */
+static ma_uint64 ma_ex_hash_bytes(const void *pData, size_t size) {
+    const ma_uint8 *p = (const ma_uint8*)pData;
+    ma_uint64 hash = 0xCBF29CE484222325ULL ^ (ma_uint64)size;
+    size_t i = 0;
+
+    for(; i + 8 <= size; i += 8) {
+        ma_uint64 word;
+        memcpy(&word, p + i, 8);
+        hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+        hash ^= hash >> 32;
+    }
+
+    for(; i < size; i++)
+        hash = (hash ^ p[i]) * 0x100000001B3ULL;
+
+    hash ^= hash >> 29;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+/*
+The name of a cache file depends on the path, size and modification time of the source file and on everything that
+changes the decoded frames, so finding it doesn't require reading the source file.
+*/
+static char *ma_ex_decode_cache_get_path(ma_ex_context *context, const char *filePath, const ma_ex_decode_cache_header *header, ma_uint64 *pKey) {
+    ma_uint64 key[5] = { ma_ex_create_hashcode(filePath, strlen(filePath)), header->sourceSize, header->sourceModifiedTime, ((ma_uint64)header->format << 32) | header->channels, ((ma_uint64)header->version << 32) | header->sampleRate };
+    ma_uint64 hash = ma_ex_hash_bytes(key, sizeof(key));
+    *pKey = hash;
+
+    size_t length = strlen(context->pDecodeCacheDirectory) + 32;
+    char *pPath = MA_MALLOC(length);
+
+    if(pPath == NULL)
+        return NULL;
+
+    snprintf(pPath, length, "%s/%016llx.pcm", context->pDecodeCacheDirectory, (unsigned long long)hash);
+    return pPath;
+}
+
+static ma_bool32 ma_ex_decode_cache_is_valid(const ma_ex_file_view *view, const ma_ex_decode_cache_header *expected) {
+    if(view->sizeInBytes < sizeof(ma_ex_decode_cache_header))
+        return MA_FALSE;
+
+    ma_ex_decode_cache_header header;
+    memcpy(&header, view->pData, sizeof(header));
+
+    if(memcmp(header.magic, expected->magic, sizeof(header.magic)) != 0 ||
+       header.version != expected->version || header.format != expected->format ||
+       header.channels != expected->channels || header.sampleRate != expected->sampleRate ||
+       header.sourceSize != expected->sourceSize || header.sourceModifiedTime != expected->sourceModifiedTime)
+        return MA_FALSE;
+
+    //Files that weren't written completely are never renamed into place, but a truncated file is still rejected
+    ma_uint64 dataSize = header.frameCount * ma_get_bytes_per_frame((ma_format)header.format, header.channels);
+    return header.frameCount > 0 && view->sizeInBytes - sizeof(header) == dataSize;
+}
+
+/* Writes to a temporary file first, so other processes never map a partially written cache file. */
+static ma_result ma_ex_decode_cache_write(const char *pPath, const ma_ex_decode_cache_header *header, const void *pFrames) {
+    static ma_uint32 tempFileCounter = 0;
+    size_t length = strlen(pPath) + 32;
+    char *pTempPath = MA_MALLOC(length);
+
+    if(pTempPath == NULL)
+        return MA_OUT_OF_MEMORY;
+
+    //Other processes may share the cache directory, so the process id and a counter keep writers of the same file apart
+    snprintf(pTempPath, length, "%s.%x.%x.tmp", pPath, ma_ex_get_process_id(), ma_ex_atomic_fetch_add_32(&tempFileCounter, 1));
+
+    FILE *file = fopen(pTempPath, "wb");
+
+    if(file == NULL) {
+        MA_FREE(pTempPath);
+        return MA_ACCESS_DENIED;
+    }
+
+    size_t dataSize = (size_t)(header->frameCount * ma_get_bytes_per_frame((ma_format)header->format, header->channels));
+    ma_bool32 isWritten = fwrite(header, sizeof(*header), 1, file) == 1 && fwrite(pFrames, 1, dataSize, file) == dataSize;
+
+    if(fclose(file) != 0)
+        isWritten = MA_FALSE;
+
+    if(isWritten && rename(pTempPath, pPath) != 0) {
+        //rename() doesn't replace existing files on Windows, another process may have written the same file in the meantime
+        remove(pPath);
+        isWritten = rename(pTempPath, pPath) == 0;
+    }
+
+    if(!isWritten)
+        remove(pTempPath);
+
+    MA_FREE(pTempPath);
+    return isWritten ? MA_SUCCESS : MA_ERROR;
+}
+
+static ma_ex_audio_clip *ma_ex_audio_clip_init_from_cache_file(ma_ex_context *context, const char *pPath, const ma_ex_decode_cache_header *expected) {
+    ma_ex_file_view view;
+
+    if(ma_ex_file_view_init(pPath, &view) != MA_SUCCESS)
+        return NULL;
+
+    if(!ma_ex_decode_cache_is_valid(&view, expected)) {
+        ma_ex_file_view_uninit(&view);
+        return NULL;
+    }
+
+    ma_ex_audio_clip *clip = ma_ex_audio_clip_alloc(context);
+
+    if(clip == NULL) {
+        ma_ex_file_view_uninit(&view);
+        return NULL;
+    }
+
+    ma_ex_decode_cache_header header;
+    memcpy(&header, view.pData, sizeof(header));
+
+    clip->fileView = view;
+    clip->pMappedFrames = (const ma_uint8*)view.pData + sizeof(header);
+    clip->mappedFormat = (ma_format)header.format;
+    clip->frameCount = header.frameCount;
+    return clip;
+}
+
+static ma_bool32 ma_ex_decode_cache_is_verified(ma_ex_context *context, ma_uint64 key) {
+    ma_bool32 isVerified = MA_FALSE;
+
+    ma_spinlock_lock(&context->clipCacheLock);
+
+    for(ma_uint32 i = 0; i < context->verifiedDecodeCacheKeyCount; i++) {
+        if(context->pVerifiedDecodeCacheKeys[i] == key) {
+            isVerified = MA_TRUE;
+            break;
+        }
+    }
+
+    ma_spinlock_unlock(&context->clipCacheLock);
+    return isVerified;
+}
+
+/* Remembers that the contents of a cache file were checked against its source file, so later loads only compare size and modification time. */
+static void ma_ex_decode_cache_set_verified(ma_ex_context *context, ma_uint64 key) {
+    ma_spinlock_lock(&context->clipCacheLock);
+
+    if(context->verifiedDecodeCacheKeyCount == context->verifiedDecodeCacheKeyCapacity) {
+        ma_uint32 newCapacity = context->verifiedDecodeCacheKeyCapacity == 0 ? 64 : context->verifiedDecodeCacheKeyCapacity * 2;
+        ma_uint64 *pNewKeys = ma_realloc(context->pVerifiedDecodeCacheKeys, sizeof(ma_uint64) * newCapacity, NULL);
+
+        if(pNewKeys != NULL) {
+            context->pVerifiedDecodeCacheKeys = pNewKeys;
+            context->verifiedDecodeCacheKeyCapacity = newCapacity;
+        }
+    }
+
+    //Without room the cache file is simply verified again the next time
+    if(context->verifiedDecodeCacheKeyCount < context->verifiedDecodeCacheKeyCapacity)
+        context->pVerifiedDecodeCacheKeys[context->verifiedDecodeCacheKeyCount++] = key;
+
+    ma_spinlock_unlock(&context->clipCacheLock);
+}
+
+/*
+Maps the decoded frames of a file from the decode cache directory, or decodes the file and adds it to the cache. Returns NULL when there is no cache directory or the file can't be decoded.
+Cache files are found by path, size and modification time of the source file. The contents of the source file are only hashed
+the first time the context uses a cache file, to catch a source that was replaced without changing either.
+*/
+static ma_ex_audio_clip *ma_ex_audio_clip_init_from_decode_cache(ma_ex_context *context, const char *filePath) {
+    if(context->pDecodeCacheDirectory == NULL)
+        return NULL;
+
+    ma_ex_decode_cache_header header;
+    MA_ZERO_OBJECT(&header);
+    memcpy(header.magic, "MAEXPCM", 8);
+    header.version = MA_EX_DECODE_CACHE_VERSION;
+    header.format = ma_format_f32;
+    header.channels = context->channels;
+    header.sampleRate = context->sampleRate;
+
+    if(ma_ex_get_file_info(filePath, &header.sourceSize, &header.sourceModifiedTime) != MA_SUCCESS)
+        return NULL;
+
+    ma_uint64 key;
+    char *pPath = ma_ex_decode_cache_get_path(context, filePath, &header, &key);
+
+    if(pPath == NULL)
+        return NULL;
+
+    ma_ex_audio_clip *clip = ma_ex_audio_clip_init_from_cache_file(context, pPath, &header);
+
+    if(clip != NULL && ma_ex_decode_cache_is_verified(context, key)) {
+        MA_FREE(pPath);
+        return clip;
+    }
+
+    ma_ex_file_view source;
+
+    if(ma_ex_file_view_init(filePath, &source) != MA_SUCCESS) {
+        ma_ex_audio_clip_uninit(clip);
+        MA_FREE(pPath);
+        return NULL;
+    }
+
+    header.sourceHash = ma_ex_hash_bytes(source.pData, source.sizeInBytes);
+
+    if(clip != NULL) {
+        ma_ex_decode_cache_header cachedHeader;
+        memcpy(&cachedHeader, clip->fileView.pData, sizeof(cachedHeader));
+
+        if(cachedHeader.sourceHash == header.sourceHash && source.sizeInBytes == header.sourceSize) {
+            ma_ex_decode_cache_set_verified(context, key);
+            ma_ex_file_view_uninit(&source);
+            MA_FREE(pPath);
+            return clip;
+        }
+
+        //The source was replaced without changing its size or modification time, the cache file is decoded again
+        ma_ex_audio_clip_uninit(clip);
+        clip = NULL;
+    }
+
+    ma_decoder_config config = ma_ex_audio_clip_get_decoder_config(context);
+    void *pFrames = NULL;
+    ma_result result = ma_decode_memory(source.pData, source.sizeInBytes, &config, &header.frameCount, &pFrames);
+    ma_ex_file_view_uninit(&source);
+
+    if(result != MA_SUCCESS || header.frameCount == 0) {
+        if(pFrames != NULL)
+            ma_free(pFrames, NULL);
+        MA_FREE(pPath);
+        return NULL;
+    }
+
+    //Once written, the cache file is mapped so this load doesn't keep its own copy of the frames either
+    if(ma_ex_decode_cache_write(pPath, &header, pFrames) == MA_SUCCESS) {
+        clip = ma_ex_audio_clip_init_from_cache_file(context, pPath, &header);
+        if(clip != NULL)
+            ma_ex_decode_cache_set_verified(context, key);
+    }
+
+    MA_FREE(pPath);
+
+    if(clip != NULL) {
+        ma_free(pFrames, NULL);
+        return clip;
+    }
+
+    clip = ma_ex_audio_clip_alloc(context);
+
+    if(clip == NULL) {
+        ma_free(pFrames, NULL);
+        return NULL;
+    }
+
+    clip->pFrames = (float*)pFrames;
+    clip->frameCount = header.frameCount;
+    return clip;
+}
+
+/*
+Tries the ways of loading a file that don't decode it every time. Returns NULL when the file has to be decoded the regular way.
+Like data buffer nodes in the resource manager, the clip is shared by everything playing the same path until its last
+reference is released, so a file is only opened and parsed when no clip of its path is playing.
+*/
+static ma_ex_audio_clip *ma_ex_audio_clip_init_from_file_fast(ma_ex_context *context, const char *filePath) {
+    if(!context->memoryMappedFiles && context->pDecodeCacheDirectory == NULL)
+        return NULL;
+
+    ma_uint64 hash = ma_ex_create_hashcode(filePath, strlen(filePath));
+    ma_ex_audio_clip *clip = ma_ex_clip_cache_acquire(context, hash, filePath);
+
+    if(clip != NULL)
+        return clip;
+
+    clip = ma_ex_audio_clip_init_from_mapped_wav(context, filePath);
+
+    if(clip == NULL)
+        clip = ma_ex_audio_clip_init_from_decode_cache(context, filePath);
+
+    return ma_ex_clip_cache_insert(context, hash, filePath, clip);
+}
+
+MA_API ma_ex_audio_clip *ma_ex_audio_clip_init_from_file(ma_ex_context *context, const char *filePath, ma_bool32 streamFromDisk) {
+    if(context == NULL)
+        return NULL;
+
+    if(filePath == NULL)
+        return NULL;
+
+    if(!streamFromDisk) {
+        ma_ex_audio_clip *fastClip = ma_ex_audio_clip_init_from_file_fast(context, filePath);
+        if(fastClip != NULL)
+            return fastClip;
+    }
+
+    ma_ex_audio_clip *clip = ma_ex_audio_clip_alloc(context);
+
+    if(clip == NULL)
+        return NULL;
+
+    if(streamFromDisk) {
+        //Streams need a decoder per sound, so only the path is shared
+        size_t length = strlen(filePath);
+        clip->pFilePath = MA_MALLOC(length + 1);
+
+        if(clip->pFilePath == NULL) {
+            MA_FREE(clip);
+            return NULL;
+        }
+
+        memcpy(clip->pFilePath, filePath, length + 1);
+        return clip;
+    }
+
+    ma_decoder_config config = ma_ex_audio_clip_get_decoder_config(context);
+    void *pFrames = NULL;
+
+    if(ma_decode_file(filePath, &config, &clip->frameCount, &pFrames) != MA_SUCCESS) {
+        MA_FREE(clip);
+        return NULL;
+    }
+
+    clip->pFrames = (float*)pFrames;
+    return clip;
+}
+
+MA_API ma_ex_audio_clip *ma_ex_audio_clip_init_from_memory(ma_ex_context *context, const void *data, ma_uint64 dataSize) {
+    if(context == NULL || data == NULL || dataSize == 0)
+        return NULL;
+
+    ma_ex_audio_clip *clip = ma_ex_audio_clip_alloc(context);
+
+    if(clip == NULL)
+        return NULL;
+
+    ma_decoder_config config = ma_ex_audio_clip_get_decoder_config(context);
+    void *pFrames = NULL;
+
+    if(ma_decode_memory(data, (size_t)dataSize, &config, &clip->frameCount, &pFrames) != MA_SUCCESS) {
+        MA_FREE(clip);
+        return NULL;
+    }
+
+    clip->pFrames = (float*)pFrames;
+    return clip;
+}
+
+MA_API ma_ex_audio_clip *ma_ex_audio_clip_init_from_callback(ma_ex_context *context, const ma_procedural_data_source_config *pConfig) {
+    if(context == NULL || pConfig == NULL || pConfig->callback == NULL)
+        return NULL;
+
+    ma_ex_audio_clip *clip = ma_ex_audio_clip_alloc(context);
+
+    if(clip == NULL)
+        return NULL;
+
+    //The callback is always invoked with the channel count of the context
+    clip->callback = pConfig->callback;
+    clip->pUserData = pConfig->pUserData;
+    return clip;
+}
+
+/* Releases a reference. The clip is freed once no source is using it anymore. */
+MA_API void ma_ex_audio_clip_uninit(ma_ex_audio_clip *clip) {
+    if(clip == NULL)
+        return;
+
+    if(ma_ex_atomic_fetch_add_32(&clip->refCount, (ma_uint32)-1) != 1)
+        return;
+
+    ma_ex_clip_cache_remove(clip);
+
+    if(clip->pFrames != NULL)
+        ma_free(clip->pFrames, NULL);
+    if(clip->pMappedFrames != NULL)
+        ma_ex_file_view_uninit(&clip->fileView);
+    if(clip->pFilePath != NULL)
+        MA_FREE(clip->pFilePath);
+    if(clip->pDataBuffer != NULL) {
+        ma_resource_manager_data_buffer_uninit(clip->pDataBuffer);
+        MA_FREE(clip->pDataBuffer);
+    }
+    MA_FREE(clip);
+}
+
+MA_API ma_ex_audio_clip *ma_ex_audio_clip_acquire(ma_ex_audio_clip *clip) {
+    if(clip != NULL)
+        ma_ex_atomic_fetch_add_32(&clip->refCount, 1);
+    return clip;
+}
+
+MA_API ma_bool8 ma_ex_audio_clip_is_initialized(ma_ex_audio_clip *clip) {
+    if(!clip)
+        return MA_FALSE;
+    return clip->pFrames != NULL || clip->pMappedFrames != NULL || clip->pFilePath != NULL || clip->callback != NULL;
+}
+
+MA_API ma_uint64 ma_ex_audio_clip_get_length(ma_ex_audio_clip *clip) {
+    if(clip == NULL)
+        return 0;
+    return clip->frameCount;
+}
+
+/* Runs once per asynchronous load, on whichever thread observes the load finishing first. The reference taken for the load is handed to the completion queue. */
+static void ma_ex_audio_clip_finish_load(ma_ex_audio_clip *clip, ma_result result) {
+    if(!ma_ex_atomic_compare_exchange_32(&clip->isLoadFinished, MA_FALSE, MA_TRUE))
+        return;
+
+    if(result == MA_SUCCESS)
+        ma_resource_manager_data_buffer_get_length_in_pcm_frames(clip->pDataBuffer, &clip->frameCount);
+
+    ma_ex_atomic_store_32(&clip->loadResult, (ma_uint32)result);
+
+    if(clip->onLoaded != NULL)
+        clip->onLoaded(clip, result, clip->pLoadedUserData);
+
+    ma_ex_context *context = clip->context;
+    void *pHead;
+
+    do {
+        pHead = ma_ex_atomic_load_ptr(&context->pLoadedClips);
+        clip->pNextLoaded = (ma_ex_audio_clip*)pHead;
+    } while(!ma_ex_atomic_compare_exchange_ptr(&context->pLoadedClips, pHead, clip));
+}
+
+static void ma_ex_audio_clip_on_ready(ma_async_notification *pNotification) {
+    ma_ex_audio_clip *clip = ((ma_ex_audio_clip_notification*)pNotification)->clip;
+    ma_ex_atomic_store_32(&clip->isReady, MA_TRUE);
+}
+
+static void ma_ex_audio_clip_on_done(ma_async_notification *pNotification) {
+    ma_ex_audio_clip *clip = ((ma_ex_audio_clip_notification*)pNotification)->clip;
+
+    //Signals raised while ma_ex_audio_clip_load_async is still submitting are picked up by the submitting thread instead
+    if(ma_ex_atomic_fetch_add_32(&clip->isSubmitted, 0))
+        ma_ex_audio_clip_finish_load(clip, ma_resource_manager_data_buffer_result(clip->pDataBuffer));
+}
+
+static ma_ex_audio_clip *ma_ex_audio_clip_load_async_ex(ma_ex_context *context, const char *filePath, ma_uint32 flags, ma_ex_audio_clip_loaded_proc onLoaded, void *pUserData) {
+    if(context == NULL || filePath == NULL)
+        return NULL;
+
+    ma_ex_audio_clip *clip = ma_ex_audio_clip_alloc(context);
+
+    if(clip == NULL)
+        return NULL;
+
+    size_t length = strlen(filePath);
+    clip->pFilePath = MA_MALLOC(length + 1);
+    clip->pDataBuffer = MA_MALLOC(sizeof(ma_resource_manager_data_buffer));
+
+    if(clip->pFilePath == NULL || clip->pDataBuffer == NULL) {
+        if(clip->pFilePath != NULL)
+            MA_FREE(clip->pFilePath);
+        if(clip->pDataBuffer != NULL)
+            MA_FREE(clip->pDataBuffer);
+        MA_FREE(clip);
+        return NULL;
+    }
+
+    memcpy(clip->pFilePath, filePath, length + 1);
+    clip->onLoaded = onLoaded;
+    clip->pLoadedUserData = pUserData;
+    clip->readyNotification.cb.onSignal = ma_ex_audio_clip_on_ready;
+    clip->readyNotification.clip = clip;
+    clip->doneNotification.cb.onSignal = ma_ex_audio_clip_on_done;
+    clip->doneNotification.clip = clip;
+    ma_ex_atomic_store_32(&clip->loadResult, (ma_uint32)MA_BUSY);
+
+    //Held until the load finishes, then owned by the completion queue
+    ma_ex_audio_clip_acquire(clip);
+
+    ma_resource_manager_pipeline_notifications notifications = ma_resource_manager_pipeline_notifications_init();
+    notifications.init.pNotification = &clip->readyNotification;
+    notifications.done.pNotification = &clip->doneNotification;
+
+    ma_resource_manager_data_source_config config = ma_resource_manager_data_source_config_init();
+    config.pFilePath = filePath;
+    config.flags = MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_DECODE | MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_ASYNC | flags;
+    config.pNotifications = &notifications;
+
+    ma_result result = ma_resource_manager_data_buffer_init_ex(&context->resourceManager, &config, clip->pDataBuffer);
+
+    if(result != MA_SUCCESS) {
+        //Nothing was loaded, so the clip is reported as a failed load
+        MA_FREE(clip->pDataBuffer);
+        clip->pDataBuffer = NULL;
+        MA_FREE(clip->pFilePath);
+        clip->pFilePath = NULL;
+        ma_ex_audio_clip_finish_load(clip, result);
+        return clip;
+    }
+
+    ma_ex_atomic_fetch_add_32(&clip->isSubmitted, 1);
+
+    //The file might have been loaded already, or the job threads finished before the clip was marked as submitted
+    result = ma_resource_manager_data_buffer_result(clip->pDataBuffer);
+
+    if(result != MA_BUSY)
+        ma_ex_audio_clip_finish_load(clip, result);
+
+    return clip;
+}
+
+/* Decodes a file on the resource manager job threads. The returned clip can be played right away, it stays silent until the first page is decoded. Completion is reported through onLoaded and ma_ex_context_poll_loaded_clips(). */
+MA_API ma_ex_audio_clip *ma_ex_audio_clip_load_async(ma_ex_context *context, const char *filePath, ma_ex_audio_clip_loaded_proc onLoaded, void *pUserData) {
+    return ma_ex_audio_clip_load_async_ex(context, filePath, 0, onLoaded, pUserData);
+}
+
+/* Same as ma_ex_audio_clip_load_async(), but the decoding only runs while the job threads have no streaming or regular loading work queued. */
+MA_API ma_ex_audio_clip *ma_ex_audio_clip_prefetch_async(ma_ex_context *context, const char *filePath, ma_ex_audio_clip_loaded_proc onLoaded, void *pUserData) {
+    return ma_ex_audio_clip_load_async_ex(context, filePath, MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_BACKGROUND, onLoaded, pUserData);
+}
+
+/* Returns MA_BUSY while the clip is loading. Clips that were not loaded asynchronously always return MA_SUCCESS. */
+MA_API ma_result ma_ex_audio_clip_get_load_result(ma_ex_audio_clip *clip) {
+    if(clip == NULL)
+        return MA_INVALID_ARGS;
+    return (ma_result)ma_ex_atomic_load_32(&clip->loadResult);
+}
+
+MA_API ma_bool8 ma_ex_audio_clip_is_ready(ma_ex_audio_clip *clip) {
+    if(clip == NULL)
+        return MA_FALSE;
+
+    ma_result result = ma_ex_audio_clip_get_load_result(clip);
+
+    if(result == MA_SUCCESS)
+        return MA_TRUE;
+
+    return result == MA_BUSY && ma_ex_atomic_load_32(&clip->isReady);
+}
+
+/* Hands out clips whose asynchronous load finished, oldest first. Each returned clip carries a reference that must be released with ma_ex_audio_clip_uninit(). */
+MA_API ma_uint32 ma_ex_context_poll_loaded_clips(ma_ex_context *context, ma_ex_audio_clip **ppClips, ma_uint32 capacity) {
+    if(context == NULL || ppClips == NULL)
+        return 0;
+
+    ma_uint32 count = 0;
+
+    while(count < capacity) {
+        if(context->pLoadedClipsPending == NULL) {
+            //The queue is a stack, so reverse it to get completion order
+            ma_ex_audio_clip *clip = (ma_ex_audio_clip*)ma_ex_atomic_exchange_ptr(&context->pLoadedClips, NULL);
+
+            if(clip == NULL)
+                break;
+
+            while(clip != NULL) {
+                ma_ex_audio_clip *pNext = clip->pNextLoaded;
+                clip->pNextLoaded = context->pLoadedClipsPending;
+                context->pLoadedClipsPending = clip;
+                clip = pNext;
+            }
+        }
+
+        ppClips[count++] = context->pLoadedClipsPending;
+        context->pLoadedClipsPending = context->pLoadedClipsPending->pNextLoaded;
+    }
+
+    return count;
+}
+
+static void ma_ex_audio_clip_read_frames(ma_ex_audio_clip *clip, void *pFramesOut, ma_uint64 frameIndex, ma_uint64 frameCount, ma_uint32 channels) {
+    if(clip->pFrames != NULL) {
+        ma_copy_pcm_frames(pFramesOut, clip->pFrames + (frameIndex * channels), frameCount, ma_format_f32, channels);
+        return;
+    }
+
+    //Mapped frames are read in place, s16 is converted on the way out
+    const ma_uint8 *pFrames = (const ma_uint8*)clip->pMappedFrames + (frameIndex * ma_get_bytes_per_frame(clip->mappedFormat, channels));
+
+    if(clip->mappedFormat == ma_format_f32)
+        ma_copy_pcm_frames(pFramesOut, pFrames, frameCount, ma_format_f32, channels);
+    else
+        ma_pcm_s16_to_f32(pFramesOut, pFrames, frameCount * channels, ma_dither_mode_none);
+}
+
+//Stored in pPendingClip to unbind the clip, since NULL means nothing is pending
+static char g_ma_ex_audio_clip_data_source_unbind;
+#define MA_EX_AUDIO_CLIP_UNBIND ((void*)&g_ma_ex_audio_clip_data_source_unbind)
+
+/* Marks the start of audio thread access and picks up a clip the owner swapped in. Must be paired with ma_ex_audio_clip_data_source_end(). */
+static ma_ex_audio_clip *ma_ex_audio_clip_data_source_begin(ma_ex_audio_clip_data_source *pClipDataSource) {
+    ma_ex_atomic_fetch_add_32(&pClipDataSource->readSequence, 1);
+
+    void *pPending = ma_ex_atomic_exchange_ptr(&pClipDataSource->pPendingClip, NULL);
+
+    if(pPending != NULL) {
+        ma_ex_atomic_exchange_ptr(&pClipDataSource->pClip, pPending == MA_EX_AUDIO_CLIP_UNBIND ? NULL : pPending);
+        ma_ex_atomic_store_64(&pClipDataSource->cursor, 0);
+    }
+
+    return (ma_ex_audio_clip*)ma_ex_atomic_load_ptr(&pClipDataSource->pClip);
+}
+
+static void ma_ex_audio_clip_data_source_end(ma_ex_audio_clip_data_source *pClipDataSource) {
+    ma_ex_atomic_fetch_add_32(&pClipDataSource->readSequence, 1);
+}
+
+static ma_result ma_ex_audio_clip_data_source_read(ma_data_source *pDataSource, void *pFramesOut, ma_uint64 frameCount, ma_uint64 *pFramesRead) {
+    ma_ex_audio_clip_data_source *pClipDataSource = (ma_ex_audio_clip_data_source*)pDataSource;
+    ma_uint64 framesRead = 0;
+
+    ma_ex_audio_clip *clip = ma_ex_audio_clip_data_source_begin(pClipDataSource);
+
+    if(clip != NULL) {
+        ma_uint64 cursor = ma_ex_atomic_load_64(&pClipDataSource->cursor);
+
+        if(clip->callback != NULL) {
+            if(pFramesOut != NULL) {
+                clip->callback(clip->pUserData, pFramesOut, frameCount, pClipDataSource->channels);
+            } else {
+                //miniaudio skips frames by reading without an output buffer. The callback still has to produce them so it stays in step.
+                float scratch[1024];
+                ma_uint64 framesPerChunk = (sizeof(scratch) / sizeof(scratch[0])) / pClipDataSource->channels;
+
+                for(ma_uint64 framesSkipped = 0; framesSkipped < frameCount; framesSkipped += framesPerChunk) {
+                    ma_uint64 framesToSkip = frameCount - framesSkipped < framesPerChunk ? frameCount - framesSkipped : framesPerChunk;
+                    clip->callback(clip->pUserData, scratch, framesToSkip, pClipDataSource->channels);
+                }
+            }
+            framesRead = frameCount;
+        } else if(cursor < clip->frameCount) {
+            framesRead = clip->frameCount - cursor;
+            if(framesRead > frameCount)
+                framesRead = frameCount;
+            if(pFramesOut != NULL)
+                ma_ex_audio_clip_read_frames(clip, pFramesOut, cursor, framesRead, pClipDataSource->channels);
+            ma_ex_atomic_store_64(&pClipDataSource->cursor, cursor + framesRead);
+        }
+    }
+
+    ma_ex_audio_clip_data_source_end(pClipDataSource);
+
+    if(pFramesRead != NULL)
+        *pFramesRead = framesRead;
+
+    if(framesRead < frameCount)
+        return MA_AT_END;
+
+    return MA_SUCCESS;
+}
+
+static ma_result ma_ex_audio_clip_data_source_seek(ma_data_source *pDataSource, ma_uint64 frameIndex) {
+    ma_ex_audio_clip_data_source *pClipDataSource = (ma_ex_audio_clip_data_source*)pDataSource;
+    ma_result result = MA_SUCCESS;
+
+    //Seeks are done by the mixing thread too, so a pending clip is picked up first to not lose the seek
+    ma_ex_audio_clip *clip = ma_ex_audio_clip_data_source_begin(pClipDataSource);
+
+    if(clip != NULL && clip->callback == NULL && frameIndex > clip->frameCount)
+        result = MA_BAD_SEEK;
+    else
+        ma_ex_atomic_store_64(&pClipDataSource->cursor, frameIndex);
+
+    ma_ex_audio_clip_data_source_end(pClipDataSource);
+
+    return result;
+}
+
+static ma_result ma_ex_audio_clip_data_source_get_data_format(ma_data_source *pDataSource, ma_format *pFormat, ma_uint32 *pChannels, ma_uint32 *pSampleRate, ma_channel *pChannelMap, size_t channelMapCap) {
+    ma_ex_audio_clip_data_source *pClipDataSource = (ma_ex_audio_clip_data_source*)pDataSource;
+    *pFormat = ma_format_f32;
+    *pChannels = pClipDataSource->channels;
+    *pSampleRate = pClipDataSource->sampleRate;
+    ma_channel_map_init_standard(ma_standard_channel_map_default, pChannelMap, channelMapCap, pClipDataSource->channels);
+    return MA_SUCCESS;
+}
+
+static ma_result ma_ex_audio_clip_data_source_get_cursor(ma_data_source *pDataSource, ma_uint64 *pCursor) {
+    ma_ex_audio_clip_data_source *pClipDataSource = (ma_ex_audio_clip_data_source*)pDataSource;
+
+    //A clip that was swapped in but not read from yet starts at the beginning
+    if(ma_ex_atomic_load_ptr(&pClipDataSource->pPendingClip) != NULL)
+        *pCursor = 0;
+    else
+        *pCursor = ma_ex_atomic_load_64(&pClipDataSource->cursor);
+    return MA_SUCCESS;
+}
+
+/* Called by the owner of the source, which keeps both the bound and the pending clip alive. */
+static ma_result ma_ex_audio_clip_data_source_get_length(ma_data_source *pDataSource, ma_uint64 *pLength) {
+    ma_ex_audio_clip_data_source *pClipDataSource = (ma_ex_audio_clip_data_source*)pDataSource;
+    void *pClip = ma_ex_atomic_load_ptr(&pClipDataSource->pPendingClip);
+
+    if(pClip == NULL)
+        pClip = ma_ex_atomic_load_ptr(&pClipDataSource->pClip);
+    else if(pClip == MA_EX_AUDIO_CLIP_UNBIND)
+        pClip = NULL;
+
+    ma_ex_audio_clip *clip = (ma_ex_audio_clip*)pClip;
+
+    if(clip == NULL || clip->callback != NULL)
+        return MA_NOT_IMPLEMENTED;
+
+    *pLength = clip->frameCount;
+    return MA_SUCCESS;
+}
+
+static ma_data_source_vtable g_ma_ex_audio_clip_data_source_vtable = {
+    ma_ex_audio_clip_data_source_read,
+    ma_ex_audio_clip_data_source_seek,
+    ma_ex_audio_clip_data_source_get_data_format,
+    ma_ex_audio_clip_data_source_get_cursor,
+    ma_ex_audio_clip_data_source_get_length,
+    NULL,   /* onSetLooping */
+    0
+};
+
+static ma_result ma_ex_audio_clip_data_source_init(ma_ex_audio_clip_data_source *pClipDataSource, ma_uint32 channels, ma_uint32 sampleRate) {
+    MA_ZERO_OBJECT(pClipDataSource);
+
+    ma_data_source_config config = ma_data_source_config_init();
+    config.vtable = &g_ma_ex_audio_clip_data_source_vtable;
+
+    pClipDataSource->channels = channels;
+    pClipDataSource->sampleRate = sampleRate;
+    return ma_data_source_init(&config, &pClipDataSource->ds);
+}
+
+/*
+Swaps the clip that is read from. The audio thread picks the clip up on its next read and is never blocked by this. When
+it returns the audio thread no longer uses the previous clip, so the reference to it can be dropped.
+*/
+static void ma_ex_audio_clip_data_source_set_clip(ma_ex_audio_clip_data_source *pClipDataSource, ma_ex_audio_clip *clip) {
+    ma_ex_atomic_exchange_ptr(&pClipDataSource->pPendingClip, clip != NULL ? (void*)clip : MA_EX_AUDIO_CLIP_UNBIND);
+
+    //Wait for a read that may have started with the previous clip. Any read starting after this sees the new one.
+    ma_uint32 readSequence = ma_ex_atomic_fetch_add_32(&pClipDataSource->readSequence, 0);
+
+    if((readSequence & 1) != 0) {
+        while(ma_ex_atomic_load_32(&pClipDataSource->readSequence) == readSequence) {
+            ma_ex_yield();
+        }
+    }
+}
+
+/* Uninitializes the sound of a source and drops its reference to a bound clip. */
+static void ma_ex_audio_source_release_sound(ma_ex_audio_source *source) {
+    ma_ex_command_queue_flush(source->context);
+
+    //Voice stealing walks the source list and looks at every sound, so the sound is detached under the lock before it is freed
+    ma_spinlock_lock(&source->context->sourceLock);
+    ma_sound *pSound = source->pSound;
+    source->pSound = NULL;
+    source->isVirtual = MA_FALSE;
+    ma_spinlock_unlock(&source->context->sourceLock);
+
+    if(pSound != NULL) {
+        ma_sound_uninit(pSound);
+        ma_ex_pool_free(&source->context->soundPool, pSound);
+    }
+
+    source->soundHash = 0;
+    source->isClipSound = MA_FALSE;
+
+    //The data source only borrows the clip, the reference is owned by the source
+    ma_ex_audio_clip_data_source_set_clip(&source->clipDataSource, NULL);
+
+    if(source->clip != NULL) {
+        ma_ex_audio_clip_uninit(source->clip);
+        source->clip = NULL;
+    }
+}
+
+static ma_result ma_ex_audio_source_alloc_sound(ma_ex_audio_source *source) {
+    ma_sound *pSound = ma_ex_pool_alloc(&source->context->soundPool);
+
+    if(pSound == NULL)
+        return MA_OUT_OF_MEMORY;
+
+    //Zeroed before it becomes visible to voice stealing, which treats a sound without an engine as not playing
+    MA_ZERO_OBJECT(pSound);
+
+    ma_spinlock_lock(&source->context->sourceLock);
+    source->pSound = pSound;
+    ma_spinlock_unlock(&source->context->sourceLock);
+    return MA_SUCCESS;
+}
+
+MA_API ma_ex_audio_source *ma_ex_audio_source_init(ma_ex_context *context) {
+    MA_ASSERT(context != NULL);
+    
+    ma_ex_audio_source *source = ma_ex_pool_alloc(&context->sourcePool);
+
+    if(source == NULL)
+        return NULL;
+
+    source->context = context;
+    source->pSound = NULL;
+    MA_ZERO_OBJECT(&source->settings);
+    source->soundHash = 0;
+    source->soundFlags = 0;
+    source->clip = NULL;
+    source->isClipSound = MA_FALSE;
+    source->group = NULL;
+
+    if(ma_ex_audio_clip_data_source_init(&source->clipDataSource, context->channels, context->sampleRate) != MA_SUCCESS) {
+        ma_ex_pool_free(&context->sourcePool, source);
+        return NULL;
+    }
+
+    source->settings.attenuationModel = ma_attenuation_model_linear;
+    ma_ex_vec3f_set(&source->settings.direction, 0.0f, 0.0f, -1.0f);
+    ma_ex_vec3f_set(&source->settings.velocity, 0.0f, 0.0f, 0.0f);
+    source->settings.dopplerFactor = 1.0f;
+    source->settings.loop = MA_FALSE;
+    source->settings.maxDistance = MA_FLT_MAX;
+    source->settings.minDistance = 1.0f;
+    source->settings.pan = 0.0f;
+    source->settings.panMode = ma_pan_mode_balance;
+    source->settings.spatialization = MA_FALSE;
+    source->priority = 0;
+    source->isStolen = MA_FALSE;
+    source->isVirtual = MA_FALSE;
+    source->virtualStartTime = 0;
+    source->virtualStartCursor = 0;
+    source->pinCount = 0;
+
+    ma_spinlock_lock(&context->sourceLock);
+
+    if(ma_ex_source_table_alloc(&context->sourceTable, source, &source->handle) != MA_SUCCESS) {
+        ma_spinlock_unlock(&context->sourceLock);
+        ma_data_source_uninit(&source->clipDataSource.ds);
+        ma_ex_pool_free(&context->sourcePool, source);
+        return NULL;
+    }
+
+    *ma_ex_audio_source_volume(source) = 1.0f;
+    *ma_ex_audio_source_pitch(source) = 1.0f;
+    ma_ex_vec3f_set(ma_ex_audio_source_position(source), 0.0f, 0.0f, 0.0f);
+
+    source->pPrev = NULL;
+    source->pNext = context->pSourceHead;
+    if(context->pSourceHead != NULL)
+        context->pSourceHead->pPrev = source;
+    context->pSourceHead = source;
+    ma_spinlock_unlock(&context->sourceLock);
+
+    return source;
+}
+
+MA_API void ma_ex_audio_source_uninit(ma_ex_audio_source *source) {
+    if(source != NULL) {
+        ma_ex_context *context = source->context;
+
+        ma_spinlock_lock(&context->sourceLock);
+        if(source->pPrev != NULL)
+            source->pPrev->pNext = source->pNext;
+        else
+            context->pSourceHead = source->pNext;
+        if(source->pNext != NULL)
+            source->pNext->pPrev = source->pPrev;
+        ma_ex_source_table_free(&context->sourceTable, source->handle);
+        ma_spinlock_unlock(&context->sourceLock);
+
+        //The handle no longer resolves, but calls that resolved it before may still be using the source. Batches
+        //that pinned it are only unpinned once applied, so the queue is kept draining while waiting.
+        while(ma_ex_atomic_load_32(&source->pinCount) != 0) {
+            ma_ex_command_queue_flush(context);
+            ma_ex_yield();
+        }
+
+        ma_ex_audio_source_release_sound(source);
+        ma_data_source_uninit(&source->clipDataSource.ds);
+        ma_ex_pool_free(&source->context->sourcePool, source);
+    }
+}
+
+MA_API ma_ex_audio_source_handle ma_ex_audio_source_get_handle(ma_ex_audio_source *source) {
+    if(source == NULL)
+        return 0;
+    return source->handle;
+}
+
+/*
+Returns NULL when the handle is invalid or the source it referred to was uninitialized. The pointer is not pinned, the
+caller must make sure the source isn't uninitialized while using it. The ma_ex_context_set_source_* functions don't
+have that restriction.
+*/
+MA_API ma_ex_audio_source *ma_ex_audio_source_from_handle(ma_ex_context *context, ma_ex_audio_source_handle handle) {
+    if(context == NULL)
+        return NULL;
+
+    ma_spinlock_lock(&context->sourceLock);
+    ma_ex_audio_source *source = ma_ex_source_table_get(&context->sourceTable, handle);
+    ma_spinlock_unlock(&context->sourceLock);
+    return source;
+}
+
+/* Resolves a handle and pins the source so ma_ex_audio_source_uninit() waits until it is unpinned. */
+static ma_ex_audio_source *ma_ex_context_pin_source(ma_ex_context *context, ma_ex_audio_source_handle handle) {
+    ma_spinlock_lock(&context->sourceLock);
+    ma_ex_audio_source *source = ma_ex_source_table_get(&context->sourceTable, handle);
+    if(source != NULL)
+        ma_ex_atomic_fetch_add_32(&source->pinCount, 1);
+    ma_spinlock_unlock(&context->sourceLock);
+    return source;
+}
+
+static ma_result ma_ex_audio_source_play_file(ma_ex_audio_source *source, const char *filePath, ma_uint32 soundFlags) {
+    ma_uint64 soundHash = ma_ex_create_hashcode(filePath, strlen(filePath));
+
+    if(source->isClipSound || source->soundFlags != soundFlags || ma_ex_hashcode_is_same(source->soundHash, soundHash) == MA_FALSE) {
+        ma_ex_audio_source_release_sound(source);
+
+        if(ma_ex_audio_source_alloc_sound(source) != MA_SUCCESS)
+            return MA_OUT_OF_MEMORY;
+
+        source->soundFlags = soundFlags;
+
+        ma_result result = ma_sound_init_from_file(&source->context->engine, filePath, source->soundFlags, source->group, NULL, source->pSound);
+
+        if(result != MA_SUCCESS) {
+            ma_ex_audio_source_release_sound(source);
+            return MA_ERROR;
+        }
+    }
+
+    source->soundHash = soundHash;
+    return ma_ex_audio_source_start(source);
+}
+
+MA_API ma_result ma_ex_audio_source_play_from_file(ma_ex_audio_source *source, const char *filePath, ma_bool8 streamFromDisk) {
+    if(source == NULL)
+        return MA_ERROR;
+
+    if(filePath == NULL)
+        return MA_INVALID_FILE;
+
+    if(streamFromDisk != MA_TRUE && (source->context->memoryMappedFiles || source->context->pDecodeCacheDirectory != NULL)) {
+        ma_uint64 soundHash = ma_ex_create_hashcode(filePath, strlen(filePath));
+
+        //Replaying the same file only restarts the source, soundHash is reset whenever another clip is bound
+        if(source->isClipSound && source->clip != NULL && ma_ex_hashcode_is_same(source->soundHash, soundHash))
+            return ma_ex_audio_source_play_clip(source, source->clip);
+
+        ma_ex_audio_clip *clip = ma_ex_audio_clip_init_from_file_fast(source->context, filePath);
+
+        if(clip != NULL) {
+            ma_result result = ma_ex_audio_source_play_clip(source, clip);
+
+            //The source holds its own reference to the clip
+            ma_ex_audio_clip_uninit(clip);
+
+            if(result == MA_SUCCESS)
+                source->soundHash = soundHash;
+            return result;
+        }
+    }
+
+    return ma_ex_audio_source_play_file(source, filePath, streamFromDisk == MA_TRUE ? MA_SOUND_FLAG_DECODE | MA_SOUND_FLAG_STREAM : MA_SOUND_FLAG_DECODE);
+}
+
+MA_API ma_result ma_ex_audio_source_play_from_file_w(ma_ex_audio_source *source, const wchar_t *filePath, ma_bool8 streamFromDisk) {
+    if(source == NULL)
+        return MA_ERROR;
+
+    if(filePath == NULL)
+        return MA_INVALID_FILE;
+    
+    ma_uint64 soundHash = ma_ex_create_hashcode(filePath, wcslen(filePath));
+
+    if(source->isClipSound || ma_ex_hashcode_is_same(source->soundHash, soundHash) == MA_FALSE) {
+        ma_ex_audio_source_release_sound(source);
+
+        if(ma_ex_audio_source_alloc_sound(source) != MA_SUCCESS)
+            return MA_OUT_OF_MEMORY;
+
+        source->soundFlags = MA_SOUND_FLAG_DECODE;
+        
+        if(streamFromDisk == MA_TRUE)
+            source->soundFlags |= MA_SOUND_FLAG_STREAM;
+
+        ma_result result = ma_sound_init_from_file_w(&source->context->engine, filePath, source->soundFlags, source->group, NULL, source->pSound);
+
+        if(result != MA_SUCCESS) {
+            ma_ex_audio_source_release_sound(source);
+            return MA_ERROR;
+        }
+    }
+
+    source->soundHash = soundHash;
+    return ma_ex_audio_source_start(source);
+}
+
+MA_API ma_result ma_ex_audio_source_play_from_memory(ma_ex_audio_source *source, const void *pData, ma_uint64 dataSize) {
+    if(source == NULL)
+        return MA_ERROR;
+
+    if(pData == NULL)
+        return MA_INVALID_DATA;
+
+    if(dataSize == 0)
+        return MA_INVALID_ARGS;
+    
+    ma_uint64 soundHash = ma_ex_pointer_to_hashcode(pData);
+
+    if(source->isClipSound || ma_ex_hashcode_is_same(source->soundHash, soundHash) == MA_FALSE) {
+        ma_ex_audio_source_release_sound(source);
+
+        if(ma_ex_audio_source_alloc_sound(source) != MA_SUCCESS)
+            return MA_OUT_OF_MEMORY;
+
+        //With MA_SOUND_FLAG_DECODE the data is decoded once and shared by every source playing the same bytes
+        source->soundFlags = source->context->shareMemoryDecodes ? MA_SOUND_FLAG_DECODE : 0;
+
+        ma_result result = ma_sound_init_from_memory(&source->context->engine, pData, dataSize, source->soundFlags, source->group, NULL, source->pSound);
+
+        if(result != MA_SUCCESS) {
+            ma_ex_audio_source_release_sound(source);
+            return MA_ERROR;
+        }
+    }
+
+    source->soundHash = soundHash;
+    return ma_ex_audio_source_start(source);
+}
+
+MA_API ma_result ma_ex_audio_source_play_from_callback(ma_ex_audio_source *source, ma_procedural_data_source_proc callback, void *pUserData) {
+    if(source == NULL)
+        return MA_ERROR;
+
+    if(callback == NULL)
+        return MA_INVALID_ARGS;
+    
+    ma_uint64 soundHash = ma_ex_pointer_to_hashcode(callback);
+
+    if(source->isClipSound || ma_ex_hashcode_is_same(source->soundHash, soundHash) == MA_FALSE) {
+        ma_ex_audio_source_release_sound(source);
+
+        if(ma_ex_audio_source_alloc_sound(source) != MA_SUCCESS)
+            return MA_OUT_OF_MEMORY;
+
+        source->soundFlags = 0;
+
+        ma_procedural_data_source_config config = ma_procedural_data_source_config_init(ma_format_f32, source->context->channels, source->context->sampleRate, callback, pUserData != NULL ? pUserData : source);
+
+        ma_result result = ma_sound_init_from_callback(&source->context->engine, &config, source->soundFlags, source->group, NULL, source->pSound);
+
+        if(result != MA_SUCCESS) {
+            ma_ex_audio_source_release_sound(source);
+            return MA_ERROR;
+        }
+    }
+
+    source->soundHash = soundHash;
+    return ma_ex_audio_source_start(source);
+}
+
+/* Plays a shared clip. Sources that alternate between decoded clips keep their sound and only swap what it reads from. */
+MA_API ma_result ma_ex_audio_source_play_clip(ma_ex_audio_source *source, ma_ex_audio_clip *clip) {
+    if(source == NULL || clip == NULL)
+        return MA_INVALID_ARGS;
+
+    if(clip->context != source->context || !ma_ex_audio_clip_is_initialized(clip))
+        return MA_INVALID_ARGS;
+
+    if(clip->pFilePath != NULL) {
+        ma_result result = ma_ex_audio_clip_get_load_result(clip);
+
+        if(result != MA_SUCCESS && result != MA_BUSY)
+            return result;
+
+        //Clips loaded asynchronously share the data of the resource manager, the sound connects to it once the first page is decoded
+        if(clip->pDataBuffer != NULL)
+            result = ma_ex_audio_source_play_file(source, clip->pFilePath, MA_SOUND_FLAG_DECODE | MA_SOUND_FLAG_ASYNC);
+        else
+            result = ma_ex_audio_source_play_file(source, clip->pFilePath, MA_SOUND_FLAG_DECODE | MA_SOUND_FLAG_STREAM);
+
+        if(result == MA_SUCCESS && source->clip != clip) {
+            if(source->clip != NULL)
+                ma_ex_audio_clip_uninit(source->clip);
+            source->clip = ma_ex_audio_clip_acquire(clip);
+        }
+
+        return result;
+    }
+
+    if(!source->isClipSound) {
+        ma_ex_audio_source_release_sound(source);
+
+        if(ma_ex_audio_source_alloc_sound(source) != MA_SUCCESS)
+            return MA_OUT_OF_MEMORY;
+
+        ma_result result = ma_sound_init_from_data_source(&source->context->engine, &source->clipDataSource, 0, source->group, source->pSound);
+
+        if(result != MA_SUCCESS) {
+            ma_ex_audio_source_release_sound(source);
+            return MA_ERROR;
+        }
+
+        source->isClipSound = MA_TRUE;
+    }
+
+    if(source->clip != clip) {
+        ma_ex_audio_clip_acquire(clip);
+        ma_ex_audio_clip_data_source_set_clip(&source->clipDataSource, clip);
+        source->soundHash = 0;
+
+        //Also drops whatever the sound still has cached from the previous clip
+        ma_sound_seek_to_pcm_frame(source->pSound, 0);
+
+        if(source->clip != NULL)
+            ma_ex_audio_clip_uninit(source->clip);
+
+        source->clip = clip;
+    }
+
+    return ma_ex_audio_source_start(source);
+}
+
+MA_API void ma_ex_audio_source_stop(ma_ex_audio_source *source) {
+    if(source != NULL) {
+        ma_spinlock_lock(&source->context->sourceLock);
+        source->isVirtual = MA_FALSE;
+        ma_sound_stop(source->pSound);
+        ma_spinlock_unlock(&source->context->sourceLock);
+    }
+}
+
+MA_API void ma_ex_audio_source_apply_settings(ma_ex_audio_source *source) {
+    if(source != NULL) {
+        const ma_vec3f *position = ma_ex_audio_source_position(source);
+
+        //With queueing enabled the settings go through the queue, so they can't overtake changes that were recorded before
+        if(ma_ex_atomic_load_32(&source->context->commandQueue.capacity) != 0) {
+            ma_ex_audio_source_defer_u32(source, ma_ex_command_type_set_attenuation_model, source->settings.attenuationModel);
+            ma_ex_audio_source_defer_vec3f(source, ma_ex_command_type_set_direction, source->settings.direction.x, source->settings.direction.y, source->settings.direction.z);
+            ma_ex_audio_source_defer_f32(source, ma_ex_command_type_set_doppler_factor, source->settings.dopplerFactor);
+            ma_ex_audio_source_defer_u32(source, ma_ex_command_type_set_loop, source->settings.loop);
+            ma_ex_audio_source_defer_f32(source, ma_ex_command_type_set_min_distance, source->settings.minDistance);
+            ma_ex_audio_source_defer_f32(source, ma_ex_command_type_set_max_distance, source->settings.maxDistance);
+            ma_ex_audio_source_defer_f32(source, ma_ex_command_type_set_pitch, *ma_ex_audio_source_pitch(source));
+            ma_ex_audio_source_defer_f32(source, ma_ex_command_type_set_pan, source->settings.pan);
+            ma_ex_audio_source_defer_u32(source, ma_ex_command_type_set_pan_mode, source->settings.panMode);
+            ma_ex_audio_source_defer_vec3f(source, ma_ex_command_type_set_position, position->x, position->y, position->z);
+            ma_ex_audio_source_defer_u32(source, ma_ex_command_type_set_spatialization, source->settings.spatialization);
+            ma_ex_audio_source_defer_vec3f(source, ma_ex_command_type_set_velocity, source->settings.velocity.x, source->settings.velocity.y, source->settings.velocity.z);
+            ma_ex_audio_source_defer_f32(source, ma_ex_command_type_set_volume, *ma_ex_audio_source_volume(source));
+            return;
+        }
+
+        ma_sound_set_attenuation_model(source->pSound, source->settings.attenuationModel);
+        ma_sound_set_direction(source->pSound, source->settings.direction.x, source->settings.direction.y, source->settings.direction.z);
+        ma_sound_set_doppler_factor(source->pSound, source->settings.dopplerFactor);
+        ma_sound_set_looping(source->pSound, source->settings.loop);
+        ma_sound_set_min_distance(source->pSound, source->settings.minDistance);
+        ma_sound_set_max_distance(source->pSound, source->settings.maxDistance);
+        ma_sound_set_pitch(source->pSound, *ma_ex_audio_source_pitch(source));
+        ma_sound_set_pan(source->pSound, source->settings.pan);
+        ma_sound_set_pan_mode(source->pSound, source->settings.panMode);
+        ma_sound_set_position(source->pSound, position->x, position->y, position->z);
+        ma_sound_set_spatialization_enabled(source->pSound, source->settings.spatialization);
+        ma_sound_set_velocity(source->pSound, source->settings.velocity.x, source->settings.velocity.y, source->settings.velocity.z);
+        ma_sound_set_volume(source->pSound, *ma_ex_audio_source_volume(source));
+    }
+}
+
+MA_API void ma_ex_audio_source_set_volume(ma_ex_audio_source *source, float value) {
+    if(source != NULL) {
+        *ma_ex_audio_source_volume(source) = value;
+        if(!ma_ex_audio_source_defer_f32(source, ma_ex_command_type_set_volume, value))
+            ma_sound_set_volume(source->pSound, value);
+    }
+}
+
+MA_API float ma_ex_audio_source_get_volume(ma_ex_audio_source *source) {
+    if(source != NULL)
+        return *ma_ex_audio_source_volume(source);
+    return 1.0f;
+}
+
+MA_API void ma_ex_audio_source_set_pitch(ma_ex_audio_source *source, float value) {
+    if(source != NULL) {
+        *ma_ex_audio_source_pitch(source) = value;
+        if(!ma_ex_audio_source_defer_f32(source, ma_ex_command_type_set_pitch, value))
+            ma_sound_set_pitch(source->pSound, value);
+    }
+}
+
+MA_API float ma_ex_audio_source_get_pitch(ma_ex_audio_source *source) {
+    if(source != NULL)
+        return *ma_ex_audio_source_pitch(source);
+    return 1.0f;
+}
+
+MA_API void ma_ex_audio_source_set_pan(ma_ex_audio_source *source, float value) {
+    if(source != NULL) {
+        source->settings.pan = value;
+        if(!ma_ex_audio_source_defer_f32(source, ma_ex_command_type_set_pan, value))
+            ma_sound_set_pan(source->pSound, value);
+    }
+}
+
+MA_API float ma_ex_audio_source_get_pan(ma_ex_audio_source *source) {
+    if(source != NULL)
+        return source->settings.pan;
+    return 0.0f;
+}
+
+MA_API void ma_ex_audio_source_set_pan_mode(ma_ex_audio_source *source, ma_pan_mode mode) {
+    if(source != NULL) {
+        source->settings.panMode = mode;
+        if(!ma_ex_audio_source_defer_u32(source, ma_ex_command_type_set_pan_mode, mode))
+            ma_sound_set_pan_mode(source->pSound, mode);
+    }
+}
+
+MA_API ma_pan_mode ma_ex_audio_source_get_pan_mode(ma_ex_audio_source *source) {
+    if(source != NULL)
+        return source->settings.panMode;
+    return ma_pan_mode_balance;
+}
+
+MA_API void ma_ex_audio_source_set_pcm_position(ma_ex_audio_source *source, ma_uint64 position) {
+    if(source != NULL) {
+        //Held across the seek so the source can't be virtualized from its old cursor in between
+        ma_spinlock_lock(&source->context->sourceLock);
+        if(source->isVirtual) {
+            source->virtualStartCursor = position;
+            source->virtualStartTime = ma_engine_get_time_in_pcm_frames(&source->context->engine);
+        } else if(!ma_ex_audio_source_defer_u64(source, ma_ex_command_type_set_pcm_position, position)) {
+            ma_sound_seek_to_pcm_frame(source->pSound, position);
+        }
+        ma_spinlock_unlock(&source->context->sourceLock);
+    }
+}
+
+MA_API ma_uint64 ma_ex_audio_source_get_pcm_position(ma_ex_audio_source *source) {
+    if(source != NULL) {
+        ma_uint64 position;
+        ma_spinlock_lock(&source->context->sourceLock);
+        if(source->isVirtual) {
+            ma_bool32 atEnd;
+            position = ma_ex_audio_source_get_virtual_cursor(source, &atEnd);
+        } else {
+            position = ma_sound_get_time_in_pcm_frames(source->pSound);
+        }
+        ma_spinlock_unlock(&source->context->sourceLock);
+        return position;
+    }
+    return 0;
+}
+
+MA_API ma_uint64 ma_ex_audio_source_get_pcm_length(ma_ex_audio_source *source) {
+    if(source != NULL) {
+        ma_data_source *dataSource = ma_sound_get_data_source(source->pSound);
+        if(dataSource != NULL) {
+            ma_uint64 length = 0;
+            ma_data_source_get_length_in_pcm_frames(dataSource, &length);
+            return length;
+        }
+    }
+    return 0;
+}
+
+MA_API void ma_ex_audio_source_set_loop(ma_ex_audio_source *source, ma_bool32 loop) {
+    if(source != NULL) {
+        source->settings.loop = loop;
+        if(!ma_ex_audio_source_defer_u32(source, ma_ex_command_type_set_loop, loop))
+            ma_sound_set_looping(source->pSound, loop);
+    }
+}
+
+MA_API ma_bool32 ma_ex_audio_source_get_loop(ma_ex_audio_source *source) {
+    if(source != NULL)
+        return source->settings.loop;
+    return MA_FALSE;
+}
+
+MA_API void ma_ex_audio_source_set_position(ma_ex_audio_source *source, float x, float y, float z) {
+    if(source != NULL) {
+        ma_ex_vec3f_set(ma_ex_audio_source_position(source), x, y, z);
+        if(!ma_ex_audio_source_defer_vec3f(source, ma_ex_command_type_set_position, x, y, z))
+            ma_sound_set_position(source->pSound, x, y, z);
+    }
+}
+
+MA_API void ma_ex_audio_source_get_position(ma_ex_audio_source *source, float *x, float *y, float *z) {
+    if(source != NULL) {
+        ma_ex_vec3f_get(ma_ex_audio_source_position(source), x, y, z);
+    } else {
+        *x = 0.0f;
+        *y = 0.0f;
+        *z = 0.0f;
+    }
+}
+
+MA_API void ma_ex_audio_source_set_direction(ma_ex_audio_source *source, float x, float y, float z) {
+    if(source != NULL) {
+        ma_ex_vec3f_set(&source->settings.direction, x, y, z);
+        if(!ma_ex_audio_source_defer_vec3f(source, ma_ex_command_type_set_direction, x, y, z))
+            ma_sound_set_direction(source->pSound, x, y, z);
+    }
+}
+
+MA_API void ma_ex_audio_source_get_direction(ma_ex_audio_source *source, float *x, float *y, float *z) {
+    if(source != NULL) {
+        ma_ex_vec3f_get(&source->settings.direction, x, y, z);
+    } else {
+        *x = 0.0f;
+        *y = 0.0f;
+        *z = 0.0f;
+    }
+}
+
+MA_API void ma_ex_audio_source_set_velocity(ma_ex_audio_source *source, float x, float y, float z) {
+    if(source != NULL) {
+        ma_ex_vec3f_set(&source->settings.velocity, x, y, z);
+        if(!ma_ex_audio_source_defer_vec3f(source, ma_ex_command_type_set_velocity, x, y, z))
+            ma_sound_set_velocity(source->pSound, x, y, z);
+    }
+}
+
+MA_API void ma_ex_audio_source_get_velocity(ma_ex_audio_source *source, float *x, float *y, float *z) {
+    if(source != NULL) {
+        ma_ex_vec3f_get(&source->settings.velocity, x, y, z);
+    } else {
+        *x = 0.0f;
+        *y = 0.0f;
+        *z = 0.0f;
+    }
+}
+
+/*
+Stores the transforms of a filled in batch as the settings of its sources, then records the batch as one command. The
+batch is applied in a single pass by the consumer, or straight away when queueing is disabled, and is freed either way.
+*/
+static void ma_ex_context_set_transforms(ma_ex_context *context, ma_ex_transform_batch *batch) {
+    for(ma_uint32 i = 0; i < batch->count; i++) {
+        ma_ex_audio_source *source = batch->ppSources[i];
+
+        if(source == NULL)
+            continue;
+
+        if(batch->pPositions != NULL)
+            ma_ex_vec3f_set(ma_ex_audio_source_position(source), batch->pPositions[i * 3], batch->pPositions[i * 3 + 1], batch->pPositions[i * 3 + 2]);
+        if(batch->pVelocities != NULL)
+            ma_ex_vec3f_set(&source->settings.velocity, batch->pVelocities[i * 3], batch->pVelocities[i * 3 + 1], batch->pVelocities[i * 3 + 2]);
+        if(batch->pDirections != NULL)
+            ma_ex_vec3f_set(&source->settings.direction, batch->pDirections[i * 3], batch->pDirections[i * 3 + 1], batch->pDirections[i * 3 + 2]);
+    }
+
+    ma_ex_command_queue_free_retired_batches(&context->commandQueue);
+
+    ma_ex_command command;
+    command.type = ma_ex_command_type_set_transforms;
+    command.source = NULL;
+    command.value.p = batch;
+
+    if(!ma_ex_command_queue_push(context, &command)) {
+        ma_ex_transform_batch_apply(batch);
+        MA_FREE(batch);
+    }
+}
+
+/* Copies the arrays of ma_ex_audio_source_set_transforms into a batch. The sources are filled in by the caller. */
+static ma_ex_transform_batch *ma_ex_transform_batch_init(ma_uint32 count, const float *positions, const float *velocities, const float *directions) {
+    ma_ex_transform_batch *batch = ma_ex_transform_batch_alloc(count, positions != NULL, velocities != NULL, directions != NULL);
+
+    if(batch == NULL)
+        return NULL;
+
+    if(positions != NULL)
+        memcpy(batch->pPositions, positions, sizeof(float) * 3 * count);
+    if(velocities != NULL)
+        memcpy(batch->pVelocities, velocities, sizeof(float) * 3 * count);
+    if(directions != NULL)
+        memcpy(batch->pDirections, directions, sizeof(float) * 3 * count);
+    return batch;
+}
+
+/*
+Sets the transforms of many sources in one call. Each array holds x, y and z for every source and may be NULL to leave
+that property as is. When every source belongs to the same context the whole call is recorded as a single command.
+*/
+MA_API void ma_ex_audio_source_set_transforms(ma_ex_audio_source **sources, ma_uint32 count, const float *positions, const float *velocities, const float *directions) {
+    if(sources == NULL || count == 0)
+        return;
+
+    ma_ex_context *context = NULL;
+    ma_bool32 isSingleContext = MA_TRUE;
+
+    for(ma_uint32 i = 0; i < count; i++) {
+        if(sources[i] == NULL)
+            continue;
+        if(context != NULL && sources[i]->context != context)
+            isSingleContext = MA_FALSE;
+        context = sources[i]->context;
+    }
+
+    ma_ex_transform_batch *batch = (context != NULL && isSingleContext) ? ma_ex_transform_batch_init(count, positions, velocities, directions) : NULL;
+
+    if(batch != NULL) {
+        memcpy(batch->ppSources, sources, sizeof(ma_ex_audio_source*) * count);
+        ma_ex_context_set_transforms(context, batch);
+        return;
+    }
+
+    //Sources from different contexts are drained by different audio threads, so they are set one at a time
+    for(ma_uint32 i = 0; i < count; i++) {
+        ma_ex_audio_source *source = sources[i];
+
+        if(source == NULL)
+            continue;
+
+        if(positions != NULL)
+            ma_ex_audio_source_set_position(source, positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]);
+        if(velocities != NULL)
+            ma_ex_audio_source_set_velocity(source, velocities[i * 3], velocities[i * 3 + 1], velocities[i * 3 + 2]);
+        if(directions != NULL)
+            ma_ex_audio_source_set_direction(source, directions[i * 3], directions[i * 3 + 1], directions[i * 3 + 2]);
+    }
+}
+
+/* Same as ma_ex_audio_source_set_transforms, but with handles. Handles to sources that no longer exist are skipped. */
+MA_API void ma_ex_context_set_source_transforms(ma_ex_context *context, const ma_ex_audio_source_handle *handles, ma_uint32 count, const float *positions, const float *velocities, const float *directions) {
+    if(context == NULL || handles == NULL || count == 0)
+        return;
+
+    ma_ex_transform_batch *batch = ma_ex_transform_batch_init(count, positions, velocities, directions);
+
+    //The batch holds the pins until it is applied, which may be after a queued command is drained
+    if(batch != NULL) {
+        for(ma_uint32 i = 0; i < count; i++)
+            batch->ppSources[i] = ma_ex_context_pin_source(context, handles[i]);
+        batch->isPinned = MA_TRUE;
+        ma_ex_context_set_transforms(context, batch);
+        return;
+    }
+
+    for(ma_uint32 i = 0; i < count; i++) {
+        ma_ex_audio_source *source = ma_ex_context_pin_source(context, handles[i]);
+
+        if(source == NULL)
+            continue;
+
+        if(positions != NULL)
+            ma_ex_audio_source_set_position(source, positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]);
+        if(velocities != NULL)
+            ma_ex_audio_source_set_velocity(source, velocities[i * 3], velocities[i * 3 + 1], velocities[i * 3 + 2]);
+        if(directions != NULL)
+            ma_ex_audio_source_set_direction(source, directions[i * 3], directions[i * 3 + 1], directions[i * 3 + 2]);
+        ma_ex_audio_source_unpin(source);
+    }
+}
+
+MA_API void ma_ex_audio_source_set_spatialization(ma_ex_audio_source *source, ma_bool32 enabled) {
+    if(source != NULL) {
+        source->settings.spatialization = enabled;
+        if(!ma_ex_audio_source_defer_u32(source, ma_ex_command_type_set_spatialization, enabled))
+            ma_sound_set_spatialization_enabled(source->pSound, enabled);
+    }
+}
+
+MA_API ma_bool32 ma_ex_audio_source_get_spatialization(ma_ex_audio_source *source) {
+    if(source != NULL)
+        return source->settings.spatialization;
+    return MA_FALSE;
 }
 
 MA_API void ma_ex_audio_source_set_attenuation_model(ma_ex_audio_source *source, ma_attenuation_model model) {
     if(source != NULL) {
         source->settings.attenuationModel = model;
-        ma_sound_set_attenuation_model(&source->clip.sound, model);
+        if(!ma_ex_audio_source_defer_u32(source, ma_ex_command_type_set_attenuation_model, model))
+            ma_sound_set_attenuation_model(source->pSound, model);
+    }
+}
+
+MA_API ma_attenuation_model ma_ex_audio_source_get_attenuation_model(ma_ex_audio_source *source) {
+    if(source != NULL)
+        return source->settings.attenuationModel;
+    return ma_attenuation_model_none;
+}
+
+MA_API void ma_ex_audio_source_set_doppler_factor(ma_ex_audio_source *source, float factor) {
+    if(source != NULL) {
+        source->settings.dopplerFactor = factor;
+        if(!ma_ex_audio_source_defer_f32(source, ma_ex_command_type_set_doppler_factor, factor))
+            ma_sound_set_doppler_factor(source->pSound, factor);
+    }
+}
+
+MA_API float ma_ex_audio_source_get_doppler_factor(ma_ex_audio_source *source) {
+    if(source != NULL)
+        return source->settings.dopplerFactor;
+    return 0.0f;
+}
+
+MA_API void ma_ex_audio_source_set_min_distance(ma_ex_audio_source *source, float distance) {
+    if(source != NULL) {
+        source->settings.minDistance = distance;
+        if(!ma_ex_audio_source_defer_f32(source, ma_ex_command_type_set_min_distance, distance))
+            ma_sound_set_min_distance(source->pSound, distance);
+    }
+}
+
+MA_API float ma_ex_audio_source_get_min_distance(ma_ex_audio_source *source) {
+    if(source != NULL)
+        return source->settings.minDistance;
+    return 1.0f;
+}
+
+MA_API void ma_ex_audio_source_set_max_distance(ma_ex_audio_source *source, float distance) {
+    if(source != NULL) {
+        source->settings.maxDistance = distance;
+        if(!ma_ex_audio_source_defer_f32(source, ma_ex_command_type_set_max_distance, distance))
+            ma_sound_set_max_distance(source->pSound, distance);
+    }
+}
+
+MA_API float ma_ex_audio_source_get_max_distance(ma_ex_audio_source *source) {
+    if(source != NULL)
+        return source->settings.maxDistance;
+    return MA_FLT_MAX;
+}
+
+MA_API ma_bool32 ma_ex_audio_source_get_is_playing(ma_ex_audio_source *source) {
+    if(source != NULL) {
+        if(source->isVirtual)
+            return MA_TRUE;
+        return ma_sound_is_playing(source->pSound);
+    }
+    return MA_FALSE;
+}
+
+MA_API ma_bool32 ma_ex_audio_source_get_is_at_end(ma_ex_audio_source *source) {
+    if(source != NULL) {
+        return ma_sound_at_end(source->pSound);
+    }
+    return MA_FALSE;
+}
+
+MA_API ma_bool32 ma_ex_audio_source_get_is_virtual(ma_ex_audio_source *source) {
+    if(source != NULL)
+        return source->isVirtual;
+    return MA_FALSE;
+}
+
+MA_API ma_uint32 ma_ex_audio_source_get_starvation_count(ma_ex_audio_source *source) {
+    if(source == NULL || source->pSound == NULL || source->pSound->pResourceManagerDataSource == NULL)
+        return 0;
+
+    //Only streams can run out of decoded data, everything else is in memory
+    if((source->pSound->pResourceManagerDataSource->flags & MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_STREAM) == 0)
+        return 0;
+
+    return ma_resource_manager_data_stream_get_starvation_count(&source->pSound->pResourceManagerDataSource->backend.stream);
+}
+
+MA_API ma_ex_audio_clip *ma_ex_audio_source_get_clip(ma_ex_audio_source *source) {
+    if(source == NULL)
+        return NULL;
+    return source->clip;
+}
+
+MA_API ma_result ma_ex_audio_source_set_group(ma_ex_audio_source *source, ma_sound_group *group) {
+    if(source == NULL)
+        return MA_ERROR;
+    source->group = group;
+
+    //Sounds that are kept alive between clips have to be moved to the new group right away
+    if(ma_sound_get_engine(source->pSound) != NULL) {
+        ma_node *pOutput = group != NULL ? (ma_node*)group : ma_engine_get_endpoint(&source->context->engine);
+        return ma_node_attach_output_bus(source->pSound, 0, pOutput, 0);
+    }
+
+    return MA_SUCCESS;
+}
+
+MA_API ma_sound_group *ma_ex_audio_source_get_group(ma_ex_audio_source *source) {
+    if(source == NULL)
+        return NULL;
+    return source->group;
+}
+
+MA_API void ma_ex_audio_source_set_priority(ma_ex_audio_source *source, ma_int32 priority) {
+    if(source != NULL)
+        source->priority = priority;
+}
+
+MA_API ma_int32 ma_ex_audio_source_get_priority(ma_ex_audio_source *source) {
+    if(source != NULL)
+        return source->priority;
+    return 0;
+}
+
+/*
+Handle based versions of the setters, for bindings that can't guarantee a source pointer is still valid. They return
+MA_INVALID_OPERATION when the source the handle referred to no longer exists. The source is pinned for the duration of
+the call, so it can safely be uninitialized from another thread at the same time.
+*/
+static ma_ex_audio_source *ma_ex_context_resolve_source(ma_ex_context *context, ma_ex_audio_source_handle handle) {
+    if(context == NULL)
+        return NULL;
+    return ma_ex_context_pin_source(context, handle);
+}
+
+MA_API ma_result ma_ex_context_stop_source(ma_ex_context *context, ma_ex_audio_source_handle handle) {
+    ma_ex_audio_source *source = ma_ex_context_resolve_source(context, handle);
+
+    if(source == NULL)
+        return MA_INVALID_OPERATION;
+
+    ma_ex_audio_source_stop(source);
+    ma_ex_audio_source_unpin(source);
+    return MA_SUCCESS;
+}
+
+MA_API ma_result ma_ex_context_set_source_volume(ma_ex_context *context, ma_ex_audio_source_handle handle, float value) {
+    ma_ex_audio_source *source = ma_ex_context_resolve_source(context, handle);
+
+    if(source == NULL)
+        return MA_INVALID_OPERATION;
+
+    ma_ex_audio_source_set_volume(source, value);
+    ma_ex_audio_source_unpin(source);
+    return MA_SUCCESS;
+}
+
+MA_API ma_result ma_ex_context_set_source_pitch(ma_ex_context *context, ma_ex_audio_source_handle handle, float value) {
+    ma_ex_audio_source *source = ma_ex_context_resolve_source(context, handle);
+
+    if(source == NULL)
+        return MA_INVALID_OPERATION;
+
+    ma_ex_audio_source_set_pitch(source, value);
+    ma_ex_audio_source_unpin(source);
+    return MA_SUCCESS;
+}
+
+MA_API ma_result ma_ex_context_set_source_pan(ma_ex_context *context, ma_ex_audio_source_handle handle, float value) {
+    ma_ex_audio_source *source = ma_ex_context_resolve_source(context, handle);
+
+    if(source == NULL)
+        return MA_INVALID_OPERATION;
+
+    ma_ex_audio_source_set_pan(source, value);
+    ma_ex_audio_source_unpin(source);
+    return MA_SUCCESS;
+}
+
+MA_API ma_result ma_ex_context_set_source_pan_mode(ma_ex_context *context, ma_ex_audio_source_handle handle, ma_pan_mode mode) {
+    ma_ex_audio_source *source = ma_ex_context_resolve_source(context, handle);
+
+    if(source == NULL)
+        return MA_INVALID_OPERATION;
+
+    ma_ex_audio_source_set_pan_mode(source, mode);
+    ma_ex_audio_source_unpin(source);
+    return MA_SUCCESS;
+}
+
+MA_API ma_result ma_ex_context_set_source_pcm_position(ma_ex_context *context, ma_ex_audio_source_handle handle, ma_uint64 position) {
+    ma_ex_audio_source *source = ma_ex_context_resolve_source(context, handle);
+
+    if(source == NULL)
+        return MA_INVALID_OPERATION;
+
+    ma_ex_audio_source_set_pcm_position(source, position);
+    ma_ex_audio_source_unpin(source);
+    return MA_SUCCESS;
+}
+
+MA_API ma_result ma_ex_context_set_source_loop(ma_ex_context *context, ma_ex_audio_source_handle handle, ma_bool32 loop) {
+    ma_ex_audio_source *source = ma_ex_context_resolve_source(context, handle);
+
+    if(source == NULL)
+        return MA_INVALID_OPERATION;
+
+    ma_ex_audio_source_set_loop(source, loop);
+    ma_ex_audio_source_unpin(source);
+    return MA_SUCCESS;
+}
+
+MA_API ma_result ma_ex_context_set_source_position(ma_ex_context *context, ma_ex_audio_source_handle handle, float x, float y, float z) {
+    ma_ex_audio_source *source = ma_ex_context_resolve_source(context, handle);
+
+    if(source == NULL)
+        return MA_INVALID_OPERATION;
+
+    ma_ex_audio_source_set_position(source, x, y, z);
+    ma_ex_audio_source_unpin(source);
+    return MA_SUCCESS;
+}
+
+MA_API ma_result ma_ex_context_set_source_direction(ma_ex_context *context, ma_ex_audio_source_handle handle, float x, float y, float z) {
+    ma_ex_audio_source *source = ma_ex_context_resolve_source(context, handle);
+
+    if(source == NULL)
+        return MA_INVALID_OPERATION;
+
+    ma_ex_audio_source_set_direction(source, x, y, z);
+    ma_ex_audio_source_unpin(source);
+    return MA_SUCCESS;
+}
+
+MA_API ma_result ma_ex_context_set_source_velocity(ma_ex_context *context, ma_ex_audio_source_handle handle, float x, float y, float z) {
+    ma_ex_audio_source *source = ma_ex_context_resolve_source(context, handle);
+
+    if(source == NULL)
+        return MA_INVALID_OPERATION;
+
+    ma_ex_audio_source_set_velocity(source, x, y, z);
+    ma_ex_audio_source_unpin(source);
+    return MA_SUCCESS;
+}
+
+MA_API ma_result ma_ex_context_set_source_spatialization(ma_ex_context *context, ma_ex_audio_source_handle handle, ma_bool32 enabled) {
+    ma_ex_audio_source *source = ma_ex_context_resolve_source(context, handle);
+
+    if(source == NULL)
+        return MA_INVALID_OPERATION;
+
+    ma_ex_audio_source_set_spatialization(source, enabled);
+    ma_ex_audio_source_unpin(source);
+    return MA_SUCCESS;
+}
+
+MA_API ma_result ma_ex_context_set_source_attenuation_model(ma_ex_context *context, ma_ex_audio_source_handle handle, ma_attenuation_model model) {
+    ma_ex_audio_source *source = ma_ex_context_resolve_source(context, handle);
+
+    if(source == NULL)
+        return MA_INVALID_OPERATION;
+
+    ma_ex_audio_source_set_attenuation_model(source, model);
+    ma_ex_audio_source_unpin(source);
+    return MA_SUCCESS;
+}
+
+MA_API ma_result ma_ex_context_set_source_doppler_factor(ma_ex_context *context, ma_ex_audio_source_handle handle, float factor) {
+    ma_ex_audio_source *source = ma_ex_context_resolve_source(context, handle);
+
+    if(source == NULL)
+        return MA_INVALID_OPERATION;
+
+    ma_ex_audio_source_set_doppler_factor(source, factor);
+    ma_ex_audio_source_unpin(source);
+    return MA_SUCCESS;
+}
+
+MA_API ma_result ma_ex_context_set_source_min_distance(ma_ex_context *context, ma_ex_audio_source_handle handle, float distance) {
+    ma_ex_audio_source *source = ma_ex_context_resolve_source(context, handle);
+
+    if(source == NULL)
+        return MA_INVALID_OPERATION;
+
+    ma_ex_audio_source_set_min_distance(source, distance);
+    ma_ex_audio_source_unpin(source);
+    return MA_SUCCESS;
+}
+
+MA_API ma_result ma_ex_context_set_source_max_distance(ma_ex_context *context, ma_ex_audio_source_handle handle, float distance) {
+    ma_ex_audio_source *source = ma_ex_context_resolve_source(context, handle);
+
+    if(source == NULL)
+        return MA_INVALID_OPERATION;
+
+    ma_ex_audio_source_set_max_distance(source, distance);
+    ma_ex_audio_source_unpin(source);
+    return MA_SUCCESS;
+}
+
+MA_API ma_result ma_ex_context_set_source_priority(ma_ex_context *context, ma_ex_audio_source_handle handle, ma_int32 priority) {
+    ma_ex_audio_source *source = ma_ex_context_resolve_source(context, handle);
+
+    if(source == NULL)
+        return MA_INVALID_OPERATION;
+
+    ma_ex_audio_source_set_priority(source, priority);
+    ma_ex_audio_source_unpin(source);
+    return MA_SUCCESS;
+}
+
+/* The hash entries are looked up by. Banks are built and read with the same function, so it must never change. */
+MA_API ma_uint64 ma_ex_bank_hash_name(const char *name) {
+    if(name == NULL)
+        return 0;
+    return ma_ex_create_hashcode(name, strlen(name));
+}
+
+static MA_INLINE ma_uint32 ma_ex_bank_get_slot(ma_uint64 nameHash, ma_uint32 slotMask) {
+    return (ma_uint32)(nameHash ^ (nameHash >> 32)) & slotMask;
+}
+
+static ma_bool32 ma_ex_bank_is_valid(const ma_ex_file_view *view) {
+    if(view->sizeInBytes < sizeof(ma_ex_bank_header))
+        return MA_FALSE;
+
+    const ma_ex_bank_header *header = (const ma_ex_bank_header*)view->pData;
+
+    if(memcmp(header->magic, "MAEXBNK", 8) != 0 || header->version != MA_EX_BANK_VERSION)
+        return MA_FALSE;
+
+    if(header->entryCount > (view->sizeInBytes - sizeof(ma_ex_bank_header)) / sizeof(ma_ex_bank_entry))
+        return MA_FALSE;
+
+    const ma_ex_bank_entry *pEntries = (const ma_ex_bank_entry*)(header + 1);
+
+    for(ma_uint32 i = 0; i < header->entryCount; i++) {
+        if(pEntries[i].offset > view->sizeInBytes || pEntries[i].sizeInBytes > view->sizeInBytes - pEntries[i].offset)
+            return MA_FALSE;
+    }
+
+    return MA_TRUE;
+}
+
+/* Maps a bank built with ma_ex_bank_builder_write(). Entries are only decoded once they are played. */
+MA_API ma_ex_bank *ma_ex_bank_init(ma_ex_context *context, const char *filePath) {
+    if(context == NULL || filePath == NULL)
+        return NULL;
+
+    //Banks are stored little endian and read in place
+    if(!ma_ex_is_little_endian())
+        return NULL;
+
+    ma_ex_bank *bank = MA_MALLOC(sizeof(ma_ex_bank));
+
+    if(bank == NULL)
+        return NULL;
+
+    MA_ZERO_OBJECT(bank);
+    bank->context = context;
+
+    if(ma_ex_file_view_init(filePath, &bank->view) != MA_SUCCESS) {
+        MA_FREE(bank);
+        return NULL;
+    }
+
+    if(!ma_ex_bank_is_valid(&bank->view)) {
+        fprintf(stderr, "Invalid sound bank: %s\n", filePath);
+        ma_ex_file_view_uninit(&bank->view);
+        MA_FREE(bank);
+        return NULL;
+    }
+
+    const ma_ex_bank_header *header = (const ma_ex_bank_header*)bank->view.pData;
+    bank->pEntries = (const ma_ex_bank_entry*)(header + 1);
+    bank->entryCount = header->entryCount;
+
+    //At most half full, so probe sequences stay short
+    ma_uint32 slotCount = ma_next_power_of_two(bank->entryCount * 2 + 1);
+    bank->pSlots = MA_MALLOC(slotCount * sizeof(ma_uint32));
+    bank->ppClips = MA_MALLOC((bank->entryCount > 0 ? bank->entryCount : 1) * sizeof(ma_ex_audio_clip*));
+
+    if(bank->pSlots == NULL || bank->ppClips == NULL) {
+        if(bank->pSlots != NULL)
+            MA_FREE(bank->pSlots);
+        if(bank->ppClips != NULL)
+            MA_FREE(bank->ppClips);
+        ma_ex_file_view_uninit(&bank->view);
+        MA_FREE(bank);
+        return NULL;
+    }
+
+    MA_ZERO_MEMORY(bank->pSlots, slotCount * sizeof(ma_uint32));
+    MA_ZERO_MEMORY(bank->ppClips, (bank->entryCount > 0 ? bank->entryCount : 1) * sizeof(ma_ex_audio_clip*));
+    bank->slotMask = slotCount - 1;
+
+    for(ma_uint32 i = 0; i < bank->entryCount; i++) {
+        const ma_ex_bank_entry *entry = &bank->pEntries[i];
+        ma_uint32 slot = ma_ex_bank_get_slot(entry->nameHash, bank->slotMask);
+
+        while(bank->pSlots[slot] != 0)
+            slot = (slot + 1) & bank->slotMask;
+
+        bank->pSlots[slot] = i + 1;
+    }
+
+    return bank;
+}
+
+MA_API void ma_ex_bank_uninit(ma_ex_bank *bank) {
+    if(bank == NULL)
+        return;
+
+    //Sources that are still playing an entry hold their own reference to its clip
+    for(ma_uint32 i = 0; i < bank->entryCount; i++)
+        ma_ex_audio_clip_uninit(bank->ppClips[i]);
+
+    MA_FREE(bank->ppClips);
+    MA_FREE(bank->pSlots);
+    ma_ex_file_view_uninit(&bank->view);
+    MA_FREE(bank);
+}
+
+/* Returns NULL when the bank has no entry with the hash. */
+MA_API const ma_ex_bank_entry *ma_ex_bank_find(const ma_ex_bank *bank, ma_uint64 nameHash) {
+    if(bank == NULL || bank->pSlots == NULL)
+        return NULL;
+
+    ma_uint32 slot = ma_ex_bank_get_slot(nameHash, bank->slotMask);
+
+    while(bank->pSlots[slot] != 0) {
+        const ma_ex_bank_entry *entry = &bank->pEntries[bank->pSlots[slot] - 1];
+        if(entry->nameHash == nameHash)
+            return entry;
+        slot = (slot + 1) & bank->slotMask;
+    }
+
+    return NULL;
+}
+
+/* The first play of an entry decodes it from the mapped bank into a clip that every later play shares. Use ma_ex_bank_hash_name() to get the hash of a name. */
+MA_API ma_result ma_ex_audio_source_play_from_bank(ma_ex_audio_source *source, ma_ex_bank *bank, ma_uint64 nameHash) {
+    if(source == NULL || bank == NULL)
+        return MA_INVALID_ARGS;
+
+    if(bank->context != source->context)
+        return MA_INVALID_ARGS;
+
+    const ma_ex_bank_entry *entry = ma_ex_bank_find(bank, nameHash);
+
+    if(entry == NULL)
+        return MA_DOES_NOT_EXIST;
+
+    ma_uint32 index = (ma_uint32)(entry - bank->pEntries);
+    ma_ex_audio_clip *clip = (ma_ex_audio_clip*)ma_ex_atomic_load_ptr((void *volatile *)&bank->ppClips[index]);
+
+    if(clip == NULL) {
+        clip = ma_ex_audio_clip_init_from_memory(bank->context, (const ma_uint8*)bank->view.pData + entry->offset, entry->sizeInBytes);
+
+        if(clip == NULL)
+            return MA_ERROR;
+
+        //Another source may have decoded the same entry in the meantime, only one clip is kept
+        if(!ma_ex_atomic_compare_exchange_ptr((void *volatile *)&bank->ppClips[index], NULL, clip)) {
+            ma_ex_audio_clip_uninit(clip);
+            clip = (ma_ex_audio_clip*)ma_ex_atomic_load_ptr((void *volatile *)&bank->ppClips[index]);
+        }
+    }
+
+    return ma_ex_audio_source_play_clip(source, clip);
+}
+
+MA_API ma_result ma_ex_bank_builder_init(ma_ex_bank_builder *builder) {
+    if(builder == NULL)
+        return MA_INVALID_ARGS;
+
+    MA_ZERO_OBJECT(builder);
+    return MA_SUCCESS;
+}
+
+MA_API void ma_ex_bank_builder_uninit(ma_ex_bank_builder *builder) {
+    if(builder == NULL)
+        return;
+
+    for(ma_uint32 i = 0; i < builder->entryCount; i++)
+        MA_FREE(builder->ppPayloads[i]);
+
+    if(builder->pEntries != NULL)
+        MA_FREE(builder->pEntries);
+    if(builder->ppPayloads != NULL)
+        MA_FREE(builder->ppPayloads);
+
+    MA_ZERO_OBJECT(builder);
+}
+
+static ma_encoding_format ma_ex_bank_detect_codec(const ma_uint8 *pData, size_t dataSize) {
+    if(dataSize >= 12 && memcmp(pData, "RIFF", 4) == 0 && memcmp(pData + 8, "WAVE", 4) == 0)
+        return ma_encoding_format_wav;
+    if(dataSize >= 4 && memcmp(pData, "fLaC", 4) == 0)
+        return ma_encoding_format_flac;
+    if(dataSize >= 4 && memcmp(pData, "OggS", 4) == 0)
+        return ma_encoding_format_vorbis;
+    if((dataSize >= 3 && memcmp(pData, "ID3", 3) == 0) || (dataSize >= 2 && pData[0] == 0xFF && (pData[1] & 0xE0) == 0xE0))
+        return ma_encoding_format_mp3;
+    return ma_encoding_format_unknown;
+}
+
+/* Copies pData into the builder. The payload has to be readable by one of the decoding backends the context uses. */
+MA_API ma_result ma_ex_bank_builder_add_memory(ma_ex_bank_builder *builder, const char *name, const void *pData, size_t dataSize) {
+    if(builder == NULL || name == NULL || pData == NULL || dataSize == 0)
+        return MA_INVALID_ARGS;
+
+    ma_uint64 nameHash = ma_ex_bank_hash_name(name);
+
+    for(ma_uint32 i = 0; i < builder->entryCount; i++) {
+        if(builder->pEntries[i].nameHash == nameHash)
+            return MA_ALREADY_EXISTS;
+    }
+
+    ma_decoding_backend_vtable *pCustomBackendVTables[] = {
+        ma_libvorbis_get_decoding_backend()
+    };
+
+    //Decoding the header up front rejects payloads the bank couldn't play and records their format
+    ma_decoder_config config = ma_decoder_config_init_default();
+    config.ppCustomBackendVTables = pCustomBackendVTables;
+    config.customBackendCount = sizeof(pCustomBackendVTables)/sizeof(pCustomBackendVTables[0]);
+
+    ma_decoder decoder;
+    ma_result result = ma_decoder_init_memory(pData, dataSize, &config, &decoder);
+
+    if(result != MA_SUCCESS)
+        return result;
+
+    ma_ex_bank_entry entry;
+    MA_ZERO_OBJECT(&entry);
+    entry.nameHash = nameHash;
+    entry.sizeInBytes = dataSize;
+    entry.codec = ma_ex_bank_detect_codec((const ma_uint8*)pData, dataSize);
+
+    ma_format format;
+    ma_decoder_get_data_format(&decoder, &format, &entry.channels, &entry.sampleRate, NULL, 0);
+    entry.format = format;
+    ma_decoder_get_length_in_pcm_frames(&decoder, &entry.lengthInFrames);
+    ma_decoder_uninit(&decoder);
+
+    if(builder->entryCount == builder->entryCapacity) {
+        ma_uint32 capacity = builder->entryCapacity == 0 ? 64 : builder->entryCapacity * 2;
+        ma_ex_bank_entry *pEntries = MA_MALLOC(capacity * sizeof(ma_ex_bank_entry));
+        void **ppPayloads = MA_MALLOC(capacity * sizeof(void*));
+
+        if(pEntries == NULL || ppPayloads == NULL) {
+            if(pEntries != NULL)
+                MA_FREE(pEntries);
+            if(ppPayloads != NULL)
+                MA_FREE(ppPayloads);
+            return MA_OUT_OF_MEMORY;
+        }
+
+        if(builder->entryCount > 0) {
+            memcpy(pEntries, builder->pEntries, builder->entryCount * sizeof(ma_ex_bank_entry));
+            memcpy(ppPayloads, builder->ppPayloads, builder->entryCount * sizeof(void*));
+            MA_FREE(builder->pEntries);
+            MA_FREE(builder->ppPayloads);
+        }
+
+        builder->pEntries = pEntries;
+        builder->ppPayloads = ppPayloads;
+        builder->entryCapacity = capacity;
+    }
+
+    void *pPayload = MA_MALLOC(dataSize);
+
+    if(pPayload == NULL)
+        return MA_OUT_OF_MEMORY;
+
+    memcpy(pPayload, pData, dataSize);
+    builder->pEntries[builder->entryCount] = entry;
+    builder->ppPayloads[builder->entryCount] = pPayload;
+    builder->entryCount++;
+    return MA_SUCCESS;
+}
+
+MA_API ma_result ma_ex_bank_builder_add_file(ma_ex_bank_builder *builder, const char *name, const char *filePath) {
+    if(builder == NULL || name == NULL || filePath == NULL)
+        return MA_INVALID_ARGS;
+
+    ma_ex_file_view view;
+    ma_result result = ma_ex_file_view_init(filePath, &view);
+
+    if(result != MA_SUCCESS)
+        return result;
+
+    result = ma_ex_bank_builder_add_memory(builder, name, view.pData, view.sizeInBytes);
+    ma_ex_file_view_uninit(&view);
+    return result;
+}
+
+static int ma_ex_bank_compare_entries(const void *a, const void *b) {
+    ma_uint64 hashA = ((const ma_ex_bank_entry*)a)->nameHash;
+    ma_uint64 hashB = ((const ma_ex_bank_entry*)b)->nameHash;
+    return hashA < hashB ? -1 : (hashA > hashB ? 1 : 0);
+}
+
+static MA_INLINE ma_uint64 ma_ex_bank_align(ma_uint64 offset) {
+    return (offset + (MA_EX_BANK_ALIGNMENT - 1)) & ~(ma_uint64)(MA_EX_BANK_ALIGNMENT - 1);
+}
+
+/* Writes the index sorted by name hash, followed by the payloads in the same order. */
+MA_API ma_result ma_ex_bank_builder_write(ma_ex_bank_builder *builder, const char *filePath) {
+    if(builder == NULL || filePath == NULL)
+        return MA_INVALID_ARGS;
+
+    if(!ma_ex_is_little_endian())
+        return MA_NOT_IMPLEMENTED;
+
+    //Sort the entries together with their payloads by remembering where each payload came from
+    ma_ex_bank_entry *pEntries = MA_MALLOC((builder->entryCount + 1) * sizeof(ma_ex_bank_entry));
+
+    if(pEntries == NULL)
+        return MA_OUT_OF_MEMORY;
+
+    for(ma_uint32 i = 0; i < builder->entryCount; i++) {
+        pEntries[i] = builder->pEntries[i];
+        pEntries[i].offset = i;
+    }
+
+    qsort(pEntries, builder->entryCount, sizeof(ma_ex_bank_entry), ma_ex_bank_compare_entries);
+
+    ma_uint64 offset = ma_ex_bank_align(sizeof(ma_ex_bank_header) + (ma_uint64)builder->entryCount * sizeof(ma_ex_bank_entry));
+    ma_uint32 *pPayloadIndices = MA_MALLOC((builder->entryCount + 1) * sizeof(ma_uint32));
+
+    if(pPayloadIndices == NULL) {
+        MA_FREE(pEntries);
+        return MA_OUT_OF_MEMORY;
+    }
+
+    for(ma_uint32 i = 0; i < builder->entryCount; i++) {
+        pPayloadIndices[i] = (ma_uint32)pEntries[i].offset;
+        pEntries[i].offset = offset;
+        offset = ma_ex_bank_align(offset + pEntries[i].sizeInBytes);
+    }
+
+    FILE *file = fopen(filePath, "wb");
+
+    if(file == NULL) {
+        MA_FREE(pPayloadIndices);
+        MA_FREE(pEntries);
+        return MA_ACCESS_DENIED;
+    }
+
+    ma_ex_bank_header header;
+    MA_ZERO_OBJECT(&header);
+    memcpy(header.magic, "MAEXBNK", 8);
+    header.version = MA_EX_BANK_VERSION;
+    header.entryCount = builder->entryCount;
+
+    static const ma_uint8 padding[MA_EX_BANK_ALIGNMENT] = { 0 };
+    ma_uint64 position = sizeof(header) + (ma_uint64)builder->entryCount * sizeof(ma_ex_bank_entry);
+    ma_bool32 isWritten = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                          fwrite(pEntries, sizeof(ma_ex_bank_entry), builder->entryCount, file) == builder->entryCount;
+
+    for(ma_uint32 i = 0; i < builder->entryCount && isWritten; i++) {
+        size_t paddingSize = (size_t)(pEntries[i].offset - position);
+        size_t payloadSize = (size_t)pEntries[i].sizeInBytes;
+
+        isWritten = fwrite(padding, 1, paddingSize, file) == paddingSize &&
+                    fwrite(builder->ppPayloads[pPayloadIndices[i]], 1, payloadSize, file) == payloadSize;
+
+        position = pEntries[i].offset + payloadSize;
+    }
+
+    if(fclose(file) != 0)
+        isWritten = MA_FALSE;
+
+    if(!isWritten)
+        remove(filePath);
+
+    MA_FREE(pPayloadIndices);
+    MA_FREE(pEntries);
+    return isWritten ? MA_SUCCESS : MA_ERROR;
+}
+
+MA_API ma_ex_audio_listener *ma_ex_audio_listener_init(ma_ex_context *context) {
+    MA_ASSERT(context != NULL);
+
+    ma_int32 listenerIndex = -1;
+
+    for(ma_int32 i = 0; i < MA_ENGINE_MAX_LISTENERS; i++) {
+        if(context->listeners[i] == -1) {
+            context->listeners[i] = i;
+            listenerIndex = i;
+            break;
+        }
+    }
+
+    if(listenerIndex == -1) {
+        fprintf(stderr, "Can't create any more audio listeners, the max of %d is already achieved\n", MA_ENGINE_MAX_LISTENERS);
+        return NULL;
+    }
+
+    ma_ex_audio_listener *listener = (ma_ex_audio_listener*)ma_ex_pool_alloc(&context->listenerPool);
+
+    if(listener == NULL) {
+        context->listeners[listenerIndex] = -1;
+        return NULL;
+    }
+
+    MA_ZERO_OBJECT(listener);
+
+    listener->context = context;
+    listener->index = listenerIndex;
+    ma_ex_vec3f_set(&listener->settings.position, 0.0f, 0.0f, 0.0f);
+    ma_ex_vec3f_set(&listener->settings.direction, 0.0f, 0.0f, -1.0f);
+    ma_ex_vec3f_set(&listener->settings.velocity, 0.0f, 0.0f, 0.0f);
+    ma_ex_vec3f_set(&listener->settings.worldUp, 0.0f, 1.0f, 0.0f);
+    listener->settings.spatialization = MA_TRUE;
+    listener->settings.coneInnerAngleInRadians = 6.283185f; /* 360 degrees. */
+    listener->settings.coneOuterAngleInRadians = 6.283185f; /* 360 degrees. */
+    listener->settings.coneOuterGain = 0;
+
+    ma_engine_listener_set_position(&listener->context->engine, listener->index, listener->settings.position.x, listener->settings.position.y, listener->settings.position.z);
+    ma_engine_listener_set_direction(&listener->context->engine, listener->index, listener->settings.direction.x, listener->settings.direction.y, listener->settings.direction.z);
+    ma_engine_listener_set_velocity(&listener->context->engine, listener->index, listener->settings.velocity.x, listener->settings.velocity.y, listener->settings.velocity.z);
+    ma_engine_listener_set_world_up(&listener->context->engine, listener->index, listener->settings.worldUp.x, listener->settings.worldUp.y, listener->settings.worldUp.z);
+    ma_engine_listener_set_cone(&listener->context->engine, listener->index, listener->settings.coneInnerAngleInRadians, listener->settings.coneOuterAngleInRadians, listener->settings.coneOuterGain);
+    ma_engine_listener_set_enabled(&listener->context->engine, listener->index, listener->settings.spatialization);
+    
+    return listener;
+}
+
+MA_API void ma_ex_audio_listener_uninit(ma_ex_audio_listener *listener) {
+    if(listener != NULL) {
+        if(listener->context != NULL && listener->index < MA_ENGINE_MAX_LISTENERS) {
+            listener->context->listeners[listener->index] = -1;
+        }
+        ma_ex_pool_free(&listener->context->listenerPool, listener);
     }
 }
 
-MA_API ma_attenuation_model ma_ex_audio_source_get_attenuation_model(ma_ex_audio_source *source) {
-    if(source != NULL)
-        return source->settings.attenuationModel;
-    return ma_attenuation_model_none;
+MA_API void ma_ex_audio_listener_set_spatialization(ma_ex_audio_listener *listener, ma_bool32 enabled) {
+    if(listener != NULL)
+        ma_engine_listener_set_enabled(&listener->context->engine, listener->index, enabled);
+}
+
+MA_API ma_bool32 ma_ex_audio_listener_get_spatialization(ma_ex_audio_listener *listener) {
+    if(listener != NULL)
+        return listener->settings.spatialization;
+    return MA_FALSE;
+}
+
+MA_API void ma_ex_audio_listener_set_position(ma_ex_audio_listener *listener, float x, float y, float z) {
+    if(listener != NULL) {
+        listener->settings.position.x = x;
+        listener->settings.position.y = y;
+        listener->settings.position.z = z;
+        ma_engine_listener_set_position(&listener->context->engine, listener->index, x, y, z);
+    }
+}
+
+MA_API void ma_ex_audio_listener_get_position(ma_ex_audio_listener *listener, float *x, float *y, float *z) {
+    if(listener != NULL) {
+        ma_ex_vec3f_get(&listener->settings.position, x, y, z);
+    } else {
+        *x = 0.0f;
+        *y = 0.0f;
+        *z = 0.0f;
+    }
+}
+
+MA_API void ma_ex_audio_listener_set_direction(ma_ex_audio_listener *listener, float x, float y, float z) {
+    if(listener != NULL) {
+        listener->settings.direction.x = x;
+        listener->settings.direction.y = y;
+        listener->settings.direction.z = z;
+        ma_engine_listener_set_direction(&listener->context->engine, listener->index, x, y, z);
+    }
+}
+
+MA_API void ma_ex_audio_listener_get_direction(ma_ex_audio_listener *listener, float *x, float *y, float *z) {
+    if(listener != NULL) {
+        ma_ex_vec3f_get(&listener->settings.direction, x, y, z);
+    } else {
+        *x = 0.0f;
+        *y = 0.0f;
+        *z = 0.0f;
+    }
+}
+
+MA_API void ma_ex_audio_listener_set_velocity(ma_ex_audio_listener *listener, float x, float y, float z) {
+    if(listener != NULL) {
+        listener->settings.velocity.x = x;
+        listener->settings.velocity.y = y;
+        listener->settings.velocity.z = z;
+        ma_engine_listener_set_velocity(&listener->context->engine, listener->index, x, y, z);
+    }
+}
+
+MA_API void ma_ex_audio_listener_get_velocity(ma_ex_audio_listener *listener, float *x, float *y, float *z) {
+    if(listener != NULL) {
+        ma_ex_vec3f_get(&listener->settings.velocity, x, y, z);
+    } else {
+        *x = 0.0f;
+        *y = 0.0f;
+        *z = 0.0f;
+    }
+}
+
+/*
+Same as ma_ex_audio_source_set_transforms, but for listeners. Listener setters aren't queued, the engine listeners are
+written directly in a single pass.
+*/
+MA_API void ma_ex_audio_listener_set_transforms(ma_ex_audio_listener **listeners, ma_uint32 count, const float *positions, const float *velocities, const float *directions) {
+    if(listeners == NULL)
+        return;
+
+    for(ma_uint32 i = 0; i < count; i++) {
+        ma_ex_audio_listener *listener = listeners[i];
+
+        if(listener == NULL)
+            continue;
+
+        ma_engine *pEngine = &listener->context->engine;
+
+        if(positions != NULL) {
+            ma_ex_vec3f_set(&listener->settings.position, positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]);
+            ma_engine_listener_set_position(pEngine, listener->index, positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]);
+        }
+        if(velocities != NULL) {
+            ma_ex_vec3f_set(&listener->settings.velocity, velocities[i * 3], velocities[i * 3 + 1], velocities[i * 3 + 2]);
+            ma_engine_listener_set_velocity(pEngine, listener->index, velocities[i * 3], velocities[i * 3 + 1], velocities[i * 3 + 2]);
+        }
+        if(directions != NULL) {
+            ma_ex_vec3f_set(&listener->settings.direction, directions[i * 3], directions[i * 3 + 1], directions[i * 3 + 2]);
+            ma_engine_listener_set_direction(pEngine, listener->index, directions[i * 3], directions[i * 3 + 1], directions[i * 3 + 2]);
+        }
+    }
+}
+
+MA_API void ma_ex_audio_listener_set_world_up(ma_ex_audio_listener *listener, float x, float y, float z) {
+    if(listener != NULL) {
+        listener->settings.worldUp.x = x;
+        listener->settings.worldUp.y = y;
+        listener->settings.worldUp.z = z;
+        ma_engine_listener_set_world_up(&listener->context->engine, listener->index, x, y, z);
+    }
+}
+
+MA_API void ma_ex_audio_listener_get_world_up(ma_ex_audio_listener *listener, float *x, float *y, float *z) {
+    if(listener != NULL) {
+        ma_ex_vec3f_get(&listener->settings.worldUp, x, y, z);
+    } else {
+        *x = 0.0f;
+        *y = 0.0f;
+        *z = 0.0f;
+    }
+}
+
+MA_API void ma_ex_audio_listener_set_cone(ma_ex_audio_listener *listener, float innerAngleInRadians, float outerAngleInRadians, float outerGain) {
+    if(listener != NULL) {
+        listener->settings.coneInnerAngleInRadians = innerAngleInRadians;
+        listener->settings.coneOuterAngleInRadians = outerAngleInRadians;
+        listener->settings.coneOuterGain = outerGain;
+        ma_engine_listener_set_cone(&listener->context->engine, listener->index, innerAngleInRadians, outerAngleInRadians, outerGain);
+    }
+}
+
+MA_API void ma_ex_audio_listener_get_cone(ma_ex_audio_listener *listener, float *innerAngleInRadians, float *outerAngleInRadians, float *outerGain) {
+    if(listener != NULL) {
+        *innerAngleInRadians = listener->settings.coneInnerAngleInRadians;
+        *outerAngleInRadians = listener->settings.coneOuterAngleInRadians;
+        *outerGain = listener->settings.coneOuterGain;
+    } else {
+        *innerAngleInRadians = 0.0f;
+        *outerAngleInRadians = 0.0f;
+        *outerGain = 0.0f;
+    }
+}
+
+MA_API ma_sound_group *ma_ex_sound_group_init(ma_ex_context *context) {
+    if(context == NULL)
+        return NULL;
+    
+    ma_sound_group *pGroup = ma_ex_pool_alloc(&context->soundGroupPool);
+
+    if(pGroup == NULL)
+        return NULL;
+        
+    ma_result result = ma_sound_group_init(&context->engine, 0, NULL, pGroup);
+
+    if(result != MA_SUCCESS) {
+        ma_ex_pool_free(&context->soundGroupPool, pGroup);
+        pGroup = NULL;
+    }
+    
+    return pGroup;
+}
+
+MA_API void ma_ex_sound_group_uninit(ma_sound_group *group) {
+    if(group == NULL)
+        return;
+    ma_ex_context *context = ma_ex_context_from_engine(ma_sound_get_engine(group));
+    ma_ex_sound_group_set_max_voices(group, 0);
+    ma_sound_group_uninit(group);
+    ma_ex_pool_free(&context->soundGroupPool, group);
+}
+
+MA_API ma_result ma_ex_sound_group_set_max_voices(ma_sound_group *group, ma_uint32 maxVoices) {
+    if(group == NULL)
+        return MA_INVALID_ARGS;
+
+    ma_ex_context *context = ma_ex_context_from_engine(ma_sound_get_engine(group));
+    ma_result result = MA_SUCCESS;
+
+    ma_spinlock_lock(&context->sourceLock);
+
+    ma_ex_sound_group_voice_limit *pLimit = ma_ex_find_group_voice_limit(context, group);
+
+    if(maxVoices == 0) {
+        //No limit, so the entry can go
+        if(pLimit != NULL)
+            *pLimit = context->pGroupVoiceLimits[--context->groupVoiceLimitCount];
+    } else if(pLimit != NULL) {
+        pLimit->maxVoices = maxVoices;
+    } else {
+        if(context->groupVoiceLimitCount == context->groupVoiceLimitCapacity) {
+            ma_uint32 newCapacity = context->groupVoiceLimitCapacity == 0 ? 8 : context->groupVoiceLimitCapacity * 2;
+            ma_ex_sound_group_voice_limit *pNewLimits = ma_realloc(context->pGroupVoiceLimits, sizeof(ma_ex_sound_group_voice_limit) * newCapacity, NULL);
+
+            if(pNewLimits == NULL) {
+                result = MA_OUT_OF_MEMORY;
+            } else {
+                context->pGroupVoiceLimits = pNewLimits;
+                context->groupVoiceLimitCapacity = newCapacity;
+            }
+        }
+
+        if(result == MA_SUCCESS) {
+            context->pGroupVoiceLimits[context->groupVoiceLimitCount].group = group;
+            context->pGroupVoiceLimits[context->groupVoiceLimitCount].maxVoices = maxVoices;
+            context->groupVoiceLimitCount++;
+        }
+    }
+
+    ma_spinlock_unlock(&context->sourceLock);
+    return result;
+}
+
+MA_API ma_uint32 ma_ex_sound_group_get_max_voices(ma_sound_group *group) {
+    if(group == NULL)
+        return 0;
+
+    ma_ex_context *context = ma_ex_context_from_engine(ma_sound_get_engine(group));
+    ma_uint32 maxVoices = 0;
+
+    ma_spinlock_lock(&context->sourceLock);
+    ma_ex_sound_group_voice_limit *pLimit = ma_ex_find_group_voice_limit(context, group);
+    if(pLimit != NULL)
+        maxVoices = pLimit->maxVoices;
+    ma_spinlock_unlock(&context->sourceLock);
+
+    return maxVoices;
+}
+
+
+MA_API char *ma_ex_read_bytes_from_file(const char *filepath, size_t *size) {
+    FILE *file = fopen(filepath, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening file\n");
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    size_t fileSize = ftell(file);
+    rewind(file);
+
+    char *buffer = (char *)MA_MALLOC(fileSize * sizeof(char));
+    if (buffer == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        fclose(file);
+        return NULL;
+    }
+
+    if (fread(buffer, sizeof(char), fileSize, file) != fileSize) {
+        fprintf(stderr, "Error reading file\n");
+        MA_FREE(buffer);
+        fclose(file);
+        return NULL;
+    }
+
+    fclose(file);
+
+    *size = fileSize;
+    return buffer;
+}
+
+MA_API void ma_ex_free_bytes_from_file(char *pointer) {
+    if(pointer != NULL)
+        MA_FREE(pointer);
+}
+
+/* Maps the whole file. Returns MA_NOT_IMPLEMENTED when the file exists but can't be mapped, like pipes and character devices. */
+static ma_result ma_ex_file_view_map(const char *filepath, ma_ex_file_view *view) {
+#if defined(_WIN32)
+    HANDLE hFile = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if(hFile == INVALID_HANDLE_VALUE)
+        return MA_DOES_NOT_EXIST;
+
+    LARGE_INTEGER fileSize;
+    if(GetFileType(hFile) != FILE_TYPE_DISK || !GetFileSizeEx(hFile, &fileSize) || (ma_uint64)fileSize.QuadPart > MA_SIZE_MAX) {
+        CloseHandle(hFile);
+        return MA_NOT_IMPLEMENTED;
+    }
+
+    //Empty files can't be mapped, but there is nothing to read from them either
+    if(fileSize.QuadPart > 0) {
+        HANDLE hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+        if(hMapping == NULL) {
+            CloseHandle(hFile);
+            return MA_NOT_IMPLEMENTED;
+        }
+
+        view->pData = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(hMapping);
+        if(view->pData == NULL) {
+            CloseHandle(hFile);
+            return MA_NOT_IMPLEMENTED;
+        }
+    }
+
+    CloseHandle(hFile);
+    view->sizeInBytes = (size_t)fileSize.QuadPart;
+#else
+    int fd = open(filepath, O_RDONLY);
+    if(fd < 0)
+        return MA_DOES_NOT_EXIST;
+
+    struct stat info;
+    if(fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || (ma_uint64)info.st_size > MA_SIZE_MAX) {
+        close(fd);
+        return MA_NOT_IMPLEMENTED;
+    }
+
+    //A length of 0 is invalid for mmap, but there is nothing to read from an empty file either
+    if(info.st_size > 0) {
+        void *pData = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(pData == MAP_FAILED) {
+            close(fd);
+            return MA_NOT_IMPLEMENTED;
+        }
+
+#if defined(MADV_SEQUENTIAL)
+        //Decoders read front to back, so let the kernel read ahead aggressively
+        madvise(pData, (size_t)info.st_size, MADV_SEQUENTIAL);
+#endif
+        view->pData = pData;
+    }
+
+    //The mapping keeps its own reference to the file
+    close(fd);
+    view->sizeInBytes = (size_t)info.st_size;
+#endif
+
+    view->isMapped = MA_TRUE;
+    return MA_SUCCESS;
+}
+
+static void ma_ex_file_view_unmap(ma_ex_file_view *view) {
+    if(view->pData == NULL)
+        return;
+#if defined(_WIN32)
+    UnmapViewOfFile(view->pData);
+#else
+    munmap((void*)view->pData, view->sizeInBytes);
+#endif
+}
+
+/* Maps filepath into memory so it can be played with ma_ex_audio_source_play_from_memory() without copying it. Falls back to a heap copy when the file can't be mapped. */
+MA_API ma_result ma_ex_file_view_init(const char *filepath, ma_ex_file_view *view) {
+    if(filepath == NULL || view == NULL)
+        return MA_INVALID_ARGS;
+
+    MA_ZERO_OBJECT(view);
+
+    ma_result result = ma_ex_file_view_map(filepath, view);
+    if(result != MA_NOT_IMPLEMENTED)
+        return result;
+
+    size_t size = 0;
+    view->pData = ma_ex_read_bytes_from_file(filepath, &size);
+    if(view->pData == NULL)
+        return MA_ERROR;
+
+    view->sizeInBytes = size;
+    return MA_SUCCESS;
 }
 
-MA_API void ma_ex_audio_source_set_doppler_factor(ma_ex_audio_source *source, float factor) {
-    if(source != NULL) {
-        source->settings.dopplerFactor = factor;
-        ma_sound_set_doppler_factor(&source->clip.sound, factor);
+MA_API void ma_ex_file_view_uninit(ma_ex_file_view *view) {
+    if(view == NULL)
+        return;
+
+    if(view->isMapped)
+        ma_ex_file_view_unmap(view);
+    else
+        ma_ex_free_bytes_from_file((char*)view->pData);
+
+    MA_ZERO_OBJECT(view);
+}
+
+typedef struct ma_ex_mmap_vfs_file ma_ex_mmap_vfs_file;
+
+struct ma_ex_mmap_vfs_file {
+    ma_ex_file_view view;
+    size_t cursor;
+    ma_vfs_file defaultFile;    /* Not NULL when the file is read through the default VFS instead. */
+};
+
+static ma_result ma_ex_mmap_vfs_open(ma_vfs *pVFS, const char *pFilePath, ma_uint32 openMode, ma_vfs_file *pFile) {
+    ma_ex_mmap_vfs *vfs = (ma_ex_mmap_vfs*)pVFS;
+    *pFile = NULL;
+
+    ma_ex_mmap_vfs_file *file = MA_MALLOC(sizeof(ma_ex_mmap_vfs_file));
+    if(file == NULL)
+        return MA_OUT_OF_MEMORY;
+    MA_ZERO_OBJECT(file);
+
+    ma_result result = MA_NOT_IMPLEMENTED;
+    if((openMode & MA_OPEN_MODE_WRITE) == 0)
+        result = ma_ex_file_view_map(pFilePath, &file->view);
+
+    if(result == MA_NOT_IMPLEMENTED)
+        result = ma_vfs_open(&vfs->defaultVFS, pFilePath, openMode, &file->defaultFile);
+
+    if(result != MA_SUCCESS) {
+        MA_FREE(file);
+        return result;
     }
-}
 
-MA_API float ma_ex_audio_source_get_doppler_factor(ma_ex_audio_source *source) {
-    if(source != NULL)
-        return source->settings.dopplerFactor;
-    return 0.0f;
+    *pFile = file;
+    return MA_SUCCESS;
 }
 
-MA_API void ma_ex_audio_source_set_min_distance(ma_ex_audio_source *source, float distance) {
-    if(source != NULL) {
-        source->settings.minDistance = distance;
-        ma_sound_set_min_distance(&source->clip.sound, distance);
+static ma_result ma_ex_mmap_vfs_open_w(ma_vfs *pVFS, const wchar_t *pFilePath, ma_uint32 openMode, ma_vfs_file *pFile) {
+    ma_ex_mmap_vfs *vfs = (ma_ex_mmap_vfs*)pVFS;
+    *pFile = NULL;
+
+    ma_ex_mmap_vfs_file *file = MA_MALLOC(sizeof(ma_ex_mmap_vfs_file));
+    if(file == NULL)
+        return MA_OUT_OF_MEMORY;
+    MA_ZERO_OBJECT(file);
+
+    ma_result result = ma_vfs_open_w(&vfs->defaultVFS, pFilePath, openMode, &file->defaultFile);
+    if(result != MA_SUCCESS) {
+        MA_FREE(file);
+        return result;
     }
+
+    *pFile = file;
+    return MA_SUCCESS;
 }
 
-MA_API float ma_ex_audio_source_get_min_distance(ma_ex_audio_source *source) {
-    if(source != NULL)
-        return source->settings.minDistance;
-    return 1.0f;
+static ma_result ma_ex_mmap_vfs_close(ma_vfs *pVFS, ma_vfs_file pFile) {
+    ma_ex_mmap_vfs *vfs = (ma_ex_mmap_vfs*)pVFS;
+    ma_ex_mmap_vfs_file *file = (ma_ex_mmap_vfs_file*)pFile;
+
+    ma_result result = MA_SUCCESS;
+    if(file->defaultFile != NULL)
+        result = ma_vfs_close(&vfs->defaultVFS, file->defaultFile);
+    else
+        ma_ex_file_view_unmap(&file->view);
+
+    MA_FREE(file);
+    return result;
 }
 
-MA_API void ma_ex_audio_source_set_max_distance(ma_ex_audio_source *source, float distance) {
-    if(source != NULL) {
-        source->settings.maxDistance = distance;
-        ma_sound_set_max_distance(&source->clip.sound, distance);
+static ma_result ma_ex_mmap_vfs_read(ma_vfs *pVFS, ma_vfs_file pFile, void *pDst, size_t sizeInBytes, size_t *pBytesRead) {
+    ma_ex_mmap_vfs *vfs = (ma_ex_mmap_vfs*)pVFS;
+    ma_ex_mmap_vfs_file *file = (ma_ex_mmap_vfs_file*)pFile;
+
+    if(file->defaultFile != NULL)
+        return ma_vfs_read(&vfs->defaultVFS, file->defaultFile, pDst, sizeInBytes, pBytesRead);
+
+    size_t bytesRemaining = file->view.sizeInBytes - file->cursor;
+    size_t bytesToRead = sizeInBytes < bytesRemaining ? sizeInBytes : bytesRemaining;
+
+    if(bytesToRead > 0) {
+        memcpy(pDst, (const ma_uint8*)file->view.pData + file->cursor, bytesToRead);
+        file->cursor += bytesToRead;
     }
-}
 
-MA_API float ma_ex_audio_source_get_max_distance(ma_ex_audio_source *source) {
-    if(source != NULL)
-        return source->settings.maxDistance;
-    return MA_FLT_MAX;
+    if(pBytesRead != NULL)
+        *pBytesRead = bytesToRead;
+
+    if(bytesToRead == 0 && sizeInBytes > 0)
+        return MA_AT_END;
+
+    return MA_SUCCESS;
 }
 
-MA_API ma_bool32 ma_ex_audio_source_get_is_playing(ma_ex_audio_source *source) {
-    if(source != NULL) {
-        return ma_sound_is_playing(&source->clip.sound);
-    }
-    return MA_FALSE;
+static ma_result ma_ex_mmap_vfs_write(ma_vfs *pVFS, ma_vfs_file pFile, const void *pSrc, size_t sizeInBytes, size_t *pBytesWritten) {
+    ma_ex_mmap_vfs *vfs = (ma_ex_mmap_vfs*)pVFS;
+    ma_ex_mmap_vfs_file *file = (ma_ex_mmap_vfs_file*)pFile;
+
+    //Mapped files are read only
+    if(file->defaultFile == NULL)
+        return MA_ACCESS_DENIED;
+
+    return ma_vfs_write(&vfs->defaultVFS, file->defaultFile, pSrc, sizeInBytes, pBytesWritten);
 }
 
-MA_API ma_bool32 ma_ex_audio_source_get_is_at_end(ma_ex_audio_source *source) {
-    if(source != NULL) {
-        return ma_sound_at_end(&source->clip.sound);
-    }
-    return MA_FALSE;
+static ma_result ma_ex_mmap_vfs_seek(ma_vfs *pVFS, ma_vfs_file pFile, ma_int64 offset, ma_seek_origin origin) {
+    ma_ex_mmap_vfs *vfs = (ma_ex_mmap_vfs*)pVFS;
+    ma_ex_mmap_vfs_file *file = (ma_ex_mmap_vfs_file*)pFile;
+
+    if(file->defaultFile != NULL)
+        return ma_vfs_seek(&vfs->defaultVFS, file->defaultFile, offset, origin);
+
+    ma_int64 cursor;
+    if(origin == ma_seek_origin_start)
+        cursor = offset;
+    else if(origin == ma_seek_origin_current)
+        cursor = (ma_int64)file->cursor + offset;
+    else
+        cursor = (ma_int64)file->view.sizeInBytes + offset;
+
+    if(cursor < 0 || (ma_uint64)cursor > file->view.sizeInBytes)
+        return MA_BAD_SEEK;
+
+    file->cursor = (size_t)cursor;
+    return MA_SUCCESS;
 }
 
-MA_API ma_ex_audio_clip *ma_ex_audio_source_get_clip(ma_ex_audio_source *source) {
-    if(source == NULL)
-        return NULL;
-    return &source->clip;
+static ma_result ma_ex_mmap_vfs_tell(ma_vfs *pVFS, ma_vfs_file pFile, ma_int64 *pCursor) {
+    ma_ex_mmap_vfs *vfs = (ma_ex_mmap_vfs*)pVFS;
+    ma_ex_mmap_vfs_file *file = (ma_ex_mmap_vfs_file*)pFile;
+
+    if(file->defaultFile != NULL)
+        return ma_vfs_tell(&vfs->defaultVFS, file->defaultFile, pCursor);
+
+    *pCursor = (ma_int64)file->cursor;
+    return MA_SUCCESS;
 }
 
-MA_API ma_result ma_ex_audio_source_set_group(ma_ex_audio_source *source, ma_sound_group *group) {
-    if(source == NULL)
-        return MA_ERROR;
-    source->group = group;
+static ma_result ma_ex_mmap_vfs_info(ma_vfs *pVFS, ma_vfs_file pFile, ma_file_info *pInfo) {
+    ma_ex_mmap_vfs *vfs = (ma_ex_mmap_vfs*)pVFS;
+    ma_ex_mmap_vfs_file *file = (ma_ex_mmap_vfs_file*)pFile;
+
+    if(file->defaultFile != NULL)
+        return ma_vfs_info(&vfs->defaultVFS, file->defaultFile, pInfo);
+
+    pInfo->sizeInBytes = file->view.sizeInBytes;
     return MA_SUCCESS;
 }
 
-MA_API ma_sound_group *ma_ex_audio_source_get_group(ma_ex_audio_source *source) {
-    if(source == NULL)
-        return NULL;
-    return source->group;
+MA_API ma_result ma_ex_mmap_vfs_init(ma_ex_mmap_vfs *vfs) {
+    if(vfs == NULL)
+        return MA_INVALID_ARGS;
+
+    MA_ZERO_OBJECT(vfs);
+    vfs->cb.onOpen = ma_ex_mmap_vfs_open;
+    vfs->cb.onOpenW = ma_ex_mmap_vfs_open_w;
+    vfs->cb.onClose = ma_ex_mmap_vfs_close;
+    vfs->cb.onRead = ma_ex_mmap_vfs_read;
+    vfs->cb.onWrite = ma_ex_mmap_vfs_write;
+    vfs->cb.onSeek = ma_ex_mmap_vfs_seek;
+    vfs->cb.onTell = ma_ex_mmap_vfs_tell;
+    vfs->cb.onInfo = ma_ex_mmap_vfs_info;
+
+    return ma_default_vfs_init(&vfs->defaultVFS, NULL);
 }
 
-MA_API ma_ex_audio_listener *ma_ex_audio_listener_init(ma_ex_context *context) {
-    MA_ASSERT(context != NULL);
+#define MA_EX_READAHEAD_BLOCK_EMPTY     0
+#define MA_EX_READAHEAD_BLOCK_QUEUED    1   /* Waiting for an I/O thread. */
+#define MA_EX_READAHEAD_BLOCK_LOADING   2
+#define MA_EX_READAHEAD_BLOCK_READY     3
+
+typedef struct ma_ex_readahead_block ma_ex_readahead_block;
+
+struct ma_ex_readahead_block {
+    ma_uint64 index;        /* Offset in the file divided by the block size. */
+    size_t sizeInBytes;     /* Less than the block size for the last block of the file. */
+    ma_uint32 state;
+    ma_uint8 *pData;
+};
+
+struct ma_ex_readahead_file {
+    ma_vfs_file innerFile;
+    ma_bool32 isPassthrough;        /* Files opened for writing, and files of unknown size, are not read ahead. */
+    ma_uint64 sizeInBytes;
+    ma_uint64 cursor;
+    ma_uint64 lastReadEnd;          /* Reads that start here are sequential. */
+    ma_ex_readahead_block blocks[MA_EX_READAHEAD_BLOCK_COUNT];
+    ma_mutex ioLock;                /* Guards the cursor of innerFile, which is shared by the reader and the I/O threads. */
+    ma_event blockEvent;            /* Signalled whenever an I/O thread is done with a block of this file. */
+    ma_bool32 isQueued;
+    ma_uint32 busyCount;            /* Number of I/O threads reading blocks of this file. A file can be queued again while a thread reads it. */
+    ma_ex_readahead_file *pNextRequest;
+};
+
+static ma_result ma_ex_readahead_file_read_block(ma_ex_readahead_vfs *vfs, ma_ex_readahead_file *file, ma_ex_readahead_block *block, ma_uint64 index) {
+    ma_uint64 offset = index * vfs->blockSize;
+    ma_uint64 size = file->sizeInBytes - offset;
+    size_t bytesRead = 0;
+
+    if(size > vfs->blockSize)
+        size = vfs->blockSize;
+
+    ma_mutex_lock(&file->ioLock);
+    ma_result result = ma_vfs_seek(vfs->pInnerVFS, file->innerFile, (ma_int64)offset, ma_seek_origin_start);
+    if(result == MA_SUCCESS)
+        result = ma_vfs_read(vfs->pInnerVFS, file->innerFile, block->pData, (size_t)size, &bytesRead);
+    ma_mutex_unlock(&file->ioLock);
+
+    if(result == MA_AT_END && bytesRead > 0)
+        result = MA_SUCCESS;
+
+    block->sizeInBytes = bytesRead;
+    return result;
+}
 
-    ma_int32 listenerIndex = -1;
+static ma_thread_result MA_THREADCALL ma_ex_readahead_thread(void *pData) {
+    ma_ex_readahead_vfs *vfs = (ma_ex_readahead_vfs*)pData;
 
-    for(ma_int32 i = 0; i < MA_ENGINE_MAX_LISTENERS; i++) {
-        if(context->listeners[i] == -1) {
-            context->listeners[i] = i;
-            listenerIndex = i;
-            break;
+    for(;;) {
+        ma_semaphore_wait(&vfs->requestSemaphore);
+        ma_mutex_lock(&vfs->lock);
+
+        ma_ex_readahead_file *file = vfs->pRequestHead;
+
+        if(file == NULL) {
+            ma_bool32 isShuttingDown = vfs->isShuttingDown;
+            ma_mutex_unlock(&vfs->lock);
+            //Closing a queued file removes it from the queue but leaves its release of the semaphore
+            if(isShuttingDown)
+                break;
+            continue;
         }
-    }
 
-    if(listenerIndex == -1) {
-        fprintf(stderr, "Can't create any more audio listeners, the max of %d is already achieved\n", MA_ENGINE_MAX_LISTENERS);
-        return NULL;
-    }
+        vfs->pRequestHead = file->pNextRequest;
+        if(vfs->pRequestHead == NULL)
+            vfs->pRequestTail = NULL;
+        file->pNextRequest = NULL;
+        file->isQueued = MA_FALSE;
+        file->busyCount++;
 
-    ma_ex_audio_listener *listener = (ma_ex_audio_listener*)MA_MALLOC(sizeof(ma_ex_audio_listener));
-    MA_ZERO_OBJECT(listener);
+        //Blocks are queued in file order, so the block the reader needs next is read first
+        for(ma_uint32 i = 0; i < MA_EX_READAHEAD_BLOCK_COUNT; i++) {
+            ma_ex_readahead_block *block = &file->blocks[i];
 
-    listener->context = context;
-    listener->index = listenerIndex;
-    ma_ex_vec3f_set(&listener->settings.position, 0.0f, 0.0f, 0.0f);
-    ma_ex_vec3f_set(&listener->settings.direction, 0.0f, 0.0f, -1.0f);
-    ma_ex_vec3f_set(&listener->settings.velocity, 0.0f, 0.0f, 0.0f);
-    ma_ex_vec3f_set(&listener->settings.worldUp, 0.0f, 1.0f, 0.0f);
-    listener->settings.spatialization = MA_TRUE;
-    listener->settings.coneInnerAngleInRadians = 6.283185f; /* 360 degrees. */
-    listener->settings.coneOuterAngleInRadians = 6.283185f; /* 360 degrees. */
-    listener->settings.coneOuterGain = 0;
+            if(block->state != MA_EX_READAHEAD_BLOCK_QUEUED)
+                continue;
 
-    ma_engine_listener_set_position(&listener->context->engine, listener->index, listener->settings.position.x, listener->settings.position.y, listener->settings.position.z);
-    ma_engine_listener_set_direction(&listener->context->engine, listener->index, listener->settings.direction.x, listener->settings.direction.y, listener->settings.direction.z);
-    ma_engine_listener_set_velocity(&listener->context->engine, listener->index, listener->settings.velocity.x, listener->settings.velocity.y, listener->settings.velocity.z);
-    ma_engine_listener_set_world_up(&listener->context->engine, listener->index, listener->settings.worldUp.x, listener->settings.worldUp.y, listener->settings.worldUp.z);
-    ma_engine_listener_set_cone(&listener->context->engine, listener->index, listener->settings.coneInnerAngleInRadians, listener->settings.coneOuterAngleInRadians, listener->settings.coneOuterGain);
-    ma_engine_listener_set_enabled(&listener->context->engine, listener->index, listener->settings.spatialization);
-    
-    return listener;
-}
+            block->state = MA_EX_READAHEAD_BLOCK_LOADING;
+            ma_uint64 index = block->index;
+            ma_mutex_unlock(&vfs->lock);
 
-MA_API void ma_ex_audio_listener_uninit(ma_ex_audio_listener *listener) {
-    if(listener != NULL) {
-        if(listener->context != NULL && listener->index < MA_ENGINE_MAX_LISTENERS) {
-            listener->context->listeners[listener->index] = -1;
+            ma_result result = ma_ex_readahead_file_read_block(vfs, file, block, index);
+
+            ma_mutex_lock(&vfs->lock);
+            //A block that failed is read again by the reader, which then gets the error
+            block->state = result == MA_SUCCESS ? MA_EX_READAHEAD_BLOCK_READY : MA_EX_READAHEAD_BLOCK_EMPTY;
+            ma_event_signal(&file->blockEvent);
         }
-        MA_FREE(listener);
+
+        file->busyCount--;
+        ma_event_signal(&file->blockEvent);
+        ma_mutex_unlock(&vfs->lock);
     }
-}
 
-MA_API void ma_ex_audio_listener_set_spatialization(ma_ex_audio_listener *listener, ma_bool32 enabled) {
-    if(listener != NULL)
-        ma_engine_listener_set_enabled(&listener->context->engine, listener->index, enabled);
+    return (ma_thread_result)0;
 }
 
-MA_API ma_bool32 ma_ex_audio_listener_get_spatialization(ma_ex_audio_listener *listener) {
-    if(listener != NULL)
-        return listener->settings.spatialization;
-    return MA_FALSE;
+static ma_ex_readahead_block *ma_ex_readahead_file_find_block(ma_ex_readahead_file *file, ma_uint64 index) {
+    for(ma_uint32 i = 0; i < MA_EX_READAHEAD_BLOCK_COUNT; i++) {
+        if(file->blocks[i].state != MA_EX_READAHEAD_BLOCK_EMPTY && file->blocks[i].index == index)
+            return &file->blocks[i];
+    }
+    return NULL;
 }
 
-MA_API void ma_ex_audio_listener_set_position(ma_ex_audio_listener *listener, float x, float y, float z) {
-    if(listener != NULL) {
-        listener->settings.position.x = x;
-        listener->settings.position.y = y;
-        listener->settings.position.z = z;
-        ma_engine_listener_set_position(&listener->context->engine, listener->index, x, y, z);
+/* Finds a block that can be reused without dropping blocks between firstIndex and lastIndex. Blocks behind the cursor are dropped first, then the ones furthest ahead. Called while holding the lock. */
+static ma_ex_readahead_block *ma_ex_readahead_file_claim_block(ma_ex_readahead_file *file, ma_uint64 firstIndex, ma_uint64 lastIndex, ma_bool32 includeQueued) {
+    ma_ex_readahead_block *claimed = NULL;
+
+    for(ma_uint32 i = 0; i < MA_EX_READAHEAD_BLOCK_COUNT; i++) {
+        ma_ex_readahead_block *block = &file->blocks[i];
+
+        if(block->state == MA_EX_READAHEAD_BLOCK_EMPTY)
+            return block;
+
+        if(block->state == MA_EX_READAHEAD_BLOCK_LOADING || (block->state == MA_EX_READAHEAD_BLOCK_QUEUED && !includeQueued))
+            continue;
+
+        if(block->index >= firstIndex && block->index <= lastIndex)
+            continue;
+
+        if(claimed == NULL) {
+            claimed = block;
+        } else if(block->index < firstIndex) {
+            if(claimed->index > lastIndex || block->index < claimed->index)
+                claimed = block;
+        } else if(claimed->index > lastIndex && block->index > claimed->index) {
+            claimed = block;
+        }
     }
+
+    return claimed;
 }
 
-MA_API void ma_ex_audio_listener_get_position(ma_ex_audio_listener *listener, float *x, float *y, float *z) {
-    if(listener != NULL) {
-        ma_ex_vec3f_get(&listener->settings.position, x, y, z);
-    } else {
-        *x = 0.0f;
-        *y = 0.0f;
-        *z = 0.0f;
+/* Queues the blocks after lastIndex that aren't cached yet. Called while holding the lock. */
+static void ma_ex_readahead_file_prefetch(ma_ex_readahead_vfs *vfs, ma_ex_readahead_file *file, ma_uint64 lastIndex) {
+    ma_bool32 isQueued = MA_FALSE;
+
+    for(ma_uint64 index = lastIndex + 1; index < lastIndex + MA_EX_READAHEAD_BLOCK_COUNT; index++) {
+        if(index * vfs->blockSize >= file->sizeInBytes)
+            break;
+
+        if(ma_ex_readahead_file_find_block(file, index) != NULL)
+            continue;
+
+        ma_ex_readahead_block *block = ma_ex_readahead_file_claim_block(file, lastIndex, lastIndex + MA_EX_READAHEAD_BLOCK_COUNT - 1, MA_FALSE);
+
+        if(block == NULL)
+            break;
+
+        block->index = index;
+        block->state = MA_EX_READAHEAD_BLOCK_QUEUED;
+        isQueued = MA_TRUE;
     }
-}
 
-MA_API void ma_ex_audio_listener_set_direction(ma_ex_audio_listener *listener, float x, float y, float z) {
-    if(listener != NULL) {
-        listener->settings.direction.x = x;
-        listener->settings.direction.y = y;
-        listener->settings.direction.z = z;
-        ma_engine_listener_set_direction(&listener->context->engine, listener->index, x, y, z);
+    if(isQueued && !file->isQueued) {
+        file->isQueued = MA_TRUE;
+        if(vfs->pRequestTail != NULL)
+            vfs->pRequestTail->pNextRequest = file;
+        else
+            vfs->pRequestHead = file;
+        vfs->pRequestTail = file;
+        ma_semaphore_release(&vfs->requestSemaphore);
     }
 }
 
-MA_API void ma_ex_audio_listener_get_direction(ma_ex_audio_listener *listener, float *x, float *y, float *z) {
-    if(listener != NULL) {
-        ma_ex_vec3f_get(&listener->settings.direction, x, y, z);
-    } else {
-        *x = 0.0f;
-        *y = 0.0f;
-        *z = 0.0f;
+static void ma_ex_readahead_file_free(ma_ex_readahead_file *file) {
+    if(!file->isPassthrough) {
+        ma_event_uninit(&file->blockEvent);
+        ma_mutex_uninit(&file->ioLock);
     }
+    MA_FREE(file);
 }
 
-MA_API void ma_ex_audio_listener_set_velocity(ma_ex_audio_listener *listener, float x, float y, float z) {
-    if(listener != NULL) {
-        listener->settings.velocity.x = x;
-        listener->settings.velocity.y = y;
-        listener->settings.velocity.z = z;
-        ma_engine_listener_set_velocity(&listener->context->engine, listener->index, x, y, z);
+static ma_result ma_ex_readahead_vfs_init_file(ma_ex_readahead_vfs *vfs, ma_ex_readahead_file *file) {
+    ma_file_info info;
+
+    if(ma_vfs_info(vfs->pInnerVFS, file->innerFile, &info) != MA_SUCCESS || info.sizeInBytes == 0) {
+        file->isPassthrough = MA_TRUE;
+        return MA_SUCCESS;
+    }
+
+    file->sizeInBytes = info.sizeInBytes;
+
+    if(ma_mutex_init(&file->ioLock) != MA_SUCCESS)
+        return MA_ERROR;
+
+    if(ma_event_init(&file->blockEvent) != MA_SUCCESS) {
+        ma_mutex_uninit(&file->ioLock);
+        return MA_ERROR;
     }
+
+    //The block data is allocated together with the file
+    ma_uint8 *pData = (ma_uint8*)(file + 1);
+    for(ma_uint32 i = 0; i < MA_EX_READAHEAD_BLOCK_COUNT; i++)
+        file->blocks[i].pData = pData + (i * vfs->blockSize);
+
+    return MA_SUCCESS;
 }
 
-MA_API void ma_ex_audio_listener_get_velocity(ma_ex_audio_listener *listener, float *x, float *y, float *z) {
-    if(listener != NULL) {
-        ma_ex_vec3f_get(&listener->settings.velocity, x, y, z);
-    } else {
-        *x = 0.0f;
-        *y = 0.0f;
-        *z = 0.0f;
+static ma_result ma_ex_readahead_vfs_open_file(ma_ex_readahead_vfs *vfs, const char *pFilePath, const wchar_t *pFilePathW, ma_uint32 openMode, ma_vfs_file *pFile) {
+    *pFile = NULL;
+
+    ma_bool32 isPassthrough = (openMode & MA_OPEN_MODE_WRITE) != 0;
+    size_t size = sizeof(ma_ex_readahead_file) + (isPassthrough ? 0 : MA_EX_READAHEAD_BLOCK_COUNT * vfs->blockSize);
+    ma_ex_readahead_file *file = MA_MALLOC(size);
+
+    if(file == NULL)
+        return MA_OUT_OF_MEMORY;
+
+    MA_ZERO_OBJECT(file);
+    file->isPassthrough = isPassthrough;
+
+    ma_result result;
+    if(pFilePath != NULL)
+        result = ma_vfs_open(vfs->pInnerVFS, pFilePath, openMode, &file->innerFile);
+    else
+        result = ma_vfs_open_w(vfs->pInnerVFS, pFilePathW, openMode, &file->innerFile);
+
+    if(result != MA_SUCCESS) {
+        MA_FREE(file);
+        return result;
+    }
+
+    if(!isPassthrough && ma_ex_readahead_vfs_init_file(vfs, file) != MA_SUCCESS) {
+        ma_vfs_close(vfs->pInnerVFS, file->innerFile);
+        MA_FREE(file);
+        return MA_ERROR;
     }
+
+    *pFile = file;
+    return MA_SUCCESS;
 }
 
-MA_API void ma_ex_audio_listener_set_world_up(ma_ex_audio_listener *listener, float x, float y, float z) {
-    if(listener != NULL) {
-        listener->settings.worldUp.x = x;
-        listener->settings.worldUp.y = y;
-        listener->settings.worldUp.z = z;
-        ma_engine_listener_set_world_up(&listener->context->engine, listener->index, x, y, z);
+static ma_result ma_ex_readahead_vfs_open(ma_vfs *pVFS, const char *pFilePath, ma_uint32 openMode, ma_vfs_file *pFile) {
+    return ma_ex_readahead_vfs_open_file((ma_ex_readahead_vfs*)pVFS, pFilePath, NULL, openMode, pFile);
+}
+
+static ma_result ma_ex_readahead_vfs_open_w(ma_vfs *pVFS, const wchar_t *pFilePath, ma_uint32 openMode, ma_vfs_file *pFile) {
+    return ma_ex_readahead_vfs_open_file((ma_ex_readahead_vfs*)pVFS, NULL, pFilePath, openMode, pFile);
+}
+
+static ma_result ma_ex_readahead_vfs_close(ma_vfs *pVFS, ma_vfs_file pFile) {
+    ma_ex_readahead_vfs *vfs = (ma_ex_readahead_vfs*)pVFS;
+    ma_ex_readahead_file *file = (ma_ex_readahead_file*)pFile;
+
+    if(!file->isPassthrough) {
+        ma_mutex_lock(&vfs->lock);
+
+        if(file->isQueued) {
+            ma_ex_readahead_file *pPrevious = NULL;
+            ma_ex_readahead_file *pRequest = vfs->pRequestHead;
+
+            while(pRequest != file) {
+                pPrevious = pRequest;
+                pRequest = pRequest->pNextRequest;
+            }
+
+            if(pPrevious != NULL)
+                pPrevious->pNextRequest = file->pNextRequest;
+            else
+                vfs->pRequestHead = file->pNextRequest;
+
+            if(vfs->pRequestTail == file)
+                vfs->pRequestTail = pPrevious;
+
+            file->isQueued = MA_FALSE;
+        }
+
+        //I/O threads that are reading blocks of the file have to finish first
+        while(file->busyCount > 0) {
+            ma_mutex_unlock(&vfs->lock);
+            ma_event_wait(&file->blockEvent);
+            ma_mutex_lock(&vfs->lock);
+        }
+
+        ma_mutex_unlock(&vfs->lock);
     }
+
+    ma_result result = ma_vfs_close(vfs->pInnerVFS, file->innerFile);
+    ma_ex_readahead_file_free(file);
+    return result;
 }
 
-MA_API void ma_ex_audio_listener_get_world_up(ma_ex_audio_listener *listener, float *x, float *y, float *z) {
-    if(listener != NULL) {
-        ma_ex_vec3f_get(&listener->settings.worldUp, x, y, z);
-    } else {
-        *x = 0.0f;
-        *y = 0.0f;
-        *z = 0.0f;
+static ma_result ma_ex_readahead_vfs_read(ma_vfs *pVFS, ma_vfs_file pFile, void *pDst, size_t sizeInBytes, size_t *pBytesRead) {
+    ma_ex_readahead_vfs *vfs = (ma_ex_readahead_vfs*)pVFS;
+    ma_ex_readahead_file *file = (ma_ex_readahead_file*)pFile;
+
+    if(file->isPassthrough)
+        return ma_vfs_read(vfs->pInnerVFS, file->innerFile, pDst, sizeInBytes, pBytesRead);
+
+    ma_bool32 isSequential = file->cursor == file->lastReadEnd;
+    ma_uint8 *pOut = (ma_uint8*)pDst;
+    size_t totalBytesRead = 0;
+    ma_result result = MA_SUCCESS;
+    ma_uint64 index = file->cursor / vfs->blockSize;
+
+    ma_mutex_lock(&vfs->lock);
+
+    while(totalBytesRead < sizeInBytes && file->cursor < file->sizeInBytes) {
+        index = file->cursor / vfs->blockSize;
+        ma_ex_readahead_block *block = ma_ex_readahead_file_find_block(file, index);
+
+        //Blocks the I/O threads haven't started on yet are quicker to read here
+        if(block != NULL && block->state == MA_EX_READAHEAD_BLOCK_QUEUED)
+            block->state = MA_EX_READAHEAD_BLOCK_EMPTY;
+
+        if(block == NULL || block->state == MA_EX_READAHEAD_BLOCK_EMPTY) {
+            //Prefer keeping the blocks read ahead of the cursor, but never wait for a block while others can be dropped
+            if(block == NULL)
+                block = ma_ex_readahead_file_claim_block(file, index, index + MA_EX_READAHEAD_BLOCK_COUNT - 1, MA_FALSE);
+            if(block == NULL)
+                block = ma_ex_readahead_file_claim_block(file, index, index, MA_TRUE);
+
+            //Every block is being read by an I/O thread, wait for one of them
+            if(block == NULL) {
+                ma_mutex_unlock(&vfs->lock);
+                ma_event_wait(&file->blockEvent);
+                ma_mutex_lock(&vfs->lock);
+                continue;
+            }
+
+            block->index = index;
+            block->state = MA_EX_READAHEAD_BLOCK_LOADING;
+            ma_mutex_unlock(&vfs->lock);
+
+            result = ma_ex_readahead_file_read_block(vfs, file, block, index);
+
+            ma_mutex_lock(&vfs->lock);
+            block->state = result == MA_SUCCESS ? MA_EX_READAHEAD_BLOCK_READY : MA_EX_READAHEAD_BLOCK_EMPTY;
+
+            if(result != MA_SUCCESS)
+                break;
+        }
+
+        if(block->state == MA_EX_READAHEAD_BLOCK_LOADING) {
+            ma_mutex_unlock(&vfs->lock);
+            ma_event_wait(&file->blockEvent);
+            ma_mutex_lock(&vfs->lock);
+            continue;
+        }
+
+        size_t offset = (size_t)(file->cursor - (index * vfs->blockSize));
+
+        //The file got shorter since it was opened
+        if(offset >= block->sizeInBytes) {
+            file->sizeInBytes = file->cursor;
+            break;
+        }
+
+        size_t bytesToCopy = block->sizeInBytes - offset;
+        if(bytesToCopy > sizeInBytes - totalBytesRead)
+            bytesToCopy = sizeInBytes - totalBytesRead;
+
+        memcpy(pOut + totalBytesRead, block->pData + offset, bytesToCopy);
+        totalBytesRead += bytesToCopy;
+        file->cursor += bytesToCopy;
     }
+
+    if(isSequential && result == MA_SUCCESS)
+        ma_ex_readahead_file_prefetch(vfs, file, index);
+
+    ma_mutex_unlock(&vfs->lock);
+
+    file->lastReadEnd = file->cursor;
+
+    if(pBytesRead != NULL)
+        *pBytesRead = totalBytesRead;
+
+    if(result != MA_SUCCESS && totalBytesRead == 0)
+        return result;
+
+    if(totalBytesRead == 0 && sizeInBytes > 0)
+        return MA_AT_END;
+
+    return MA_SUCCESS;
 }
 
-MA_API void ma_ex_audio_listener_set_cone(ma_ex_audio_listener *listener, float innerAngleInRadians, float outerAngleInRadians, float outerGain) {
-    if(listener != NULL) {
-        listener->settings.coneInnerAngleInRadians = innerAngleInRadians;
-        listener->settings.coneOuterAngleInRadians = outerAngleInRadians;
-        listener->settings.coneOuterGain = outerGain;
-        ma_engine_listener_set_cone(&listener->context->engine, listener->index, innerAngleInRadians, outerAngleInRadians, outerGain);
-    }
+static ma_result ma_ex_readahead_vfs_write(ma_vfs *pVFS, ma_vfs_file pFile, const void *pSrc, size_t sizeInBytes, size_t *pBytesWritten) {
+    ma_ex_readahead_vfs *vfs = (ma_ex_readahead_vfs*)pVFS;
+    ma_ex_readahead_file *file = (ma_ex_readahead_file*)pFile;
+
+    if(!file->isPassthrough)
+        return MA_ACCESS_DENIED;
+
+    return ma_vfs_write(vfs->pInnerVFS, file->innerFile, pSrc, sizeInBytes, pBytesWritten);
 }
 
-MA_API void ma_ex_audio_listener_get_cone(ma_ex_audio_listener *listener, float *innerAngleInRadians, float *outerAngleInRadians, float *outerGain) {
-    if(listener != NULL) {
-        *innerAngleInRadians = listener->settings.coneInnerAngleInRadians;
-        *outerAngleInRadians = listener->settings.coneOuterAngleInRadians;
-        *outerGain = listener->settings.coneOuterGain;
-    } else {
-        *innerAngleInRadians = 0.0f;
-        *outerAngleInRadians = 0.0f;
-        *outerGain = 0.0f;
-    }
+static ma_result ma_ex_readahead_vfs_seek(ma_vfs *pVFS, ma_vfs_file pFile, ma_int64 offset, ma_seek_origin origin) {
+    ma_ex_readahead_vfs *vfs = (ma_ex_readahead_vfs*)pVFS;
+    ma_ex_readahead_file *file = (ma_ex_readahead_file*)pFile;
+
+    if(file->isPassthrough)
+        return ma_vfs_seek(vfs->pInnerVFS, file->innerFile, offset, origin);
+
+    ma_int64 cursor;
+    if(origin == ma_seek_origin_start)
+        cursor = offset;
+    else if(origin == ma_seek_origin_current)
+        cursor = (ma_int64)file->cursor + offset;
+    else
+        cursor = (ma_int64)file->sizeInBytes + offset;
+
+    if(cursor < 0 || (ma_uint64)cursor > file->sizeInBytes)
+        return MA_BAD_SEEK;
+
+    //Reading from the new position is only treated as sequential when it doesn't move
+    file->cursor = (ma_uint64)cursor;
+    return MA_SUCCESS;
 }
 
-MA_API ma_sound_group *ma_ex_sound_group_init(ma_ex_context *context) {
-    if(context == NULL)
-        return NULL;
-    
-    ma_sound_group *pGroup = ma_malloc(sizeof(ma_sound_group), NULL);
+static ma_result ma_ex_readahead_vfs_tell(ma_vfs *pVFS, ma_vfs_file pFile, ma_int64 *pCursor) {
+    ma_ex_readahead_vfs *vfs = (ma_ex_readahead_vfs*)pVFS;
+    ma_ex_readahead_file *file = (ma_ex_readahead_file*)pFile;
 
-    if(pGroup == NULL)
-        return NULL;
-        
-    ma_result result = ma_sound_group_init(&context->engine, 0, NULL, pGroup);
+    if(file->isPassthrough)
+        return ma_vfs_tell(vfs->pInnerVFS, file->innerFile, pCursor);
 
-    if(result != MA_SUCCESS) {
-        free(pGroup);
-        pGroup = NULL;
-    }
-    
-    return pGroup;
+    *pCursor = (ma_int64)file->cursor;
+    return MA_SUCCESS;
 }
 
-MA_API void ma_ex_sound_group_uninit(ma_sound_group *group) {
-    if(group == NULL)
-        return;
-    ma_sound_group_uninit(group);
-    MA_FREE(group);
+static ma_result ma_ex_readahead_vfs_info(ma_vfs *pVFS, ma_vfs_file pFile, ma_file_info *pInfo) {
+    ma_ex_readahead_vfs *vfs = (ma_ex_readahead_vfs*)pVFS;
+    ma_ex_readahead_file *file = (ma_ex_readahead_file*)pFile;
+
+    if(file->isPassthrough)
+        return ma_vfs_info(vfs->pInnerVFS, file->innerFile, pInfo);
+
+    pInfo->sizeInBytes = file->sizeInBytes;
+    return MA_SUCCESS;
 }
 
-MA_API char *ma_ex_read_bytes_from_file(const char *filepath, size_t *size) {
-    FILE *file = fopen(filepath, "rb");
-    if (file == NULL) {
-        fprintf(stderr, "Error opening file\n");
-        return NULL;
+/* Reads through pInnerVFS, or the default VFS when it is NULL. blockSize defaults to 64 KiB when 0. */
+MA_API ma_result ma_ex_readahead_vfs_init(ma_ex_readahead_vfs *vfs, ma_vfs *pInnerVFS, ma_uint32 threadCount, size_t blockSize) {
+    if(vfs == NULL || threadCount == 0)
+        return MA_INVALID_ARGS;
+
+    MA_ZERO_OBJECT(vfs);
+    vfs->cb.onOpen = ma_ex_readahead_vfs_open;
+    vfs->cb.onOpenW = ma_ex_readahead_vfs_open_w;
+    vfs->cb.onClose = ma_ex_readahead_vfs_close;
+    vfs->cb.onRead = ma_ex_readahead_vfs_read;
+    vfs->cb.onWrite = ma_ex_readahead_vfs_write;
+    vfs->cb.onSeek = ma_ex_readahead_vfs_seek;
+    vfs->cb.onTell = ma_ex_readahead_vfs_tell;
+    vfs->cb.onInfo = ma_ex_readahead_vfs_info;
+    vfs->blockSize = blockSize > 0 ? blockSize : 65536;
+
+    if(threadCount > MA_EX_READAHEAD_MAX_THREADS)
+        threadCount = MA_EX_READAHEAD_MAX_THREADS;
+
+    ma_default_vfs_init(&vfs->defaultVFS, NULL);
+    vfs->pInnerVFS = pInnerVFS != NULL ? pInnerVFS : (ma_vfs*)&vfs->defaultVFS;
+
+    if(ma_mutex_init(&vfs->lock) != MA_SUCCESS)
+        return MA_ERROR;
+
+    if(ma_semaphore_init(0, &vfs->requestSemaphore) != MA_SUCCESS) {
+        ma_mutex_uninit(&vfs->lock);
+        return MA_ERROR;
     }
 
-    fseek(file, 0, SEEK_END);
-    size_t fileSize = ftell(file);
-    rewind(file);
+    vfs->pThreads = MA_MALLOC(threadCount * sizeof(ma_thread));
 
-    char *buffer = (char *)MA_MALLOC(fileSize * sizeof(char));
-    if (buffer == NULL) {
-        fprintf(stderr, "Memory allocation failed\n");
-        fclose(file);
-        return NULL;
+    if(vfs->pThreads == NULL) {
+        ma_semaphore_uninit(&vfs->requestSemaphore);
+        ma_mutex_uninit(&vfs->lock);
+        return MA_OUT_OF_MEMORY;
     }
 
-    if (fread(buffer, sizeof(char), fileSize, file) != fileSize) {
-        fprintf(stderr, "Error reading file\n");
-        MA_FREE(buffer);
-        fclose(file);
-        return NULL;
+    for(ma_uint32 i = 0; i < threadCount; i++) {
+        if(ma_thread_create(&vfs->pThreads[i], ma_thread_priority_default, 0, ma_ex_readahead_thread, vfs, NULL) != MA_SUCCESS)
+            break;
+        vfs->threadCount++;
     }
 
-    fclose(file);
+    if(vfs->threadCount == 0) {
+        ma_ex_readahead_vfs_uninit(vfs);
+        return MA_ERROR;
+    }
 
-    *size = fileSize;
-    return buffer;
+    return MA_SUCCESS;
 }
 
-MA_API void ma_ex_free_bytes_from_file(char *pointer) {
-    if(pointer != NULL)
-        MA_FREE(pointer);
+/* Every file opened through the VFS must be closed first. */
+MA_API void ma_ex_readahead_vfs_uninit(ma_ex_readahead_vfs *vfs) {
+    if(vfs == NULL || vfs->pThreads == NULL)
+        return;
+
+    ma_mutex_lock(&vfs->lock);
+    vfs->isShuttingDown = MA_TRUE;
+    ma_mutex_unlock(&vfs->lock);
+
+    for(ma_uint32 i = 0; i < vfs->threadCount; i++)
+        ma_semaphore_release(&vfs->requestSemaphore);
+
+    for(ma_uint32 i = 0; i < vfs->threadCount; i++)
+        ma_thread_wait(&vfs->pThreads[i]);
+
+    MA_FREE(vfs->pThreads);
+    vfs->pThreads = NULL;
+    ma_semaphore_uninit(&vfs->requestSemaphore);
+    ma_mutex_uninit(&vfs->lock);
 }
 
 MA_API void ma_ex_free(void *pointer) {
@@ -1207,4 +5397,607 @@ MA_API float *ma_ex_decode_memory(const void *pData, ma_uint64 size, ma_uint64 *
         return (float*)pPCMFrames;
     }
     return NULL;
-}
\ No newline at end of file
+}
+
+static MA_INLINE ma_uint32 ma_ex_read_be32(const ma_uint8 *p) {
+    return ((ma_uint32)p[0] << 24) | ((ma_uint32)p[1] << 16) | ((ma_uint32)p[2] << 8) | (ma_uint32)p[3];
+}
+
+static MA_INLINE ma_uint64 ma_ex_read_le64(const ma_uint8 *p) {
+    return (ma_uint64)ma_ex_read_le32(p) | ((ma_uint64)ma_ex_read_le32(p + 4) << 32);
+}
+
+/* Reads the fmt chunk and the size of the data chunk. Returns MA_NOT_IMPLEMENTED for compressed files without a fact chunk, whose length can only be found by the decoder. */
+static ma_result ma_ex_probe_wav(const ma_uint8 *p, size_t dataSize, ma_ex_probe_info *pInfo) {
+    ma_bool32 isRF64 = memcmp(p, "RF64", 4) == 0;
+    ma_uint64 ds64DataSize = 0;
+    ma_uint64 factFrameCount = 0;
+    ma_bool32 hasFact = MA_FALSE;
+    ma_uint16 formatTag = 0;
+    ma_uint16 blockAlign = 0;
+    ma_uint16 bitsPerSample = 0;
+    size_t offset = 12;
+
+    pInfo->codec = ma_encoding_format_wav;
+
+    while(offset + 8 <= dataSize) {
+        const ma_uint8 *pChunk = p + offset;
+        ma_uint64 chunkSize = ma_ex_read_le32(pChunk + 4);
+        offset += 8;
+
+        if(memcmp(pChunk, "ds64", 4) == 0) {
+            if(chunkSize < 24 || offset + 24 > dataSize)
+                return MA_INVALID_FILE;
+            ds64DataSize = ma_ex_read_le64(pChunk + 16);
+        } else if(memcmp(pChunk, "fmt ", 4) == 0) {
+            if(chunkSize < 16 || offset + 16 > dataSize)
+                return MA_INVALID_FILE;
+
+            formatTag = ma_ex_read_le16(pChunk + 8);
+            pInfo->channels = ma_ex_read_le16(pChunk + 10);
+            pInfo->sampleRate = ma_ex_read_le32(pChunk + 12);
+            blockAlign = ma_ex_read_le16(pChunk + 20);
+            bitsPerSample = ma_ex_read_le16(pChunk + 22);
+
+            //WAVE_FORMAT_EXTENSIBLE stores the actual format tag at the start of the sub format GUID
+            if(formatTag == 0xFFFE) {
+                if(chunkSize < 40 || offset + 26 > dataSize)
+                    return MA_INVALID_FILE;
+                formatTag = ma_ex_read_le16(pChunk + 32);
+            }
+        } else if(memcmp(pChunk, "fact", 4) == 0) {
+            if(chunkSize >= 4 && offset + 4 <= dataSize) {
+                factFrameCount = ma_ex_read_le32(pChunk + 8);
+                hasFact = MA_TRUE;
+            }
+        } else if(memcmp(pChunk, "data", 4) == 0) {
+            if(formatTag == 0 || blockAlign == 0 || pInfo->channels == 0)
+                return MA_INVALID_FILE;
+
+            if(isRF64 && chunkSize == 0xFFFFFFFF)
+                chunkSize = ds64DataSize;
+
+            pInfo->isLengthExact = MA_TRUE;
+
+            //Files that were cut short still play up to where they end
+            if(chunkSize > dataSize - offset) {
+                chunkSize = dataSize - offset;
+                pInfo->isLengthExact = MA_FALSE;
+            }
+
+            pInfo->format = ma_format_f32;
+
+            switch(formatTag) {
+                case 1:     //PCM
+                    if(bitsPerSample == 8)
+                        pInfo->format = ma_format_u8;
+                    else if(bitsPerSample == 16)
+                        pInfo->format = ma_format_s16;
+                    else if(bitsPerSample == 24)
+                        pInfo->format = ma_format_s24;
+                    else if(bitsPerSample == 32)
+                        pInfo->format = ma_format_s32;
+                    pInfo->lengthInPCMFrames = chunkSize / blockAlign;
+                    break;
+                case 3:     //IEEE float
+                    //miniaudio has no 64-bit float format
+                    if(bitsPerSample != 32)
+                        pInfo->format = ma_format_unknown;
+                    pInfo->lengthInPCMFrames = chunkSize / blockAlign;
+                    break;
+                case 6:     //A-law
+                case 7:     //mu-law
+                    //Both expand to 16-bit samples
+                    pInfo->format = ma_format_s16;
+                    pInfo->lengthInPCMFrames = chunkSize / blockAlign;
+                    break;
+                default:
+                    if(!hasFact)
+                        return MA_NOT_IMPLEMENTED;
+                    pInfo->lengthInPCMFrames = factFrameCount;
+                    pInfo->isLengthExact = MA_TRUE;
+                    break;
+            }
+
+            return MA_SUCCESS;
+        }
+
+        if(chunkSize >= dataSize - offset)
+            break;
+
+        //Chunks are padded to an even size
+        offset += (size_t)chunkSize + (size_t)(chunkSize & 1);
+    }
+
+    return MA_INVALID_FILE;
+}
+
+/* Reads a 34 byte STREAMINFO block. The total sample count is 0 when the encoder didn't know it. */
+static void ma_ex_probe_flac_streaminfo(const ma_uint8 *pStreamInfo, ma_ex_probe_info *pInfo) {
+    pInfo->codec = ma_encoding_format_flac;
+    pInfo->format = ma_format_f32;
+    pInfo->sampleRate = ((ma_uint32)pStreamInfo[10] << 12) | ((ma_uint32)pStreamInfo[11] << 4) | ((ma_uint32)pStreamInfo[12] >> 4);
+    pInfo->channels = ((pStreamInfo[12] >> 1) & 0x07) + 1;
+    pInfo->lengthInPCMFrames = ((ma_uint64)(pStreamInfo[13] & 0x0F) << 32) | ma_ex_read_be32(pStreamInfo + 14);
+    pInfo->isLengthExact = pInfo->lengthInPCMFrames > 0;
+}
+
+static ma_result ma_ex_probe_flac(const ma_uint8 *p, size_t dataSize, ma_ex_probe_info *pInfo) {
+    //STREAMINFO is always the first metadata block
+    if(dataSize < 8 + 34 || (p[4] & 0x7F) != 0)
+        return MA_INVALID_FILE;
+
+    ma_ex_probe_flac_streaminfo(p + 8, pInfo);
+    return MA_SUCCESS;
+}
+
+/* Reads the codec from the first packet, and the length from the granule position of the last page of the stream. */
+static ma_result ma_ex_probe_ogg(const ma_uint8 *p, size_t dataSize, ma_ex_probe_info *pInfo) {
+    if(dataSize < 27 || p[4] != 0)
+        return MA_INVALID_FILE;
+
+    size_t packetOffset = 27 + (size_t)p[26];
+    if(packetOffset > dataSize)
+        return MA_INVALID_FILE;
+
+    const ma_uint8 *pPacket = p + packetOffset;
+    size_t packetSize = dataSize - packetOffset;
+    ma_uint32 serial = ma_ex_read_le32(p + 14);
+
+    if(packetSize >= 16 && memcmp(pPacket, "\001vorbis", 7) == 0) {
+        pInfo->codec = ma_encoding_format_vorbis;
+        pInfo->format = ma_format_f32;
+        pInfo->channels = pPacket[11];
+        pInfo->sampleRate = ma_ex_read_le32(pPacket + 12);
+    } else if(packetSize >= 17 + 34 && memcmp(pPacket, "\177FLAC", 5) == 0 && memcmp(pPacket + 9, "fLaC", 4) == 0) {
+        ma_ex_probe_flac_streaminfo(pPacket + 17, pInfo);
+        if(pInfo->isLengthExact)
+            return MA_SUCCESS;
+    } else {
+        return MA_NOT_IMPLEMENTED;  //Opus and anything else is left to the custom decoders
+    }
+
+    //A page is at most 65307 bytes, so the last page with a granule position starts close to the end
+    size_t searchStart = dataSize > 27 ? dataSize - 27 : 0;
+    size_t searchEnd = dataSize > 65307 * 2 ? dataSize - 65307 * 2 : 0;
+
+    for(size_t offset = searchStart; offset > searchEnd; offset--) {
+        const ma_uint8 *pPage = p + offset;
+
+        if(pPage[0] != 'O' || memcmp(pPage, "OggS", 4) != 0 || pPage[4] != 0 || ma_ex_read_le32(pPage + 14) != serial)
+            continue;
+
+        ma_uint64 granulePosition = ma_ex_read_le64(pPage + 6);
+
+        //Pages that don't end a packet have no granule position
+        if(granulePosition != ~(ma_uint64)0) {
+            pInfo->lengthInPCMFrames = granulePosition;
+            pInfo->isLengthExact = MA_TRUE;
+            break;
+        }
+    }
+
+    return MA_SUCCESS;
+}
+
+/* Returns the size of an MPEG audio frame starting with this header, or 0 if it isn't a valid Layer I, II or III header. */
+static ma_uint32 ma_ex_probe_mp3_frame_header(const ma_uint8 *pHeader, ma_uint32 *pSampleRate, ma_uint32 *pBitrate, ma_uint32 *pSamplesPerFrame) {
+    static const ma_uint16 bitratesMPEG1[3][15] = {
+        {0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448},
+        {0, 32, 48, 56,  64,  80,  96, 112, 128, 160, 192, 224, 256, 320, 384},
+        {0, 32, 40, 48,  56,  64,  80,  96, 112, 128, 160, 192, 224, 256, 320}
+    };
+    static const ma_uint16 bitratesMPEG2[2][15] = {
+        {0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256},
+        {0,  8, 16, 24, 32, 40, 48,  56,  64,  80,  96, 112, 128, 144, 160}
+    };
+    static const ma_uint32 sampleRatesMPEG1[3] = {44100, 48000, 32000};
+
+    if(pHeader[0] != 0xFF || (pHeader[1] & 0xE0) != 0xE0)
+        return 0;
+
+    ma_uint32 version = (pHeader[1] >> 3) & 0x03;     //3: MPEG-1, 2: MPEG-2, 0: MPEG-2.5
+    ma_uint32 layer = 4 - ((pHeader[1] >> 1) & 0x03);  //4 is reserved
+    ma_uint32 bitrateIndex = pHeader[2] >> 4;
+    ma_uint32 sampleRateIndex = (pHeader[2] >> 2) & 0x03;
+    ma_uint32 padding = (pHeader[2] >> 1) & 0x01;
+
+    //Free format streams have no bitrate in the header, they are left to the decoder
+    if(version == 1 || layer == 4 || bitrateIndex == 0 || bitrateIndex == 15 || sampleRateIndex == 3)
+        return 0;
+
+    ma_bool32 isMPEG1 = version == 3;
+    ma_uint32 bitrate = 1000 * (isMPEG1 ? bitratesMPEG1[layer - 1][bitrateIndex] : bitratesMPEG2[layer == 1 ? 0 : 1][bitrateIndex]);
+    ma_uint32 sampleRate = sampleRatesMPEG1[sampleRateIndex] >> (isMPEG1 ? 0 : (version == 2 ? 1 : 2));
+    ma_uint32 samplesPerFrame = layer == 1 ? 384 : (layer == 3 && !isMPEG1 ? 576 : 1152);
+
+    *pSampleRate = sampleRate;
+    *pBitrate = bitrate;
+    *pSamplesPerFrame = samplesPerFrame;
+
+    if(layer == 1)
+        return (12 * bitrate / sampleRate + padding) * 4;
+
+    return samplesPerFrame / 8 * bitrate / sampleRate + padding;
+}
+
+/* Uses the frame count of a Xing, Info or VBRI header in the first frame, the same way the decoder does. Without one the length is estimated from the bitrate of the first frame. */
+static ma_result ma_ex_probe_mp3(const ma_uint8 *p, size_t dataSize, ma_ex_probe_info *pInfo) {
+    size_t offset = 0;
+
+    //Skip ID3v2 tags, the size is a 28 bit synchsafe integer that excludes the 10 byte header and the footer
+    while(offset + 10 <= dataSize && memcmp(p + offset, "ID3", 3) == 0) {
+        const ma_uint8 *pTag = p + offset;
+        offset += 10 + (((size_t)(pTag[6] & 0x7F) << 21) | ((size_t)(pTag[7] & 0x7F) << 14) | ((size_t)(pTag[8] & 0x7F) << 7) | (size_t)(pTag[9] & 0x7F));
+        if(pTag[5] & 0x10)
+            offset += 10;
+    }
+
+    ma_uint32 sampleRate = 0;
+    ma_uint32 bitrate = 0;
+    ma_uint32 samplesPerFrame = 0;
+    ma_uint32 frameSize = 0;
+
+    //Some files have junk between the tags and the audio. A header is only trusted when another frame follows it.
+    size_t searchEnd = offset + 65536;
+
+    for(; offset + 4 <= dataSize && offset < searchEnd; offset++) {
+        frameSize = ma_ex_probe_mp3_frame_header(p + offset, &sampleRate, &bitrate, &samplesPerFrame);
+        if(frameSize == 0)
+            continue;
+
+        ma_uint32 nextSampleRate, nextBitrate, nextSamplesPerFrame;
+        if(offset + frameSize + 4 > dataSize || ma_ex_probe_mp3_frame_header(p + offset + frameSize, &nextSampleRate, &nextBitrate, &nextSamplesPerFrame) != 0)
+            break;
+    }
+
+    if(frameSize == 0 || offset + 4 > dataSize || offset >= searchEnd)
+        return MA_INVALID_FILE;
+
+    const ma_uint8 *pFrame = p + offset;
+    ma_bool32 isMPEG1 = ((pFrame[1] >> 3) & 0x03) == 3;
+    ma_bool32 isMono = (pFrame[3] >> 6) == 3;
+    ma_bool32 hasCRC = (pFrame[1] & 0x01) == 0;
+    size_t availableFrameSize = dataSize - offset < frameSize ? dataSize - offset : frameSize;
+
+    pInfo->codec = ma_encoding_format_mp3;
+    pInfo->format = ma_format_f32;
+    pInfo->channels = isMono ? 1 : 2;
+    pInfo->sampleRate = sampleRate;
+
+    //The Xing header follows the side information of the first frame
+    size_t xingOffset = 4 + (hasCRC ? 2 : 0) + (isMPEG1 ? (isMono ? 17 : 32) : (isMono ? 9 : 17));
+
+    if(xingOffset + 8 <= availableFrameSize && (memcmp(pFrame + xingOffset, "Xing", 4) == 0 || memcmp(pFrame + xingOffset, "Info", 4) == 0)) {
+        const ma_uint8 *pTag = pFrame + xingOffset;
+        ma_uint32 flags = pTag[7];
+        size_t tagOffset = 8;
+        ma_uint64 frameCount = 0;
+
+        if(flags & 0x01) {
+            if(xingOffset + tagOffset + 4 > availableFrameSize)
+                return MA_INVALID_FILE;
+            frameCount = ma_ex_read_be32(pTag + tagOffset);
+            tagOffset += 4;
+        }
+
+        if(flags & 0x02)
+            tagOffset += 4;
+        if(flags & 0x04)
+            tagOffset += 100;
+        if(flags & 0x08)
+            tagOffset += 4;
+
+        if(flags & 0x01) {
+            ma_uint64 lengthInPCMFrames = frameCount * samplesPerFrame;
+
+            //The LAME extension stores the encoder delay and padding, which the decoder trims
+            if(xingOffset + tagOffset + 21 + 3 <= availableFrameSize && pTag[tagOffset] != 0 && xingOffset + tagOffset + 21 + 14 < frameSize) {
+                const ma_uint8 *pLame = pTag + tagOffset + 21;
+                ma_uint32 delay = (((ma_uint32)pLame[0] << 4) | ((ma_uint32)pLame[1] >> 4)) + 529;
+                ma_int32 padding = (ma_int32)((((ma_uint32)pLame[1] & 0x0F) << 8) | (ma_uint32)pLame[2]) - 529;
+
+                lengthInPCMFrames = lengthInPCMFrames >= delay ? lengthInPCMFrames - delay : 0;
+                if(padding > 0)
+                    lengthInPCMFrames = lengthInPCMFrames >= (ma_uint64)padding ? lengthInPCMFrames - padding : 0;
+            }
+
+            pInfo->lengthInPCMFrames = lengthInPCMFrames;
+            pInfo->isLengthExact = MA_TRUE;
+            return MA_SUCCESS;
+        }
+    }
+
+    //The VBRI header has a fixed position. The decoder plays the frame holding it as silence, so the length is a close estimate.
+    if(4 + 32 + 18 <= availableFrameSize && memcmp(pFrame + 4 + 32, "VBRI", 4) == 0) {
+        pInfo->lengthInPCMFrames = (ma_uint64)ma_ex_read_be32(pFrame + 4 + 32 + 14) * samplesPerFrame;
+        pInfo->isLengthExact = MA_FALSE;
+        return MA_SUCCESS;
+    }
+
+    ma_uint64 audioSize = dataSize - offset;
+    if(dataSize - offset >= 128 && memcmp(p + dataSize - 128, "TAG", 3) == 0)
+        audioSize -= 128;
+
+    pInfo->lengthInPCMFrames = audioSize * 8 * sampleRate / bitrate;
+    pInfo->isLengthExact = MA_FALSE;
+    return MA_SUCCESS;
+}
+
+/* Opens the data with the stock and libvorbis decoders for the containers the header parsers don't handle. The length is exact, but may need a scan over the whole file. */
+static ma_result ma_ex_probe_with_decoder(const void *pData, size_t dataSize, ma_ex_probe_info *pInfo) {
+    ma_decoding_backend_vtable *pCustomBackendVTables[] = {
+        ma_libvorbis_get_decoding_backend()
+    };
+
+    ma_decoder_config config = ma_decoder_config_init_default();
+    config.ppCustomBackendVTables = pCustomBackendVTables;
+    config.customBackendCount = sizeof(pCustomBackendVTables)/sizeof(pCustomBackendVTables[0]);
+
+    ma_decoder decoder;
+    ma_result result = ma_decoder_init_memory(pData, dataSize, &config, &decoder);
+    if(result != MA_SUCCESS)
+        return result;
+
+    result = ma_decoder_get_data_format(&decoder, &pInfo->format, &pInfo->channels, &pInfo->sampleRate, NULL, 0);
+    if(result == MA_SUCCESS)
+        result = ma_decoder_get_length_in_pcm_frames(&decoder, &pInfo->lengthInPCMFrames);
+
+    pInfo->isLengthExact = result == MA_SUCCESS;
+    ma_decoder_uninit(&decoder);
+    return result;
+}
+
+/* Reads the format, channels, sample rate and length from the headers of a WAV, FLAC, Ogg or MP3 file without decoding audio. Anything else is opened with a decoder. */
+MA_API ma_result ma_ex_probe_memory(const void *pData, ma_uint64 size, ma_ex_probe_info *pInfo) {
+    if(pInfo == NULL)
+        return MA_INVALID_ARGS;
+
+    MA_ZERO_OBJECT(pInfo);
+
+    if(pData == NULL || size == 0 || size > MA_SIZE_MAX)
+        return MA_INVALID_ARGS;
+
+    const ma_uint8 *p = (const ma_uint8*)pData;
+    size_t dataSize = (size_t)size;
+    ma_result result = MA_NOT_IMPLEMENTED;
+    ma_uint32 sampleRate, bitrate, samplesPerFrame;
+
+    if(dataSize >= 12 && (memcmp(p, "RIFF", 4) == 0 || memcmp(p, "RF64", 4) == 0) && memcmp(p + 8, "WAVE", 4) == 0)
+        result = ma_ex_probe_wav(p, dataSize, pInfo);
+    else if(dataSize >= 4 && memcmp(p, "fLaC", 4) == 0)
+        result = ma_ex_probe_flac(p, dataSize, pInfo);
+    else if(dataSize >= 4 && memcmp(p, "OggS", 4) == 0)
+        result = ma_ex_probe_ogg(p, dataSize, pInfo);
+    else if(dataSize >= 4 && (memcmp(p, "ID3", 3) == 0 || ma_ex_probe_mp3_frame_header(p, &sampleRate, &bitrate, &samplesPerFrame) != 0))
+        result = ma_ex_probe_mp3(p, dataSize, pInfo);
+
+    if(result == MA_SUCCESS && pInfo->channels > 0 && pInfo->sampleRate > 0)
+        return MA_SUCCESS;
+
+    //Big endian and Wave64 files, compressed WAV files without a fact chunk and damaged headers
+    ma_encoding_format codec = result == MA_NOT_IMPLEMENTED ? pInfo->codec : ma_encoding_format_unknown;
+    MA_ZERO_OBJECT(pInfo);
+    pInfo->codec = codec;
+    return ma_ex_probe_with_decoder(pData, dataSize, pInfo);
+}
+
+MA_API ma_result ma_ex_probe_file(const char *pFilePath, ma_ex_probe_info *pInfo) {
+    if(pInfo != NULL)
+        MA_ZERO_OBJECT(pInfo);
+
+    if(pFilePath == NULL || pInfo == NULL)
+        return MA_INVALID_ARGS;
+
+    //Only the pages holding the headers are read from a mapped file, and for Ogg the last page
+    ma_ex_file_view view;
+    ma_result result = ma_ex_file_view_init(pFilePath, &view);
+    if(result != MA_SUCCESS)
+        return result;
+
+    result = ma_ex_probe_memory(view.pData, view.sizeInBytes, pInfo);
+    ma_ex_file_view_uninit(&view);
+    return result;
+}
+
+typedef struct ma_ex_probe_batch ma_ex_probe_batch;
+
+struct ma_ex_probe_batch {
+    ma_ex_probe_result *pResults;
+    ma_uint32 count;
+    MA_ATOMIC(4, ma_uint32) nextIndex;
+};
+
+static ma_thread_result MA_THREADCALL ma_ex_probe_thread(void *pData) {
+    ma_ex_probe_batch *batch = (ma_ex_probe_batch*)pData;
+
+    for(;;) {
+        ma_uint32 index = ma_ex_atomic_fetch_add_32(&batch->nextIndex, 1);
+        if(index >= batch->count)
+            break;
+
+        ma_ex_probe_result *pResult = &batch->pResults[index];
+        pResult->result = ma_ex_probe_file(pResult->pFilePath, &pResult->info);
+    }
+
+    return (ma_thread_result)0;
+}
+
+/* Lists the names of the regular files in a directory as consecutive null terminated strings. */
+static char *ma_ex_probe_list_directory(const char *pDirectoryPath, ma_uint32 *pCount, size_t *pSizeInBytes) {
+    char *pNames = NULL;
+    size_t capacity = 0;
+    size_t size = 0;
+    ma_uint32 count = 0;
+
+#if defined(_WIN32)
+    size_t pathLength = strlen(pDirectoryPath);
+    char *pPattern = MA_MALLOC(pathLength + 3);
+    if(pPattern == NULL)
+        return NULL;
+    memcpy(pPattern, pDirectoryPath, pathLength);
+    memcpy(pPattern + pathLength, "\\*", 3);
+
+    WIN32_FIND_DATAA findData;
+    HANDLE hFind = FindFirstFileA(pPattern, &findData);
+    MA_FREE(pPattern);
+    if(hFind == INVALID_HANDLE_VALUE)
+        return NULL;
+
+    do {
+        if(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            continue;
+        const char *pName = findData.cFileName;
+#else
+    DIR *pDir = opendir(pDirectoryPath);
+    if(pDir == NULL)
+        return NULL;
+
+    struct dirent *pEntry;
+    size_t pathLength = strlen(pDirectoryPath);
+
+    while((pEntry = readdir(pDir)) != NULL) {
+        const char *pName = pEntry->d_name;
+
+        //Not every file system fills in d_type
+        if(pEntry->d_type != DT_REG) {
+            if(pEntry->d_type != DT_UNKNOWN && pEntry->d_type != DT_LNK)
+                continue;
+
+            struct stat info;
+            size_t nameLength = strlen(pName);
+            char *pPath = MA_MALLOC(pathLength + nameLength + 2);
+            if(pPath == NULL)
+                continue;
+            memcpy(pPath, pDirectoryPath, pathLength);
+            pPath[pathLength] = '/';
+            memcpy(pPath + pathLength + 1, pName, nameLength + 1);
+            int isFile = stat(pPath, &info) == 0 && S_ISREG(info.st_mode);
+            MA_FREE(pPath);
+            if(!isFile)
+                continue;
+        }
+#endif
+        size_t nameSize = strlen(pName) + 1;
+
+        if(size + nameSize > capacity) {
+            size_t newCapacity = capacity == 0 ? 4096 : capacity * 2;
+            while(newCapacity < size + nameSize)
+                newCapacity *= 2;
+
+            char *pNewNames = MA_REALLOC(pNames, newCapacity);
+            if(pNewNames == NULL)
+                break;
+
+            pNames = pNewNames;
+            capacity = newCapacity;
+        }
+
+        memcpy(pNames + size, pName, nameSize);
+        size += nameSize;
+        count++;
+#if defined(_WIN32)
+    } while(FindNextFileA(hFind, &findData));
+
+    FindClose(hFind);
+#else
+    }
+
+    closedir(pDir);
+#endif
+
+    *pCount = count;
+    *pSizeInBytes = size;
+    return pNames;
+}
+
+/*
+Probes every file in a directory, not including subdirectories, on threadCount threads including the calling thread. Files that
+can't be probed are returned with the error in their result. The results and their paths are one allocation, freed with
+ma_ex_probe_results_free.
+*/
+MA_API ma_ex_probe_result *ma_ex_probe_directory(const char *pDirectoryPath, ma_uint32 threadCount, ma_uint32 *count) {
+    if(count == NULL)
+        return NULL;
+
+    *count = 0;
+
+    if(pDirectoryPath == NULL)
+        return NULL;
+
+    ma_uint32 fileCount = 0;
+    size_t namesSize = 0;
+    char *pNames = ma_ex_probe_list_directory(pDirectoryPath, &fileCount, &namesSize);
+
+    if(pNames == NULL || fileCount == 0) {
+        MA_FREE(pNames);
+        return NULL;
+    }
+
+    size_t pathLength = strlen(pDirectoryPath);
+    size_t resultsSize = sizeof(ma_ex_probe_result) * fileCount;
+    ma_ex_probe_result *pResults = MA_MALLOC(resultsSize + namesSize + (pathLength + 1) * fileCount);
+
+    if(pResults == NULL) {
+        MA_FREE(pNames);
+        return NULL;
+    }
+
+    char *pPath = (char*)pResults + resultsSize;
+    const char *pName = pNames;
+
+    for(ma_uint32 i = 0; i < fileCount; i++) {
+        size_t nameSize = strlen(pName) + 1;
+
+        memcpy(pPath, pDirectoryPath, pathLength);
+#if defined(_WIN32)
+        pPath[pathLength] = '\\';
+#else
+        pPath[pathLength] = '/';
+#endif
+        memcpy(pPath + pathLength + 1, pName, nameSize);
+
+        MA_ZERO_OBJECT(&pResults[i]);
+        pResults[i].pFilePath = pPath;
+        pResults[i].result = MA_ERROR;
+
+        pPath += pathLength + 1 + nameSize;
+        pName += nameSize;
+    }
+
+    MA_FREE(pNames);
+
+    ma_ex_probe_batch batch;
+    batch.pResults = pResults;
+    batch.count = fileCount;
+    ma_ex_atomic_store_32(&batch.nextIndex, 0);
+
+    if(threadCount > fileCount)
+        threadCount = fileCount;
+
+    ma_thread *pThreads = threadCount > 1 ? MA_MALLOC((threadCount - 1) * sizeof(ma_thread)) : NULL;
+    ma_uint32 startedThreadCount = 0;
+
+    for(ma_uint32 i = 0; pThreads != NULL && i < threadCount - 1; i++) {
+        if(ma_thread_create(&pThreads[i], ma_thread_priority_default, 0, ma_ex_probe_thread, &batch, NULL) != MA_SUCCESS)
+            break;
+        startedThreadCount++;
+    }
+
+    //The calling thread takes files as well, and does all of them when no thread could be started
+    ma_ex_probe_thread(&batch);
+
+    for(ma_uint32 i = 0; i < startedThreadCount; i++)
+        ma_thread_wait(&pThreads[i]);
+
+    MA_FREE(pThreads);
+
+    *count = fileCount;
+    return pResults;
+}
+
+MA_API void ma_ex_probe_results_free(ma_ex_probe_result *pResults, ma_uint32 count) {
+    (void)count;
+    if(pResults != NULL)
+        MA_FREE(pResults);
+}